@@ -45,6 +45,13 @@ function concat(table1, table2)
 	return result
 end
 
+-- The prebuilt Bullet libraries are not threadsafe, if they get rebuilt with BT_THREADSAFE=1 this lets the
+-- multithreaded physics world (see Scene::PhysicsSettings) actually run across threads
+newoption {
+	trigger = "bullet-threadsafe",
+	description = "Define BT_THREADSAFE=1, only use with Bullet libraries that were built with it"
+}
+
 -- Log what the startup project will be
 premake.info("Startup project: " .. startup)
 
@@ -358,6 +365,10 @@ function AddProjects(groupName, folders)
 				"_CRT_SECURE_NO_WARNINGS"
 			}
 
+			if _OPTIONS["bullet-threadsafe"] then
+				defines { "BT_THREADSAFE=1" }
+			end
+
 			-- We update the reserved include directory to be the project's source directory
 			ProjIncludes[1] = srcdir
 			-- Defines what directories we want to include
@@ -402,4 +413,89 @@ for k, proj in pairs(sampleGroups) do
 	local name = path.getbasename(proj);
     local samples = os.matchdirs(proj .. "/*")
     AddProjects("Samples - " .. name, samples)
-end
\ No newline at end of file
+end
+
+-- The headless benchmark builds just the gameplay simulation (AI, navigation and physics) with none of the
+-- rendering, windowing or audio code, so that it can run on build machines without a GPU
+-- ex: premake5 gmake2 && make config=release ResonanceBenchmark
+group("Tools")
+
+local benchmarkDir = "projects/Resonance v2"
+
+premake.info("Adding headless benchmark from: " .. benchmarkDir)
+project "ResonanceBenchmark"
+	location(benchmarkDir)
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("%{wks.location}/bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("%{wks.location}/obj/" .. outputdir .. "/%{prj.name}")
+
+	-- Only the sources that the simulation needs, anything that touches GL or FMOD is left out
+	files {
+		benchmarkDir .. "/benchmark/**.cpp",
+		benchmarkDir .. "/src/Gameplay/AIScheduler.cpp",
+		benchmarkDir .. "/src/Gameplay/Navigation/**.cpp",
+		benchmarkDir .. "/src/Gameplay/Physics/RayBatch.cpp",
+		benchmarkDir .. "/src/Gameplay/Physics/TaskScheduler.cpp",
+		benchmarkDir .. "/src/Utils/FileHelpers.cpp",
+		benchmarkDir .. "/src/Utils/AssetPack.cpp",
+		benchmarkDir .. "/src/Utils/StringUtils.cpp",
+		benchmarkDir .. "/src/Utils/ThreadPool.cpp",
+		"modules/toolkit/src/Logging.cpp"
+	}
+
+	includedirs {
+		benchmarkDir .. "/src",
+		"modules/toolkit/include",
+		"dependencies/GLM/include",
+		"dependencies/spdlog/include",
+		"dependencies/bullet3/include",
+	}
+
+	defines {
+		"_CRT_SECURE_NO_WARNINGS"
+	}
+
+	if _OPTIONS["bullet-threadsafe"] then
+		defines { "BT_THREADSAFE=1" }
+	end
+
+	filter "system:windows"
+		systemversion "latest"
+		buildoptions { "/bigobj" }
+		defines {
+			"WINDOWS"
+		}
+		links { "imagehlp.lib" }
+
+	-- On Linux we use the system's Bullet (ex: libbullet-dev) instead of the prebuilt Windows libs
+	filter "system:linux"
+		sysincludedirs { "/usr/include/bullet" }
+		links { "BulletDynamics", "BulletCollision", "LinearMath", "pthread" }
+
+	filter { "system:windows", "configurations:Debug" }
+		links {
+			"dependencies/bullet3/lib/BulletCollision_Debug.lib",
+			"dependencies/bullet3/lib/BulletDynamics_Debug.lib",
+			"dependencies/bullet3/lib/LinearMath_Debug.lib",
+		}
+
+	filter { "system:windows", "configurations:Release" }
+		links {
+			"dependencies/bullet3/lib/BulletCollision.lib",
+			"dependencies/bullet3/lib/BulletDynamics.lib",
+			"dependencies/bullet3/lib/LinearMath.lib",
+		}
+
+	filter "configurations:Debug"
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		runtime "Release"
+		optimize "on"
+
+	filter {}
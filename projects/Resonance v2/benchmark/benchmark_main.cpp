@@ -0,0 +1,502 @@
+// Headless benchmark for the gameplay simulation, no window, GL context or assets required
+//
+// Builds a procedural level of rooms and doorways in a Bullet world, bakes a navmesh from it and runs a crowd
+// of enemy agents through the same systems the Enemy component uses (AI scheduling, path service, flow field,
+// crowd avoidance and batched raycasts), stepping at a fixed dt. Reports per-system timings, raycast counts and
+// path request latency so that AI and physics regressions can be caught automatically
+//
+// ex: ResonanceBenchmark --agents 64 --frames 3600 --budget-ms 4
+//     ResonanceBenchmark --nav-graph
+//     ResonanceBenchmark --compare-physics --crates 32
+
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <btBulletDynamicsCommon.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+
+#include <Logging.h>
+#include "Gameplay/AIScheduler.h"
+#include "Gameplay/Navigation/NavMeshBuilder.h"
+#include "Gameplay/Navigation/PathService.h"
+#include "Gameplay/Navigation/FlowField.h"
+#include "Gameplay/Navigation/Crowd.h"
+#include "Gameplay/Physics/RayBatch.h"
+#include "Gameplay/Physics/TaskScheduler.h"
+
+using namespace Gameplay;
+typedef std::chrono::high_resolution_clock Clock;
+
+struct BenchmarkSettings {
+	int   Agents = 32;
+	int   Frames = 1800;
+	float Dt = 1.0f / 60.0f;
+	// How many of the agents chase the player instead of patrolling
+	float ChaseFraction = 0.25f;
+	int   RoomsPerSide = 4;
+	float RoomSize = 20.0f;
+	int   RayWorkers = 2;
+	int   PathWorkers = 1;
+	// Path and steer over a plain NavGraph instead of the navmesh, like a level that only has nav nodes
+	bool  UseNavGraph = false;
+	unsigned int Seed = 1234;
+	// If above zero, the benchmark fails when the average frame takes longer than this
+	float BudgetMs = 0.0f;
+	// Same as Scene::PhysicsSettings
+	bool  MultithreadedPhysics = false;
+	int   PhysicsThreads = 0;
+	// Instead of the agents, step stacks of crates with single and multithreaded physics and compare them
+	bool  ComparePhysics = false;
+	int   CrateStacks = 16;
+};
+
+// Accumulates how long a system took over the run
+struct Timing {
+	const char* Name;
+	double TotalMs = 0.0;
+	double MaxMs = 0.0;
+
+	Timing(const char* name) : Name(name) {}
+
+	void Add(Clock::time_point start) {
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		TotalMs += ms;
+		MaxMs = std::max(MaxMs, ms);
+	}
+};
+
+struct Agent {
+	btRigidBody* Body = nullptr;
+	uint32_t     SchedulerAgent = AIScheduler::NO_AGENT;
+	uint32_t     CrowdAgent = Navigation::Crowd::NO_AGENT;
+	bool         IsChasing = false;
+	// Same as Enemy, ordered from the goal back towards the start and walked from the back
+	std::vector<glm::vec3>  Path;
+	int                     PathIndex = -1;
+	Navigation::PathTicket  Ticket = Navigation::PathService::INVALID_TICKET;
+	Clock::time_point       RequestTime;
+	Physics::RayHandle      SightRay = Physics::RayBatch::INVALID_RAY;
+};
+
+static bool ParseArgs(int argc, char** args, BenchmarkSettings& settings) {
+	for (int ix = 1; ix < argc; ix++) {
+		bool hasValue = ix + 1 < argc;
+		if (hasValue && strcmp(args[ix], "--agents") == 0) {
+			settings.Agents = atoi(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--frames") == 0) {
+			settings.Frames = atoi(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--dt") == 0) {
+			settings.Dt = (float)atof(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--chase") == 0) {
+			settings.ChaseFraction = (float)atof(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--rooms") == 0) {
+			settings.RoomsPerSide = atoi(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--ray-workers") == 0) {
+			settings.RayWorkers = atoi(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--path-workers") == 0) {
+			settings.PathWorkers = atoi(args[++ix]);
+		} else if (strcmp(args[ix], "--nav-graph") == 0) {
+			settings.UseNavGraph = true;
+		} else if (hasValue && strcmp(args[ix], "--seed") == 0) {
+			settings.Seed = (unsigned int)atoi(args[++ix]);
+		} else if (hasValue && strcmp(args[ix], "--budget-ms") == 0) {
+			settings.BudgetMs = (float)atof(args[++ix]);
+		} else if (strcmp(args[ix], "--mt-physics") == 0) {
+			settings.MultithreadedPhysics = true;
+		} else if (hasValue && strcmp(args[ix], "--physics-threads") == 0) {
+			settings.PhysicsThreads = atoi(args[++ix]);
+		} else if (strcmp(args[ix], "--compare-physics") == 0) {
+			settings.ComparePhysics = true;
+		} else if (hasValue && strcmp(args[ix], "--crates") == 0) {
+			settings.CrateStacks = atoi(args[++ix]);
+		} else {
+			LOG_ERROR("Unknown argument \"{}\"", args[ix]);
+			LOG_INFO("Usage: [--agents N] [--frames N] [--dt seconds] [--chase fraction] [--rooms N] [--ray-workers N] [--path-workers N] [--nav-graph] [--seed N] [--budget-ms ms] [--mt-physics] [--physics-threads N] [--compare-physics] [--crates N]");
+			return false;
+		}
+	}
+	return settings.Agents > 0 && settings.Frames > 0 && settings.Dt > 0.0f && settings.RoomsPerSide > 0;
+}
+
+// A Bullet world set up the same way as Scene::_InitPhysics
+struct PhysicsWorld {
+	btDefaultCollisionConfiguration* CollisionConfig = nullptr;
+	btCollisionDispatcher*           Dispatcher = nullptr;
+	btBroadphaseInterface*           Broadphase = nullptr;
+	btConstraintSolver*              Solver = nullptr;
+	btConstraintSolverPoolMt*        SolverPool = nullptr;
+	btDiscreteDynamicsWorld*         World = nullptr;
+	std::vector<btCollisionShape*>   Shapes;
+
+	void Create(bool multithreaded, int threads) {
+		static Physics::TaskScheduler::Sptr scheduler = nullptr;
+
+		CollisionConfig = new btDefaultCollisionConfiguration();
+		Broadphase = new btDbvtBroadphase();
+		if (multithreaded && Physics::TaskScheduler::IS_SUPPORTED) {
+			if (scheduler == nullptr) {
+				scheduler = std::make_shared<Physics::TaskScheduler>(threads);
+				btSetTaskScheduler(scheduler.get());
+			}
+			scheduler->setNumThreads(threads > 0 ? threads : scheduler->getMaxNumThreads());
+			Dispatcher = new btCollisionDispatcherMt(CollisionConfig);
+			SolverPool = new btConstraintSolverPoolMt(scheduler->getNumThreads());
+			Solver = new btSequentialImpulseConstraintSolverMt();
+			World = new btDiscreteDynamicsWorldMt(Dispatcher, Broadphase, SolverPool, Solver, CollisionConfig);
+		} else {
+			Dispatcher = new btCollisionDispatcher(CollisionConfig);
+			Solver = new btSequentialImpulseConstraintSolver();
+			World = new btDiscreteDynamicsWorld(Dispatcher, Broadphase, Solver, CollisionConfig);
+		}
+		World->setGravity(btVector3(0.0f, 0.0f, -9.81f));
+	}
+
+	btRigidBody* AddBody(float mass, btCollisionShape* shape, const glm::vec3& position) {
+		btVector3 inertia(0.0f, 0.0f, 0.0f);
+		if (mass > 0.0f) {
+			shape->calculateLocalInertia(mass, inertia);
+		}
+		btTransform transform(btQuaternion::getIdentity(), btVector3(position.x, position.y, position.z));
+		btRigidBody::btRigidBodyConstructionInfo info(mass, new btDefaultMotionState(transform), shape, inertia);
+		btRigidBody* body = new btRigidBody(info);
+		World->addRigidBody(body);
+		return body;
+	}
+
+	void Destroy() {
+		for (int ix = World->getNumCollisionObjects() - 1; ix >= 0; ix--) {
+			btCollisionObject* object = World->getCollisionObjectArray()[ix];
+			btRigidBody* body = btRigidBody::upcast(object);
+			if (body != nullptr) {
+				delete body->getMotionState();
+			}
+			World->removeCollisionObject(object);
+			delete object;
+		}
+		for (btCollisionShape* shape : Shapes) {
+			delete shape;
+		}
+		Shapes.clear();
+		delete World;
+		delete SolverPool;
+		delete Solver;
+		delete Broadphase;
+		delete Dispatcher;
+		delete CollisionConfig;
+	}
+};
+
+// Adds a static box to the world, the same way a static RigidBody with a box collider would
+static void AddStaticBox(PhysicsWorld& world, const glm::vec3& center, const glm::vec3& halfExtents) {
+	btBoxShape* shape = new btBoxShape(btVector3(halfExtents.x, halfExtents.y, halfExtents.z));
+	world.Shapes.push_back(shape);
+	world.AddBody(0.0f, shape, center);
+}
+
+// A grid of rooms, with a doorway in the middle of every wall between two rooms
+static void BuildLevel(PhysicsWorld& world, const BenchmarkSettings& settings) {
+	const float size = settings.RoomsPerSide * settings.RoomSize;
+	const float wallHalfThickness = 0.25f;
+	const float wallHalfHeight = 1.5f;
+	const float doorHalfWidth = 2.0f;
+
+	AddStaticBox(world, glm::vec3(size / 2.0f, size / 2.0f, -0.5f), glm::vec3(size / 2.0f, size / 2.0f, 0.5f));
+
+	for (int line = 0; line <= settings.RoomsPerSide; line++) {
+		const float offset = line * settings.RoomSize;
+		const bool isOuter = line == 0 || line == settings.RoomsPerSide;
+		for (int room = 0; room < settings.RoomsPerSide; room++) {
+			const float start = room * settings.RoomSize;
+			const float mid = start + settings.RoomSize / 2.0f;
+			if (isOuter) {
+				AddStaticBox(world, glm::vec3(mid, offset, wallHalfHeight), glm::vec3(settings.RoomSize / 2.0f, wallHalfThickness, wallHalfHeight));
+				AddStaticBox(world, glm::vec3(offset, mid, wallHalfHeight), glm::vec3(wallHalfThickness, settings.RoomSize / 2.0f, wallHalfHeight));
+				continue;
+			}
+
+			// Each side of the doorway
+			const float halfLength = (settings.RoomSize / 2.0f - doorHalfWidth) / 2.0f;
+			for (float side : { -1.0f, 1.0f }) {
+				const float center = mid + side * (doorHalfWidth + halfLength);
+				AddStaticBox(world, glm::vec3(center, offset, wallHalfHeight), glm::vec3(halfLength, wallHalfThickness, wallHalfHeight));
+				AddStaticBox(world, glm::vec3(offset, center, wallHalfHeight), glm::vec3(wallHalfThickness, halfLength, wallHalfHeight));
+			}
+		}
+	}
+}
+
+// Stacks of crates with debris raining down on them, the kind of room that should scale across cores
+static Timing RunCrateBenchmark(const BenchmarkSettings& settings, bool multithreaded) {
+	PhysicsWorld world;
+	world.Create(multithreaded, settings.PhysicsThreads);
+
+	const int stacksPerSide = (int)glm::ceil(glm::sqrt((float)settings.CrateStacks));
+	const float spacing = 3.0f;
+	const float size = stacksPerSide * spacing;
+	AddStaticBox(world, glm::vec3(size / 2.0f, size / 2.0f, -0.5f), glm::vec3(size, size, 0.5f));
+
+	btBoxShape* crate = new btBoxShape(btVector3(0.5f, 0.5f, 0.5f));
+	btSphereShape* debris = new btSphereShape(0.25f);
+	world.Shapes.push_back(crate);
+	world.Shapes.push_back(debris);
+	for (int ix = 0; ix < settings.CrateStacks; ix++) {
+		const glm::vec3 base = glm::vec3((ix % stacksPerSide + 0.5f) * spacing, (ix / stacksPerSide + 0.5f) * spacing, 0.5f);
+		for (int level = 0; level < 10; level++) {
+			world.AddBody(1.0f, crate, base + glm::vec3(0.0f, 0.0f, level * 1.0f));
+		}
+	}
+
+	std::mt19937 random(settings.Seed);
+	std::uniform_real_distribution<float> randomPosition(0.0f, size);
+	Timing timing(multithreaded ? "Multithreaded" : "Single threaded");
+	for (int frame = 0; frame < settings.Frames; frame++) {
+		if (frame % 10 == 0) {
+			world.AddBody(0.2f, debris, glm::vec3(randomPosition(random), randomPosition(random), 15.0f));
+		}
+		Clock::time_point start = Clock::now();
+		world.World->stepSimulation(settings.Dt, 15);
+		timing.Add(start);
+	}
+
+	world.Destroy();
+	return timing;
+}
+
+static double Percentile(std::vector<double>& values, double percent) {
+	if (values.empty()) {
+		return 0.0;
+	}
+	size_t index = std::min(values.size() - 1, (size_t)(percent / 100.0 * values.size()));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+int main(int argc, char** args) {
+	Logger::Init();
+
+	BenchmarkSettings settings;
+	if (!ParseArgs(argc, args, settings)) {
+		Logger::Uninitialize();
+		return 1;
+	}
+	std::mt19937 random(settings.Seed);
+
+	if (settings.ComparePhysics) {
+		LOG_INFO("Comparing physics worlds with {} stacks of crates for {} frames", settings.CrateStacks, settings.Frames);
+		if (!Physics::TaskScheduler::IS_SUPPORTED) {
+			LOG_WARN("Bullet was not built with BT_THREADSAFE, both worlds will be single threaded");
+		}
+		Timing single = RunCrateBenchmark(settings, false);
+		Timing multi = RunCrateBenchmark(settings, true);
+		LOG_INFO("{:<16} {:>10} {:>10}", "World", "Avg (ms)", "Max (ms)");
+		for (const Timing* timing : { &single, &multi }) {
+			LOG_INFO("{:<16} {:>10.4f} {:>10.4f}", timing->Name, timing->TotalMs / settings.Frames, timing->MaxMs);
+		}
+		LOG_INFO("Speedup: {:.2f}x", single.TotalMs / std::max(multi.TotalMs, 0.0001));
+		Logger::Uninitialize();
+		return 0;
+	}
+
+	PhysicsWorld physics;
+	physics.Create(settings.MultithreadedPhysics, settings.PhysicsThreads);
+	btDiscreteDynamicsWorld* world = physics.World;
+	BuildLevel(physics, settings);
+
+	// Navigation
+	Clock::time_point bakeStart = Clock::now();
+	std::vector<glm::vec3> vertices;
+	std::vector<uint32_t> indices;
+	Navigation::NavMeshBuilder::GatherCollisionGeometry(world, vertices, indices);
+	Navigation::NavMesh::Sptr mesh = Navigation::NavMeshBuilder::Bake(vertices, indices);
+	double bakeMs = std::chrono::duration<double, std::milli>(Clock::now() - bakeStart).count();
+	if (mesh == nullptr || mesh->GetPolygonCount() == 0) {
+		LOG_ERROR("Failed to bake a navmesh for the benchmark level");
+		Logger::Uninitialize();
+		return 1;
+	}
+
+	// The nav graph stands in for a level's nav nodes, with one node for each polygon connected to it's neighbours
+	Navigation::NavGraph::Sptr graph = std::make_shared<Navigation::NavGraph>();
+	if (settings.UseNavGraph) {
+		const Navigation::NavGraph& meshGraph = mesh->GetGraph();
+		std::vector<glm::vec3> positions;
+		std::vector<std::pair<uint32_t, uint32_t>> edges;
+		for (uint32_t node = 0; node < (uint32_t)meshGraph.GetNodeCount(); node++) {
+			positions.push_back(meshGraph.GetNodePosition(node));
+			for (uint32_t edge = meshGraph.GetEdgesBegin(node); edge < meshGraph.GetEdgesEnd(node); edge++) {
+				edges.push_back({ node, meshGraph.GetEdgeTarget(edge) });
+			}
+		}
+		graph->Build(positions, edges, settings.RoomSize * 0.25f);
+	}
+	// Same as pathfindingManager, a navmesh is always used over the graph if there is one
+	const Navigation::NavMesh::Sptr navMesh = settings.UseNavGraph ? nullptr : mesh;
+
+	Navigation::PathService pathService;
+	pathService.SetWorkerCount(settings.PathWorkers);
+	pathService.SetSource(graph, navMesh);
+	Navigation::FlowField flowField;
+
+	// The nav graph doesn't know where the walls are, so agents only avoid walls when there is a navmesh
+	Navigation::Crowd crowd;
+	std::vector<glm::vec3> walls;
+	if (navMesh != nullptr) {
+		mesh->GetBoundaryEdges(walls);
+	}
+	crowd.SetObstacles(walls);
+
+	Physics::RayBatch rayBatch;
+	rayBatch.SetWorkerCount(settings.RayWorkers);
+	AIScheduler scheduler;
+
+	// Agents are capsules like the enemies, spawned in random polygons
+	btCapsuleShapeZ* agentShape = new btCapsuleShapeZ(0.5f, 1.0f);
+	physics.Shapes.push_back(agentShape);
+	std::uniform_int_distribution<uint32_t> randomPolygon(0, (uint32_t)mesh->GetPolygonCount() - 1);
+	auto randomPoint = [&]() { return mesh->GetPolygon(randomPolygon(random)).Center; };
+
+	std::vector<Agent> agents(settings.Agents);
+	for (int ix = 0; ix < settings.Agents; ix++) {
+		Agent& agent = agents[ix];
+		glm::vec3 position = randomPoint() + glm::vec3(0.0f, 0.0f, 1.0f);
+
+		agent.Body = physics.AddBody(1.0f, agentShape, position);
+		agent.Body->setAngularFactor(btVector3(0.0f, 0.0f, 0.0f));
+		agent.Body->setActivationState(DISABLE_DEACTIVATION);
+
+		agent.IsChasing = ix < settings.Agents * settings.ChaseFraction;
+		agent.SchedulerAgent = scheduler.Register(position);
+		Navigation::Crowd::AgentSettings crowdSettings;
+		crowdSettings.Radius = 0.5f;
+		agent.CrowdAgent = crowd.AddAgent(crowdSettings, position);
+	}
+
+	Timing scheduleTime("AI scheduling"), agentTime("Agent updates"), crowdTime("Crowd"), pathTime("Path service"), physicsTime("Physics step"), rayTime("Raycasts"), frameTime("Frame");
+	std::vector<double> pathLatencyMs;
+	uint64_t totalRays = 0, totalTicks = 0, failedPaths = 0;
+	uint32_t maxRays = 0;
+
+	LOG_INFO("Benchmarking {} agents for {} frames ({} polygons, {} walls, baked in {:.2f}ms)", settings.Agents, settings.Frames, mesh->GetPolygonCount(), walls.size() / 2, bakeMs);
+	if (settings.UseNavGraph) {
+		LOG_INFO("Using a nav graph of {} nodes and {} edges instead of the navmesh", graph->GetNodeCount(), graph->GetEdgeCount());
+	}
+
+	const float agentSpeed = 4.0f;
+	for (int frame = 0; frame < settings.Frames; frame++) {
+		Clock::time_point frameStart = Clock::now();
+
+		// The player walks a loop around the middle of the level
+		const float levelSize = settings.RoomsPerSide * settings.RoomSize;
+		const float angle = frame * settings.Dt * 0.1f;
+		const glm::vec3 player = glm::vec3(levelSize / 2.0f) + glm::vec3(glm::cos(angle), glm::sin(angle), 0.0f) * levelSize * 0.3f;
+
+		Clock::time_point start = Clock::now();
+		scheduler.Schedule(settings.Dt, glm::vec3(player.x, player.y, 1.0f), rayBatch);
+		scheduleTime.Add(start);
+		totalTicks += scheduler.GetTickCount();
+
+		start = Clock::now();
+		for (Agent& agent : agents) {
+			const btVector3& origin = agent.Body->getWorldTransform().getOrigin();
+			const glm::vec3 position = glm::vec3(origin.x(), origin.y(), origin.z());
+			const btVector3& linear = agent.Body->getLinearVelocity();
+			glm::vec3 velocity = glm::vec3(linear.x(), linear.y(), 0.0f);
+
+			scheduler.SetAgentState(agent.SchedulerAgent, position, agent.IsChasing);
+			float dt;
+			if (!scheduler.ShouldTick(agent.SchedulerAgent, dt)) {
+				crowd.SetAgentState(agent.CrowdAgent, position, velocity);
+				continue;
+			}
+
+			// Perception, the same line of sight check the aggravated state makes
+			agent.SightRay = rayBatch.Submit(position, glm::vec3(player.x, player.y, position.z));
+
+			glm::vec3 target = position;
+			if (agent.IsChasing) {
+				flowField.GetSteeringTarget(*graph, navMesh.get(), position, player, target);
+			} else {
+				// Patrollers path to random points through the path service
+				Navigation::PathStatus status;
+				std::vector<glm::vec3> path;
+				if (agent.Ticket != Navigation::PathService::INVALID_TICKET && pathService.Poll(agent.Ticket, status, path)) {
+					pathLatencyMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - agent.RequestTime).count());
+					agent.Ticket = Navigation::PathService::INVALID_TICKET;
+					if (status == Navigation::PathStatus::Success) {
+						agent.Path.swap(path);
+						agent.PathIndex = (int)agent.Path.size() - 1;
+					} else {
+						failedPaths++;
+					}
+				}
+				if (agent.PathIndex >= 0 && glm::length(glm::vec2(agent.Path[agent.PathIndex] - position)) < 1.0f) {
+					agent.PathIndex--;
+				}
+				if (agent.PathIndex < 0 && agent.Ticket == Navigation::PathService::INVALID_TICKET) {
+					agent.Ticket = pathService.Request(position, randomPoint());
+					agent.RequestTime = Clock::now();
+				}
+				if (agent.PathIndex >= 0) {
+					target = agent.Path[agent.PathIndex];
+				}
+			}
+
+			glm::vec3 preferred = glm::vec3(target.x - position.x, target.y - position.y, 0.0f);
+			if (glm::length(preferred) > 0.01f) {
+				preferred = glm::normalize(preferred) * agentSpeed;
+			}
+			glm::vec3 safe = crowd.ComputeVelocity(agent.CrowdAgent, preferred, agentSpeed, dt);
+			agent.Body->setLinearVelocity(btVector3(safe.x, safe.y, linear.z()));
+			crowd.SetAgentState(agent.CrowdAgent, position, safe);
+		}
+		agentTime.Add(start);
+
+		start = Clock::now();
+		crowd.Update();
+		crowdTime.Add(start);
+
+		start = Clock::now();
+		pathService.Update();
+		pathTime.Add(start);
+
+		start = Clock::now();
+		world->stepSimulation(settings.Dt, 15);
+		physicsTime.Add(start);
+
+		const uint32_t rayCount = (uint32_t)rayBatch.GetPendingCount();
+		totalRays += rayCount;
+		maxRays = std::max(maxRays, rayCount);
+		start = Clock::now();
+		rayBatch.Execute(world);
+		rayTime.Add(start);
+
+		frameTime.Add(frameStart);
+	}
+
+	LOG_INFO("{:<16} {:>10} {:>10}", "System", "Avg (ms)", "Max (ms)");
+	for (const Timing* timing : { &scheduleTime, &agentTime, &crowdTime, &pathTime, &physicsTime, &rayTime, &frameTime }) {
+		LOG_INFO("{:<16} {:>10.4f} {:>10.4f}", timing->Name, timing->TotalMs / settings.Frames, timing->MaxMs);
+	}
+	LOG_INFO("AI ticks: {:.2f} per frame, out of {} agents", (double)totalTicks / settings.Frames, settings.Agents);
+	LOG_INFO("Raycasts: {:.2f} per frame, {} at most", (double)totalRays / settings.Frames, maxRays);
+	LOG_INFO("Path requests: {} finished, {} failed, latency p50 {:.3f}ms p90 {:.3f}ms p99 {:.3f}ms max {:.3f}ms",
+		pathLatencyMs.size(), failedPaths, Percentile(pathLatencyMs, 50.0), Percentile(pathLatencyMs, 90.0), Percentile(pathLatencyMs, 99.0), Percentile(pathLatencyMs, 100.0));
+
+	const double averageFrameMs = frameTime.TotalMs / settings.Frames;
+	const bool isOverBudget = settings.BudgetMs > 0.0f && averageFrameMs > settings.BudgetMs;
+	if (isOverBudget) {
+		LOG_WARN("Average frame took {:.4f}ms, over the budget of {:.4f}ms", averageFrameMs, settings.BudgetMs);
+	}
+
+	physics.Destroy();
+
+	Logger::Uninitialize();
+	return isOverBudget ? 2 : 0;
+}
@@ -79,6 +79,7 @@ std::string Application::_applicationName = "Resonance";
 
 #define DEFAULT_WINDOW_WIDTH 1920
 #define DEFAULT_WINDOW_HEIGHT 1080
+#define ASSET_PACK_PATH "assets.pak"
 
 Application::Application() :
 	_window(nullptr),
@@ -127,13 +128,13 @@ void Application::Quit() {
 }
 
 bool Application::LoadScene(const std::string & path) {
-	if (std::filesystem::exists(path)) {
+	if (FileHelpers::Exists(path)) {
 		isEscapePressed = false;
 		isGamePaused = false;
 		isGameStarted = true;
 
 		std::string manifestPath = std::filesystem::path(path).stem().string() + "-manifest.json";
-		if (std::filesystem::exists(manifestPath)) {
+		if (FileHelpers::Exists(manifestPath)) {
 			LOG_INFO("Loading manifest from \"{}\"", manifestPath);
 			ResourceManager::LoadManifest(manifestPath);
 		}
@@ -186,9 +187,23 @@ void Application::_Run()
 	_windowSize.x = JsonGet(_appSettings, "window_width", DEFAULT_WINDOW_WIDTH);
 	_windowSize.y = JsonGet(_appSettings, "window_height", DEFAULT_WINDOW_HEIGHT);
 
+	// The physics settings need to be in place before the first scene is created
+	Gameplay::Scene::PhysicsSettings physics;
+	physics.Multithreaded = JsonGet(_appSettings, "physics_multithreaded", physics.Multithreaded);
+	physics.Threads = JsonGet(_appSettings, "physics_threads", physics.Threads);
+	Gameplay::Scene::SetPhysicsSettings(physics);
+
+	// Lets the audio load and play without a device, ex: when running headless
+	AudioManager::SetNoSoundOutput(JsonGet(_appSettings, "audio_no_sound", false));
+
 	// By default, we want our viewport to be the whole screen
 	_primaryViewport = { 0, 0, _windowSize.x, _windowSize.y };
 
+	// If we've got a packed build of our assets, serve reads from the pack rather than loose files
+	if (std::filesystem::exists(ASSET_PACK_PATH)) {
+		FileHelpers::MountPack(ASSET_PACK_PATH);
+	}
+
 	// Register all component and resource types
 	_RegisterClasses();
 
@@ -482,6 +497,9 @@ void Application::_HandleSceneChange() {
 
 	_currentScene = _targetScene;
 
+	// The old scene's GUI textures are going away, so the new one gets to pack it's own from scratch
+	GuiBatcher::ResetAtlas();
+
 	// Let the layers know that we've loaded in a new scene
 	for (const auto& layer : _layers) {
 		if (layer->Enabled && *(layer->Overrides & AppLayerFunctions::OnSceneLoad)) {
@@ -549,6 +567,9 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"] = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+	result["physics_multithreaded"] = false;
+	result["physics_threads"] = 0;
+	result["audio_no_sound"] = false;
 	return result;
 }
 
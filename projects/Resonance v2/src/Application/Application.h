@@ -103,6 +103,10 @@ public:
 		return nullptr;
 	}
 
+	/**
+	 * Gets the application settings, call SaveSettings to keep any changes
+	 */
+	nlohmann::json& GetSettings() { return _appSettings; }
 	/**
 	 * Saves the application settings to a file in %APPDATA%
 	 */
@@ -253,6 +253,21 @@ void ImGuiDebugLayer::_RenderGameWindow()
 			app.CurrentScene()->SetPhysicsDebugDrawMode(physicsDrawMode);
 		}
 
+		// The physics world is only created with the scene, so changes show up the next time a scene loads
+		Scene::PhysicsSettings physics = Scene::GetPhysicsSettings();
+		bool physicsChanged = ImGui::Checkbox("Multithreaded Physics", &physics.Multithreaded);
+		if (!Physics::TaskScheduler::IS_SUPPORTED) {
+			ImGui::TextDisabled("Bullet was not built with BT_THREADSAFE");
+		}
+		physicsChanged |= ImGui::DragInt("Physics Threads (0 = auto)", &physics.Threads, 0.1f, 0, 64);
+		if (physicsChanged) {
+			Scene::SetPhysicsSettings(physics);
+			app.GetSettings()["physics_multithreaded"] = physics.Multithreaded;
+			app.GetSettings()["physics_threads"] = physics.Threads;
+			app.SaveSettings();
+		}
+		ImGui::TextDisabled("Current scene is %s, changes apply on scene load", app.CurrentScene()->IsPhysicsMultithreaded() ? "multithreaded" : "single threaded");
+
 		ImGui::EndPopup();
 	}
 
@@ -3,6 +3,7 @@
 #include "Gameplay/Scene.h"
 #include "Application/Application.h"
 #include "Gameplay/Components/RotatingBehaviour.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 
 InstancedRenderingTestLayer::InstancedRenderingTestLayer()
 	: ApplicationLayer()
@@ -42,10 +43,10 @@ void InstancedRenderingTestLayer::OnSceneLoad() {
 	_vao->AddVertexBuffer(_instanceBuffer, instancedParams, true);
 
 	// Load our instanced shader
-	_shader = ShaderProgram::Create();
-	_shader->LoadShaderPartFromFile("shaders/vertex_shaders/basic_instanced.glsl", ShaderPartType::Vertex); 
-	_shader->LoadShaderPartFromFile("shaders/fragment_shaders/frag_environment_mirror.glsl", ShaderPartType::Fragment);
-	_shader->Link();
+	_shader = ResourceManager::GetShader({
+		{ ShaderPartType::Vertex, "shaders/vertex_shaders/basic_instanced.glsl" },
+		{ ShaderPartType::Fragment, "shaders/fragment_shaders/frag_environment_mirror.glsl" }
+	});
 
 
 	// Due to how scene stuff is handled in editor, we'll remove all existing instances and re-add them
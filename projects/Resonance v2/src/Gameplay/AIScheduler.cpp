@@ -0,0 +1,140 @@
+#include "Gameplay/AIScheduler.h"
+
+#include <algorithm>
+
+namespace Gameplay {
+	AIScheduler::AIScheduler() :
+		_settings(),
+		_agents(),
+		_freeAgents(),
+		_tickCount(0),
+		_due(),
+		_visibilityChecks(),
+		_visibilityCursor(0)
+	{ }
+
+	uint32_t AIScheduler::Register(const glm::vec3& position) {
+		Agent agent;
+		agent.Position = position;
+		agent.IsUrgent = false;
+		agent.IsVisible = false;
+		agent.Level = Lod::Full;
+		agent.ShouldTick = true;
+		agent.TickDelta = 0.0f;
+		agent.IsActive = true;
+
+		uint32_t index = static_cast<uint32_t>(_agents.size());
+		if (!_freeAgents.empty()) {
+			index = _freeAgents.back();
+			_freeAgents.pop_back();
+		} else {
+			_agents.emplace_back();
+		}
+		// Spread the agents' first ticks out over a low rate interval, so they don't all come due on the same frame
+		agent.Elapsed = glm::fract(index * 0.618034f) / _settings.LowRate;
+		_agents[index] = agent;
+		return index;
+	}
+
+	void AIScheduler::Unregister(uint32_t agent) {
+		if (agent >= _agents.size() || !_agents[agent].IsActive) {
+			return;
+		}
+		// A line of sight check may still be out for the agent, it's result is ignored once it comes back
+		_agents[agent].IsActive = false;
+		_agents[agent].ShouldTick = false;
+		_freeAgents.push_back(agent);
+	}
+
+	void AIScheduler::SetAgentState(uint32_t agent, const glm::vec3& position, bool isUrgent) {
+		_agents[agent].Position = position;
+		_agents[agent].IsUrgent = isUrgent;
+	}
+
+	bool AIScheduler::ShouldTick(uint32_t agent, float& outDeltaTime) const {
+		outDeltaTime = _agents[agent].TickDelta;
+		return _agents[agent].ShouldTick;
+	}
+
+	void AIScheduler::Schedule(float dt, const glm::vec3& focus, Physics::RayBatch& rays) {
+		_tickCount = 0;
+		if (GetAgentCount() == 0) {
+			return;
+		}
+
+		// Pick up the line of sight checks from last frame, anything in the way that isn't static (ex: another enemy) doesn't block sight
+		const Physics::RayBatch::Results& results = rays.GetResults();
+		for (const VisibilityCheck& check : _visibilityChecks) {
+			uint32_t index = rays.GetResultIndex(check.Ray);
+			if (index != Physics::RayBatch::NO_RESULT && _agents[check.Agent].IsActive) {
+				_agents[check.Agent].IsVisible = !results.HasHit[index] || !results.IsStatic[index];
+			}
+		}
+		_visibilityChecks.clear();
+
+		// Send out the next few checks, agents that are too far away can't see the player at all. Free slots are
+		// stepped over without using up a ray
+		const float visibilityDistSq = _settings.VisibilityDistance * _settings.VisibilityDistance;
+		const uint32_t checkCount = glm::min(static_cast<uint32_t>(glm::max(_settings.VisibilityRaysPerFrame, 0)), static_cast<uint32_t>(GetAgentCount()));
+		for (uint32_t ix = 0; ix < checkCount; ix++) {
+			do {
+				_visibilityCursor = (_visibilityCursor + 1) % _agents.size();
+			} while (!_agents[_visibilityCursor].IsActive);
+			Agent& agent = _agents[_visibilityCursor];
+			const glm::vec3 offset = focus - agent.Position;
+			if (glm::dot(offset, offset) > visibilityDistSq) {
+				agent.IsVisible = false;
+				continue;
+			}
+			_visibilityChecks.push_back({ _visibilityCursor, rays.Submit(agent.Position, focus) });
+		}
+
+		// Work out each agent's level of detail, full rate agents always tick
+		const float fullDistSq = _settings.FullRateDistance * _settings.FullRateDistance;
+		const float mediumDistSq = _settings.MediumRateDistance * _settings.MediumRateDistance;
+		_due.clear();
+		for (uint32_t ix = 0; ix < _agents.size(); ix++) {
+			Agent& agent = _agents[ix];
+			if (!agent.IsActive) {
+				continue;
+			}
+			const glm::vec3 offset = focus - agent.Position;
+			const float distSq = glm::dot(offset, offset);
+
+			agent.Elapsed += dt;
+			agent.ShouldTick = false;
+			if (agent.IsUrgent || distSq < fullDistSq) {
+				agent.Level = Lod::Full;
+				agent.ShouldTick = true;
+				agent.TickDelta = glm::min(agent.Elapsed, _settings.MaxTickDelta);
+				agent.Elapsed = 0.0f;
+				_tickCount++;
+				continue;
+			}
+
+			agent.Level = agent.IsVisible || distSq < mediumDistSq ? Lod::Medium : Lod::Low;
+			const float interval = 1.0f / (agent.Level == Lod::Medium ? _settings.MediumRate : _settings.LowRate);
+			if (agent.Elapsed >= interval) {
+				_due.push_back(ix);
+			}
+		}
+
+		// Only a few of the reduced rate agents get to tick each frame, the ones that are furthest past their interval go first
+		const size_t budget = static_cast<size_t>(glm::max(_settings.MaxReducedTicks, 0));
+		if (_due.size() > budget) {
+			auto overdue = [this](uint32_t index) {
+				const Agent& agent = _agents[index];
+				return agent.Elapsed * (agent.Level == Lod::Medium ? _settings.MediumRate : _settings.LowRate);
+			};
+			std::partial_sort(_due.begin(), _due.begin() + budget, _due.end(), [&](uint32_t a, uint32_t b) { return overdue(a) > overdue(b); });
+			_due.resize(budget);
+		}
+		for (uint32_t ix : _due) {
+			Agent& agent = _agents[ix];
+			agent.ShouldTick = true;
+			agent.TickDelta = glm::min(agent.Elapsed, _settings.MaxTickDelta);
+			agent.Elapsed = 0.0f;
+			_tickCount++;
+		}
+	}
+}
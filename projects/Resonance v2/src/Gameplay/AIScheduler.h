@@ -0,0 +1,130 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Physics/RayBatch.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Decides how often each AI agent (ex: enemies) runs its full update, so that agents far away from the
+	/// player don't cost as much as the ones the player can see
+	///
+	/// Each agent gets a level of detail from its distance to the player, whether it can see the player and whether
+	/// it has asked to be updated every frame (ex: while chasing the player). Agents at a reduced rate are ticked once
+	/// enough time has built up, with the most overdue agents going first and only a few of them each frame, so the
+	/// cost stays about the same no matter how many agents there are. Agents that miss a tick are given all of the
+	/// time since their last one when they do tick, and keep moving with their last velocity in between
+	/// </summary>
+	class AIScheduler {
+	public:
+		// An agent index that never refers to an agent
+		static constexpr uint32_t NO_AGENT = ~0u;
+
+		enum class Lod {
+			// Ticked every frame
+			Full,
+			// Ticked at MediumRate
+			Medium,
+			// Ticked at LowRate
+			Low
+		};
+
+		struct Settings {
+			// Agents closer than this to the player are always ticked every frame
+			float FullRateDistance = 15.0f;
+			// Agents closer than this, or that can see the player, are ticked at MediumRate
+			float MediumRateDistance = 40.0f;
+			// How far away an agent can be and still be checked for line of sight to the player
+			float VisibilityDistance = 60.0f;
+			// Ticks per second
+			float MediumRate = 10.0f;
+			float LowRate = 3.0f;
+			// The most reduced rate agents that can tick in one frame, full rate agents are not counted
+			int   MaxReducedTicks = 4;
+			// How many line of sight rays are cast each frame, agents take turns
+			int   VisibilityRaysPerFrame = 2;
+			// The most time that can be handed to an agent in one tick, so that a long hitch doesn't teleport it
+			float MaxTickDelta = 0.5f;
+		};
+
+		AIScheduler();
+		~AIScheduler() = default;
+
+		/// <summary>
+		/// Adds an agent to be scheduled
+		/// </summary>
+		/// <param name="position">Where the agent is starting</param>
+		/// <returns>The index of the new agent</returns>
+		uint32_t Register(const glm::vec3& position);
+		/// <summary>
+		/// Stops scheduling an agent, so it no longer takes up ticks or line of sight checks. It's index may be handed
+		/// out again by Register
+		/// </summary>
+		/// <param name="agent">The index of the agent, does nothing if it's NO_AGENT or already removed</param>
+		void Unregister(uint32_t agent);
+		/// <summary>
+		/// Updates where an agent is, and if it needs to run every frame regardless of distance. Should be called every
+		/// frame by the agent, even when it isn't ticking
+		/// </summary>
+		void SetAgentState(uint32_t agent, const glm::vec3& position, bool isUrgent);
+
+		/// <summary>
+		/// Works out which agents tick this frame, should be called once a frame before any agents update
+		/// </summary>
+		/// <param name="dt">The time in seconds since the last frame</param>
+		/// <param name="focus">The position agents are scheduled around, usually the player</param>
+		/// <param name="rays">The ray batch to check line of sight with, results are read the frame after</param>
+		void Schedule(float dt, const glm::vec3& focus, Physics::RayBatch& rays);
+
+		/// <summary>
+		/// Checks if an agent should run its full update this frame
+		/// </summary>
+		/// <param name="agent">The index of the agent</param>
+		/// <param name="outDeltaTime">Will store the time in seconds since the agent last ticked</param>
+		/// <returns>True if the agent should tick, false if otherwise</returns>
+		bool ShouldTick(uint32_t agent, float& outDeltaTime) const;
+		/// <summary>
+		/// Gets the level of detail an agent was given this frame
+		/// </summary>
+		Lod GetLod(uint32_t agent) const { return _agents[agent].Level; }
+
+		Settings& GetSettings() { return _settings; }
+		/// <summary>
+		/// Gets the number of agents that ticked in the last frame
+		/// </summary>
+		uint32_t GetTickCount() const { return _tickCount; }
+		size_t GetAgentCount() const { return _agents.size() - _freeAgents.size(); }
+
+	protected:
+		struct Agent {
+			glm::vec3 Position;
+			bool      IsUrgent;
+			bool      IsVisible;
+			Lod       Level;
+			// The time since the agent last ticked
+			float     Elapsed;
+			bool      ShouldTick;
+			float     TickDelta;
+			// Removed agents keep their slot so other indices stay the same, until it's re-used
+			bool      IsActive;
+		};
+
+		Settings           _settings;
+		std::vector<Agent>    _agents;
+		std::vector<uint32_t> _freeAgents;
+		uint32_t              _tickCount;
+
+		// The agents with reduced rates that are due for a tick this frame, re-used between frames
+		std::vector<uint32_t> _due;
+
+		// Line of sight checks sent out last frame, waiting for the ray batch
+		struct VisibilityCheck {
+			uint32_t           Agent;
+			Physics::RayHandle Ray;
+		};
+		std::vector<VisibilityCheck> _visibilityChecks;
+		// The next agent to check line of sight for
+		uint32_t _visibilityCursor;
+	};
+}
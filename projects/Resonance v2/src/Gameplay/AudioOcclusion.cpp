@@ -0,0 +1,187 @@
+#include "Gameplay/AudioOcclusion.h"
+
+#include <btBulletCollisionCommon.h>
+
+#include "Utils/ThreadPool.h"
+
+namespace Gameplay {
+	// We only care if anything is in the way, so the first hit ends the ray
+	struct AnyHitRayCallback : btCollisionWorld::RayResultCallback {
+		virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool /*normalInWorldSpace*/) override {
+			m_collisionObject = rayResult.m_collisionObject;
+			m_closestHitFraction = btScalar(0.0f);
+			return m_closestHitFraction;
+		}
+	};
+
+	AudioOcclusion::Geometry::~Geometry() {
+		delete Object;
+		delete Shape;
+		delete Mesh;
+	}
+
+	void AudioOcclusion::Geometry::Build() {
+		btIndexedMesh mesh;
+		mesh.m_numTriangles        = static_cast<int>(Indices.size() / 3);
+		mesh.m_triangleIndexBase   = reinterpret_cast<const unsigned char*>(Indices.data());
+		mesh.m_triangleIndexStride = 3 * sizeof(int);
+		mesh.m_numVertices         = static_cast<int>(Vertices.size());
+		mesh.m_vertexBase          = reinterpret_cast<const unsigned char*>(Vertices.data());
+		mesh.m_vertexStride        = sizeof(glm::vec3);
+		mesh.m_vertexType          = PHY_FLOAT;
+		Mesh = new btTriangleIndexVertexArray();
+		Mesh->addIndexedMesh(mesh, PHY_INTEGER);
+		Shape = new btBvhTriangleMeshShape(Mesh, true);
+		Object = new btCollisionObject();
+		Object->setCollisionShape(Shape);
+	}
+
+	AudioOcclusion::AudioOcclusion() :
+		_settings(),
+		_isRunning(false),
+		_lastPass(),
+		_mutex(),
+		_passDone(),
+		_isPassRunning(false),
+		_geometry(nullptr),
+		_pendingGeometry(nullptr),
+		_hasPendingGeometry(false),
+		_listener(0.0f),
+		_sources(),
+		_results(),
+		_hasNewResults(false)
+	{ }
+
+	AudioOcclusion::~AudioOcclusion() {
+		Stop();
+	}
+
+	void AudioOcclusion::Start(const Settings& settings) {
+		if (_isRunning) {
+			return;
+		}
+		// Settings are only read by passes, and none can be running while we're stopped
+		_settings = settings;
+		_isRunning = true;
+		_lastPass = std::chrono::steady_clock::time_point();
+	}
+
+	void AudioOcclusion::Stop() {
+		if (!_isRunning) {
+			return;
+		}
+		_isRunning = false;
+		std::unique_lock<std::mutex> lock(_mutex);
+		_passDone.wait(lock, [this]() { return !_isPassRunning; });
+	}
+
+	void AudioOcclusion::SetRate(float rate) {
+		// The rate is only read while queuing up passes, which happens under the lock
+		std::lock_guard<std::mutex> lock(_mutex);
+		_settings.Rate = rate;
+	}
+
+	void AudioOcclusion::SetGeometry(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices) {
+		std::shared_ptr<Geometry> geometry = nullptr;
+		if (!vertices.empty() && indices.size() >= 3) {
+			geometry = std::make_shared<Geometry>();
+			geometry->Vertices = std::move(vertices);
+			geometry->Indices = std::move(indices);
+		}
+
+		// Passes keep casting against the old geometry until the next one has built this, anything handed over
+		// before that is just replaced
+		std::lock_guard<std::mutex> lock(_mutex);
+		_pendingGeometry = geometry;
+		_hasPendingGeometry = true;
+	}
+
+	void AudioOcclusion::Submit(const glm::vec3& listener, const std::vector<Source>& sources) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_listener = listener;
+		_sources = sources;
+
+		// Only one pass is ever in flight, if the last one is running late the next just starts later
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		const std::chrono::duration<float> interval(1.0f / glm::max(_settings.Rate, 1.0f));
+		if (_isRunning && !_isPassRunning && now - _lastPass >= interval) {
+			_lastPass = now;
+			_isPassRunning = true;
+			ThreadPool::Get().Enqueue([this]() { _RunPass(); });
+		}
+	}
+
+	bool AudioOcclusion::GetResults(std::vector<Result>& results) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_hasNewResults) {
+			return false;
+		}
+		results.swap(_results);
+		_hasNewResults = false;
+		return true;
+	}
+
+	void AudioOcclusion::_RunPass() {
+		std::vector<Source> sources;
+		std::vector<Result> results;
+		std::shared_ptr<Geometry> geometry;
+		glm::vec3 listener;
+		bool isNewGeometry;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			isNewGeometry = _hasPendingGeometry;
+			geometry = isNewGeometry ? std::move(_pendingGeometry) : _geometry;
+			_pendingGeometry = nullptr;
+			_hasPendingGeometry = false;
+			listener = _listener;
+			sources = _sources;
+		}
+
+		// Only one pass runs at a time, so nothing else can be using geometry that hasn't been built yet
+		if (isNewGeometry && geometry != nullptr) {
+			geometry->Build();
+		}
+
+		results.resize(sources.size());
+		for (size_t ix = 0; ix < sources.size(); ix++) {
+			results[ix].Key = sources[ix].Key;
+			results[ix].Order = sources[ix].Order;
+			results[ix].Occlusion = geometry != nullptr ? _CastRay(*geometry, listener, sources[ix].Position) : 0.0f;
+		}
+		// Let go of the geometry before we're marked as done, so Stop never leaves a pass holding on to it
+		std::shared_ptr<Geometry> oldGeometry = nullptr;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (isNewGeometry) {
+				oldGeometry = std::move(_geometry);
+				_geometry = std::move(geometry);
+			}
+		}
+		oldGeometry.reset();
+		geometry.reset();
+
+		// We're notified under the lock, since Stop can return (and we can be destroyed) as soon as it's released
+		std::lock_guard<std::mutex> lock(_mutex);
+		_results.swap(results);
+		_hasNewResults = true;
+		_isPassRunning = false;
+		_passDone.notify_all();
+	}
+
+	float AudioOcclusion::_CastRay(const Geometry& geometry, const glm::vec3& from, const glm::vec3& to) const {
+		glm::vec3 direction = to - from;
+		const float length = glm::length(direction);
+		if (length <= _settings.EndMargin * 2.0f) {
+			return 0.0f;
+		}
+		direction /= length;
+		const glm::vec3 start = from + direction * _settings.EndMargin;
+		const glm::vec3 end = to - direction * _settings.EndMargin;
+
+		const btTransform rayFrom(btQuaternion::getIdentity(), btVector3(start.x, start.y, start.z));
+		const btTransform rayTo(btQuaternion::getIdentity(), btVector3(end.x, end.y, end.z));
+		AnyHitRayCallback callback;
+		btCollisionWorld::rayTestSingle(rayFrom, rayTo, geometry.Object, geometry.Shape, geometry.Object->getWorldTransform(), callback);
+		return callback.hasHit() ? _settings.Strength : 0.0f;
+	}
+}
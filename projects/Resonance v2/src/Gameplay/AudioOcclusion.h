@@ -0,0 +1,125 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <chrono>
+#include <GLM/glm.hpp>
+
+class btBvhTriangleMeshShape;
+class btTriangleIndexVertexArray;
+class btCollisionObject;
+
+namespace Gameplay {
+	/// <summary>
+	/// Works out how blocked each sound is from the listener by casting rays against the level geometry on the
+	/// engine's thread pool, at a much lower rate than the game runs at
+	///
+	/// Passes have their own copy of the static level triangles, so they never touch the physics world and can
+	/// run while the world is being stepped. New triangles are built into a BVH by the next pass, off the main thread. Sources are handed over each frame, which also queues up the next
+	/// pass once it's due, and the results from the latest pass can be picked up whenever they're ready
+	/// </summary>
+	class AudioOcclusion {
+	public:
+		// A sound to check, the key lets the results be matched back up to whatever made the sound
+		struct Source {
+			void*     Key = nullptr;
+			uint64_t  Order = 0;
+			glm::vec3 Position = glm::vec3(0.0f);
+		};
+		// How blocked a source is, from 0 (clear) to 1 (fully blocked)
+		struct Result {
+			void*    Key = nullptr;
+			uint64_t Order = 0;
+			float    Occlusion = 0.0f;
+		};
+
+		struct Settings {
+			// How many times a second the sources are checked
+			float Rate = 15.0f;
+			// How blocked a source that has geometry in the way is
+			float Strength = 0.8f;
+			// How far from each end the ray is shortened, so surfaces right at the listener or sound don't count
+			float EndMargin = 0.25f;
+		};
+
+		AudioOcclusion();
+		~AudioOcclusion();
+
+		AudioOcclusion(const AudioOcclusion& other) = delete;
+		AudioOcclusion& operator=(const AudioOcclusion& other) = delete;
+
+		/// <summary>
+		/// Starts checking the sources, does nothing if it's already running
+		/// </summary>
+		/// <param name="settings">How the sources should be checked</param>
+		void Start(const Settings& settings);
+		/// <summary>
+		/// Stops checking the sources, waiting for any pass that is still running to finish
+		/// </summary>
+		void Stop();
+		bool IsRunning() const { return _isRunning; }
+		/// <summary>
+		/// Changes how many times a second the sources are checked, takes effect from the next pass
+		/// </summary>
+		void SetRate(float rate);
+
+		/// <summary>
+		/// Replaces the geometry that sounds can be blocked by. The triangles are handed over as they are, and the
+		/// next pass builds them into a BVH before it casts against them
+		/// </summary>
+		/// <param name="vertices">The world space vertices of the triangles</param>
+		/// <param name="indices">Three indices into vertices for each triangle</param>
+		void SetGeometry(std::vector<glm::vec3> vertices, std::vector<uint32_t> indices);
+
+		/// <summary>
+		/// Hands over where the listener and sources are, replacing the last ones given. If it's been long enough
+		/// since the last pass, and it has finished, a new pass is queued up to check them
+		/// </summary>
+		void Submit(const glm::vec3& listener, const std::vector<Source>& sources);
+		/// <summary>
+		/// Gets the results from the latest pass, if there's been one since this was last called
+		/// </summary>
+		/// <param name="results">Replaced with the results if there are new ones</param>
+		/// <returns>True if results were new, false if otherwise</returns>
+		bool GetResults(std::vector<Result>& results);
+
+	protected:
+		// The level geometry that rays are cast against, only used by passes once it's been handed over
+		struct Geometry {
+			std::vector<glm::vec3>      Vertices;
+			std::vector<uint32_t>       Indices;
+			btTriangleIndexVertexArray* Mesh = nullptr;
+			btBvhTriangleMeshShape*     Shape = nullptr;
+			btCollisionObject*          Object = nullptr;
+
+			~Geometry();
+
+			/// <summary>
+			/// Builds the BVH over the triangles, this is the expensive part so it's left to a pass
+			/// </summary>
+			void Build();
+		};
+
+		Settings                  _settings;
+		bool                      _isRunning;
+		std::chrono::steady_clock::time_point _lastPass;
+		std::mutex                _mutex;
+		std::condition_variable   _passDone;
+
+		// Everything below is guarded by _mutex
+		bool                      _isPassRunning;
+		std::shared_ptr<Geometry> _geometry;
+		// Geometry from SetGeometry that no pass has built yet, it may be null to clear the geometry
+		std::shared_ptr<Geometry> _pendingGeometry;
+		bool                      _hasPendingGeometry;
+		glm::vec3                 _listener;
+		std::vector<Source>       _sources;
+		std::vector<Result>       _results;
+		bool                      _hasNewResults;
+
+		void _RunPass();
+		float _CastRay(const Geometry& geometry, const glm::vec3& from, const glm::vec3& to) const;
+	};
+}
@@ -1,74 +1,110 @@
 #include "Gameplay/Components/AudioManager.h"
 #include "Utils/ImGuiHelper.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 #include "Gameplay/Components/SimpleCameraControl.h"
+#include "Gameplay/Navigation/NavMeshBuilder.h"
+#include "fmod_errors.h"
+#include <algorithm>
+#include <chrono>
+
+bool AudioManager::_useNoSoundOutput = false;
 
 void AudioManager::Awake() {
 	GetGameObject()->GetScene()->audioManager = GetGameObject();
 
+	// Xorshift gets stuck at zero, so make sure the seed never is
+	randomState = static_cast<uint32_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count()) | 1u;
+
 	FMOD::System_Create(&system);
-	system->init(32, FMOD_INIT_NORMAL, nullptr);
-
-	LoadSound("L1_Ambiance", "Audio/Music/Infested_Engines.wav", false, true);
-	LoadSound("Title", "Audio/Music/Resonance.wav", false, true);
-	LoadSound("L2_Ambiance", "Audio/Music/Dead Quarters.wav", false, true);
-	LoadSound("Transition", "Audio/Sounds/loadingTransition.wav", false, false);
-	LoadSound("Footstep", "Audio/Sounds/footstepTest4.wav", false, false);
-	LoadSound("LeaflingPatrol", "Audio/Sounds/Leaflings_Patrol2.wav", true, true);
-	LoadSound("LeaflingDistracted", "Audio/Sounds/Leaflings_Distracted.wav", true, true);
-	LoadSound("LeaflingAgro", "Audio/Sounds/Leaflings_Agro.wav", true, true);
-	LoadSound("Engines", "Audio/Sounds/engineWhirring.wav", true, true);
-	LoadSound("OxygenRefill", "Audio/Sounds/replenishOxygen.wav", false, true);
-	LoadSound("OutOfBreath", "Audio/Sounds/outOfBreath.wav", false, true);
-	LoadSound("HoldingBreath", "Audio/Sounds/holdingBreath.wav", false, false);
-	LoadSound("BreathOut", "Audio/Sounds/breathOut.wav", false, false);
-	LoadSound("ValveTwist", "Audio/Sounds/valveTwist2.wav", true, false);
-	LoadSound("VendingMachine", "Audio/Sounds/vendingMachine.wav", true, false);
-	LoadSound("IdleIn", "Audio/Sounds/idleIn.wav", false, false);
-	LoadSound("IdleOut", "Audio/Sounds/idleOut.wav", false, false);
-	LoadSound("StopReplenish", "Audio/Sounds/stopReplenishOxygen.wav", false, false);
-	LoadSound("Death", "Audio/Music/Death Has Come Too Early.wav", false, false);
-	LoadSound("LadderClimb", "Audio/Sounds/ladderClimb.wav", false, false);
-	LoadSound("KeyPickup", "Audio/Sounds/keyPickup.wav", false, false);
-	LoadSound("DoorOpen", "Audio/Sounds/doorOpen.wav", true, false);
-	LoadSound("DoorClose", "Audio/Sounds/doorClose.wav", true, false);
+	if (_useNoSoundOutput) {
+		system->setOutput(FMOD_OUTPUTTYPE_NOSOUND);
+	}
 
-	if (track == "L1_Ambiance")
-	{
-		FMOD::Channel* tempChannel;
-		system->playSound(sounds[track], nullptr, false, &tempChannel);
-		tempChannel->set3DAttributes(&GlmVectorToFmodVector(glm::vec3(0, 50, -7)), 0);
-		tempChannel->setVolume(1.0f);
+	// Only realVoices are ever mixed, anything past that (or too quiet to hear) becomes virtual
+	Gameplay::VoiceManager::Settings voiceSettings;
+	voiceSettings.RealVoices = realVoices;
+	voiceSettings.MaxVoices = maxVoices;
+	voices.Configure(system, voiceSettings);
+	const FMOD_INITFLAGS initFlags = FMOD_INIT_NORMAL | FMOD_INIT_VOL0_BECOMES_VIRTUAL;
 
-		FMOD::Channel* tempChannel2;
-		system->playSound(sounds["Engines"], nullptr, false, &tempChannel2);
-		tempChannel2->set3DAttributes(&GlmVectorToFmodVector(glm::vec3(13.5f, 28.8f, 0)), 0);
-		tempChannel2->setVolume(3.0f);
+	// If there's no audio device, we can still load and "play" everything with the no-sound output
+	if (system->init(maxVoices, initFlags, nullptr) != FMOD_OK && !_useNoSoundOutput) {
+		LOG_WARN("Failed to initialize audio output, falling back to no sound");
+		system->setOutput(FMOD_OUTPUTTYPE_NOSOUND);
+		system->init(maxVoices, initFlags, nullptr);
+	}
 
-		FMOD::Channel* tempChannel3;
-		system->playSound(sounds["Engines"], nullptr, false, &tempChannel3);
-		tempChannel3->set3DAttributes(&GlmVectorToFmodVector(glm::vec3(-13.5f, 28.8f, 0)), 0);
-		tempChannel3->setVolume(3.0f);
+	// Grab the sound bank from the scene's manifest, or add the default bank to it so it gets saved with the scene
+	const nlohmann::ordered_json& manifest = ResourceManager::GetManifest();
+	nlohmann::json bankBlob;
+	if (manifest.contains("sounds")) {
+		bankBlob = manifest["sounds"];
+	} else {
+		bankBlob = _GetDefaultBank();
+		ResourceManager::SetManifestSection("sounds", bankBlob);
 	}
-	else
-	{
-		PlaySoundByName(track);
+
+	// Declare the whole bank before loading anything, so that variation groups can resolve their sounds
+	std::vector<SoundId> declared;
+	for (auto& [name, blob] : bankBlob.items()) {
+		declared.push_back(_DeclareSound(name, SoundInfo::FromJson(blob)));
+	}
+
+	SoundId trackSound = GetSoundId(track);
+	std::vector<SoundId> preloads;
+	for (SoundId id : declared) {
+		_ResolveVariations(id);
+		const SoundSlot& slot = slots[id];
+
+		if (id == trackSound || slot.Info.File.empty()) {
+			continue;
+		}
+		if (slot.Info.Preload) {
+			preloads.push_back(id);
+		} else {
+			deferredSounds.push_back(id);
+		}
+	}
+	footstepSound = GetSoundId("Footstep");
+
+	// FMOD loads non-blocking sounds one at a time in the order they were requested, so we start with the
+	// scene's track, then go from the most to least important sounds
+	std::stable_sort(preloads.begin(), preloads.end(), [&](SoundId a, SoundId b) {
+		return slots[a].Info.GetPriority() < slots[b].Info.GetPriority();
+	});
+	_StartLoad(trackSound);
+	for (SoundId id : preloads) {
+		_StartLoad(id);
 	}
 }
 
 AudioManager::~AudioManager()
 {
-	system->release();
+	// Releasing the system releases all of our sounds as well
+	if (system != nullptr) {
+		system->release();
+	}
 }
 
 void AudioManager::Update(float deltaTime) {
+	_PollLoads();
 
 	GameObject* player = GetGameObject()->GetScene()->MainCamera->GetGameObject();
+	voices.SetListener(player->GetPosition());
 	if (player->Has<SimpleCameraControl>())
 	{
 		glm::quat dir = player->Get<SimpleCameraControl>()->currentRot;
 		system->set3DListenerAttributes(0, &GlmVectorToFmodVector(player->GetPosition()), &GlmVectorToFmodVector(player->Get<Gameplay::Physics::RigidBody>()->GetLinearVelocity()), &GlmVectorToFmodVector(dir * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f)), &GlmVectorToFmodVector(dir * glm::vec4(0.0f, -1.0f, 0.0f, 1.0f)));
 	}
+	if (useOcclusion) {
+		_UpdateOcclusion(player->GetPosition());
+	} else if (occlusion.IsRunning()) {
+		occlusion.Stop();
+		voices.ClearOcclusion();
+	}
+	voices.Update(deltaTime);
 	system->update();
 
 	FMOD::ChannelGroup* masterChannelGroup;
@@ -76,8 +112,129 @@ void AudioManager::Update(float deltaTime) {
 	masterChannelGroup->setVolume(volume);
 }
 
+void AudioManager::_UpdateOcclusion(const glm::vec3& listener) {
+	if (!occlusion.IsRunning()) {
+		Gameplay::AudioOcclusion::Settings settings;
+		settings.Rate = occlusionRate;
+		occlusion.Start(settings);
+		appliedOcclusionRate = occlusionRate;
+	} else if (occlusionRate != appliedOcclusionRate) {
+		occlusion.SetRate(occlusionRate);
+		appliedOcclusionRate = occlusionRate;
+	}
+
+	// Occlusion has it's own copy of every static collider (the merged level and anything that wasn't merged), which
+	// only needs replacing when the static bodies change. Dynamic bodies and triggers coming and going don't count,
+	// and the BVH is built by the next pass rather than here
+	Gameplay::Scene* scene = GetGameObject()->GetScene();
+	const uint64_t bodiesHash = Gameplay::Navigation::NavMeshBuilder::ComputeCollisionBodiesHash(scene->GetPhysicsWorld());
+	if (!hasOcclusionGeometry || bodiesHash != occlusionBodiesHash) {
+		occlusionBodiesHash = bodiesHash;
+		hasOcclusionGeometry = true;
+		std::vector<glm::vec3> vertices;
+		std::vector<uint32_t> indices;
+		Gameplay::Navigation::NavMeshBuilder::GatherCollisionGeometry(scene->GetPhysicsWorld(), vertices, indices);
+		occlusion.SetGeometry(std::move(vertices), std::move(indices));
+	}
+
+	if (occlusion.GetResults(occlusionResults)) {
+		voices.SetOcclusion(occlusionResults);
+	}
+	voices.GetOcclusionSources(occlusionSources);
+	occlusion.Submit(listener, occlusionSources);
+}
+
+void AudioManager::_PollLoads() {
+	for (size_t ix = 0; ix < loadingSounds.size();) {
+		SoundSlot& slot = slots[loadingSounds[ix]];
+
+		// The sound was unloaded while it was still loading
+		if (slot.Sound == nullptr) {
+			loadingSounds[ix] = loadingSounds.back();
+			loadingSounds.pop_back();
+			continue;
+		}
+
+		// If the open failed, getOpenState returns the reason
+		FMOD_OPENSTATE state = FMOD_OPENSTATE_LOADING;
+		FMOD_RESULT openResult = slot.Sound->getOpenState(&state, nullptr, nullptr, nullptr);
+		if (openResult != FMOD_OK || state == FMOD_OPENSTATE_ERROR) {
+			_FailLoad(loadingSounds[ix], openResult);
+		}
+		else if (state == FMOD_OPENSTATE_LOADING || state == FMOD_OPENSTATE_CONNECTING) {
+			ix++;
+			continue;
+		}
+		else {
+			// Priority can only be set once the sound is open, so we keep the frequency FMOD read from the file
+			float frequency;
+			int priority;
+			slot.Sound->getDefaults(&frequency, &priority);
+			slot.Sound->setDefaults(frequency, slot.Info.GetPriority());
+
+			// FMOD has made it's own copy of the file (or is reading from the mapped pack), so we can drop ours
+			slot.Buffer.reset();
+			slot.IsReady = true;
+		}
+
+		loadingSounds[ix] = loadingSounds.back();
+		loadingSounds.pop_back();
+	}
+
+	// Once everything we need up front is done, we can start on the rest of the bank
+	if (loadingSounds.empty() && !deferredSounds.empty()) {
+		for (SoundId id : deferredSounds) {
+			_StartLoad(id);
+		}
+		deferredSounds.clear();
+	}
+
+	if (!isTrackStarted) {
+		_PlayTrack();
+	}
+}
+
+void AudioManager::_PlayTrack() {
+	SoundId trackId = GetSoundId(track);
+	// The failure (or missing sound) has already been logged, there's nothing left to wait for
+	if (trackId == INVALID_SOUND || slots[trackId].HasFailed) {
+		isTrackStarted = true;
+		return;
+	}
+	FMOD::Sound* trackSound = _GetReadySound(trackId);
+	if (trackSound == nullptr) {
+		return;
+	}
+
+	if (track == "L1_Ambiance")
+	{
+		// The level can still have it's ambiance if the engines didn't load
+		SoundId engineId = GetSoundId("Engines");
+		bool hasEngines = engineId < slots.size() && !slots[engineId].HasFailed;
+		FMOD::Sound* engineSound = hasEngines ? _GetReadySound(engineId) : nullptr;
+		if (hasEngines && engineSound == nullptr) {
+			return;
+		}
+
+		voices.Play(system, trackSound, slots[trackId].Info.MaxInstances, glm::vec3(0, 50, -7), 1.0f);
+		if (hasEngines) {
+			voices.Play(system, engineSound, slots[engineId].Info.MaxInstances, glm::vec3(13.5f, 28.8f, 0), 3.0f);
+			voices.Play(system, engineSound, slots[engineId].Info.MaxInstances, glm::vec3(-13.5f, 28.8f, 0), 3.0f);
+		}
+	}
+	else
+	{
+		Play(trackId);
+	}
+	isTrackStarted = true;
+}
+
 void AudioManager::RenderImGui() {
 	LABEL_LEFT(ImGui::DragFloat, "Volume", &volume);
+	ImGui::Text("Voices: %d (%d loading sounds)", static_cast<int>(voices.GetVoiceCount()), GetNumLoadingSounds());
+	ImGui::Text("Position updates: %u", voices.GetPositionUpdateCount());
+	LABEL_LEFT(ImGui::Checkbox, "Occlusion", &useOcclusion);
+	LABEL_LEFT(ImGui::DragFloat, "Occlusion Rate", &occlusionRate, 1.0f, 1.0f, 60.0f);
 	ImGui::Text("Track");
 	// Draw a textbox for our track name
 	static char nameBuff[256];
@@ -91,7 +248,11 @@ void AudioManager::RenderImGui() {
 nlohmann::json AudioManager::ToJson() const {
 	return {
 		{ "volume", volume },
-		{ "track", track }
+		{ "track", track },
+		{ "real_voices", realVoices },
+		{ "max_voices", maxVoices },
+		{ "occlusion", useOcclusion },
+		{ "occlusion_rate", occlusionRate }
 	};
 }
 
@@ -99,83 +260,377 @@ AudioManager::Sptr AudioManager::FromJson(const nlohmann::json& blob) {
 	AudioManager::Sptr result = std::make_shared<AudioManager>();
 	result->volume = JsonGet(blob, "volume", result->volume);
 	result->track = JsonGet(blob, "track", result->track);
+	result->realVoices = JsonGet(blob, "real_voices", result->realVoices);
+	result->maxVoices = JsonGet(blob, "max_voices", result->maxVoices);
+	result->useOcclusion = JsonGet(blob, "occlusion", result->useOcclusion);
+	result->occlusionRate = JsonGet(blob, "occlusion_rate", result->occlusionRate);
+	return result;
+}
+
+AudioManager::SoundInfo AudioManager::SoundInfo::FromJson(const nlohmann::json& blob) {
+	SoundInfo result;
+	result.File = JsonGet(blob, "file", result.File);
+	result.Is3D = JsonGet(blob, "3d", result.Is3D);
+	result.IsLooping = JsonGet(blob, "loop", result.IsLooping);
+	result.IsStreamed = JsonGet(blob, "stream", result.IsStreamed);
+	result.Category = JsonParseEnum(SoundCategory, blob, "category", result.Category);
+	result.Priority = JsonGet(blob, "priority", result.Priority);
+	result.MaxInstances = JsonGet(blob, "max_instances", result.MaxInstances);
+	result.Preload = JsonGet(blob, "preload", result.Preload);
+	result.Variations = JsonGet(blob, "variations", result.Variations);
+	result.Pitch = JsonGet(blob, "pitch", result.Pitch);
+	result.PitchRange = JsonGet(blob, "pitch_range", result.PitchRange);
+	result.VolumeRange = JsonGet(blob, "volume_range", result.VolumeRange);
+	return result;
+}
+
+nlohmann::json AudioManager::SoundInfo::ToJson() const {
+	nlohmann::json result = {
+		{ "file", File },
+		{ "3d", Is3D },
+		{ "loop", IsLooping },
+		{ "stream", IsStreamed },
+		{ "category", ~Category },
+		{ "priority", Priority },
+		{ "max_instances", MaxInstances },
+		{ "preload", Preload },
+		{ "pitch", Pitch },
+		{ "pitch_range", PitchRange },
+		{ "volume_range", VolumeRange }
+	};
+	if (!Variations.empty()) {
+		result["variations"] = Variations;
+	}
+	return result;
+}
+
+int AudioManager::SoundInfo::GetPriority() const {
+	return Priority >= 0 ? Priority : Gameplay::VoiceManager::GetCategoryPriority(Category);
+}
+
+nlohmann::json AudioManager::_GetDefaultBank() {
+	// Music is streamed so it's never fully decoded into memory, and is only loaded up front when it's the
+	// scene's track. Everything else is small enough to keep in memory
+	auto sound = [](const std::string& file, SoundCategory category, bool b3d, bool bLooping, int maxInstances = 0, bool bStream = false, bool preload = true) {
+		SoundInfo info;
+		info.File = file;
+		info.Category = category;
+		info.Is3D = b3d;
+		info.IsLooping = bLooping;
+		info.MaxInstances = maxInstances;
+		info.IsStreamed = bStream;
+		info.Preload = preload;
+		return info;
+	};
+
+	// Footsteps get a bit of random volume and pitch so that they don't sound the same every step
+	SoundInfo footstep = sound("Audio/Sounds/footstepTest4.wav", SoundCategory::Player, false, false, 2);
+	footstep.Pitch = 0.7f;
+	footstep.PitchRange = 0.4f;
+	footstep.VolumeRange = 0.3f;
+
+	nlohmann::json result;
+	result["L1_Ambiance"]        = sound("Audio/Music/Infested_Engines.wav", SoundCategory::Music, false, true, 1, true, false).ToJson();
+	result["Title"]              = sound("Audio/Music/Resonance.wav", SoundCategory::Music, false, true, 1, true, false).ToJson();
+	result["L2_Ambiance"]        = sound("Audio/Music/Dead Quarters.wav", SoundCategory::Music, false, true, 1, true, false).ToJson();
+	result["Death"]              = sound("Audio/Music/Death Has Come Too Early.wav", SoundCategory::Music, false, false, 1, true, false).ToJson();
+	result["Transition"]         = sound("Audio/Sounds/loadingTransition.wav", SoundCategory::Interface, false, false, 1).ToJson();
+	result["Footstep"]           = footstep.ToJson();
+	result["LeaflingPatrol"]     = sound("Audio/Sounds/Leaflings_Patrol2.wav", SoundCategory::Enemy, true, true, 4).ToJson();
+	result["LeaflingDistracted"] = sound("Audio/Sounds/Leaflings_Distracted.wav", SoundCategory::Enemy, true, true, 4).ToJson();
+	result["LeaflingAgro"]       = sound("Audio/Sounds/Leaflings_Agro.wav", SoundCategory::Enemy, true, true, 4).ToJson();
+	result["Engines"]            = sound("Audio/Sounds/engineWhirring.wav", SoundCategory::Ambience, true, true, 2).ToJson();
+	result["OxygenRefill"]       = sound("Audio/Sounds/replenishOxygen.wav", SoundCategory::Player, false, true, 1).ToJson();
+	result["OutOfBreath"]        = sound("Audio/Sounds/outOfBreath.wav", SoundCategory::Player, false, true, 1).ToJson();
+	result["HoldingBreath"]      = sound("Audio/Sounds/holdingBreath.wav", SoundCategory::Player, false, false, 1).ToJson();
+	result["BreathOut"]          = sound("Audio/Sounds/breathOut.wav", SoundCategory::Player, false, false, 1).ToJson();
+	result["ValveTwist"]         = sound("Audio/Sounds/valveTwist2.wav", SoundCategory::Effect, true, false, 2).ToJson();
+	result["VendingMachine"]     = sound("Audio/Sounds/vendingMachine.wav", SoundCategory::Effect, true, false, 2).ToJson();
+	result["IdleIn"]             = sound("Audio/Sounds/idleIn.wav", SoundCategory::Player, false, false, 1).ToJson();
+	result["IdleOut"]            = sound("Audio/Sounds/idleOut.wav", SoundCategory::Player, false, false, 1).ToJson();
+	result["StopReplenish"]      = sound("Audio/Sounds/stopReplenishOxygen.wav", SoundCategory::Player, false, false, 1).ToJson();
+	result["LadderClimb"]        = sound("Audio/Sounds/ladderClimb.wav", SoundCategory::Player, false, false, 2).ToJson();
+	result["KeyPickup"]          = sound("Audio/Sounds/keyPickup.wav", SoundCategory::Interface, false, false, 1).ToJson();
+	result["DoorOpen"]           = sound("Audio/Sounds/doorOpen.wav", SoundCategory::Effect, true, false, 4).ToJson();
+	result["DoorClose"]          = sound("Audio/Sounds/doorClose.wav", SoundCategory::Effect, true, false, 4).ToJson();
 	return result;
 }
 
+SoundId AudioManager::GetSoundId(const std::string& soundName)
+{
+	auto foundElement = soundIds.find(soundName);
+	if (foundElement != soundIds.end())
+	{
+		return foundElement->second;
+	}
+
+	// Making slots for unknown names would let typos and one-off names grow the bank forever
+	if (missingSounds.insert(soundName).second) {
+		LOG_WARN("Sound \"{}\" is not in the sound bank", soundName);
+	}
+	return INVALID_SOUND;
+}
+
+SoundId AudioManager::GetSoundId(SoundRef& sound)
+{
+	if (sound.Id == INVALID_SOUND && !sound.Name.empty()) {
+		sound.Id = GetSoundId(sound.Name);
+	}
+	return sound.Id;
+}
+
 void AudioManager::LoadSound(const std::string& soundName, const std::string& filename, bool b3d, bool bLooping, bool bStream)
 {
-	//Check if already loaded
-	auto foundElement = sounds.find(soundName);
-	if (foundElement != sounds.end())
+	SoundInfo info;
+	info.File = filename;
+	info.Is3D = b3d;
+	info.IsLooping = bLooping;
+	info.IsStreamed = bStream;
+	LoadSound(soundName, info);
+}
+
+void AudioManager::LoadSound(const std::string& soundName, const SoundInfo& info)
+{
+	// Sounds that are already declared keep the info they were declared with
+	SoundId id;
+	auto foundElement = soundIds.find(soundName);
+	if (foundElement != soundIds.end()) {
+		id = foundElement->second;
+	} else {
+		id = _DeclareSound(soundName, info);
+		_ResolveVariations(id);
+	}
+	_StartLoad(id);
+}
+
+SoundId AudioManager::_DeclareSound(const std::string& soundName, const SoundInfo& info)
+{
+	SoundId id = static_cast<SoundId>(slots.size());
+	slots.emplace_back();
+	slots.back().Name = soundName;
+	slots.back().Info = info;
+	soundIds[soundName] = id;
+	missingSounds.erase(soundName);
+	return id;
+}
+
+void AudioManager::_ResolveVariations(SoundId sound)
+{
+	SoundSlot& slot = slots[sound];
+	slot.Variations.clear();
+	for (const std::string& variation : slot.Info.Variations) {
+		SoundId variationId = GetSoundId(variation);
+		if (variationId != INVALID_SOUND) {
+			slot.Variations.push_back(variationId);
+		}
+	}
+}
+
+void AudioManager::_StartLoad(SoundId sound)
+{
+	if (sound >= slots.size()) {
+		return;
+	}
+	SoundSlot& slot = slots[sound];
+
+	//Check if already loaded, if there's nothing to load, or if we already know it can't be loaded
+	if (slot.Sound != nullptr || slot.HasFailed || slot.Info.File.empty())
 	{
-		//has already been loaded.
 		return;
 	}
 
-	FMOD_MODE mode = FMOD_DEFAULT;
-	mode |= (b3d) ? FMOD_3D : FMOD_2D;
-	mode |= (bLooping) ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF;
-	mode |= (bStream) ? FMOD_CREATESTREAM : FMOD_CREATECOMPRESSEDSAMPLE;
+	// Non-blocking sounds are opened on FMOD's loading thread, we check on them in Update
+	FMOD_MODE mode = FMOD_NONBLOCKING;
+	mode |= (slot.Info.Is3D) ? FMOD_3D : FMOD_2D;
+	mode |= (slot.Info.IsLooping) ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF;
+	mode |= (slot.Info.IsStreamed) ? FMOD_CREATESTREAM : FMOD_CREATECOMPRESSEDSAMPLE;
+
+	FMOD_CREATESOUNDEXINFO exInfo;
+	memset(&exInfo, 0, sizeof(FMOD_CREATESOUNDEXINFO));
+	exInfo.cbsize = sizeof(FMOD_CREATESOUNDEXINFO);
+
+	// If the sound is in an asset pack, we hand FMOD the memory rather than a path. Mapped entries
+	// live as long as the pack, so FMOD can read (and stream) from them in place
+	const char* source = slot.Info.File.c_str();
+	if (FileHelpers::IsPacked(slot.Info.File)) {
+		slot.Buffer = std::make_unique<FileHelpers::FileBuffer>();
+		if (FileHelpers::ReadFileBuffer(slot.Info.File, *slot.Buffer)) {
+			mode |= slot.Buffer->IsMapped ? FMOD_OPENMEMORY_POINT : FMOD_OPENMEMORY;
+			exInfo.length = static_cast<unsigned int>(slot.Buffer->Size);
+			source = reinterpret_cast<const char*>(slot.Buffer->Data);
+		}
+	}
 
-	FMOD::Sound* loadedSound;
-	system->createSound(filename.c_str(), mode, nullptr, &loadedSound);
-	if (loadedSound != nullptr)
-		sounds[soundName] = loadedSound;
+	FMOD_RESULT result = system->createSound(source, mode, &exInfo, &slot.Sound);
+	if (result != FMOD_OK || slot.Sound == nullptr) {
+		_FailLoad(sound, result);
+		return;
+	}
+	slot.IsReady = false;
+	loadingSounds.push_back(sound);
 }
 
-FMOD::Channel* AudioManager::PlaySoundByName(const std::string& soundName, float vol, glm::vec3 pos)
+void AudioManager::_FailLoad(SoundId sound, FMOD_RESULT result)
 {
-	FMOD::Channel* newChannel;
-	system->playSound(sounds[soundName], nullptr, false, &newChannel);
-	newChannel->setVolume(vol);
-	newChannel->set3DAttributes(&GlmVectorToFmodVector(pos), 0);
+	SoundSlot& slot = slots[sound];
+	LOG_WARN("Failed to load sound \"{}\" from \"{}\": {}", slot.Name, slot.Info.File,
+		result != FMOD_OK ? FMOD_ErrorString(result) : "the sound is in an error state");
+	if (slot.Sound != nullptr) {
+		slot.Sound->release();
+		slot.Sound = nullptr;
+	}
+	slot.Buffer.reset();
+	slot.IsReady = false;
+	slot.HasFailed = true;
+}
 
-	return newChannel;
+bool AudioManager::IsSoundReady(const std::string& soundName) const
+{
+	auto foundElement = soundIds.find(soundName);
+	return foundElement != soundIds.end() && IsSoundReady(foundElement->second);
 }
 
-FMOD::Channel* AudioManager::PlaySoundWithVariation(const std::string& soundName, float baseVol, float basePitch, float volRange, float pitchRange, glm::vec3 pos)
+bool AudioManager::IsSoundReady(SoundId sound) const
 {
-	FMOD::Channel* newChannel;
-	system->playSound(sounds[soundName], nullptr, false, &newChannel);
+	return sound < slots.size() && slots[sound].IsReady;
+}
 
-	float rVolume = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / volRange));
-	newChannel->setVolume(baseVol + rVolume);
+int AudioManager::GetNumLoadingSounds() const
+{
+	return static_cast<int>(loadingSounds.size());
+}
 
-	float rPitch = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / pitchRange));
-	newChannel->setPitch(basePitch + rPitch);
+FMOD::Sound* AudioManager::_GetReadySound(SoundId sound)
+{
+	if (sound >= slots.size()) {
+		return nullptr;
+	}
+	SoundSlot& slot = slots[sound];
+	if (slot.IsReady) {
+		return slot.Sound;
+	}
+	// Sounds that haven't been loaded yet get started the first time they're needed
+	_StartLoad(sound);
+	return nullptr;
+}
 
-	newChannel->set3DAttributes(&GlmVectorToFmodVector(pos), 0);
-	return newChannel;
+SoundId AudioManager::_PickVariation(SoundId sound)
+{
+	const std::vector<SoundId>& variations = slots[sound].Variations;
+	if (variations.empty()) {
+		return sound;
+	}
+	size_t index = static_cast<size_t>(_Random() * variations.size());
+	return variations[glm::min(index, variations.size() - 1)];
 }
 
-void AudioManager::PlayFootstepSound(glm::vec3 pos, float vol)
+float AudioManager::_Random()
 {
-	system->playSound(sounds["Footstep"], nullptr, false, &footstepChannel);
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	// Use the top 24 bits, so the result fits exactly in a float's mantissa
+	return static_cast<float>(randomState >> 8) * (1.0f / 16777216.0f);
+}
 
-	float rVolume = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / 0.3f));
-	footstepChannel->setVolume(vol + rVolume);
+FMOD::Channel* AudioManager::Play(SoundId sound, float vol, glm::vec3 pos)
+{
+	if (sound >= slots.size()) {
+		return nullptr;
+	}
+
+	// Groups pick a sound, but the variation in volume and pitch comes from the group
+	const SoundInfo& info = slots[sound].Info;
+	SoundId picked = _PickVariation(sound);
+	FMOD::Sound* fmodSound = _GetReadySound(picked);
+	if (fmodSound == nullptr) {
+		return nullptr;
+	}
+
+	float rVolume = info.VolumeRange * _Random();
+	float rPitch = info.PitchRange * _Random();
+	return voices.Play(system, fmodSound, slots[picked].Info.MaxInstances, pos, vol + rVolume, info.Pitch + rPitch);
+}
 
-	float rPitch = static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / 0.4f));
-	footstepChannel->setPitch(rPitch + 0.7f);
+FMOD::Channel* AudioManager::Play(SoundRef& sound, float vol, glm::vec3 pos)
+{
+	return Play(GetSoundId(sound), vol, pos);
+}
 
-	footstepChannel->set3DAttributes(&GlmVectorToFmodVector(pos), 0);
+FMOD::Channel* AudioManager::PlaySoundByName(const std::string& soundName, float vol, glm::vec3 pos)
+{
+	return Play(GetSoundId(soundName), vol, pos);
+}
+
+FMOD::Channel* AudioManager::PlaySoundWithVariation(SoundId sound, float baseVol, float basePitch, float volRange, float pitchRange, glm::vec3 pos)
+{
+	if (sound >= slots.size()) {
+		return nullptr;
+	}
+
+	SoundId picked = _PickVariation(sound);
+	FMOD::Sound* fmodSound = _GetReadySound(picked);
+	if (fmodSound == nullptr) {
+		return nullptr;
+	}
+
+	float rVolume = volRange * _Random();
+	float rPitch = pitchRange * _Random();
+	return voices.Play(system, fmodSound, slots[picked].Info.MaxInstances, pos, baseVol + rVolume, basePitch + rPitch);
+}
+
+FMOD::Channel* AudioManager::PlaySoundWithVariation(const std::string& soundName, float baseVol, float basePitch, float volRange, float pitchRange, glm::vec3 pos)
+{
+	return PlaySoundWithVariation(GetSoundId(soundName), baseVol, basePitch, volRange, pitchRange, pos);
+}
+
+void AudioManager::PlayFootstepSound(glm::vec3 pos, float vol)
+{
+	// The random volume and pitch for footsteps is set in the bank
+	FMOD::Channel* channel = Play(footstepSound, vol, pos);
+	if (channel != nullptr) {
+		footstepChannel = channel;
+	}
+}
+
+bool AudioManager::SetChannelPosition(FMOD::Channel* channel, glm::vec3 pos, glm::vec3 velocity)
+{
+	return voices.SetPosition(channel, pos, velocity);
 }
 
 //void AudioManager::PauseSoundByName(const std::string& soundName)
 //{
 //	//system->playSound(sounds[soundName], nullptr, true, nullptr);
-//	
+//
 //}
 
 void AudioManager::UnloadSound(const std::string& soundName)
 {
+	auto foundElement = soundIds.find(soundName);
+	if (foundElement != soundIds.end())
+	{
+		UnloadSound(foundElement->second);
+	}
+}
+
+void AudioManager::UnloadSound(SoundId sound)
+{
+	if (sound >= slots.size()) {
+		return;
+	}
+
 	//Check if already loaded
-	auto foundElement = sounds.find(soundName);
-	if (foundElement != sounds.end())
+	SoundSlot& slot = slots[sound];
+	if (slot.Sound != nullptr)
 	{
-		foundElement->second->release();
-		sounds.erase(foundElement);
+		slot.Sound->release();
+		slot.Sound = nullptr;
+		slot.IsReady = false;
+		slot.Buffer.reset();
 	}
+	// Let a failed sound be tried again if it's loaded again on purpose
+	slot.HasFailed = false;
+	deferredSounds.erase(std::remove(deferredSounds.begin(), deferredSounds.end(), sound), deferredSounds.end());
 }
 
 const FMOD_VECTOR AudioManager::GlmVectorToFmodVector(glm::vec3 vec)
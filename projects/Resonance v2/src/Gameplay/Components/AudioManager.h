@@ -3,17 +3,112 @@
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 #include "fmod.hpp"
+#include "Utils/FileHelpers.h"
+#include "Gameplay/VoiceManager.h"
+#include "Gameplay/AudioOcclusion.h"
 #include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
 
 using namespace Gameplay;
 
+/// <summary>
+/// A compact handle to a sound (or variation group) in an AudioManager's bank. Handles only mean something to
+/// the manager that gave them out
+/// </summary>
+typedef uint32_t SoundId;
+static constexpr SoundId INVALID_SOUND = ~0u;
+
+/// <summary>
+/// A sound that is referenced by name (ex: from a component's JSON), the name is only looked up the first time
+/// the sound is played, after that it's played by handle. Stored as a plain string in JSON
+/// </summary>
+struct SoundRef {
+	std::string Name;
+	SoundId     Id = INVALID_SOUND;
+
+	SoundRef() = default;
+	SoundRef(const std::string& name) : Name(name), Id(INVALID_SOUND) { }
+
+	/// <summary>
+	/// Changes which sound this refers to, it will be looked up again the next time it's played
+	/// </summary>
+	void SetName(const std::string& name) {
+		Name = name;
+		Id = INVALID_SOUND;
+	}
+};
+
+inline void to_json(nlohmann::json& blob, const SoundRef& value) {
+	blob = value.Name;
+}
+inline void from_json(const nlohmann::json& blob, SoundRef& value) {
+	value.SetName(blob.get<std::string>());
+}
+
+/// <summary>
+/// Plays all of our sounds through FMOD. The sounds are declared in the "sounds" section of the scene's
+/// resource manifest, and are loaded in the background so that the scene doesn't wait on them to start
+///
+/// Every sound in the bank has a SoundId, and names that aren't in the bank give INVALID_SOUND. Gameplay code
+/// should resolve the sounds it uses up front (or use a SoundRef) and play them by handle, so that playing a
+/// sound is just an array lookup
+///
+/// 3D voices are occluded by every static collider in the scene (the merged level and anything that wasn't
+/// merged), which is checked on a worker thread a few times a second and eased in so that sounds don't snap
+/// between muffled and clear
+/// </summary>
 class AudioManager : public Gameplay::IComponent {
 public:
 	typedef std::shared_ptr<AudioManager> Sptr;
-	FMOD::System* system;
+	FMOD::System* system = nullptr;
+
+	/// <summary>
+	/// Describes how a sound in the bank should be loaded
+	/// </summary>
+	struct SoundInfo {
+		std::string File;
+		bool Is3D = false;
+		bool IsLooping = false;
+		// Streamed sounds are decoded from the file as they play, rather than being held in memory. Good for
+		// long tracks, but a stream can only be playing on one channel at a time
+		bool IsStreamed = false;
+		// What the sound is used for, sets the priority of it's voices if Priority is not set
+		SoundCategory Category = SoundCategory::Effect;
+		// The FMOD priority of the sound's voices, 0 is the most important and 256 is the least. -1 uses the
+		// category's priority
+		int Priority = -1;
+		// The most instances of the sound that can play at once, or 0 for no limit
+		int MaxInstances = 0;
+		// Preloaded sounds start loading when the manager wakes up, the rest once those are done or when
+		// they're first played
+		bool Preload = true;
+		// If this has any names, this is a variation group, and playing it plays one of these sounds at random
+		std::vector<std::string> Variations;
+		// The pitch to play at, plus a random amount up to PitchRange
+		float Pitch = 1.0f;
+		float PitchRange = 0.0f;
+		// A random amount of volume, up to this, is added to the volume the sound is played at
+		float VolumeRange = 0.0f;
+
+		/// <summary>
+		/// Gets the priority of the sound's voices, taking the category into account
+		/// </summary>
+		int GetPriority() const;
+
+		static SoundInfo FromJson(const nlohmann::json& blob);
+		nlohmann::json ToJson() const;
+	};
 
 	float volume = 1.0f;
 	std::string track = "L1_Ambiance";
+	// How many voices are actually mixed, and how many can be playing including virtual voices
+	int realVoices = 32;
+	int maxVoices = 256;
+	// Whether 3D voices are muffled by level geometry, and how many times a second it's checked (only read when
+	// occlusion is turned on)
+	bool useOcclusion = true;
+	float occlusionRate = 15.0f;
 	AudioManager() = default;
 	~AudioManager();
 	virtual void Update(float deltaTime) override;
@@ -23,18 +118,162 @@ public:
 	virtual nlohmann::json ToJson() const override;
 	static AudioManager::Sptr FromJson(const nlohmann::json& data);
 
+	/// <summary>
+	/// Uses the no-sound output for all audio managers created after this is called, so sounds can be
+	/// loaded and played without an audio device (ex: when running headless)
+	/// </summary>
+	static void SetNoSoundOutput(bool value) { _useNoSoundOutput = value; }
+
 	void LoadSound(const std::string& soundName, const std::string& filename, bool b3d, bool bLooping = false, bool bStream = false);
+	/// <summary>
+	/// Starts loading a sound in the background, does nothing if the sound is already loaded or loading
+	/// </summary>
+	/// <param name="soundName">The name to play the sound by</param>
+	/// <param name="info">Describes the file and how it should be loaded</param>
+	void LoadSound(const std::string& soundName, const SoundInfo& info);
 	void UnloadSound(const std::string& soundName);
+	void UnloadSound(SoundId sound);
+	/// <summary>
+	/// Gets the handle for a sound or variation group, this is the only place a name is looked up. The same
+	/// name will always give the same handle. Names that aren't in the bank (or loaded with LoadSound) give
+	/// INVALID_SOUND, which every function taking a handle ignores
+	/// </summary>
+	/// <param name="soundName">The name of the sound in the bank</param>
+	SoundId GetSoundId(const std::string& soundName);
+	/// <summary>
+	/// Resolves a sound reference to a handle, only looking up the name if it hasn't been resolved yet. A
+	/// name that isn't in the bank stays unresolved, so it's picked up if the sound is loaded later
+	/// </summary>
+	SoundId GetSoundId(SoundRef& sound);
+	/// <summary>
+	/// Checks if a sound has finished loading and can be played
+	/// </summary>
+	bool IsSoundReady(const std::string& soundName) const;
+	bool IsSoundReady(SoundId sound) const;
+	/// <summary>
+	/// Gets the number of sounds that are still being loaded
+	/// </summary>
+	int GetNumLoadingSounds() const;
+
+	// Note that the play functions return nullptr if the sound is not done loading yet, or if it is at
+	// it's instance limit
+
+	/// <summary>
+	/// Plays a sound, or a random sound from a variation group, with the pitch and volume variation from the bank
+	/// </summary>
+	/// <param name="sound">The handle from GetSoundId</param>
+	/// <param name="vol">The volume to play at, before the bank's random volume is added</param>
+	/// <param name="pos">The world position of the sound, ignored for 2D sounds</param>
+	FMOD::Channel* Play(SoundId sound, float vol = 1.0f, glm::vec3 pos = glm::vec3(0.0f));
+	FMOD::Channel* Play(SoundRef& sound, float vol = 1.0f, glm::vec3 pos = glm::vec3(0.0f));
 	FMOD::Channel* PlaySoundByName(const std::string& soundName, float vol = 1.0f, glm::vec3 pos = glm::vec3(0.0f));
+	/// <summary>
+	/// Plays a sound with the given random variation, instead of the variation from the bank
+	/// </summary>
+	FMOD::Channel* PlaySoundWithVariation(SoundId sound, float baseVol = 1.0f, float basePitch = 1.0f, float volRange = 1.0f, float pitchRange = 1.0f, glm::vec3 pos = glm::vec3(0.0f));
 	FMOD::Channel* PlaySoundWithVariation(const std::string& soundName, float baseVol = 1.0f, float basePitch = 1.0f, float volRange = 1.0f, float pitchRange = 1.0f, glm::vec3 pos = glm::vec3(0.0f));
 	//void PauseSoundByName(const std::string& soundName);
 	void PlayFootstepSound(glm::vec3 pos, float vol);
+	/// <summary>
+	/// Moves a channel that was returned by one of the play functions. The position is only sent to FMOD
+	/// if it has moved far enough, so this is cheap to call every frame
+	/// </summary>
+	/// <returns>True if the channel is still playing, false if otherwise</returns>
+	bool SetChannelPosition(FMOD::Channel* channel, glm::vec3 pos, glm::vec3 velocity = glm::vec3(0.0f));
 
 
 	const FMOD_VECTOR GlmVectorToFmodVector(glm::vec3 vec);
 	MAKE_TYPENAME(AudioManager);
 
 protected:
-	FMOD::Channel* footstepChannel;
-	std::unordered_map<std::string, FMOD::Sound*> sounds;
+	// A sound in the bank, indexed by it's SoundId. Slots are only made when a sound is declared by the bank or LoadSound
+	struct SoundSlot {
+		std::string  Name;
+		SoundInfo    Info;
+		// The handles of the sounds in a variation group
+		std::vector<SoundId> Variations;
+
+		// Set once the sound has been handed to FMOD, it may still be loading
+		FMOD::Sound* Sound = nullptr;
+		bool         IsReady = false;
+		// Set if FMOD couldn't open the sound, it's reported once and never tried again
+		bool         HasFailed = false;
+		// FMOD reads sounds from packed assets out of this buffer, it needs to stay alive until the sound is ready
+		std::unique_ptr<FileHelpers::FileBuffer> Buffer;
+	};
+
+	static bool _useNoSoundOutput;
+
+	FMOD::Channel* footstepChannel = nullptr;
+	SoundId footstepSound = INVALID_SOUND;
+	Gameplay::VoiceManager voices;
+	Gameplay::AudioOcclusion occlusion;
+	std::vector<Gameplay::AudioOcclusion::Source> occlusionSources;
+	std::vector<Gameplay::AudioOcclusion::Result> occlusionResults;
+	// The hash of the static bodies that the occlusion geometry was copied from
+	uint64_t occlusionBodiesHash = 0;
+	bool hasOcclusionGeometry = false;
+	// The rate that was last handed to the occlusion worker
+	float appliedOcclusionRate = 0.0f;
+	std::vector<SoundSlot> slots;
+	std::unordered_map<std::string, SoundId> soundIds;
+	// Names that were asked for but aren't in the bank, so each one is only warned about once
+	std::unordered_set<std::string> missingSounds;
+	// The sounds that FMOD is still loading
+	std::vector<SoundId> loadingSounds;
+	// The sounds that weren't preloaded, and will be loaded once the preloaded sounds are ready
+	std::vector<SoundId> deferredSounds;
+	bool isTrackStarted = false;
+	// State for our random number generator (xorshift), used for the pitch and volume variations
+	uint32_t randomState = 0x9E3779B9u;
+
+	/// <summary>
+	/// Gets the bank that is used when the scene's manifest doesn't have a sounds section
+	/// </summary>
+	static nlohmann::json _GetDefaultBank();
+
+	/// <summary>
+	/// Checks on all the sounds that are loading, and handles the ones that have finished
+	/// </summary>
+	void _PollLoads();
+	/// <summary>
+	/// Hands the voices over to the occlusion worker, and passes it's latest results on to the voices
+	/// </summary>
+	/// <param name="listener">Where the listener is</param>
+	void _UpdateOcclusion(const glm::vec3& listener);
+	/// <summary>
+	/// Starts playing the scene's track, once it has loaded
+	/// </summary>
+	void _PlayTrack();
+	/// <summary>
+	/// Adds a slot for a sound that hasn't been declared yet
+	/// </summary>
+	/// <returns>The handle of the new slot</returns>
+	SoundId _DeclareSound(const std::string& soundName, const SoundInfo& info);
+	/// <summary>
+	/// Looks up the handles of a declared sound's variations, skipping any that aren't in the bank
+	/// </summary>
+	void _ResolveVariations(SoundId sound);
+	/// <summary>
+	/// Hands a declared sound to FMOD to be loaded in the background, does nothing if it has already been
+	/// or if it failed to load before
+	/// </summary>
+	void _StartLoad(SoundId sound);
+	/// <summary>
+	/// Marks a sound as failed and logs why, so it isn't loaded again every time it's played
+	/// </summary>
+	void _FailLoad(SoundId sound, FMOD_RESULT result);
+	/// <summary>
+	/// Gets a sound that is ready to play, starting to load it if it isn't loaded yet
+	/// </summary>
+	/// <returns>The sound, or nullptr if it is not ready yet</returns>
+	FMOD::Sound* _GetReadySound(SoundId sound);
+	/// <summary>
+	/// Picks the sound to play for a handle, choosing from the variations if it's a group
+	/// </summary>
+	SoundId _PickVariation(SoundId sound);
+	/// <summary>
+	/// Gets a random number in [0, 1)
+	/// </summary>
+	float _Random();
 };
\ No newline at end of file
@@ -18,6 +18,30 @@ Enemy::Enemy()
 {
 	//Patrol State by default
 	currentState = &PatrollingState::getInstance();
+
+	for (int i = 0; i < AVOIDANCE_RAYS; i++)
+	{
+		avoidanceRays[i] = Physics::RayBatch::INVALID_RAY;
+		avoidanceDirs[i] = glm::vec3(0.0f);
+		avoidanceHits[i] = false;
+		avoidanceHitEmmiters[i] = false;
+		avoidanceHitDirs[i] = glm::vec3(0.0f);
+		avoidanceHitNormals[i] = glm::vec3(0.0f);
+	}
+}
+Enemy::~Enemy()
+{
+	//Give our listening light back to the pool, so it doesn't stick around after we're gone
+	if (scene != nullptr)
+		scene->GetLightManager().Release(soundLight);
+
+	//Leave the crowd, otherwise the other enemies keep steering around where we died
+	if (pathfindingManager::Sptr manager = crowdOwner.lock())
+		manager->getCrowd().RemoveAgent(crowdAgent);
+
+	//Stop taking up ticks and line of sight checks in the scheduler
+	if (scene != nullptr)
+		scene->aiScheduler.Unregister(aiAgent);
 }
 void Enemy::Awake()
 {
@@ -29,16 +53,23 @@ void Enemy::Awake()
 	//body->SetLinearDamping(0.2f);
 	GetGameObject()->SetPostion(startPos);
 
-	scene->Lights.push_back(Light());
-	soundLight = scene->Lights.size() - 1;
-	scene->Lights[soundLight].isGenerated = true;
-
-	scene->Lights[soundLight].Range = -listeningRadius * 8.0f;;
-	scene->Lights[soundLight].Color = blue;
+	soundLight = scene->GetLightManager().Allocate();
+	Light& light = scene->GetLightManager().Get(soundLight);
+	light.Range = -listeningRadius * 8.0f;
+	light.Color = blue;
 
 	player = scene->MainCamera->GetGameObject();
 	pathManager = scene->pathManager;
 
+	if (pathManager != nullptr)
+	{
+		Navigation::Crowd::AgentSettings agent;
+		agent.Radius = agentRadius;
+		pathfindingManager::Sptr manager = pathManager->Get<pathfindingManager>();
+		crowdOwner = manager;
+		crowdAgent = manager->getCrowd().AddAgent(agent, startPos);
+	}
+	aiAgent = scene->aiScheduler.Register(startPos);
 }
 
 void Enemy::Update(float deltaTime)
@@ -49,15 +80,34 @@ void Enemy::Update(float deltaTime)
 		started = true;
 	}
 
+	//Ray results only last until the next batch, so grab them every frame even if we don't tick
+	CollectAvoidanceResults();
+
+	//Far away enemies don't run their full update every frame, they keep moving with the velocity from their last tick in between
+	scene->aiScheduler.SetAgentState(aiAgent, GetGameObject()->GetPosition(), currentState == &AggravatedState::getInstance());
+	float tickDelta;
+	if (!scene->aiScheduler.ShouldTick(aiAgent, tickDelta))
+	{
+		MoveListeningLight();
+		if (crowdAgent != Navigation::Crowd::NO_AGENT)
+			pathManager->Get<pathfindingManager>()->getCrowd().SetAgentState(crowdAgent, GetGameObject()->GetPosition(), body->GetLinearVelocity());
+
+		GetGameObject()->SetPostion(glm::vec3(GetGameObject()->GetPosition().x, GetGameObject()->GetPosition().y, startPos.z));
+		return;
+	}
+	deltaTime = tickDelta;
+
 	if (myChannel != NULL)
 	{
-		AudioManager::Sptr aMan = scene->audioManager->Get<AudioManager>();
-		myChannel->set3DAttributes(&aMan->GlmVectorToFmodVector(GetGameObject()->GetPosition()), &aMan->GlmVectorToFmodVector(body->GetLinearVelocity()));
+		// The voice manager only passes this on to FMOD when we've moved far enough to be heard
+		//If the voice is gone (stolen or finished), don't hold on to the old handle, FMOD re-uses them
+		if (!scene->audioManager->Get<AudioManager>()->SetChannelPosition(myChannel, GetGameObject()->GetPosition(), body->GetLinearVelocity()))
+			myChannel = nullptr;
 	}
 	MoveListeningLight();
 	currentState->Listen(this, deltaTime);
 	currentState->Pathfind(this, deltaTime);
-	currentState->Move(this, deltaTime); //In Agro state, make it so the enemy doesn't slow down when its near target
+	currentState->Move(this, glm::min(deltaTime, maxMoveDelta)); //In Agro state, make it so the enemy doesn't slow down when its near target
 
 
 	if (lastHeardSounds.size() > 2)
@@ -112,6 +162,9 @@ nlohmann::json Enemy::ToJson() const {
 	}
 	result["PatrolPointCount"] = glm::vec3(patrolPoints.size());
 	result["StartingPosition"] = startPos;
+	result["PatrolSound"] = patrolSound;
+	result["DistractedSound"] = distractedSound;
+	result["AgroSound"] = agroSound;
 	return result;
 }
 
@@ -122,6 +175,9 @@ Enemy::Sptr Enemy::FromJson(const nlohmann::json& blob) {
 		result->patrolPoints.push_back(JsonGet(blob, "PatrolPoint" + std::to_string(i), glm::vec3(0.0f)));
 	}
 	result->startPos = JsonGet(blob, "StartingPosition", result->startPos);
+	result->patrolSound = JsonGet(blob, "PatrolSound", result->patrolSound);
+	result->distractedSound = JsonGet(blob, "DistractedSound", result->distractedSound);
+	result->agroSound = JsonGet(blob, "AgroSound", result->agroSound);
 
 	return result;
 }
@@ -129,32 +185,54 @@ Enemy::Sptr Enemy::FromJson(const nlohmann::json& blob) {
 
 void Enemy::MoveListeningLight()
 {
-	scene->Lights[soundLight].Position = GetGameObject()->GetPosition();
-	scene->Lights[soundLight].Range = listeningRadius * listeningRadius * -1.20f;
+	Light& light = scene->GetLightManager().Get(soundLight);
+	light.Position = GetGameObject()->GetPosition();
+	light.Range = listeningRadius * listeningRadius * -1.20f;
 }
 
 void Enemy::SetState(EnemyState& newState)
 {
+	// The old state's path is no use to the new one
+	pathManager->Get<pathfindingManager>()->cancelPath(pathTicket);
+	pathTicket = Navigation::PathService::INVALID_TICKET;
+	pathSet.clear();
+	nIndex = 0;
+
 	currentState->End(this);
 	currentState = &newState;
 	currentState->Start(this);
 }
 
+void Enemy::RequestPath(const glm::vec3& goal)
+{
+	pathfindingManager::Sptr manager = pathManager->Get<pathfindingManager>();
+	manager->cancelPath(pathTicket);
+	pathTicket = manager->requestPathAsync(GetGameObject()->GetPosition(), goal);
+}
 
-void Enemy::Move(float deltaTime)
+bool Enemy::PollPath(Navigation::PathStatus& outStatus)
 {
-	Steering(deltaTime);
+	if (pathTicket == Navigation::PathService::INVALID_TICKET)
+		return false;
 
-	AvoidanceReflect(body->GetLinearVelocity(), deltaTime);
+	std::vector<glm::vec3> newPath;
+	if (!pathManager->Get<pathfindingManager>()->pollPath(pathTicket, outStatus, newPath))
+		return false;
 
-	glm::vec3 vel = body->GetLinearVelocity();
-	glm::vec3 leftDir = glm::vec3(-vel.y + vel.x, vel.x + vel.y, 0.0f) / 2.0f;
-	glm::vec3 rightDir = glm::vec3(vel.y + vel.x, -vel.x + vel.y, 0.0f) / 2.0f;
+	pathTicket = Navigation::PathService::INVALID_TICKET;
+	if (outStatus == Navigation::PathStatus::Success)
+	{
+		pathSet.swap(newPath);
+		nIndex = pathSet.size() - 1;
+	}
+	return true;
+}
 
-	Avoidance(leftDir, deltaTime);
-	Avoidance(rightDir, deltaTime);
-	Avoidance(glm::vec3(-body->GetLinearVelocity().y, body->GetLinearVelocity().x, 0.0f), deltaTime);
-	Avoidance(glm::vec3(body->GetLinearVelocity().y, -body->GetLinearVelocity().x, 0.0f), deltaTime);
+void Enemy::Move(float deltaTime)
+{
+	Steering(deltaTime);
+
+	Avoid(deltaTime);
 
 	GetGameObject()->LookAt(GetGameObject()->GetPosition() + body->GetLinearVelocity() * -1.0f);
 }
@@ -163,16 +241,7 @@ void Enemy::MoveChase(float deltaTime)
 {
 	Chase(deltaTime);
 
-	AvoidanceReflect(body->GetLinearVelocity(), deltaTime);
-
-	glm::vec3 vel = body->GetLinearVelocity();
-	glm::vec3 leftDir = glm::vec3(-vel.y + vel.x, vel.x + vel.y, 0.0f) / 2.0f;
-	glm::vec3 rightDir = glm::vec3(vel.y + vel.x, -vel.x + vel.y, 0.0f) / 2.0f;
-
-	Avoidance(leftDir, deltaTime);
-	Avoidance(rightDir, deltaTime);
-	Avoidance(glm::vec3(-body->GetLinearVelocity().y, body->GetLinearVelocity().x, 0.0f), deltaTime);
-	Avoidance(glm::vec3(body->GetLinearVelocity().y, -body->GetLinearVelocity().x, 0.0f), deltaTime);
+	Avoid(deltaTime);
 
 	GetGameObject()->LookAt(GetGameObject()->GetPosition() + body->GetLinearVelocity() * -1.0f);
 }
@@ -218,58 +287,109 @@ void Enemy::Chase(float deltaTime)
 	body->SetLinearVelocity(glm::vec3(newVel.x, newVel.y, 0.0f));
 }
 
-void Enemy::AvoidanceReflect(glm::vec3 dir, float deltaTime)
+void Enemy::Avoid(float deltaTime)
 {
-	//Check if greater than zero before normalizing since that would divide by 0
-	if (Magnitude(dir) <= 0.0f)
-		return;
+	if (crowdAgent != Navigation::Crowd::NO_AGENT)
+	{
+		//Pick the velocity closest to where we're steering that won't run into other enemies or walls
+		Navigation::Crowd& crowd = pathManager->Get<pathfindingManager>()->getCrowd();
+		glm::vec3 safeVel = crowd.ComputeVelocity(crowdAgent, body->GetLinearVelocity(), maxVelocity, deltaTime);
+		body->SetLinearVelocity(glm::vec3(safeVel.x, safeVel.y, 0.0f));
+		crowd.SetAgentState(crowdAgent, GetGameObject()->GetPosition(), safeVel);
+
+		//The navmesh walls are already avoided, the rays are only needed without it
+		if (crowd.HasObstacles())
+			return;
+	}
 
-	dir = glm::normalize(dir);
+	AvoidanceReflect(0, body->GetLinearVelocity(), deltaTime);
 
-	//Perform Raycast
-	const glm::vec3 startPoint = GetGameObject()->GetPosition();
-	const glm::vec3 endPoint = GetGameObject()->GetPosition() + (dir * avoidanceRange);
-	btCollisionWorld::ClosestRayResultCallback hit(ToBt(startPoint), ToBt(endPoint));
-	scene->GetPhysicsWorld()->rayTest(ToBt(startPoint), ToBt(endPoint), hit);
+	glm::vec3 vel = body->GetLinearVelocity();
+	glm::vec3 leftDir = glm::vec3(-vel.y + vel.x, vel.x + vel.y, 0.0f) / 2.0f;
+	glm::vec3 rightDir = glm::vec3(vel.y + vel.x, -vel.x + vel.y, 0.0f) / 2.0f;
 
-	if (!hit.hasHit())
-		return;
+	Avoidance(1, leftDir, deltaTime);
+	Avoidance(2, rightDir, deltaTime);
+	Avoidance(3, glm::vec3(-body->GetLinearVelocity().y, body->GetLinearVelocity().x, 0.0f), deltaTime);
+	Avoidance(4, glm::vec3(body->GetLinearVelocity().y, -body->GetLinearVelocity().x, 0.0f), deltaTime);
+}
 
-	//Make sure enemy doesn't avoid player or sound emmiters
-	glm::vec3 objectPos = ToGlm(hit.m_collisionObject->getWorldTransform().getOrigin());
+void Enemy::CollectAvoidanceResults()
+{
+	Physics::RayBatch& rays = scene->GetRayBatch();
+	const Physics::RayBatch::Results& results = rays.GetResults();
+	for (int slot = 0; slot < AVOIDANCE_RAYS; slot++)
+	{
+		uint32_t hit = rays.GetResultIndex(avoidanceRays[slot]);
+		if (hit == Physics::RayBatch::NO_RESULT)
+			continue;
+
+		avoidanceRays[slot] = Physics::RayBatch::INVALID_RAY;
+		avoidanceHits[slot] = results.HasHit[hit];
+		avoidanceHitDirs[slot] = avoidanceDirs[slot];
+		avoidanceHitNormals[slot] = results.Normal[hit];
+
+		//Make sure enemy doesn't avoid player or sound emmiters, the object is gone if it was deleted since the ray was cast
+		avoidanceHitEmmiters[slot] = false;
+		const btCollisionObject* object = results.Object[hit];
+		if (avoidanceHits[slot] && object != nullptr)
+		{
+			//Merged level geometry is one big mesh at the origin, so look up the body the hit part came from
+			Physics::RigidBody::Sptr part = scene->GetStaticWorld().GetPartBody(object, results.Part[hit]);
+			glm::vec3 objectPos = part != nullptr ? part->GetGameObject()->GetPosition() : ToGlm(object->getWorldTransform().getOrigin());
+
+			for (int i = 0; i < scene->soundEmmiters.size(); i++)
+			{
+				if (objectPos == scene->soundEmmiters[i]->GetPosition())
+					avoidanceHitEmmiters[slot] = true;
+			}
+		}
+	}
+}
 
-	for (int i = 0; i < scene->soundEmmiters.size(); i++)
+void Enemy::SubmitAvoidanceRay(int slot, glm::vec3 dir)
+{
+	//Check if greater than zero before normalizing since that would divide by 0
+	if (Magnitude(dir) <= 0.0f)
 	{
-		if (objectPos == scene->soundEmmiters[i]->GetPosition())
-			return;
+		//Nothing to look out for if we're not going that way
+		avoidanceRays[slot] = Physics::RayBatch::INVALID_RAY;
+		avoidanceHits[slot] = false;
+		return;
 	}
 
-	//Add avoidance force
-	glm::vec3 newDir = glm::reflect(dir, ToGlm(hit.m_hitNormalWorld));
-	newDir = (newDir * avoidanceRange) - GetGameObject()->GetPosition();
+	avoidanceDirs[slot] = glm::normalize(dir);
 
-	body->ApplyForce(glm::normalize(newDir) * avoidanceStrength * deltaTime);
+	const glm::vec3 startPoint = GetGameObject()->GetPosition();
+	const glm::vec3 endPoint = GetGameObject()->GetPosition() + (avoidanceDirs[slot] * avoidanceRange);
+	avoidanceRays[slot] = scene->GetRayBatch().Submit(startPoint, endPoint);
 }
 
-void Enemy::Avoidance(glm::vec3 dir, float deltaTime)
+void Enemy::AvoidanceReflect(int slot, glm::vec3 dir, float deltaTime)
 {
-	if (Magnitude(dir) <= 0.0f)
+	//Rays are cast after the physics step, so we react to the last one that came back
+	SubmitAvoidanceRay(slot, dir);
+
+	if (!avoidanceHits[slot] || avoidanceHitEmmiters[slot])
 		return;
 
-	dir = glm::normalize(dir);
+	//Add avoidance force
+	glm::vec3 newDir = glm::reflect(avoidanceHitDirs[slot], avoidanceHitNormals[slot]);
+	newDir = (newDir * avoidanceRange) - GetGameObject()->GetPosition();
 
-	//Perform Raycast
-	const glm::vec3 startPoint = GetGameObject()->GetPosition();
-	const glm::vec3 endPoint = GetGameObject()->GetPosition() + (dir * avoidanceRange);
+	body->ApplyForce(glm::normalize(newDir) * avoidanceStrength * deltaTime);
+}
 
-	btCollisionWorld::ClosestRayResultCallback hit(ToBt(startPoint), ToBt(endPoint));
-	scene->GetPhysicsWorld()->rayTest(ToBt(startPoint), ToBt(endPoint), hit);
+void Enemy::Avoidance(int slot, glm::vec3 dir, float deltaTime)
+{
+	//Rays are cast after the physics step, so we react to the last one that came back
+	SubmitAvoidanceRay(slot, dir);
 
-	if (!hit.hasHit())
+	if (!avoidanceHits[slot])
 		return;
 
 	//Add avoidance force
-	glm::vec3 newDir = glm::normalize(body->GetLinearVelocity()) - dir;
+	glm::vec3 newDir = glm::normalize(body->GetLinearVelocity()) - avoidanceHitDirs[slot];
 	newDir = glm::vec3(newDir.x, newDir.y, 0.0f);
 
 	body->ApplyForce(glm::normalize(newDir) * avoidanceStrength * deltaTime);
@@ -19,14 +19,14 @@ public:
 
 	typedef std::shared_ptr<Enemy> Sptr;
 	Enemy();
-	//~Enemy();
+	~Enemy();
 
 #pragma region "Properties & Variables"
 
 	std::vector<GameObject*> lastHeardSounds;
 	std::vector<glm::vec3> lastHeardPositions;
 	GameObject* player;
-	Scene* scene;
+	Scene* scene = nullptr;
 	GLFWwindow* window;
 	Gameplay::Physics::RigidBody::Sptr body;
 	glm::quat currentRot;
@@ -44,10 +44,30 @@ public:
 	glm::vec3 targetRotation;
 	float avoidanceRange = 2.5f; //2.5 is good
 	float avoidanceStrength = 1000.0f; //1000 is good, 750 seemed to increase odds of enemies getting stuck
+	//Avoidance rays go through the scene's ray batch, so each slot holds the ray we sent out and the direction it went
+	static const int AVOIDANCE_RAYS = 5;
+	Physics::RayHandle avoidanceRays[AVOIDANCE_RAYS];
+	glm::vec3 avoidanceDirs[AVOIDANCE_RAYS];
+	//The last result each slot's ray gave back, kept until the next one comes in since we don't tick every frame when far away
+	bool avoidanceHits[AVOIDANCE_RAYS];
+	bool avoidanceHitEmmiters[AVOIDANCE_RAYS];
+	glm::vec3 avoidanceHitDirs[AVOIDANCE_RAYS];
+	glm::vec3 avoidanceHitNormals[AVOIDANCE_RAYS];
+	//Reduced rate ticks hand us all the time since our last one, movement only uses this much of it so we don't get huge velocity kicks
+	float maxMoveDelta = 1.0f / 15.0f;
+	//Our agent in the path manager's crowd, used to steer around other enemies and the walls of the navmesh
+	uint32_t crowdAgent = Navigation::Crowd::NO_AGENT;
+	//The manager that owns our crowd agent, weak since it may be destroyed before us when the scene is torn down
+	std::weak_ptr<pathfindingManager> crowdOwner;
+	float agentRadius = 1.5f;
+	//Our agent in the scene's AI scheduler, which decides how often we run our full update
+	uint32_t aiAgent = AIScheduler::NO_AGENT;
 
 	//Listening Light
 	float listeningRadius = 3.0f;
-	int soundLight;
+	uint32_t soundLight = LightManager::NO_LIGHT;
+	//The sound emmiters within our listening radius this frame, filled in by the scene's SoundPerception
+	std::vector<GameObject*> audibleSounds;
 
 	//Pathfinding
 	bool pathRequested = false;
@@ -57,6 +77,8 @@ public:
 	int pIndex = 0;
 	std::vector<glm::vec3> pathSet;
 	int nIndex = 0;
+	//The path request we are waiting on, we keep following pathSet until it's ready
+	Navigation::PathTicket pathTicket = Navigation::PathService::INVALID_TICKET;
 
 	//State Machine Stuff
 	glm::vec3 red = glm::vec3(0.2f, 0, 0);
@@ -75,7 +97,11 @@ public:
 
 	EnemyState* currentState;
 
-	FMOD::Channel* myChannel;
+	FMOD::Channel* myChannel = nullptr;
+	//The sounds we make in each state, resolved to handles the first time they're played
+	SoundRef patrolSound = SoundRef("LeaflingPatrol");
+	SoundRef distractedSound = SoundRef("LeaflingDistracted");
+	SoundRef agroSound = SoundRef("LeaflingAgro");
 
 #pragma endregion "Properties & Variables"
 
@@ -88,10 +114,24 @@ public:
 	void MoveChase(float deltaTime);
 	void Steering(float deltaTime);
 	void Chase(float deltaTime);
-	void AvoidanceReflect(glm::vec3 dir, float deltaTime);
-	void Avoidance(glm::vec3 dir, float deltaTime);
+	void Avoid(float deltaTime);
+	void CollectAvoidanceResults();
+	void SubmitAvoidanceRay(int slot, glm::vec3 dir);
+	void AvoidanceReflect(int slot, glm::vec3 dir, float deltaTime);
+	void Avoidance(int slot, glm::vec3 dir, float deltaTime);
 	void IsPlayerDead();
 
+	/// <summary>
+	/// Queues up a path to the goal, replacing any request that is still pending
+	/// </summary>
+	void RequestPath(const glm::vec3& goal);
+	/// <summary>
+	/// Checks on our pending path request, and swaps the new path into pathSet once it's ready
+	/// </summary>
+	/// <param name="outStatus">Will store if the search succeeded, or why it failed</param>
+	/// <returns>True if a request finished this call, false if there is nothing new</returns>
+	bool PollPath(Navigation::PathStatus& outStatus);
+
 	//General Functions
 	glm::vec3 speed = glm::vec3(0.0f);
 	bool started = false;
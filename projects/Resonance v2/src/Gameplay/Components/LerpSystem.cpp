@@ -85,6 +85,7 @@ void LerpSystem::Update(float deltaTime) {
 		auto _body = GetComponent<Gameplay::Physics::RigidBody>();
 		if(_body != nullptr)
 			_body->SetType(RigidBodyType::Kinematic);
+		_ExpandSweep(_body);
 
 		if (lerpReverse) {
 			t -= deltaTime;
@@ -94,8 +95,7 @@ void LerpSystem::Update(float deltaTime) {
 				beginLerp = false;
 				if (_body != nullptr)
 					_body->SetType(RigidBodyType::Static);
-				if(doUpdateNbors)
-					GetGameObject()->GetScene()->pathManager->Get<pathfindingManager>()->UpdateNbors();
+				_EndSweep(_body);
 				}
 				//t = 0;
 			
@@ -108,8 +108,7 @@ void LerpSystem::Update(float deltaTime) {
 				beginLerp = false;
 				if (_body != nullptr)
 					_body->SetType(RigidBodyType::Static);
-				if(doUpdateNbors)
-					GetGameObject()->GetScene()->pathManager->Get<pathfindingManager>()->UpdateNbors();
+				_EndSweep(_body);
 				}
 				//t = 0;
 			 
@@ -147,6 +146,33 @@ void LerpSystem::Update(float deltaTime) {
 	}
 }
 
+void LerpSystem::_ExpandSweep(const Gameplay::Physics::RigidBody::Sptr& body) {
+	glm::vec3 min, max;
+	if (body == nullptr || !body->GetWorldAabb(min, max))
+		return;
+
+	if (_isSweeping) {
+		_sweepMin = glm::min(_sweepMin, min);
+		_sweepMax = glm::max(_sweepMax, max);
+	} else {
+		_sweepMin = min;
+		_sweepMax = max;
+		_isSweeping = true;
+	}
+}
+
+void LerpSystem::_EndSweep(const Gameplay::Physics::RigidBody::Sptr& body) {
+	// Our rotation for this frame hasn't been applied yet, so the final pose is covered by
+	// growing the sweep towards where we are heading to
+	_ExpandSweep(body);
+	if (_isSweeping && doUpdateNbors) {
+		GameObject* pathManager = GetGameObject()->GetScene()->pathManager;
+		if (pathManager != nullptr)
+			pathManager->Get<pathfindingManager>()->InvalidateRegion(_sweepMin, _sweepMax);
+	}
+	_isSweeping = false;
+}
+
 glm::vec3 LerpSystem::lerpstuff(glm::vec3 a, glm::vec3 b, float t) {
 	return a * (1 - t) + (b * t);
 }
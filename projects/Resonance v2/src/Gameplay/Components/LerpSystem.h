@@ -54,6 +54,12 @@ public:
 	void setRotationEnd(glm::vec3 xyz);
 
 protected:
+	// The world space bounds covered by the body since the lerp started, so the nav graph can re-test
+	// only the edges that the body moved through
+	bool      _isSweeping = false;
+	glm::vec3 _sweepMin = glm::vec3(0.0f);
+	glm::vec3 _sweepMax = glm::vec3(0.0f);
 
-	
+	void _ExpandSweep(const Gameplay::Physics::RigidBody::Sptr& body);
+	void _EndSweep(const Gameplay::Physics::RigidBody::Sptr& body);
 };
\ No newline at end of file
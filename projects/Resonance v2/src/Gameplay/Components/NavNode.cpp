@@ -8,21 +8,6 @@ void NavNode::Awake() {
 	GetGameObject()->GetScene()->navNodes.push_back(GetGameObject());
 }
 
-void NavNode::Reset() {
-	NodeType = type::blank;
-	hCost = 0;
-	gCost = 0;
-	fCost = 0;
-	parent = NULL;
-}
-
-void NavNode::ClearCosts() {
-	hCost = 0;
-	gCost = 0;
-	fCost = 0;
-	parent = NULL;
-}
-
 void NavNode::RenderImGui() {
 	LABEL_LEFT(ImGui::DragFloat3, "Speed", &speed.x);
 }
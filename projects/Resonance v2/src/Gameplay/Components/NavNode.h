@@ -14,30 +14,9 @@ public:
 
 	NavNode() = default;
 
-	~NavNode()
-	{
-		neighbors.clear();
-		parent = NULL;
-	}
+	~NavNode() = default;
 
 	//Properties
-	std::vector <GameObject*> neighbors;
-	GameObject* parent = NULL; //Check if parent index > 0 to see if a node actually has a parent or not
-	float hCost = 0, gCost = 0, fCost = 0;
-	enum type
-	{
-		blank,
-		open,
-		closed,
-		start,
-		end,
-		path
-	};
-
-	type NodeType = blank;
-	void Reset();
-	void ClearCosts();
-
 	glm::vec3 speed = glm::vec3(0.0f);
 
 	virtual void Awake() override;
@@ -3,6 +3,7 @@
 #include "Application/Timing.h"
 #include "Application/Application.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 
 ParticleSystem::ParticleSystem() :
 	IComponent(),
@@ -243,7 +244,7 @@ void ParticleSystem::RenderImGui()
 void ParticleSystem::Awake()
 {
 	// There are the things we want the feedback buffers to track
-	const char const* varyings[6] = {
+	static const std::vector<std::string> varyings = {
 		"out_Type",  
 		"out_Position",
 		"out_Velocity",
@@ -252,18 +253,18 @@ void ParticleSystem::Awake()
 		"out_Metadata" 
 	}; 
 
-	// This is our transform feedback shader
-	_updateShader = ShaderProgram::Create();
-	_updateShader->LoadShaderPartFromFile("shaders/vertex_shaders/particles_sim_vs.glsl", ShaderPartType::Vertex);
- 	_updateShader->LoadShaderPartFromFile("shaders/geometry_shaders/particle_sim_gs.glsl", ShaderPartType::Geometry);
-	_updateShader->RegisterVaryings(varyings, 6, true); // Here we call glTransformFeedbackVaryings, and let it know we want interleaved data
-	_updateShader->Link(); 
+	// This is our transform feedback shader, shared between all particle systems
+	// The varyings are passed to glTransformFeedbackVaryings, with interleaved data
+	_updateShader = ResourceManager::GetShader({
+		{ ShaderPartType::Vertex, "shaders/vertex_shaders/particles_sim_vs.glsl" },
+		{ ShaderPartType::Geometry, "shaders/geometry_shaders/particle_sim_gs.glsl" }
+	}, {}, varyings);
 
 	// This shader will render the particles
-	_renderShader = ShaderProgram::Create();
-	_renderShader->LoadShaderPartFromFile("shaders/vertex_shaders/particles_render_vs.glsl", ShaderPartType::Vertex);
-	_renderShader->LoadShaderPartFromFile("shaders/fragment_shaders/particles_render_fs.glsl", ShaderPartType::Fragment);
-	_renderShader->Link(); 
+	_renderShader = ResourceManager::GetShader({
+		{ ShaderPartType::Vertex, "shaders/vertex_shaders/particles_render_vs.glsl" },
+		{ ShaderPartType::Fragment, "shaders/fragment_shaders/particles_render_fs.glsl" }
+	});
 }
 
 nlohmann::json ParticleSystem::ToJson() const {
@@ -67,7 +67,7 @@ void SimpleCameraControl::Awake() {
 			emmiter->linearLerp = true;
 			emmiter->defaultColour = glm::vec3(0.1f, 0.0f, 0.45f);
 			emmiter->soundLightOffset = glm::vec3(0, 0, -3.0f);
-			emmiter->soundName = "";
+			emmiter->sound.SetName("");
 			playerEmmiters.push_back(emmiter);
 		}
 	}
@@ -270,7 +270,8 @@ void SimpleCameraControl::OxygenSystem(float deltaTime)
 			oxygenMeter = oxygenMeterMax;
 			if (startedRefill)
 			{
-				oxygenChannel->stop();
+				if (oxygenChannel != nullptr)
+					oxygenChannel->stop();
 				_scene->audioManager->Get<AudioManager>()->PlaySoundByName("StopReplenish", 0.5f);
 				startedRefill = false;
 			}
@@ -284,7 +285,8 @@ void SimpleCameraControl::OxygenSystem(float deltaTime)
 	{
 		if (startedRefill)
 		{
-			oxygenChannel->stop();
+			if (oxygenChannel != nullptr)
+				oxygenChannel->stop();
 			_scene->audioManager->Get<AudioManager>()->PlaySoundByName("StopReplenish", 0.5f);
 			startedRefill = false;
 		}
@@ -295,7 +297,8 @@ void SimpleCameraControl::OxygenSystem(float deltaTime)
 			if (outOfBreath)
 			{
 				outOfBreath = false;
-				outOfBreathChannel->stop();
+				if (outOfBreathChannel != nullptr)
+					outOfBreathChannel->stop();
 			}
 		}
 		else
@@ -124,7 +124,7 @@ protected:
 	bool outOfBreath = false;
 	bool holdingBreath = false;
 
-	FMOD::Channel* oxygenChannel;
-	FMOD::Channel* outOfBreathChannel;
+	FMOD::Channel* oxygenChannel = nullptr;
+	FMOD::Channel* outOfBreathChannel = nullptr;
 
 };
\ No newline at end of file
@@ -3,20 +3,24 @@
 #include "Utils/JsonGlmHelpers.h"
 #include "Gameplay/Components/AudioManager.h"
 
+SoundEmmiter::~SoundEmmiter()
+{
+	if (scene != nullptr)
+		scene->GetLightManager().Release(soundLight);
+}
+
 void SoundEmmiter::Awake()
 {
 	lerpSpeed = attackSpeed;
 
 	scene = GetGameObject()->GetScene();
 
-	scene->Lights.push_back(Light());
-	soundLight = scene->Lights.size() - 1;
-	scene->Lights[soundLight].isGenerated = true;
+	soundLight = scene->GetLightManager().Allocate();
 	scene->soundEmmiters.push_back(GetGameObject());
 
 
 	colour = defaultColour;
-	scene->Lights[soundLight].Color = colour;
+	scene->GetLightManager().Get(soundLight).Color = colour;
 }
 
 void SoundEmmiter::Update(float deltaTime)
@@ -36,9 +40,10 @@ void SoundEmmiter::Update(float deltaTime)
 	if (!isDecaying)
 		Attack(deltaTime);
 
-	scene->Lights[soundLight].Range = volume * volume * -1.20f;
+	Light& light = scene->GetLightManager().Get(soundLight);
+	light.Range = volume * volume * -1.20f;
 	if (!isPlayerLight)
-		scene->Lights[soundLight].Position = GetGameObject()->GetPosition();
+		light.Position = GetGameObject()->GetPosition();
 }
 
 void SoundEmmiter::RenderImGui() {
@@ -48,10 +53,10 @@ void SoundEmmiter::RenderImGui() {
 
 	// Draw a textbox for our track name
 	static char nameBuff[256];
-	memcpy(nameBuff, soundName.c_str(), soundName.size());
-	nameBuff[soundName.size()] = '\0';
+	memcpy(nameBuff, sound.Name.c_str(), sound.Name.size());
+	nameBuff[sound.Name.size()] = '\0';
 	if (ImGui::InputText("", nameBuff, 256)) {
-		soundName = nameBuff;
+		sound.SetName(nameBuff);
 	}
 
 	LABEL_LEFT(ImGui::DragFloat, "soundVol", &soundVol);
@@ -63,7 +68,7 @@ nlohmann::json SoundEmmiter::ToJson() const {
 		{ "muteAtZero", glm::vec3(muteAtZero) },
 		{ "distractionVolume", glm::vec3(distractionVolume) },
 		{ "defaultColour", defaultColour },
-		{ "soundName", soundName },
+		{ "soundName", sound },
 		{ "soundVol", soundVol }
 
 	};
@@ -79,7 +84,7 @@ SoundEmmiter::Sptr SoundEmmiter::FromJson(const nlohmann::json& blob) {
 
 	result->distractionVolume = JsonGet(blob, "distractionVolume", glm::vec3(result->distractionVolume)).x;
 	result->defaultColour = JsonGet(blob, "defaultColour", result->defaultColour);
-	result->soundName = JsonGet(blob, "soundName", result->soundName);
+	result->sound = JsonGet(blob, "soundName", result->sound);
 	result->soundVol = JsonGet(blob, "soundVol", 1.0f);
 
 	return result;
@@ -95,7 +100,7 @@ void SoundEmmiter::Attack(float deltaTime)
 {
 	if (!soundPlayed && !isPlayerLight)
 	{
-		scene->audioManager->Get<AudioManager>()->PlaySoundByName(soundName, soundVol, GetGameObject()->GetPosition());
+		scene->audioManager->Get<AudioManager>()->Play(sound, soundVol, GetGameObject()->GetPosition());
 		soundPlayed = true;
 	}
 
@@ -112,7 +117,7 @@ void SoundEmmiter::Attack(float deltaTime)
 	if (!muteAtZero)
 		return;
 
-	scene->Lights[soundLight].Color = glm::vec3(defaultColour * (1.0f - (volume / targetVolume)));
+	scene->GetLightManager().Get(soundLight).Color = glm::vec3(defaultColour * (1.0f - (volume / targetVolume)));
 
 	if (targetVolume - volume < 0.001f || t >= 1.0)
 	{
@@ -126,5 +131,5 @@ void SoundEmmiter::Attack(float deltaTime)
 void SoundEmmiter::MoveToPlayer()
 {
 	GetGameObject()->SetPostion(scene->MainCamera->GetGameObject()->GetPosition() + soundLightOffset);
-	scene->Lights[soundLight].Position = scene->MainCamera->GetGameObject()->GetPosition() + soundLightOffset;
+	scene->GetLightManager().Get(soundLight).Position = scene->MainCamera->GetGameObject()->GetPosition() + soundLightOffset;
 }
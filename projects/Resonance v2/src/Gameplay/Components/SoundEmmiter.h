@@ -3,6 +3,7 @@
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 #include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Components/AudioManager.h"
 
 using namespace Gameplay;
 
@@ -14,8 +15,8 @@ public:
 	typedef std::shared_ptr<SoundEmmiter> Sptr;
 
 	SoundEmmiter() = default;
-	//Hey, ur probably gonna have to make sure shared pointers get deleted properly so no rings persist during scene changes
-	//~SoundEmmiter(); 
+	//Gives our ring light back to the scene's light manager, so no rings persist after we're gone
+	~SoundEmmiter();
 
 	//Properties
 	float volume = 0.0f;
@@ -25,7 +26,7 @@ public:
 	float attackSpeed = 4;
 	float lerpSpeed;
 	glm::vec3 soundLightOffset = glm::vec3(0, 0, 0);
-	Scene* scene;
+	Scene* scene = nullptr;
 
 	bool isDecaying = true;
 	bool muteAtZero = false;
@@ -41,7 +42,8 @@ public:
 	void MoveToPlayer();
 	//Generic Functions
 	glm::vec3 speed = glm::vec3(0.0f);
-	std::string soundName;
+	//The sound to play when we go off, stored by name in JSON but played by handle
+	SoundRef sound;
 	float soundVol;
 
 
@@ -57,6 +59,6 @@ public:
 	MAKE_TYPENAME(SoundEmmiter);
 
 protected:
-	int soundLight;
+	uint32_t soundLight = LightManager::NO_LIGHT;
 	bool soundPlayed;
 };
\ No newline at end of file
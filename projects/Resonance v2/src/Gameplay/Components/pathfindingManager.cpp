@@ -4,7 +4,6 @@
 #include "Utils/JsonGlmHelpers.h"
 #include <GLFW/glfw3.h>
 #include "Gameplay/Scene.h"
-#include "Gameplay/Components/NavNode.h"
 #include "Utils\GlmBulletConversions.h"
 #include "Application/Application.h"
 
@@ -15,7 +14,11 @@ void pathfindingManager::Awake() {
 	Application& app = Application::Get();
 	_window = app.GetWindow();
 	scene = GetGameObject()->GetScene();
+	_pathService.SetWorkerCount(pathWorkers);
+	_pathService.SetMainThreadBudget(pathBudgetUs);
 	UpdateNbors();
+	if (useNavMesh)
+		BakeNavMesh();
 
 	//GameObject::Sptr myself = std::make_shared<GameObject>(*GetGameObject());
 	scene->pathManager = GetGameObject();
@@ -24,304 +27,362 @@ void pathfindingManager::Awake() {
 pathfindingManager::~pathfindingManager()
 {
 	navNodes.clear();
-	openSet.clear();
-	closedSet.clear();
-	pathSet.clear();
-	startNode = nullptr;
-	endNode = nullptr;
 }
-//Pathfinding Stress-test
 void pathfindingManager::Update(float deltaTime)
 {
-	//if (glfwGetKey(_window, GLFW_KEY_P))
-	//{
-	//	std::vector<GameObject::Sptr> yo = requestPath(glm::vec3(0, 50.0f, 100), scene->MainCamera->GetGameObject()->GetPosition());
+	_pathService.Update();
+	_crowd.Update();
 
-	//	for (int i = 0; i < navNodes.size(); i++)
-	//	{
-	//		navNodes[i]->SetScale(glm::vec3(1.0f));
-	//		navNodes[i]->SetRotation(glm::vec3(0.0f));
-
-	//	}
-
-	//	for (int i = 0; i < yo.size(); i++)
-	//	{
-	//		yo[i]->SetScale(glm::vec3(2.0f, 2.0f, 5.0f));
-	//	}
+	// Work through any edges that need re-testing, spreading the raycasts over multiple frames
+	if (!_retestQueue.empty())
+	{
+		double startTime = glfwGetTime();
+		do
+		{
+			CandidateEdge& edge = _candidates[_retestQueue.front()];
+			_retestQueue.pop_front();
+			edge.Queued = false;
 
-	//	endNode->SetRotation(glm::vec3(90, 0, 0));
-	//	startNode->SetRotation(glm::vec3(30, 0, 0));
+			bool visible = _TestVisibility(edge);
+			if (visible != edge.Visible)
+			{
+				edge.Visible = visible;
+				_isGraphDirty = true;
+			}
+		} while (!_retestQueue.empty() && (glfwGetTime() - startTime) * 1000.0 < retestBudgetMs);
+	}
 
-	//}
+	// Only recompile once everything has been re-tested, so paths never see a half updated region
+	if (_isGraphDirty && _retestQueue.empty())
+	{
+		_CompileGraph();
+		_isGraphDirty = false;
+	}
 }
 
 
 void pathfindingManager::RenderImGui() {
 	LABEL_LEFT(ImGui::DragFloat3, "Speed2", &speed.x);
+	LABEL_LEFT(ImGui::DragFloat, "Retest Budget (ms)", &retestBudgetMs, 0.01f, 0.01f, 16.0f);
+	ImGui::Text("Edges: %d (%d pending)", (int)_graph->GetEdgeCount(), (int)_retestQueue.size());
+
+	ImGui::Separator();
+	if (LABEL_LEFT(ImGui::SliderInt, "Path Workers", &pathWorkers, 0, 4)) {
+		_pathService.SetWorkerCount(pathWorkers);
+	}
+	if (LABEL_LEFT(ImGui::DragFloat, "Path Budget (us)", &pathBudgetUs, 10.0f, 10.0f, 16000.0f)) {
+		_pathService.SetMainThreadBudget(pathBudgetUs);
+	}
+	ImGui::Text("Paths: %d pending, %d cached", (int)_pathService.GetPendingCount(), (int)_pathService.GetCacheSize());
+	ImGui::Text("Sound occlusion raycasts: %d last frame", (int)scene->soundPerception.GetRaycastCount());
+	ImGui::Text("AI ticks: %d of %d agents last frame", (int)scene->aiScheduler.GetTickCount(), (int)scene->aiScheduler.GetAgentCount());
+
+	ImGui::Separator();
+	LABEL_LEFT(ImGui::Checkbox, "Use Navmesh", &useNavMesh);
+	LABEL_LEFT(ImGui::DragFloat, "Cell Size", &bakeSettings.CellSize, 0.01f, 0.05f, 2.0f);
+	LABEL_LEFT(ImGui::DragFloat, "Cell Height", &bakeSettings.CellHeight, 0.01f, 0.05f, 2.0f);
+	LABEL_LEFT(ImGui::DragFloat, "Agent Height", &bakeSettings.AgentHeight, 0.1f, 0.1f, 10.0f);
+	LABEL_LEFT(ImGui::DragFloat, "Agent Radius", &bakeSettings.AgentRadius, 0.05f, 0.0f, 5.0f);
+	LABEL_LEFT(ImGui::DragFloat, "Max Climb", &bakeSettings.AgentMaxClimb, 0.05f, 0.0f, 5.0f);
+	LABEL_LEFT(ImGui::DragFloat, "Max Slope", &bakeSettings.AgentMaxSlope, 1.0f, 0.0f, 89.0f);
+	if (ImGui::Button("Bake Navmesh")) {
+		BakeNavMesh();
+	}
+	if (_navMesh != nullptr) {
+		ImGui::Text("Navmesh: %d polygons", (int)_navMesh->GetPolygonCount());
+	}
 }
 
 nlohmann::json pathfindingManager::ToJson() const {
 	return {
-		{ "speed", speed }
+		{ "speed", speed },
+		{ "retest_budget", retestBudgetMs },
+		{ "path_workers", pathWorkers },
+		{ "path_budget_us", pathBudgetUs },
+		{ "use_navmesh", useNavMesh },
+		{ "navmesh_path", navMeshPath },
+		{ "navmesh_settings", {
+			{ "cell_size", bakeSettings.CellSize },
+			{ "cell_height", bakeSettings.CellHeight },
+			{ "agent_height", bakeSettings.AgentHeight },
+			{ "agent_radius", bakeSettings.AgentRadius },
+			{ "max_climb", bakeSettings.AgentMaxClimb },
+			{ "max_slope", bakeSettings.AgentMaxSlope }
+		}}
 	};
 }
 
 pathfindingManager::Sptr pathfindingManager::FromJson(const nlohmann::json& blob) {
 	pathfindingManager::Sptr result = std::make_shared<pathfindingManager>();
 	result->speed = JsonGet(blob, "speed", result->speed);
+	result->retestBudgetMs = JsonGet(blob, "retest_budget", result->retestBudgetMs);
+	result->pathWorkers = JsonGet(blob, "path_workers", result->pathWorkers);
+	result->pathBudgetUs = JsonGet(blob, "path_budget_us", result->pathBudgetUs);
+	result->useNavMesh = JsonGet(blob, "use_navmesh", result->useNavMesh);
+	result->navMeshPath = JsonGet(blob, "navmesh_path", result->navMeshPath);
+	if (blob.contains("navmesh_settings")) {
+		const nlohmann::json& settings = blob["navmesh_settings"];
+		Navigation::NavMeshBakeSettings& bake = result->bakeSettings;
+		bake.CellSize = JsonGet(settings, "cell_size", bake.CellSize);
+		bake.CellHeight = JsonGet(settings, "cell_height", bake.CellHeight);
+		bake.AgentHeight = JsonGet(settings, "agent_height", bake.AgentHeight);
+		bake.AgentRadius = JsonGet(settings, "agent_radius", bake.AgentRadius);
+		bake.AgentMaxClimb = JsonGet(settings, "max_climb", bake.AgentMaxClimb);
+		bake.AgentMaxSlope = JsonGet(settings, "max_slope", bake.AgentMaxSlope);
+	}
 
 	return result;
 }
 
 #pragma endregion "Default Functions"
 
-float SquareMagnitude(glm::vec3 dir)
+uint64_t pathfindingManager::_CellKey(int x, int y)
 {
-	float dirLength = (dir.x * dir.x) + (dir.y * dir.y) + (dir.z * dir.z);
-	return dirLength;
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
 }
 
+glm::ivec2 pathfindingManager::_GetCell(const glm::vec3& position) const
+{
+	return glm::ivec2(glm::floor(glm::vec2(position) / nborRange));
+}
 
-void pathfindingManager::resetGrid()
+bool pathfindingManager::_TestVisibility(const CandidateEdge& edge) const
 {
-	for (int i = 0; i < navNodes.size(); i++)
-	{
-		navNodes[i]->Get<NavNode>()->Reset();
-	}
+	const btVector3 from = ToBt(_nodePositions[edge.A]);
+	const btVector3 to = ToBt(_nodePositions[edge.B]);
+	btCollisionWorld::ClosestRayResultCallback hit(from, to);
+	scene->GetPhysicsWorld()->rayTest(from, to, hit);
+	return !hit.hasHit();
 }
 
 void pathfindingManager::UpdateNbors()
 {
-	for (int i = 0; i < navNodes.size(); i++)
+	_nodePositions.clear();
+	_candidates.clear();
+	_candidateCells.clear();
+	_retestQueue.clear();
+
+	// Bucket the nodes into cells of nborRange, so neighbors can only be in the same or adjacent cells
+	std::unordered_map<uint64_t, std::vector<uint32_t>> nodeCells;
+	for (uint32_t i = 0; i < navNodes.size(); i++)
 	{
-		navNodes[i]->Get<NavNode>()->neighbors.clear();
+		_nodePositions.push_back(navNodes[i]->GetPosition());
+		glm::ivec2 cell = _GetCell(_nodePositions[i]);
+		nodeCells[_CellKey(cell.x, cell.y)].push_back(i);
+	}
 
-		for (int x = 0; x < navNodes.size(); x++)
+	for (uint32_t i = 0; i < _nodePositions.size(); i++)
+	{
+		glm::ivec2 cell = _GetCell(_nodePositions[i]);
+		for (int y = cell.y - 1; y <= cell.y + 1; y++)
 		{
-			if (navNodes[x] == navNodes[i])
-				continue;
-
-			glm::vec3 dir = navNodes[x]->GetPosition() - navNodes[i]->GetPosition();
-			float dirLength = glm::sqrt((dir.x * dir.x) + (dir.y * dir.y));
-
-			if (dirLength <= nborRange && dirLength > 0)
+			for (int x = cell.x - 1; x <= cell.x + 1; x++)
 			{
-				btCollisionWorld::ClosestRayResultCallback hit(ToBt(navNodes[i]->GetPosition()), ToBt(navNodes[x]->GetPosition()));
-				scene->GetPhysicsWorld()->rayTest(ToBt(navNodes[i]->GetPosition()), ToBt(navNodes[x]->GetPosition()), hit);
-
-				if (!hit.hasHit())
-					navNodes[i]->Get<NavNode>()->neighbors.push_back(navNodes[x]);
+				auto it = nodeCells.find(_CellKey(x, y));
+				if (it == nodeCells.end())
+					continue;
+
+				for (uint32_t j : it->second)
+				{
+					// Each pair is only considered once, and line of sight goes both ways
+					if (j <= i)
+						continue;
+
+					glm::vec2 dir = glm::vec2(_nodePositions[j] - _nodePositions[i]);
+					float dirLength = glm::length(dir);
+					if (dirLength > nborRange || dirLength <= 0)
+						continue;
+
+					CandidateEdge edge = { i, j, false, false };
+					edge.Visible = _TestVisibility(edge);
+
+					uint32_t index = static_cast<uint32_t>(_candidates.size());
+					_candidates.push_back(edge);
+					glm::ivec2 midCell = _GetCell((_nodePositions[i] + _nodePositions[j]) * 0.5f);
+					_candidateCells[_CellKey(midCell.x, midCell.y)].push_back(index);
+				}
 			}
 		}
 	}
-	std::cout << "\n\nNavNode Neighbors Updated.";
-}
-
-bool pathfindingManager::StartAndEndCheck()
-{
-	if (startNode == NULL || endNode == NULL)
-		return false;
-
-	if (startNode == endNode)
-		return false;
-
-	return true;
-}
-
-float pathfindingManager::g(GameObject* n, GameObject* p)
-{
-	glm::vec3 dir = n->GetPosition() - p->GetPosition();
-	return SquareMagnitude(dir) + p->Get<NavNode>()->gCost;
-}
-
-void pathfindingManager::h(GameObject* n1)
-{
-	glm::vec3 dir = n1->GetPosition() - endNode->GetPosition();
-	n1->Get<NavNode>()->hCost = SquareMagnitude(dir);
-}
 
-void pathfindingManager::f(GameObject* n1)
-{
-	NavNode::Sptr node = n1->Get<NavNode>();
-	node->fCost = node->gCost + node->hCost;
+	_CompileGraph();
+	_isGraphDirty = false;
+	LOG_INFO("NavNode neighbors updated ({} nodes, {} candidate pairs, {} edges)", _graph->GetNodeCount(), _candidates.size(), _graph->GetEdgeCount());
 }
 
-void pathfindingManager::CompareOpen()
+void pathfindingManager::InvalidateRegion(const glm::vec3& min, const glm::vec3& max)
 {
-	NavNode::Sptr minNode;
-	minNode = openSet[0]->Get<NavNode>();
-	int minIndex = 0;
+	// Every candidate edge is at most nborRange long, so if it passes through the region it's midpoint is
+	// within half of that of the region on the XY plane
+	glm::ivec2 minCell = _GetCell(min - glm::vec3(nborRange * 0.5f));
+	glm::ivec2 maxCell = _GetCell(max + glm::vec3(nborRange * 0.5f));
 
-	//Find minimum node in openSet
-	for (int i = 0; i < openSet.size(); i++)
+	int queued = 0;
+	for (int y = minCell.y; y <= maxCell.y; y++)
 	{
-		NavNode::Sptr openNode = openSet[i]->Get<NavNode>();
-		if (openNode->fCost < minNode->fCost && openNode->hCost < minNode->hCost)
+		for (int x = minCell.x; x <= maxCell.x; x++)
 		{
-			minNode = openNode;
-			minIndex = i;
+			auto it = _candidateCells.find(_CellKey(x, y));
+			if (it == _candidateCells.end())
+				continue;
+
+			for (uint32_t index : it->second)
+			{
+				CandidateEdge& edge = _candidates[index];
+				if (edge.Queued)
+					continue;
+
+				// Slab test the edge's segment against the region
+				const glm::vec3& from = _nodePositions[edge.A];
+				glm::vec3 delta = _nodePositions[edge.B] - from;
+				float tMin = 0.0f, tMax = 1.0f;
+				bool overlaps = true;
+				for (int axis = 0; axis < 3 && overlaps; axis++)
+				{
+					if (glm::abs(delta[axis]) < 1e-6f)
+					{
+						overlaps = from[axis] >= min[axis] && from[axis] <= max[axis];
+					}
+					else
+					{
+						float t1 = (min[axis] - from[axis]) / delta[axis];
+						float t2 = (max[axis] - from[axis]) / delta[axis];
+						tMin = glm::max(tMin, glm::min(t1, t2));
+						tMax = glm::min(tMax, glm::max(t1, t2));
+						overlaps = tMin <= tMax;
+					}
+				}
+
+				if (overlaps)
+				{
+					edge.Queued = true;
+					_retestQueue.push_back(index);
+					queued++;
+				}
+			}
 		}
 	}
-
-	//Remove node from openSet
-	minNode->NodeType = minNode->closed;
-	closedSet.push_back(openSet[minIndex]);
-	openSet.erase(openSet.begin() + minIndex);
+	LOG_TRACE("Queued {} nav edges for re-testing", queued);
 }
 
-void pathfindingManager::RunPathfind()
+void pathfindingManager::_CompileGraph()
 {
-	if (StartAndEndCheck())
+	// Line of sight goes both ways, so each visible candidate is an edge in each direction
+	std::vector<std::pair<uint32_t, uint32_t>> edges;
+	for (const CandidateEdge& edge : _candidates)
 	{
-		//Resetting Stuff
-		cIndex = 0;
-		resetGrid();
-		closedSet.clear();
-		openSet.clear();
-		pathSet.clear();
-
-		//Initializing Pathfind
-		closedSet.push_back(startNode);
-		calculatingPath = true;
-
-		while (calculatingPath)
+		if (edge.Visible)
 		{
-			CalculatePath();
+			edges.push_back({ edge.A, edge.B });
+			edges.push_back({ edge.B, edge.A });
 		}
 	}
-	else
-	{
-		std::cout << "\n\nStart & End Point have not been defined!";
-	}
 
+	Navigation::NavGraph::Sptr graph = std::make_shared<Navigation::NavGraph>();
+	graph->Build(_nodePositions, edges, nborRange);
+	_graph = graph;
+	_OnGraphChanged();
 }
 
-void pathfindingManager::CalculateFCosts(int nbor)
+void pathfindingManager::_OnGraphChanged()
 {
-	//Variables storing indexs for the navNodes list
-
-	GameObject* nborObj = closedSet[cIndex]->Get<NavNode>()->neighbors[nbor];
-
-	if (nborObj->Get<NavNode>()->gCost <= 0 || g(nborObj, closedSet[cIndex]) < nborObj->Get<NavNode>()->gCost)
-	{
-		//Parenting
-		nborObj->Get<NavNode>()->parent = closedSet[cIndex];
-
-		//Calculating Costs
-		nborObj->Get<NavNode>()->gCost = g(nborObj, closedSet[cIndex]);
-		h(nborObj);
-		f(nborObj);
-	}
+	_pathService.SetSource(_graph, _navMesh);
+	_flowField.Invalidate();
+
+	// The nav graph doesn't know where the walls are, so agents only avoid walls when there is a navmesh
+	_boundaryEdges.clear();
+	if (_navMesh != nullptr)
+		_navMesh->GetBoundaryEdges(_boundaryEdges);
+	_crowd.SetObstacles(_boundaryEdges);
 }
 
-void pathfindingManager::CheckIfEnd(int nbor)
+bool pathfindingManager::BakeNavMesh()
 {
-	GameObject* nborObj = closedSet[cIndex]->Get<NavNode>()->neighbors[nbor];
+	std::vector<glm::vec3> vertices;
+	std::vector<uint32_t> indices;
+	Navigation::NavMeshBuilder::GatherCollisionGeometry(scene->GetPhysicsWorld(), vertices, indices);
+	uint64_t sourceHash = Navigation::NavMeshBuilder::ComputeSourceHash(vertices, indices, bakeSettings);
 
-	if (nborObj == endNode)
+	// Reuse the cached mesh if nothing has changed since it was baked
+	if (!navMeshPath.empty())
 	{
-		nborObj->Get<NavNode>()->parent = closedSet[cIndex];
-		SequencePath();
-		return;
+		Navigation::NavMesh::Sptr cached = Navigation::NavMesh::Load(navMeshPath);
+		if (cached != nullptr && cached->GetSourceHash() == sourceHash)
+		{
+			_navMesh = cached;
+			_OnGraphChanged();
+			LOG_INFO("Loaded navmesh from \"{}\" ({} polygons)", navMeshPath, _navMesh->GetPolygonCount());
+			return true;
+		}
 	}
+
+	_navMesh = Navigation::NavMeshBuilder::Bake(vertices, indices, bakeSettings);
+	if (_navMesh != nullptr && !navMeshPath.empty())
+		_navMesh->Save(navMeshPath);
+	_OnGraphChanged();
+	return _navMesh != nullptr;
 }
 
-void pathfindingManager::OpenNbors(int nbor)
+Navigation::PathTicket pathfindingManager::requestPathAsync(const glm::vec3& startPos, const glm::vec3& targetPos)
 {
-	GameObject* nborObj = closedSet[cIndex]->Get<NavNode>()->neighbors[nbor];
-
-	if (nborObj->Get<NavNode>()->NodeType == nborObj->Get<NavNode>()->blank)
-	{
-		nborObj->Get<NavNode>()->NodeType = nborObj->Get<NavNode>()->open;
-		openSet.push_back(nborObj);
-	}
+	return _pathService.Request(startPos, targetPos);
 }
 
-void pathfindingManager::SequencePath()
+bool pathfindingManager::pollPath(Navigation::PathTicket ticket, Navigation::PathStatus& outStatus, std::vector<glm::vec3>& outPath)
 {
-	pathSet.push_back(endNode->GetPosition());
-
-	GameObject* current = endNode;
-	current = current->Get<NavNode>()->parent;
+	return _pathService.Poll(ticket, outStatus, outPath);
+}
 
-	while (true)
-	{
-		if (current == startNode)
-		{
-			calculatingPath = false;
-			return;
-		}
-		else
-		{
-			pathSet.push_back(current->GetPosition());
-			current = current->Get<NavNode>()->parent;;
-		}
-	}
+void pathfindingManager::cancelPath(Navigation::PathTicket ticket)
+{
+	_pathService.Cancel(ticket);
 }
 
-std::vector<glm::vec3> pathfindingManager::requestPath(glm::vec3 startPos, glm::vec3 targetPos)
+bool pathfindingManager::getFlowTarget(const glm::vec3& position, const glm::vec3& targetPos, glm::vec3& outTarget)
 {
-	float minDistance = 999999;
-	GameObject* minNode = navNodes[0];
-	float distance;
-	pathSet.clear();
+	return _flowField.GetSteeringTarget(*_graph, _navMesh.get(), position, targetPos, outTarget);
+}
 
-	//Find Start Node
-	for (int i = 0; i < navNodes.size(); i++)
-	{
-		distance = glm::sqrt(SquareMagnitude(navNodes[i]->GetPosition() - startPos));
-		if (distance < minDistance)
-		{
-			minDistance = distance;
-			minNode = navNodes[i];
-		}
-	}
-	startNode = minNode;
+Navigation::PathStatus pathfindingManager::requestPath(const glm::vec3& startPos, const glm::vec3& targetPos, std::vector<glm::vec3>& outPath)
+{
+	outPath.clear();
 
-	minDistance = 999999;
-	//Find End Node
-	for (int i = 0; i < navNodes.size(); i++)
+	if (_navMesh != nullptr)
 	{
-		distance = glm::sqrt(SquareMagnitude(navNodes[i]->GetPosition() - targetPos));
-		if (navNodes[i] == startNode)
-			continue;
+		Navigation::PathStatus status = _navMesh->FindPath(startPos, targetPos, _meshPath);
+		if (status != Navigation::PathStatus::Success)
+			return status;
 
-		if (distance < minDistance)
+		// Same ordering as the node paths, from the target back to the first corner after the start
+		outPath.reserve(_meshPath.size() - 1);
+		for (size_t i = _meshPath.size() - 1; i > 0; i--)
 		{
-			minDistance = distance;
-			minNode = navNodes[i];
+			outPath.push_back(_meshPath[i]);
 		}
+		return Navigation::PathStatus::Success;
 	}
-	endNode = minNode;
 
-	RunPathfind();
-	if (pathSet.size() > 0)
-		return pathSet;
-	else //Returns a weird position to signify no path could be found
-	{
-		pathSet.push_back(glm::vec3(69420.0f, 69420.0f, 69420.0f));
-		return pathSet;
-	}
-}
+	uint32_t startNode = _graph->FindNearestNode(startPos);
+	uint32_t endNode = _graph->FindNearestNode(targetPos);
+	if (startNode == Navigation::NavGraph::NO_NODE || endNode == Navigation::NavGraph::NO_NODE)
+		return Navigation::PathStatus::EmptyGraph;
 
-void pathfindingManager::CalculatePath()
-{
-	for (int nbor = 0; nbor < closedSet[cIndex]->Get<NavNode>()->neighbors.size(); nbor++)
+	// Both ends are at the same node, just head straight for it
+	if (startNode == endNode)
 	{
-		CheckIfEnd(nbor);
-		OpenNbors(nbor);
-		CalculateFCosts(nbor);
+		outPath.push_back(_graph->GetNodePosition(endNode));
+		return Navigation::PathStatus::Success;
 	}
 
-	if (openSet.size() <= 0 && cIndex > 0)
+	Navigation::PathStatus status = _graph->FindPath(startNode, endNode, _nodePath);
+	if (status != Navigation::PathStatus::Success)
+		return status;
+
+	// Enemies walk the path from the back, so store it from the target back to the first node after the start
+	outPath.reserve(_nodePath.size() - 1);
+	for (size_t i = _nodePath.size() - 1; i > 0; i--)
 	{
-		std::cout << "\n\nNo possible path could be found";
-		calculatingPath = false;
-		return;
+		outPath.push_back(_graph->GetNodePosition(_nodePath[i]));
 	}
-
-	CompareOpen();
-
-	cIndex++;
-
+	return Navigation::PathStatus::Success;
 }
@@ -1,6 +1,13 @@
 #pragma once
 #include "IComponent.h"
 #include "Gameplay/GameObject.h"
+#include "Gameplay/Navigation/NavGraph.h"
+#include "Gameplay/Navigation/NavMeshBuilder.h"
+#include "Gameplay/Navigation/PathService.h"
+#include "Gameplay/Navigation/FlowField.h"
+#include "Gameplay/Navigation/Crowd.h"
+#include <deque>
+#include <unordered_map>
 struct GLFWwindow;
 
 using namespace Gameplay;
@@ -17,37 +24,95 @@ public:
 
 	//Properties
 	std::vector<GameObject*> navNodes;
-	std::vector<GameObject*> openSet;
-	std::vector<GameObject*> closedSet;
-
-	std::vector<glm::vec3> pathSet;
-	GameObject* startNode;
-	GameObject* endNode;
 
 	glm::vec3 speed = glm::vec3(0.0f);
 	float nborRange = 15.0f;
+	//The time in milliseconds per frame we can spend re-testing edges after InvalidateRegion
+	float retestBudgetMs = 0.5f;
+	//If true, a navmesh is baked from the scene's static collision on awake, and paths are found over it instead of the nav nodes
+	bool useNavMesh = false;
+	//Where to cache the baked navmesh, if empty the mesh is baked every time the scene loads
+	std::string navMeshPath = "";
+	Navigation::NavMeshBakeSettings bakeSettings;
+	//How many threads solve path requests, with 0 they are solved on the main thread within pathBudgetUs each frame
+	int pathWorkers = 1;
+	float pathBudgetUs = 500.0f;
 	Scene* scene;
 	GLFWwindow* _window;
 
-	int cIndex = 0;
-	bool calculatingPath = false;
-
 	//Pathfinding Functions
-	void resetGrid();
+
+	/// <summary>
+	/// Rebuilds the entire graph, finding candidate neighbors with a spatial hash and testing
+	/// line of sight for each of them
+	/// </summary>
 	void UpdateNbors();
-	bool StartAndEndCheck();
-	void RunPathfind(); //just merge the ClearPathCalculations() and pathfinding operations
-	void CompareOpen();
-	float g(GameObject* n, GameObject* p);
-	void h(GameObject* n1);
-	void f(GameObject* n1);
-	void CalculateFCosts(int nbor);
-	void CheckIfEnd(int nbor);
-	void OpenNbors(int nbor);
-	void SequencePath();
-	std::vector<glm::vec3> requestPath(glm::vec3 startPos, glm::vec3 targetPos);
-	void CalculatePath();
+	/// <summary>
+	/// Flags every edge whose line of sight passes through the given world space bounds to be
+	/// re-tested. Dynamic obstacles (ex: doors) should call this with the bounds they sweep through,
+	/// the re-tests are spread over the following frames according to retestBudgetMs
+	/// </summary>
+	/// <param name="min">The minimum corner of the changed region</param>
+	/// <param name="max">The maximum corner of the changed region</param>
+	void InvalidateRegion(const glm::vec3& min, const glm::vec3& max);
+
+	/// <summary>
+	/// Bakes the navmesh from the static collision geometry in the scene, or loads it from navMeshPath if the
+	/// cached mesh was baked from the same geometry and settings
+	/// </summary>
+	/// <returns>True if there is a navmesh to path over, false if otherwise</returns>
+	bool BakeNavMesh();
+
+	/// <summary>
+	/// Queues up a path request, to be solved by the path service. Requests between the same places are
+	/// merged, and recent results are reused until the graph changes
+	/// </summary>
+	/// <param name="startPos">The position to path from</param>
+	/// <param name="targetPos">The position to path to</param>
+	/// <returns>A ticket to poll for the result with</returns>
+	Navigation::PathTicket requestPathAsync(const glm::vec3& startPos, const glm::vec3& targetPos);
+	/// <summary>
+	/// Checks if a queued path request is ready, see PathService::Poll
+	/// </summary>
+	bool pollPath(Navigation::PathTicket ticket, Navigation::PathStatus& outStatus, std::vector<glm::vec3>& outPath);
+	/// <summary>
+	/// Cancels a queued path request
+	/// </summary>
+	void cancelPath(Navigation::PathTicket ticket);
+
+	/// <summary>
+	/// Finds where an agent should steer to in order to reach a shared target, using a flow field. The field
+	/// is only rebuilt when the target moves to a different node, so this is cheap for any number of agents
+	/// chasing the same target (ex: the player)
+	/// </summary>
+	/// <param name="position">The position of the agent</param>
+	/// <param name="targetPos">The position of the shared target</param>
+	/// <param name="outTarget">Will store the point the agent should head towards</param>
+	/// <returns>True if the target can be reached, false if otherwise</returns>
+	bool getFlowTarget(const glm::vec3& position, const glm::vec3& targetPos, glm::vec3& outTarget);
 
+	/// <summary>
+	/// Immediately finds a path across the navmesh if one is baked, otherwise between the nav nodes nearest to the start and target positions
+	/// </summary>
+	/// <param name="startPos">The position to path from</param>
+	/// <param name="targetPos">The position to path to</param>
+	/// <param name="outPath">Will store the points along the path, ordered from the target back towards the
+	/// start (the start itself is excluded), so agents can walk it from the back</param>
+	/// <returns>Success if a path was found, or the reason there is no path</returns>
+	Navigation::PathStatus requestPath(const glm::vec3& startPos, const glm::vec3& targetPos, std::vector<glm::vec3>& outPath);
+
+	/// <summary>
+	/// Gets the compiled navigation graph
+	/// </summary>
+	const Navigation::NavGraph& GetGraph() const { return *_graph; }
+	/// <summary>
+	/// Gets the baked navmesh, or nullptr if there isn't one
+	/// </summary>
+	const Navigation::NavMesh::Sptr& GetNavMesh() const { return _navMesh; }
+	/// <summary>
+	/// Gets the crowd that agents use to steer around each other, and around the walls of the navmesh
+	/// </summary>
+	Navigation::Crowd& getCrowd() { return _crowd; }
 
 	//General Functions
 	virtual void Awake() override;
@@ -60,4 +125,47 @@ public:
 	static pathfindingManager::Sptr FromJson(const nlohmann::json& data);
 
 	MAKE_TYPENAME(pathfindingManager);
+
+protected:
+	// A pair of nodes within nborRange of each other, which are neighbors if they can see each other
+	struct CandidateEdge {
+		uint32_t A, B;
+		bool     Visible;
+		bool     Queued;
+	};
+
+	// Rebuilt rather than modified, since the path service's workers may still be searching the old one
+	Navigation::NavGraph::Sptr _graph = std::make_shared<Navigation::NavGraph>();
+	Navigation::NavMesh::Sptr  _navMesh;
+	Navigation::PathService    _pathService;
+	Navigation::FlowField      _flowField;
+	Navigation::Crowd          _crowd;
+	// Reused when the navmesh changes, so that we don't allocate every time
+	std::vector<glm::vec3>     _boundaryEdges;
+	// Reused between queries so that we don't allocate on every request
+	std::vector<uint32_t> _nodePath;
+	std::vector<glm::vec3> _meshPath;
+
+	std::vector<glm::vec3>     _nodePositions;
+	std::vector<CandidateEdge> _candidates;
+	// Candidate edges bucketed by the XY cell that their midpoint falls in, cells are nborRange in size
+	std::unordered_map<uint64_t, std::vector<uint32_t>> _candidateCells;
+	// Candidate edges waiting to be re-tested
+	std::deque<uint32_t> _retestQueue;
+	bool                 _isGraphDirty = false;
+
+	static uint64_t _CellKey(int x, int y);
+	glm::ivec2 _GetCell(const glm::vec3& position) const;
+	/// <summary>
+	/// Performs the line of sight test for a candidate edge
+	/// </summary>
+	bool _TestVisibility(const CandidateEdge& edge) const;
+	/// <summary>
+	/// Lets everything that depends on _graph or _navMesh know that they have been replaced
+	/// </summary>
+	void _OnGraphChanged();
+	/// <summary>
+	/// Compiles the visible candidate edges into _graph
+	/// </summary>
+	void _CompileGraph();
 };
\ No newline at end of file
@@ -15,7 +15,7 @@ EnemyState& AggravatedState::getInstance()
 void AggravatedState::Start(Enemy* e)
 {
 	std::cout << "\n[Enemy] " << e->GetGameObject()->Name << ": Entered Aggravated State";
-	e->myChannel = e->scene->audioManager->Get<AudioManager>()->PlaySoundByName("LeaflingAgro", 4.0f, e->GetGameObject()->GetPosition());
+	e->myChannel = e->scene->audioManager->Get<AudioManager>()->Play(e->agroSound, 4.0f, e->GetGameObject()->GetPosition());
 
 	e->pathRequested = false;
 	e->agroTimer = agroTimerMax;
@@ -24,7 +24,8 @@ void AggravatedState::Start(Enemy* e)
 
 void AggravatedState::End(Enemy* e)
 {
-	e->myChannel->stop();
+	if (e->myChannel != nullptr)
+		e->myChannel->stop();
 	std::cout << "\n[Enemy] " << e->GetGameObject()->Name << ": Exited Aggravated State";
 }
 
@@ -35,7 +36,8 @@ void AggravatedState::Listen(Enemy* e, float deltaTime)
 	else
 		e->listeningRadius = glm::mix(e->listeningRadius, e->agroMovingListeningRadius, 2.0f * deltaTime);
 
-	e->scene->Lights[e->soundLight].Color = glm::mix(e->scene->Lights[e->soundLight].Color, e->red, 8.0f * deltaTime);
+	Light& soundLight = e->scene->GetLightManager().Get(e->soundLight);
+	soundLight.Color = glm::mix(soundLight.Color, e->red, 8.0f * deltaTime);
 
 
 	//std::cout << "\n\nAGRO TIMER: " << e->agroTimer;
@@ -44,25 +46,16 @@ void AggravatedState::Listen(Enemy* e, float deltaTime)
 	else
 		e->SetState(PatrollingState::getInstance());
 
-	for each (GameObject * s in e->scene->soundEmmiters)
+	//Only the sounds close enough to hear come back from the scene, and occlusion raycasts are shared between nearby enemies
+	glm::vec3 enemyPos = e->GetGameObject()->GetPosition();
+	e->scene->soundPerception.Query(enemyPos, e->listeningRadius, e->audibleSounds);
+	for (GameObject* s : e->audibleSounds)
 	{
 		if (!s->Get<SoundEmmiter>()->isPlayerLight)
 			continue;
 
-		//Checking if any sounds are in listening Radius
-		glm::vec3 dir = s->GetPosition() - e->GetGameObject()->GetPosition();
-		float dist = glm::length(dir);
-		float totalRadius = s->Get<SoundEmmiter>()->volume + e->listeningRadius;
-
-		if (dist >= totalRadius)
-			continue;
-
-		//Raycasting toward heard sound to determine state change
-		btCollisionWorld::ClosestRayResultCallback hit(ToBt(e->GetGameObject()->GetPosition()), ToBt(e->player->GetPosition()));
-		e->scene->GetPhysicsWorld()->rayTest(ToBt(e->GetGameObject()->GetPosition()), ToBt(e->player->GetPosition()), hit);
-
-
-		if (hit.hasHit() && hit.m_collisionObject->isStaticObject())
+		//Raycasting toward the player to determine if we can still hear them
+		if (e->scene->soundPerception.IsOccluded(e->scene->GetPhysicsWorld(), enemyPos, s, e->player->GetPosition()))
 			continue;
 
 		//std::cout << "\nMADE IT BRU";
@@ -110,30 +103,17 @@ void AggravatedState::Pathfind(Enemy* e, float deltaTime)
 		return;
 	}
 
-	if (!e->pathRequested)
+	//Every aggravated enemy is chasing the player, so they share a flow field rather than each finding their own path
+	glm::vec3 flowTarget;
+	if (!e->pathManager->Get<pathfindingManager>()->getFlowTarget(enemyPos, soundPos, flowTarget))
 	{
-		e->pathSet.clear();
-		//std::cout << "\nCalculated Path to: " << patrolPos.x << ", " << patrolPos.y << ", " << patrolPos.z;
-		e->pathSet = e->pathManager->Get<pathfindingManager>()->requestPath(enemyPos, e->player->GetPosition());
-
-		if (e->pathSet[0] == glm::vec3(69420.0f, 69420.0f, 69420.0f))
-		{
-			e->SetState(PatrollingState::getInstance());
-			return;
-		}
-
-		e->nIndex = e->pathSet.size() - 1;
-		e->pathRequested = true;
-	}
-
-	e->target = e->pathSet[e->nIndex];
-
-	if (glm::length(e->GetGameObject()->GetPosition() - e->pathSet[e->nIndex]) < 3.0f)
-	{
-		SwitchIndex(e, deltaTime);
+		e->SetState(PatrollingState::getInstance());
+		return;
 	}
 
-
+	e->target = flowTarget;
+	//Listen uses nIndex to tell if we are still finding our way to the player
+	e->nIndex = flowTarget == soundPos ? 0 : 1;
 }
 
 void AggravatedState::Move(Enemy* e, float  deltaTime)
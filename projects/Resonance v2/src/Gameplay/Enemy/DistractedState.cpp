@@ -17,7 +17,7 @@ EnemyState& DistractedState::getInstance()
 void DistractedState::Start(Enemy* e)
 {
 	std::cout << "\n[Enemy] " << e->GetGameObject()->Name << ": Entered Distracted State";
-	e->myChannel = e->scene->audioManager->Get<AudioManager>()->PlaySoundByName("LeaflingDistracted", 4.0f, e->GetGameObject()->GetPosition());
+	e->myChannel = e->scene->audioManager->Get<AudioManager>()->Play(e->distractedSound, 4.0f, e->GetGameObject()->GetPosition());
 	e->pathRequested = false;
 	e->maxVelocity = e->IdleVelocity;
 	e->distractedBackupTimer = distractedBackupTimerMax;
@@ -26,7 +26,8 @@ void DistractedState::Start(Enemy* e)
 
 void DistractedState::End(Enemy* e)
 {
-	e->myChannel->stop();
+	if (e->myChannel != nullptr)
+		e->myChannel->stop();
 	std::cout << "\n[Enemy] " << e->GetGameObject()->Name << ": Exited Distracted State";
 }
 
@@ -34,7 +35,8 @@ void DistractedState::Listen(Enemy* e, float deltaTime)
 {
 	//Sound Light Lerping
 	e->listeningRadius = glm::mix(e->listeningRadius, e->patrolListeningRadius, 2.0f * deltaTime);
-	e->scene->Lights[e->soundLight].Color = glm::mix(e->scene->Lights[e->soundLight].Color, e->yellow, 4.0f * deltaTime);
+	Light& soundLight = e->scene->GetLightManager().Get(e->soundLight);
+	soundLight.Color = glm::mix(soundLight.Color, e->yellow, 4.0f * deltaTime);
 
 	//std::cout << "\nSWITCHING BACK IN: " << e->distractedTimer;
 	//Backup distraction timer
@@ -50,21 +52,12 @@ void DistractedState::Listen(Enemy* e, float deltaTime)
 	if (e->distractedTimer <= 0)
 		e->SetState(PatrollingState::getInstance());
 
-	for each (GameObject * s in e->scene->soundEmmiters)
+	//Only the sounds close enough to hear come back from the scene, and occlusion raycasts are shared between nearby enemies
+	glm::vec3 enemyPos = e->GetGameObject()->GetPosition();
+	e->scene->soundPerception.Query(enemyPos, e->listeningRadius, e->audibleSounds);
+	for (GameObject* s : e->audibleSounds)
 	{
-		//Checking if any sounds are in listening Radius
-		glm::vec3 dir = s->GetPosition() - e->GetGameObject()->GetPosition();
-		float dist = glm::length(dir);
-		float totalRadius = s->Get<SoundEmmiter>()->volume + e->listeningRadius;
-
-		if (dist >= totalRadius)
-			continue;
-
-		//Raycasting toward heard sound to determine state change
-		btCollisionWorld::ClosestRayResultCallback hit(ToBt(e->GetGameObject()->GetPosition()), ToBt(s->GetPosition()));
-		e->scene->GetPhysicsWorld()->rayTest(ToBt(e->GetGameObject()->GetPosition()), ToBt(s->GetPosition()), hit);
-
-		if (hit.hasHit() && hit.m_collisionObject->isStaticObject())
+		if (e->scene->soundPerception.IsOccluded(e->scene->GetPhysicsWorld(), enemyPos, s, s->GetPosition()))
 			continue;
 
 		//Adding the heard sound to our lists (removing them if already there)
@@ -121,6 +114,8 @@ void DistractedState::SwitchIndex(Enemy* e, float deltaTime)
 
 		e->lastHeardPositions.erase(e->lastHeardPositions.begin());
 		e->lastHeardSounds.erase(e->lastHeardSounds.begin());
+		//We've reached the sound, wait for the path to the next one rather than walking this one again
+		e->pathSet.clear();
 		e->pathRequested = false;
 	}
 }
@@ -148,22 +143,23 @@ void DistractedState::Pathfind(Enemy* e, float deltaTime)
 		return;
 	}
 
+	//Request a path, we keep following our current one until it's ready
 	if (!e->pathRequested)
 	{
-		e->pathSet.clear();
-		//std::cout << "\nCalculated Path to: " << patrolPos.x << ", " << patrolPos.y << ", " << patrolPos.z;
-		e->pathSet = e->pathManager->Get<pathfindingManager>()->requestPath(enemyPos, e->lastHeardPositions[0]);
-
-		if (e->pathSet[0] == glm::vec3(69420.0f, 69420.0f, 69420.0f))
-		{
-			e->SetState(PatrollingState::getInstance());
-			return;
-		}
-
-		e->nIndex = e->pathSet.size() - 1;
+		e->RequestPath(e->lastHeardPositions[0]);
 		e->pathRequested = true;
 	}
 
+	Navigation::PathStatus status;
+	if (e->PollPath(status) && status != Navigation::PathStatus::Success)
+	{
+		e->SetState(PatrollingState::getInstance());
+		return;
+	}
+
+	if (e->pathSet.empty())
+		return;
+
 	e->target = e->pathSet[e->nIndex];
 
 	if (glm::length(e->GetGameObject()->GetPosition() - e->pathSet[e->nIndex]) < 12.0f)
@@ -15,14 +15,15 @@ EnemyState& PatrollingState::getInstance()
 void PatrollingState::Start(Enemy* e)
 {
 	std::cout << "\n[Enemy] " << e->GetGameObject()->Name << ": Entered Patrolling State";
-	e->myChannel = e->scene->audioManager->Get<AudioManager>()->PlaySoundByName("LeaflingPatrol", 4.0f, e->GetGameObject()->GetPosition());
+	e->myChannel = e->scene->audioManager->Get<AudioManager>()->Play(e->patrolSound, 4.0f, e->GetGameObject()->GetPosition());
 	e->pathRequested = false;
 	e->maxVelocity = e->IdleVelocity;
 }
 
 void PatrollingState::End(Enemy* e)
 {
-	e->myChannel->stop();
+	if (e->myChannel != nullptr)
+		e->myChannel->stop();
 	std::cout << "\n[Enemy] " << e->GetGameObject()->Name << ": Exited Patrolling State";
 }
 
@@ -30,25 +31,15 @@ void PatrollingState::Listen(Enemy* e, float deltaTime)
 {
 	//Sound Light Lerping
 	e->listeningRadius = glm::mix(e->listeningRadius, e->patrolListeningRadius, 2.0f * deltaTime);
-	e->scene->Lights[e->soundLight].Color = glm::mix(e->scene->Lights[e->soundLight].Color, e->blue, 4.0f * deltaTime);
+	Light& soundLight = e->scene->GetLightManager().Get(e->soundLight);
+	soundLight.Color = glm::mix(soundLight.Color, e->blue, 4.0f * deltaTime);
 
-	for each (GameObject * s in e->scene->soundEmmiters)
+	//Only the sounds close enough to hear come back from the scene, and occlusion raycasts are shared between nearby enemies
+	glm::vec3 enemyPos = e->GetGameObject()->GetPosition();
+	e->scene->soundPerception.Query(enemyPos, e->listeningRadius, e->audibleSounds);
+	for (GameObject* s : e->audibleSounds)
 	{
-		//Checking if any sounds are in listening Radius
-		glm::vec3 dir = s->GetPosition() - e->GetGameObject()->GetPosition();
-		float dist = glm::length(dir);
-		float totalRadius = s->Get<SoundEmmiter>()->volume + e->listeningRadius;
-
-		if (dist >= totalRadius)
-			continue;
-
-
-
-		//Raycasting toward heard sound to determine state change
-		btCollisionWorld::ClosestRayResultCallback hit(ToBt(e->GetGameObject()->GetPosition()), ToBt(s->GetPosition()));
-		e->scene->GetPhysicsWorld()->rayTest(ToBt(e->GetGameObject()->GetPosition()), ToBt(s->GetPosition()), hit);
-
-		if (hit.hasHit() && hit.m_collisionObject->isStaticObject())
+		if (e->scene->soundPerception.IsOccluded(e->scene->GetPhysicsWorld(), enemyPos, s, s->GetPosition()))
 			continue;
 
 		//Adding the heard sound to our lists (removing them if already there)
@@ -90,6 +81,8 @@ void SwitchIndex(Enemy* e)
 		else
 			e->pIndex = 0;
 
+		//We've reached the end of our path, wait for the next one rather than walking this one again
+		e->pathSet.clear();
 		e->pathRequested = false;
 	}
 }
@@ -122,25 +115,28 @@ void PatrollingState::Pathfind(Enemy* e, float deltaTime)
 		}
 	}
 
-	//Request a path, and set indexes
+	//Request a path, we keep following our current one until it's ready
 	if (!e->pathRequested)
 	{
-		e->pathSet.clear();
-		std::cout << "\n[Enemy] " << e->GetGameObject()->Name << " Calculated Path to Patrol Point " << e->pIndex << " (" << patrolPos.x << ", " << patrolPos.y << ", " << patrolPos.z << ")";
-		e->pathSet = e->pathManager->Get<pathfindingManager>()->requestPath(enemyPos, patrolPos);
-
-		//This if statement runs if a path could not be found
-		if (e->pathSet[0] == glm::vec3(69420.0f, 69420.0f, 69420.0f))
-		{
-			//Hmm I wonder what should happen if the enemy can't find a path while patrolling? 
-			//This isn't something that should ever happen in this state, or level though.
-			//It should prob just switch index and go towards the next patrol point
-		}
-
-		e->nIndex = e->pathSet.size() - 1;
+		LOG_TRACE("[Enemy] {} requested path to patrol point {} ({}, {}, {})", e->GetGameObject()->Name, e->pIndex, patrolPos.x, patrolPos.y, patrolPos.z);
+		e->RequestPath(patrolPos);
 		e->pathRequested = true;
 	}
 
+	//This if statement runs if a path could not be found
+	Navigation::PathStatus status;
+	if (e->PollPath(status) && status != Navigation::PathStatus::Success)
+	{
+		//This isn't something that should ever happen in this state, or level though.
+		//Skip to the next patrol point, and try again next frame
+		e->nIndex = 0;
+		SwitchIndex(e);
+		return;
+	}
+
+	if (e->pathSet.empty())
+		return;
+
 	e->target = e->pathSet[e->nIndex];
 
 	if (glm::length(e->GetGameObject()->GetPosition() - e->pathSet[e->nIndex]) < 3.f) //3
@@ -29,6 +29,7 @@ namespace Gameplay {
 		_worldTransform(MAT4_IDENTITY),
 		_inverseWorldTransform(MAT4_IDENTITY),
 		_isWorldTransformDirty(true),
+		_transformVersion(0),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>())
 	{ }
@@ -112,8 +113,13 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetPostion(const glm::vec3& position) {
+		// Writing back the same value isn't a move, so it shouldn't make physics re-sync us
+		if (position == _position) {
+			return;
+		}
 		_position = position;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
@@ -121,8 +127,13 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetRotation(const glm::quat& value) {
+		// Writing back the same value isn't a move, so it shouldn't make physics re-sync us
+		if (value == _rotation) {
+			return;
+		}
 		_rotation = value;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
@@ -130,8 +141,7 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
-		_rotation = glm::quat(glm::radians(eulerAngles));
-		_isLocalTransformDirty = true;
+		SetRotation(glm::quat(glm::radians(eulerAngles)));
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
@@ -139,14 +149,23 @@ namespace Gameplay {
 	}
 
 	void GameObject::SetScale(const glm::vec3& value) {
+		// Writing back the same value isn't a move, so it shouldn't make physics re-sync us
+		if (value == _scale) {
+			return;
+		}
 		_scale = value;
 		_isLocalTransformDirty = true;
+		_transformVersion++;
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
 		return _scale;
 	}
 
+	uint32_t GameObject::GetTransformVersion() const {
+		return _transformVersion;
+	}
+
 	const glm::mat4& GameObject::GetTransform() const {
 		_RecalcWorldTransform();
 		return _worldTransform;
@@ -350,7 +369,10 @@ namespace Gameplay {
 			}
 
 			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f)) {
+				_isLocalTransformDirty = true;
+				_transformVersion++;
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
@@ -376,7 +398,10 @@ namespace Gameplay {
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f)) {
+				_isLocalTransformDirty = true;
+				_transformVersion++;
+			}
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
@@ -212,6 +212,11 @@ namespace Gameplay {
 		/// Gets the scaling factor for the game object
 		/// </summary>
 		const glm::vec3& GetScale() const;
+		/// <summary>
+		/// Gets a number that changes every time the object's position, rotation or scale is set,
+		/// so that systems mirroring the transform (ex: physics) can tell if it's been moved
+		/// </summary>
+		uint32_t GetTransformVersion() const;
 
 		/// <summary>
 		/// Gets or recalculates and gets the object's world transform
@@ -356,6 +361,9 @@ namespace Gameplay {
 		mutable glm::mat4 _inverseWorldTransform;
 		mutable bool _isWorldTransformDirty;
 
+		// Bumped whenever the position, rotation or scale is set
+		uint32_t _transformVersion;
+
 		// For the hierarchy
 		WeakRef _parent;
 		std::vector<WeakRef> _children;
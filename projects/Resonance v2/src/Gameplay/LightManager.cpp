@@ -0,0 +1,165 @@
+#include "Gameplay/LightManager.h"
+
+#include <algorithm>
+
+namespace Gameplay {
+	static float DistanceSq(const glm::vec3& a, const glm::vec3& b) {
+		const glm::vec3 delta = a - b;
+		return glm::dot(delta, delta);
+	}
+
+	LightManager::LightManager() :
+		_settings(),
+		_pool(),
+		_free(),
+		_skippedCount(0),
+		_candidates(),
+		_merged(),
+		_result()
+	{ }
+
+	uint32_t LightManager::Allocate() {
+		uint32_t handle;
+		if (!_free.empty()) {
+			handle = _free.back();
+			_free.pop_back();
+		} else {
+			handle = static_cast<uint32_t>(_pool.size());
+			_pool.emplace_back();
+		}
+		_pool[handle].Value = Light();
+		_pool[handle].IsAllocated = true;
+		return handle;
+	}
+
+	void LightManager::Release(uint32_t handle) {
+		if (handle == NO_LIGHT || handle >= _pool.size() || !_pool[handle].IsAllocated) {
+			return;
+		}
+		_pool[handle].IsAllocated = false;
+		_free.push_back(handle);
+	}
+
+	float LightManager::GetImportance(const Light& light) {
+		// Some lights use a negative range for a sharper falloff, they reach just as far
+		const float brightness = glm::max(light.Color.r, glm::max(light.Color.g, light.Color.b));
+		return glm::abs(light.Range) * glm::max(brightness, 0.0f);
+	}
+
+	const std::vector<Light>& LightManager::Collect(const std::vector<Light>& sceneLights, int maxLights, const glm::mat4* viewProjection) {
+		_candidates.clear();
+		_skippedCount = 0;
+
+		// Pull the view frustum planes out of the view projection, normals point inwards
+		glm::vec4 planes[6];
+		if (viewProjection != nullptr) {
+			const glm::mat4& m = *viewProjection;
+			const glm::vec4 rowX(m[0][0], m[1][0], m[2][0], m[3][0]);
+			const glm::vec4 rowY(m[0][1], m[1][1], m[2][1], m[3][1]);
+			const glm::vec4 rowZ(m[0][2], m[1][2], m[2][2], m[3][2]);
+			const glm::vec4 rowW(m[0][3], m[1][3], m[2][3], m[3][3]);
+			planes[0] = rowW + rowX;
+			planes[1] = rowW - rowX;
+			planes[2] = rowW + rowY;
+			planes[3] = rowW - rowY;
+			planes[4] = rowW + rowZ;
+			planes[5] = rowW - rowZ;
+			for (glm::vec4& plane : planes) {
+				plane /= glm::length(glm::vec3(plane));
+			}
+		}
+
+		for (size_t ix = 0; ix < sceneLights.size(); ix++) {
+			_AddCandidate(sceneLights[ix], static_cast<uint32_t>(ix), viewProjection != nullptr ? planes : nullptr);
+		}
+		for (size_t ix = 0; ix < _pool.size(); ix++) {
+			if (_pool[ix].IsAllocated) {
+				_AddCandidate(_pool[ix].Value, static_cast<uint32_t>(sceneLights.size() + ix), viewProjection != nullptr ? planes : nullptr);
+			}
+		}
+
+		// Fold dim lights into the first dim light near them. The merged light sits at the importance weighted
+		// center of the group, with all of their color and the longest range
+		const float mergeRadiusSq = _settings.MergeRadius * _settings.MergeRadius;
+		_merged.assign(_candidates.size(), 0);
+		for (size_t ix = 0; ix < _candidates.size(); ix++) {
+			Candidate& seed = _candidates[ix];
+			if (_merged[ix] || seed.Importance >= _settings.MergeThreshold) {
+				continue;
+			}
+			const bool isNegative = seed.Value.Range < 0.0f;
+			glm::vec3 center = seed.Value.Position * seed.Importance;
+			glm::vec3 color = seed.Value.Color;
+			float range = glm::abs(seed.Value.Range);
+			float weight = seed.Importance;
+			bool hasMerged = false;
+
+			for (size_t other = ix + 1; other < _candidates.size(); other++) {
+				const Candidate& candidate = _candidates[other];
+				if (_merged[other] || candidate.Importance >= _settings.MergeThreshold || (candidate.Value.Range < 0.0f) != isNegative ||
+					DistanceSq(seed.Value.Position, candidate.Value.Position) > mergeRadiusSq) {
+					continue;
+				}
+				center += candidate.Value.Position * candidate.Importance;
+				color += candidate.Value.Color;
+				range = glm::max(range, glm::abs(candidate.Value.Range));
+				weight += candidate.Importance;
+				_merged[other] = 1;
+				_skippedCount++;
+				hasMerged = true;
+			}
+
+			if (hasMerged) {
+				seed.Value.Position = center / weight;
+				seed.Value.Color = color;
+				seed.Value.Range = isNegative ? -range : range;
+				seed.Importance = GetImportance(seed.Value);
+			}
+		}
+
+		size_t count = 0;
+		for (size_t ix = 0; ix < _candidates.size(); ix++) {
+			if (!_merged[ix]) {
+				_candidates[count++] = _candidates[ix];
+			}
+		}
+		_candidates.resize(count);
+
+		// Only the most important lights fit, but we still send them in their usual order
+		const size_t limit = static_cast<size_t>(glm::max(maxLights, 0));
+		if (_candidates.size() > limit) {
+			std::nth_element(_candidates.begin(), _candidates.begin() + limit, _candidates.end(), [](const Candidate& a, const Candidate& b) {
+				return a.Importance > b.Importance;
+			});
+			_skippedCount += static_cast<uint32_t>(_candidates.size() - limit);
+			_candidates.resize(limit);
+			std::sort(_candidates.begin(), _candidates.end(), [](const Candidate& a, const Candidate& b) {
+				return a.Order < b.Order;
+			});
+		}
+
+		_result.clear();
+		for (const Candidate& candidate : _candidates) {
+			_result.push_back(candidate.Value);
+		}
+		return _result;
+	}
+
+	void LightManager::_AddCandidate(const Light& light, uint32_t order, const glm::vec4* planes) {
+		const float importance = GetImportance(light);
+		if (importance < _settings.CullThreshold) {
+			_skippedCount++;
+			return;
+		}
+		if (planes != nullptr) {
+			const float radius = glm::abs(light.Range);
+			for (int ix = 0; ix < 6; ix++) {
+				if (glm::dot(glm::vec3(planes[ix]), light.Position) + planes[ix].w < -radius) {
+					_skippedCount++;
+					return;
+				}
+			}
+		}
+		_candidates.push_back({ light, importance, order });
+	}
+}
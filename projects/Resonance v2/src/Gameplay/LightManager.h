@@ -0,0 +1,98 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Light.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Hands out pooled light slots to gameplay code (ex: the rings around sound emmiters and enemies), and picks
+	/// which lights actually get sent to the shaders each frame
+	///
+	/// Lights that are too dim or too small to matter (range times brightness), or that can't reach the camera's
+	/// view, are dropped. Dim lights that are close together are merged into a single light, and if there are
+	/// still too many the least important ones are dropped. The lights that are kept stay in the same order from
+	/// frame to frame, so the light buffer only changes where the lights themselves have changed
+	/// </summary>
+	class LightManager {
+	public:
+		// A light handle that never refers to a light
+		static constexpr uint32_t NO_LIGHT = ~0u;
+
+		struct Settings {
+			// Lights with a range times brightness below this are dropped
+			float CullThreshold = 0.01f;
+			// Lights with a range times brightness below this can be merged with the dim lights around them
+			float MergeThreshold = 0.25f;
+			// How close dim lights have to be to be merged
+			float MergeRadius = 2.0f;
+		};
+
+		LightManager();
+		~LightManager() = default;
+
+		/// <summary>
+		/// Takes a light from the pool, re-using a released one if there is one
+		/// </summary>
+		/// <returns>The handle of the light</returns>
+		uint32_t Allocate();
+		/// <summary>
+		/// Puts a light back in the pool, does nothing for NO_LIGHT
+		/// </summary>
+		void Release(uint32_t handle);
+		/// <summary>
+		/// Gets a light that was allocated from the pool, the reference is only good until the next Allocate
+		/// </summary>
+		Light& Get(uint32_t handle) { return _pool[handle].Value; }
+
+		/// <summary>
+		/// Works out which lights will be sent to the shaders this frame
+		/// </summary>
+		/// <param name="sceneLights">The lights that are saved with the scene</param>
+		/// <param name="maxLights">The most lights the shaders can take</param>
+		/// <param name="viewProjection">The camera's view projection, lights that can't reach it's view are dropped. Can be nullptr</param>
+		/// <returns>The lights to send, in a stable order</returns>
+		const std::vector<Light>& Collect(const std::vector<Light>& sceneLights, int maxLights, const glm::mat4* viewProjection);
+
+		/// <summary>
+		/// Gets how much a light contributes, it's range times the brightness of it's brightest channel
+		/// </summary>
+		static float GetImportance(const Light& light);
+
+		Settings& GetSettings() { return _settings; }
+		/// <summary>
+		/// Gets the number of lights that are allocated from the pool
+		/// </summary>
+		size_t GetAllocatedCount() const { return _pool.size() - _free.size(); }
+		/// <summary>
+		/// Gets the number of lights that were dropped or merged away in the last Collect
+		/// </summary>
+		uint32_t GetSkippedCount() const { return _skippedCount; }
+
+	protected:
+		struct Slot {
+			Light Value;
+			bool  IsAllocated = false;
+		};
+		// A light that made it past culling, waiting to be merged or sent
+		struct Candidate {
+			Light    Value;
+			float    Importance;
+			// Where the light came from, so the lights we send keep the same order between frames
+			uint32_t Order;
+		};
+
+		Settings              _settings;
+		std::vector<Slot>     _pool;
+		std::vector<uint32_t> _free;
+		uint32_t              _skippedCount;
+
+		// Re-used between frames
+		std::vector<Candidate> _candidates;
+		std::vector<uint8_t>   _merged;
+		std::vector<Light>     _result;
+
+		void _AddCandidate(const Light& light, uint32_t order, const glm::vec4* planes);
+	};
+}
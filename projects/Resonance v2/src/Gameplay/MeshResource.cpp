@@ -2,6 +2,10 @@
 #include <filesystem>
 
 #include "Utils/ObjLoader.h"
+#include "Utils/GltfLoader.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/StringUtils.h"
+#include "Gameplay/Physics/CollisionCooker.h"
 
 namespace Gameplay {
 	MeshResource::MeshResource() :
@@ -9,7 +13,7 @@ namespace Gameplay {
 		Filename(""),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		ConvexHull()
 	{ }
 
 	MeshResource::MeshResource(const std::string& filename) :
@@ -17,9 +21,9 @@ namespace Gameplay {
 		Filename(filename),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		ConvexHull()
 	{
-		Mesh = ObjLoader::LoadFromFile(filename);
+		Mesh = _LoadFromFile(filename);
 	}
 
 	MeshResource::~MeshResource() = default;
@@ -54,18 +58,24 @@ namespace Gameplay {
 			result->Mesh = mesh.Bake();
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
-			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
-				#ifdef OPTIMIZED_OBJ_LOADER
-				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
-				#else
-				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
-				#endif
-
+			if (result->Filename != "null" && FileHelpers::Exists(result->Filename)) {
+				result->Mesh = _LoadFromFile(result->Filename);
 			}
 		}
 		return result;
 	}
 
+	VertexArrayObject::Sptr MeshResource::_LoadFromFile(const std::string& filename) {
+		if (GltfLoader::IsGltfFile(filename)) {
+			return GltfLoader::LoadFromFile(filename);
+		}
+		#ifdef OPTIMIZED_OBJ_LOADER
+		return OptimizedObjLoader::LoadFromFile(filename);
+		#else
+		return ObjLoader::LoadFromFile(filename);
+		#endif
+	}
+
 	void MeshResource::GenerateMesh() {
 		MeshBuilder<VertexPosNormTexColTangents> mesh;
 		for (auto& param : MeshBuilderParams) {
@@ -78,4 +88,79 @@ namespace Gameplay {
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
 		MeshBuilderParams.push_back(param);
 	}
+
+	bool MeshResource::CookConvexHull() {
+		// We've already cooked or loaded the hull, use existing
+		if (!ConvexHull.empty()) {
+			return true;
+		}
+
+		// Generated meshes have no file to cache next to, but they're cheap to rebuild
+		bool isFileMesh = MeshBuilderParams.empty() && !Filename.empty() && Filename != "null";
+		std::string hullPath = isFileMesh ? Physics::CollisionCooker::GetHullPath(Filename) : "";
+		if (isFileMesh && FileHelpers::Exists(hullPath) && Physics::CollisionCooker::LoadHull(hullPath, Filename, ConvexHull)) {
+			return true;
+		}
+
+		std::vector<glm::vec3> positions;
+		if (!_GatherPositions(positions) || !Physics::CollisionCooker::CookConvexHull(positions, ConvexHull)) {
+			LOG_WARN("Failed to cook collision hull for mesh \"{}\"", Filename);
+			return false;
+		}
+
+		if (isFileMesh) {
+			Physics::CollisionCooker::SaveHull(hullPath, Filename, ConvexHull);
+		}
+		return true;
+	}
+
+	bool MeshResource::_GatherPositions(std::vector<glm::vec3>& outPositions) const {
+		outPositions.clear();
+
+		// Rebuild generated meshes on the CPU, we only need the positions so skip the TBN
+		if (!MeshBuilderParams.empty()) {
+			MeshBuilder<VertexPosNormTexColTangents> mesh;
+			for (const auto& param : MeshBuilderParams) {
+				MeshFactory::AddParameterized(mesh, param);
+			}
+			outPositions.reserve(mesh.GetVertexCount());
+			for (size_t ix = 0; ix < mesh.GetVertexCount(); ix++) {
+				outPositions.push_back(mesh.GetVertexDataPtr()[ix].Position);
+			}
+			return true;
+		}
+
+		if (GltfLoader::IsGltfFile(Filename)) {
+			MeshBuilder<VertexPosNormTexColTangents> mesh;
+			if (!GltfLoader::LoadMesh(Filename, mesh)) {
+				return false;
+			}
+			outPositions.reserve(mesh.GetVertexCount());
+			for (size_t ix = 0; ix < mesh.GetVertexCount(); ix++) {
+				outPositions.push_back(mesh.GetVertexDataPtr()[ix].Position);
+			}
+			return true;
+		}
+
+		// For OBJ files the hull only depends on the positions, so we only need to read the v lines
+		std::string extension = std::filesystem::path(Filename).extension().string();
+		StringTools::ToLower(extension);
+		if (extension == ".obj") {
+			std::string contents = FileHelpers::ReadFile(Filename);
+			std::stringstream stream = std::stringstream(contents);
+			std::string line;
+			while (std::getline(stream, line)) {
+				if (line.size() > 2 && line[0] == 'v' && (line[1] == ' ' || line[1] == '\t')) {
+					glm::vec3 pos = glm::vec3(0.0f);
+					std::stringstream lineStream = std::stringstream(line.substr(2));
+					lineStream >> pos.x >> pos.y >> pos.z;
+					outPositions.push_back(pos);
+				}
+			}
+			return !outPositions.empty();
+		}
+
+		LOG_WARN("Cannot gather collision positions from \"{}\"", Filename);
+		return false;
+	}
 }
\ No newline at end of file
@@ -3,9 +3,6 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Utils/MeshFactory.h"
 
-// bullet triangle mesh pre-declaration
-class btTriangleMesh;
-
 namespace Gameplay {
 	/// <summary>
 	/// A mesh resource contains information on how to generate a VAO at runtime
@@ -47,9 +44,9 @@ namespace Gameplay {
 		/// </summary>
 		MeshResource::Sptr             ColliderMeshData;
 		/// <summary>
-		/// Allows for bullet to generate a triangle mesh from this mesh and cache it
+		/// The cooked convex hull of this mesh, empty until CookConvexHull is called
 		/// </summary>
-		std::shared_ptr<btTriangleMesh> BulletTriMesh;
+		std::vector<glm::vec3>          ConvexHull;
 
 		/// <summary>
 		/// Generates a new mesh from the mesh builder parameters
@@ -61,9 +58,31 @@ namespace Gameplay {
 		/// <param name="param">The parameter to add</param>
 		void AddParam(const MeshBuilderParam& param);
 
+		/// <summary>
+		/// Ensures that ConvexHull is populated. Hulls for file meshes are loaded from the collision cache
+		/// next to the file if it exists, otherwise the hull is cooked from the mesh's CPU-side source data
+		/// and stored in the cache for next time. This never reads anything back from the GPU
+		/// </summary>
+		/// <returns>True if the hull is available, false if otherwise</returns>
+		bool CookConvexHull();
+
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
 		static MeshResource::Sptr FromJson(const nlohmann::json& blob);
+
+	protected:
+		/// <summary>
+		/// Loads a VAO from a model file, selecting the loader based on the file's extension
+		/// </summary>
+		/// <param name="filename">The path to the .obj, .gltf or .glb file to load</param>
+		static VertexArrayObject::Sptr _LoadFromFile(const std::string& filename);
+		/// <summary>
+		/// Gathers the vertex positions of this mesh on the CPU, either by re-running the mesh builder
+		/// parameters, or by reading the positions from the source file
+		/// </summary>
+		/// <param name="outPositions">Will store the vertex positions</param>
+		/// <returns>True if the positions were gathered, false if otherwise</returns>
+		bool _GatherPositions(std::vector<glm::vec3>& outPositions) const;
 	};
 }
\ No newline at end of file
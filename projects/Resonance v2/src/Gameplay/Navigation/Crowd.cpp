@@ -0,0 +1,334 @@
+#include "Gameplay/Navigation/Crowd.h"
+
+#include <algorithm>
+
+namespace Gameplay::Navigation {
+	// Anything smaller than this is treated as parallel, or as zero length
+	static constexpr float CROWD_EPSILON = 0.00001f;
+
+	// The 2D cross product, positive if b is counter-clockwise from a
+	inline float Det(const glm::vec2& a, const glm::vec2& b) {
+		return a.x * b.y - a.y * b.x;
+	}
+
+	Crowd::Crowd() :
+		_agents(),
+		_freeAgents(),
+		_agentCellSize(1.0f),
+		_agentCells(),
+		_obstacles(),
+		_obstacleCellSize(4.0f),
+		_obstacleCells(),
+		_queryStamp(0),
+		_lines(),
+		_projectedLines(),
+		_neighbors()
+	{ }
+
+	uint64_t Crowd::_CellKey(int x, int y) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+	}
+
+	glm::ivec2 Crowd::_GetCell(const glm::vec2& position, float cellSize) {
+		return glm::ivec2(glm::floor(position / cellSize));
+	}
+
+	uint32_t Crowd::AddAgent(const AgentSettings& settings, const glm::vec3& position) {
+		Agent agent;
+		agent.Settings = settings;
+		agent.Position = glm::vec2(position);
+		agent.Velocity = glm::vec2(0.0f);
+		agent.IsActive = true;
+		if (!_freeAgents.empty()) {
+			const uint32_t index = _freeAgents.back();
+			_freeAgents.pop_back();
+			_agents[index] = agent;
+			return index;
+		}
+		_agents.push_back(agent);
+		return static_cast<uint32_t>(_agents.size() - 1);
+	}
+
+	void Crowd::RemoveAgent(uint32_t agent) {
+		if (agent >= _agents.size() || !_agents[agent].IsActive) {
+			return;
+		}
+		// The agent stays in the grid until the next Update, queries skip it until then
+		_agents[agent].IsActive = false;
+		_freeAgents.push_back(agent);
+	}
+
+	void Crowd::SetAgentState(uint32_t agent, const glm::vec3& position, const glm::vec3& velocity) {
+		_agents[agent].Position = glm::vec2(position);
+		_agents[agent].Velocity = glm::vec2(velocity);
+	}
+
+	void Crowd::SetObstacles(const std::vector<glm::vec3>& edges) {
+		_obstacles.clear();
+		_obstacleCells.clear();
+		for (size_t ix = 0; ix + 1 < edges.size(); ix += 2) {
+			Obstacle obstacle;
+			obstacle.A = glm::vec2(edges[ix]);
+			obstacle.B = glm::vec2(edges[ix + 1]);
+			obstacle.QueryStamp = 0;
+
+			// Walls go in every cell their bounds touch, so a query only has to look at the cells around it
+			const uint32_t index = static_cast<uint32_t>(_obstacles.size());
+			glm::ivec2 min = _GetCell(glm::min(obstacle.A, obstacle.B), _obstacleCellSize);
+			glm::ivec2 max = _GetCell(glm::max(obstacle.A, obstacle.B), _obstacleCellSize);
+			for (int y = min.y; y <= max.y; y++) {
+				for (int x = min.x; x <= max.x; x++) {
+					_obstacleCells[_CellKey(x, y)].push_back(index);
+				}
+			}
+			_obstacles.push_back(obstacle);
+		}
+	}
+
+	void Crowd::Update() {
+		// Cells are as big as the largest neighbor distance, so neighbors are always in the surrounding 3x3 cells
+		_agentCellSize = 1.0f;
+		for (const Agent& agent : _agents) {
+			if (agent.IsActive) {
+				_agentCellSize = glm::max(_agentCellSize, agent.Settings.NeighborDistance);
+			}
+		}
+
+		for (auto& [key, bucket] : _agentCells) {
+			bucket.clear();
+		}
+		for (uint32_t ix = 0; ix < _agents.size(); ix++) {
+			if (!_agents[ix].IsActive) {
+				continue;
+			}
+			glm::ivec2 cell = _GetCell(_agents[ix].Position, _agentCellSize);
+			_agentCells[_CellKey(cell.x, cell.y)].push_back(ix);
+		}
+	}
+
+	glm::vec3 Crowd::ComputeVelocity(uint32_t agentIndex, const glm::vec3& preferredVelocity, float maxSpeed, float dt) {
+		const Agent& agent = _agents[agentIndex];
+		const AgentSettings& settings = agent.Settings;
+		dt = glm::max(dt, CROWD_EPSILON);
+		_lines.clear();
+
+		// Walls, treating the closest point on each one as a point obstacle that doesn't move out of our way
+		const float obstacleRange = settings.ObstacleTimeHorizon * maxSpeed + settings.Radius;
+		const float invObstacleTimeHorizon = 1.0f / settings.ObstacleTimeHorizon;
+		_queryStamp++;
+		glm::ivec2 min = _GetCell(agent.Position - glm::vec2(obstacleRange), _obstacleCellSize);
+		glm::ivec2 max = _GetCell(agent.Position + glm::vec2(obstacleRange), _obstacleCellSize);
+		for (int y = min.y; y <= max.y && !_obstacles.empty(); y++) {
+			for (int x = min.x; x <= max.x; x++) {
+				auto it = _obstacleCells.find(_CellKey(x, y));
+				if (it == _obstacleCells.end()) {
+					continue;
+				}
+				for (uint32_t ix : it->second) {
+					Obstacle& obstacle = _obstacles[ix];
+					if (obstacle.QueryStamp == _queryStamp) {
+						continue;
+					}
+					obstacle.QueryStamp = _queryStamp;
+
+					const glm::vec2 edge = obstacle.B - obstacle.A;
+					const float lengthSq = glm::dot(edge, edge);
+					float t = lengthSq > CROWD_EPSILON ? glm::clamp(glm::dot(agent.Position - obstacle.A, edge) / lengthSq, 0.0f, 1.0f) : 0.0f;
+					const glm::vec2 relativePosition = obstacle.A + edge * t - agent.Position;
+					if (glm::dot(relativePosition, relativePosition) > obstacleRange * obstacleRange) {
+						continue;
+					}
+					_AddLine(agent, relativePosition, agent.Velocity, settings.Radius, invObstacleTimeHorizon, 1.0f, dt);
+				}
+			}
+		}
+		const size_t numObstacleLines = _lines.size();
+
+		// Other agents, only the closest few are considered
+		_neighbors.clear();
+		const float neighborDistSq = settings.NeighborDistance * settings.NeighborDistance;
+		glm::ivec2 cell = _GetCell(agent.Position, _agentCellSize);
+		for (int y = cell.y - 1; y <= cell.y + 1; y++) {
+			for (int x = cell.x - 1; x <= cell.x + 1; x++) {
+				auto it = _agentCells.find(_CellKey(x, y));
+				if (it == _agentCells.end()) {
+					continue;
+				}
+				for (uint32_t ix : it->second) {
+					if (ix == agentIndex || !_agents[ix].IsActive) {
+						continue;
+					}
+					const glm::vec2 offset = _agents[ix].Position - agent.Position;
+					const float distSq = glm::dot(offset, offset);
+					if (distSq < neighborDistSq) {
+						_neighbors.push_back({ distSq, ix });
+					}
+				}
+			}
+		}
+		if (_neighbors.size() > static_cast<size_t>(settings.MaxNeighbors)) {
+			std::nth_element(_neighbors.begin(), _neighbors.begin() + settings.MaxNeighbors, _neighbors.end());
+			_neighbors.resize(settings.MaxNeighbors);
+		}
+
+		const float invTimeHorizon = 1.0f / settings.TimeHorizon;
+		for (const auto& [distSq, ix] : _neighbors) {
+			const Agent& other = _agents[ix];
+			_AddLine(agent, other.Position - agent.Position, agent.Velocity - other.Velocity, settings.Radius + other.Settings.Radius, invTimeHorizon, 0.5f, dt);
+		}
+
+		// Find the allowed velocity closest to the one we want, if it's impossible to satisfy every line
+		// we find the velocity that breaks them by the least amount instead
+		glm::vec2 result;
+		const size_t lineFail = _LinearProgram2(_lines, maxSpeed, glm::vec2(preferredVelocity), false, result);
+		if (lineFail < _lines.size()) {
+			_LinearProgram3(numObstacleLines, lineFail, maxSpeed, result);
+		}
+		return glm::vec3(result, preferredVelocity.z);
+	}
+
+	void Crowd::_AddLine(const Agent& agent, const glm::vec2& relativePosition, const glm::vec2& relativeVelocity, float combinedRadius, float invTimeHorizon, float responsibility, float dt) {
+		const float distSq = glm::dot(relativePosition, relativePosition);
+		const float combinedRadiusSq = combinedRadius * combinedRadius;
+
+		Line line;
+		glm::vec2 u;
+		if (distSq > combinedRadiusSq) {
+			// No collision yet, the velocity obstacle is a cone truncated by a circle at the time horizon
+			const glm::vec2 w = relativeVelocity - invTimeHorizon * relativePosition;
+			const float wLengthSq = glm::dot(w, w);
+			const float dotProduct = glm::dot(w, relativePosition);
+
+			if (dotProduct < 0.0f && dotProduct * dotProduct > combinedRadiusSq * wLengthSq) {
+				// Closest to the circle at the end of the cone
+				const float wLength = glm::sqrt(wLengthSq);
+				const glm::vec2 unitW = w / wLength;
+				line.Direction = glm::vec2(unitW.y, -unitW.x);
+				u = (combinedRadius * invTimeHorizon - wLength) * unitW;
+			} else {
+				// Closest to one of the legs of the cone
+				const float leg = glm::sqrt(distSq - combinedRadiusSq);
+				if (Det(relativePosition, w) > 0.0f) {
+					line.Direction = glm::vec2(relativePosition.x * leg - relativePosition.y * combinedRadius, relativePosition.x * combinedRadius + relativePosition.y * leg) / distSq;
+				} else {
+					line.Direction = -glm::vec2(relativePosition.x * leg + relativePosition.y * combinedRadius, -relativePosition.x * combinedRadius + relativePosition.y * leg) / distSq;
+				}
+				u = glm::dot(relativeVelocity, line.Direction) * line.Direction - relativeVelocity;
+			}
+		} else {
+			// Already overlapping, get apart within the next update
+			const float invTimeStep = 1.0f / dt;
+			const glm::vec2 w = relativeVelocity - invTimeStep * relativePosition;
+			const float wLength = glm::length(w);
+			const glm::vec2 unitW = wLength > CROWD_EPSILON ? w / wLength : glm::vec2(-relativePosition.y, relativePosition.x);
+			line.Direction = glm::vec2(unitW.y, -unitW.x);
+			u = (combinedRadius * invTimeStep - wLength) * unitW;
+		}
+
+		line.Point = agent.Velocity + responsibility * u;
+		_lines.push_back(line);
+	}
+
+	bool Crowd::_LinearProgram1(const std::vector<Line>& lines, size_t lineNo, float radius, const glm::vec2& optVelocity, bool directionOpt, glm::vec2& result) {
+		const float dotProduct = glm::dot(lines[lineNo].Point, lines[lineNo].Direction);
+		const float discriminant = dotProduct * dotProduct + radius * radius - glm::dot(lines[lineNo].Point, lines[lineNo].Point);
+		if (discriminant < 0.0f) {
+			// The max speed circle doesn't reach this line
+			return false;
+		}
+
+		const float sqrtDiscriminant = glm::sqrt(discriminant);
+		float tLeft = -dotProduct - sqrtDiscriminant;
+		float tRight = -dotProduct + sqrtDiscriminant;
+
+		for (size_t ix = 0; ix < lineNo; ix++) {
+			const float denominator = Det(lines[lineNo].Direction, lines[ix].Direction);
+			const float numerator = Det(lines[ix].Direction, lines[lineNo].Point - lines[ix].Point);
+
+			if (glm::abs(denominator) <= CROWD_EPSILON) {
+				// Parallel lines, either this one is entirely outside the other or the other doesn't limit it
+				if (numerator < 0.0f) {
+					return false;
+				}
+				continue;
+			}
+
+			const float t = numerator / denominator;
+			if (denominator >= 0.0f) {
+				tRight = glm::min(tRight, t);
+			} else {
+				tLeft = glm::max(tLeft, t);
+			}
+			if (tLeft > tRight) {
+				return false;
+			}
+		}
+
+		if (directionOpt) {
+			result = lines[lineNo].Point + (glm::dot(optVelocity, lines[lineNo].Direction) > 0.0f ? tRight : tLeft) * lines[lineNo].Direction;
+		} else {
+			const float t = glm::clamp(glm::dot(lines[lineNo].Direction, optVelocity - lines[lineNo].Point), tLeft, tRight);
+			result = lines[lineNo].Point + t * lines[lineNo].Direction;
+		}
+		return true;
+	}
+
+	size_t Crowd::_LinearProgram2(const std::vector<Line>& lines, float radius, const glm::vec2& optVelocity, bool directionOpt, glm::vec2& result) {
+		if (directionOpt) {
+			// The optimal velocity is a unit direction, we want to go as far as we can that way
+			result = optVelocity * radius;
+		} else if (glm::dot(optVelocity, optVelocity) > radius * radius) {
+			result = glm::normalize(optVelocity) * radius;
+		} else {
+			result = optVelocity;
+		}
+
+		for (size_t ix = 0; ix < lines.size(); ix++) {
+			if (Det(lines[ix].Direction, lines[ix].Point - result) > 0.0f) {
+				// The result breaks this line, move it onto the line
+				const glm::vec2 lastResult = result;
+				if (!_LinearProgram1(lines, ix, radius, optVelocity, directionOpt, result)) {
+					result = lastResult;
+					return ix;
+				}
+			}
+		}
+		return lines.size();
+	}
+
+	void Crowd::_LinearProgram3(size_t numObstacleLines, size_t beginLine, float radius, glm::vec2& result) {
+		float distance = 0.0f;
+
+		for (size_t ix = beginLine; ix < _lines.size(); ix++) {
+			if (Det(_lines[ix].Direction, _lines[ix].Point - result) <= distance) {
+				continue;
+			}
+
+			// Walls can never be broken, other agents' lines are relaxed to be as close to this one as possible
+			_projectedLines.assign(_lines.begin(), _lines.begin() + numObstacleLines);
+			for (size_t jx = numObstacleLines; jx < ix; jx++) {
+				Line line;
+				const float determinant = Det(_lines[ix].Direction, _lines[jx].Direction);
+				if (glm::abs(determinant) <= CROWD_EPSILON) {
+					if (glm::dot(_lines[ix].Direction, _lines[jx].Direction) > 0.0f) {
+						// Pointing the same way, the other line doesn't change anything
+						continue;
+					}
+					line.Point = 0.5f * (_lines[ix].Point + _lines[jx].Point);
+				} else {
+					line.Point = _lines[ix].Point + (Det(_lines[jx].Direction, _lines[ix].Point - _lines[jx].Point) / determinant) * _lines[ix].Direction;
+				}
+				line.Direction = glm::normalize(_lines[jx].Direction - _lines[ix].Direction);
+				_projectedLines.push_back(line);
+			}
+
+			const glm::vec2 lastResult = result;
+			if (_LinearProgram2(_projectedLines, radius, glm::vec2(-_lines[ix].Direction.y, _lines[ix].Direction.x), true, result) < _projectedLines.size()) {
+				// This should in principle not happen, the result is by definition already in the feasible region
+				// of this linear program. If it does it's a floating point error, so we keep the last result
+				result = lastResult;
+			}
+			distance = Det(_lines[ix].Direction, _lines[ix].Point - result);
+		}
+	}
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Utils/Macros.h"
+
+namespace Gameplay::Navigation {
+	/// <summary>
+	/// Local steering for groups of agents, using optimal reciprocal collision avoidance (ORCA)
+	///
+	/// Each agent's velocity is limited by a set of half-planes, one for each nearby agent (where both agents take half
+	/// the responsibility for avoiding each other) and one for the closest point on each nearby wall. We then pick the
+	/// allowed velocity closest to the one the agent wants with a small linear program. Avoidance is done on the XY
+	/// plane only, and walls are usually the boundary edges of a navmesh
+	/// </summary>
+	class Crowd {
+	public:
+		MAKE_PTRS(Crowd);
+
+		// An agent index that never refers to an agent
+		static constexpr uint32_t NO_AGENT = ~0u;
+
+		struct AgentSettings {
+			float Radius = 1.0f;
+			// How far away other agents can be and still be avoided
+			float NeighborDistance = 10.0f;
+			// The most agents that will be avoided at once, the closest ones are picked
+			int   MaxNeighbors = 10;
+			// How many seconds ahead we look for collisions with other agents, and with walls
+			float TimeHorizon = 2.0f;
+			float ObstacleTimeHorizon = 1.0f;
+		};
+
+		Crowd();
+		~Crowd() = default;
+
+		/// <summary>
+		/// Adds an agent to the crowd
+		/// </summary>
+		/// <returns>The index of the new agent</returns>
+		uint32_t AddAgent(const AgentSettings& settings, const glm::vec3& position);
+		/// <summary>
+		/// Removes an agent from the crowd, so others stop avoiding it. It's index may be handed out again by AddAgent
+		/// </summary>
+		/// <param name="agent">The index of the agent, does nothing if it's NO_AGENT or already removed</param>
+		void RemoveAgent(uint32_t agent);
+		/// <summary>
+		/// Updates where an agent is and how fast it is moving, should be called every frame after the agent moves
+		/// </summary>
+		void SetAgentState(uint32_t agent, const glm::vec3& position, const glm::vec3& velocity);
+		/// <summary>
+		/// Gets the number of agents in the crowd
+		/// </summary>
+		size_t GetAgentCount() const { return _agents.size() - _freeAgents.size(); }
+
+		/// <summary>
+		/// Replaces the walls that agents will avoid
+		/// </summary>
+		/// <param name="edges">The end points of each wall, two points per wall (ex: from NavMesh::GetBoundaryEdges)</param>
+		void SetObstacles(const std::vector<glm::vec3>& edges);
+		/// <summary>
+		/// Gets whether there are any walls for agents to avoid
+		/// </summary>
+		bool HasObstacles() const { return !_obstacles.empty(); }
+
+		/// <summary>
+		/// Rebuilds the grid used to find nearby agents, should be called once a frame
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Finds the velocity closest to the one an agent wants that won't run it into other agents or walls
+		/// </summary>
+		/// <param name="agent">The index of the agent</param>
+		/// <param name="preferredVelocity">The velocity the agent would like to move at</param>
+		/// <param name="maxSpeed">The fastest the agent can move</param>
+		/// <param name="dt">The time in seconds until the agent's next update</param>
+		/// <returns>The collision free velocity, with the same Z as the preferred velocity</returns>
+		glm::vec3 ComputeVelocity(uint32_t agent, const glm::vec3& preferredVelocity, float maxSpeed, float dt);
+
+	protected:
+		struct Agent {
+			AgentSettings Settings;
+			glm::vec2     Position;
+			glm::vec2     Velocity;
+			// Removed agents keep their slot so other indices stay the same, until it's re-used
+			bool          IsActive;
+		};
+
+		struct Obstacle {
+			glm::vec2 A;
+			glm::vec2 B;
+			// The last query that looked at this obstacle, so it's only considered once per query
+			uint32_t  QueryStamp;
+		};
+
+		// A half-plane of allowed velocities, everything to the left of the directed line is allowed
+		struct Line {
+			glm::vec2 Point;
+			glm::vec2 Direction;
+		};
+
+		std::vector<Agent>    _agents;
+		std::vector<uint32_t> _freeAgents;
+		float                 _agentCellSize;
+		std::unordered_map<uint64_t, std::vector<uint32_t>> _agentCells;
+
+		std::vector<Obstacle> _obstacles;
+		float                 _obstacleCellSize;
+		std::unordered_map<uint64_t, std::vector<uint32_t>> _obstacleCells;
+		uint32_t              _queryStamp;
+
+		// Scratch space for ComputeVelocity
+		std::vector<Line>     _lines;
+		std::vector<Line>     _projectedLines;
+		std::vector<std::pair<float, uint32_t>> _neighbors;
+
+		static uint64_t _CellKey(int x, int y);
+		static glm::ivec2 _GetCell(const glm::vec2& position, float cellSize);
+
+		/// <summary>
+		/// Adds the half-plane of velocities that avoid a collision with something at the given relative position and velocity
+		/// </summary>
+		/// <param name="responsibility">How much of the avoidance this agent does, 0.5 for other agents and 1 for walls</param>
+		void _AddLine(const Agent& agent, const glm::vec2& relativePosition, const glm::vec2& relativeVelocity, float combinedRadius, float invTimeHorizon, float responsibility, float dt);
+
+		static bool _LinearProgram1(const std::vector<Line>& lines, size_t lineNo, float radius, const glm::vec2& optVelocity, bool directionOpt, glm::vec2& result);
+		static size_t _LinearProgram2(const std::vector<Line>& lines, float radius, const glm::vec2& optVelocity, bool directionOpt, glm::vec2& result);
+		void _LinearProgram3(size_t numObstacleLines, size_t beginLine, float radius, glm::vec2& result);
+	};
+}
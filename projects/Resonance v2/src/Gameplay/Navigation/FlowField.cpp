@@ -0,0 +1,113 @@
+#include "Gameplay/Navigation/FlowField.h"
+#include "Gameplay/Navigation/NavMesh.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace Gameplay::Navigation {
+	FlowField::FlowField() :
+		_graph(nullptr),
+		_targetNode(NavGraph::NO_NODE),
+		_next(),
+		_distance(),
+		_open(),
+		_corridor(),
+		_corners()
+	{ }
+
+	void FlowField::Build(const NavGraph& graph, uint32_t targetNode) {
+		const size_t nodeCount = graph.GetNodeCount();
+		_graph = &graph;
+		_next.assign(nodeCount, NavGraph::NO_NODE);
+		_distance.assign(nodeCount, std::numeric_limits<float>::infinity());
+		_targetNode = targetNode < nodeCount ? targetNode : NavGraph::NO_NODE;
+		if (_targetNode == NavGraph::NO_NODE) {
+			return;
+		}
+
+		// Dijkstra outwards from the target. Since edges go both ways, whichever node we reach another from
+		// is also it's next step back towards the target. The heap may hold stale entries for nodes that were
+		// improved after being pushed, which are skipped when popped
+		auto compare = std::greater<std::pair<float, uint32_t>>();
+		_open.clear();
+		_distance[_targetNode] = 0.0f;
+		_open.push_back({ 0.0f, _targetNode });
+
+		while (!_open.empty()) {
+			std::pop_heap(_open.begin(), _open.end(), compare);
+			std::pair<float, uint32_t> current = _open.back();
+			_open.pop_back();
+			if (current.first > _distance[current.second]) {
+				continue;
+			}
+
+			for (uint32_t edge = graph.GetEdgesBegin(current.second); edge < graph.GetEdgesEnd(current.second); edge++) {
+				uint32_t neighbor = graph.GetEdgeTarget(edge);
+				float distance = current.first + graph.GetEdgeCost(edge);
+				if (distance < _distance[neighbor]) {
+					_distance[neighbor] = distance;
+					_next[neighbor] = current.second;
+					_open.push_back({ distance, neighbor });
+					std::push_heap(_open.begin(), _open.end(), compare);
+				}
+			}
+		}
+	}
+
+	uint32_t FlowField::GetNextNode(uint32_t node) const {
+		return node < _next.size() ? _next[node] : NavGraph::NO_NODE;
+	}
+
+	float FlowField::GetDistance(uint32_t node) const {
+		return node < _distance.size() ? _distance[node] : std::numeric_limits<float>::infinity();
+	}
+
+	bool FlowField::GetSteeringTarget(const NavGraph& graph, const NavMesh* mesh, const glm::vec3& position, const glm::vec3& targetPos, glm::vec3& outTarget) {
+		// With a navmesh the field is over it's polygons, otherwise it's over the graph's nodes
+		const NavGraph& fieldGraph = mesh != nullptr ? mesh->GetGraph() : graph;
+		auto locate = [&](const glm::vec3& pos) {
+			return mesh != nullptr ? mesh->FindPolygon(pos) : fieldGraph.FindNearestNode(pos);
+		};
+
+		const uint32_t targetNode = locate(targetPos);
+		const uint32_t node = locate(position);
+		if (targetNode == NavGraph::NO_NODE || node == NavGraph::NO_NODE) {
+			return false;
+		}
+
+		if (_graph != &fieldGraph || _targetNode != targetNode) {
+			Build(fieldGraph, targetNode);
+		}
+
+		if (node == targetNode) {
+			outTarget = targetPos;
+			return true;
+		}
+
+		const uint32_t next = GetNextNode(node);
+		if (next == NavGraph::NO_NODE) {
+			return false;
+		}
+
+		if (mesh == nullptr) {
+			outTarget = fieldGraph.GetNodePosition(next);
+			return true;
+		}
+
+		// String pull through the next few polygons in the field, and head for the first corner
+		const size_t lookahead = 4;
+		_corridor.clear();
+		_corridor.push_back(node);
+		_corridor.push_back(next);
+		while (_corridor.size() < lookahead && _corridor.back() != targetNode) {
+			_corridor.push_back(GetNextNode(_corridor.back()));
+		}
+		const glm::vec3 goal = _corridor.back() == targetNode ? targetPos : mesh->GetPolygon(_corridor.back()).Center;
+
+		_corners.clear();
+		mesh->StringPull(position, goal, _corridor, _corners);
+		outTarget = _corners[1];
+		return true;
+	}
+}
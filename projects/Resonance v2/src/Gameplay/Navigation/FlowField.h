@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Navigation/NavGraph.h"
+#include "Utils/Macros.h"
+
+namespace Gameplay::Navigation {
+	class NavMesh;
+
+	/// <summary>
+	/// Stores the direction to a single target from every node in a NavGraph, so that any number of agents
+	/// can head to the same place without each running their own search
+	///
+	/// The field is built with one Dijkstra pass outwards from the target, and only needs to be rebuilt when
+	/// the target moves to a different node. Edges are treated as two-way, which holds for the graphs built by
+	/// the pathfindingManager and NavMeshBuilder
+	/// </summary>
+	class FlowField {
+	public:
+		MAKE_PTRS(FlowField);
+
+		FlowField();
+		~FlowField() = default;
+
+		/// <summary>
+		/// Rebuilds the field to lead towards the given node
+		/// </summary>
+		/// <param name="graph">The graph to build the field over, must stay alive while the field is used</param>
+		/// <param name="targetNode">The node that every other node should lead towards</param>
+		void Build(const NavGraph& graph, uint32_t targetNode);
+		/// <summary>
+		/// Forgets the target, so that the next GetSteeringTarget rebuilds the field. Used when the graph has changed
+		/// </summary>
+		void Invalidate() { _targetNode = NavGraph::NO_NODE; }
+
+		/// <summary>
+		/// Works out where an agent should head to follow the field towards a target, rebuilding the field first if
+		/// the target has moved to a different node. Over a navmesh the agent heads for the first corner of the
+		/// string pulled corridor through the next few polygons, since polygon centers make for wobbly steering.
+		/// Over a plain graph it heads for the next node
+		/// </summary>
+		/// <param name="graph">The graph to use if there is no navmesh</param>
+		/// <param name="mesh">The navmesh to use, or nullptr to use the graph</param>
+		/// <param name="position">The position of the agent</param>
+		/// <param name="targetPos">The position of the target</param>
+		/// <param name="outTarget">Will store the point the agent should head towards</param>
+		/// <returns>True if the target can be reached, false if otherwise</returns>
+		bool GetSteeringTarget(const NavGraph& graph, const NavMesh* mesh, const glm::vec3& position, const glm::vec3& targetPos, glm::vec3& outTarget);
+
+		/// <summary>
+		/// Gets the node to head to from a node to get closer to the target
+		/// </summary>
+		/// <returns>The next node, or NavGraph::NO_NODE if the node is the target or can't reach it</returns>
+		uint32_t GetNextNode(uint32_t node) const;
+		/// <summary>
+		/// Gets the path distance from a node to the target, or infinity if the node can't reach it
+		/// </summary>
+		float GetDistance(uint32_t node) const;
+		/// <summary>
+		/// Gets the node that the field leads to, or NavGraph::NO_NODE if the field has not been built
+		/// </summary>
+		uint32_t GetTargetNode() const { return _targetNode; }
+		/// <summary>
+		/// Gets the graph that the field was built over
+		/// </summary>
+		const NavGraph* GetGraph() const { return _graph; }
+
+	protected:
+		const NavGraph*       _graph;
+		uint32_t              _targetNode;
+		std::vector<uint32_t> _next;
+		std::vector<float>    _distance;
+
+		// Scratch space for the Dijkstra pass and string pulling, kept between calls so that we don't reallocate it
+		std::vector<std::pair<float, uint32_t>> _open;
+		std::vector<uint32_t>                   _corridor;
+		std::vector<glm::vec3>                  _corners;
+	};
+}
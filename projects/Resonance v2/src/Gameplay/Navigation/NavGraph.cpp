@@ -0,0 +1,277 @@
+#include "Gameplay/Navigation/NavGraph.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Gameplay::Navigation {
+	NavGraph::SearchContext::SearchContext() :
+		_gCost(),
+		_fCost(),
+		_parent(),
+		_openStamp(),
+		_closedStamp(),
+		_generation(0),
+		_heap(),
+		_heapIndex()
+	{ }
+
+	void NavGraph::SearchContext::_Prepare(size_t nodeCount) {
+		// Resize our scratch space if the graph has grown, new stamps start at 0 which is never a valid generation
+		if (_gCost.size() != nodeCount) {
+			_gCost.resize(nodeCount);
+			_fCost.resize(nodeCount);
+			_parent.resize(nodeCount);
+			_openStamp.assign(nodeCount, 0);
+			_closedStamp.assign(nodeCount, 0);
+			_heapIndex.resize(nodeCount);
+			_generation = 0;
+		}
+
+		// If the generation wraps around, old stamps could match again, so clear them
+		_generation++;
+		if (_generation == 0) {
+			std::fill(_openStamp.begin(), _openStamp.end(), 0);
+			std::fill(_closedStamp.begin(), _closedStamp.end(), 0);
+			_generation = 1;
+		}
+		_heap.clear();
+	}
+
+	void NavGraph::SearchContext::_Push(uint32_t node) {
+		_heapIndex[node] = static_cast<uint32_t>(_heap.size());
+		_heap.push_back(node);
+		_SiftUp(_heapIndex[node]);
+	}
+
+	uint32_t NavGraph::SearchContext::_Pop() {
+		uint32_t result = _heap[0];
+		_heap[0] = _heap.back();
+		_heapIndex[_heap[0]] = 0;
+		_heap.pop_back();
+		if (!_heap.empty()) {
+			_SiftDown(0);
+		}
+		return result;
+	}
+
+	void NavGraph::SearchContext::_SiftUp(uint32_t slot) {
+		uint32_t node = _heap[slot];
+		while (slot > 0) {
+			uint32_t parentSlot = (slot - 1) / 2;
+			if (_fCost[_heap[parentSlot]] <= _fCost[node]) {
+				break;
+			}
+			_heap[slot] = _heap[parentSlot];
+			_heapIndex[_heap[slot]] = slot;
+			slot = parentSlot;
+		}
+		_heap[slot] = node;
+		_heapIndex[node] = slot;
+	}
+
+	void NavGraph::SearchContext::_SiftDown(uint32_t slot) {
+		const uint32_t count = static_cast<uint32_t>(_heap.size());
+		uint32_t node = _heap[slot];
+		while (true) {
+			uint32_t child = slot * 2 + 1;
+			if (child >= count) {
+				break;
+			}
+			// Pick the smaller of the two children
+			if (child + 1 < count && _fCost[_heap[child + 1]] < _fCost[_heap[child]]) {
+				child++;
+			}
+			if (_fCost[node] <= _fCost[_heap[child]]) {
+				break;
+			}
+			_heap[slot] = _heap[child];
+			_heapIndex[_heap[slot]] = slot;
+			slot = child;
+		}
+		_heap[slot] = node;
+		_heapIndex[node] = slot;
+	}
+
+	NavGraph::NavGraph() :
+		_positions(),
+		_edgeOffsets(),
+		_edgeTargets(),
+		_edgeCosts(),
+		_cellSize(1.0f),
+		_gridOrigin(glm::vec2(0.0f)),
+		_gridSize(glm::ivec2(0)),
+		_cellOffsets(),
+		_cellNodes(),
+		_context()
+	{ }
+
+	void NavGraph::Build(const std::vector<glm::vec3>& positions, const std::vector<std::pair<uint32_t, uint32_t>>& edges, float cellSize) {
+		const uint32_t nodeCount = static_cast<uint32_t>(positions.size());
+		_positions = positions;
+
+		// Count the edges leaving each node, then prefix sum into offsets
+		_edgeOffsets.assign(nodeCount + 1, 0);
+		for (const auto& edge : edges) {
+			if (edge.first < nodeCount && edge.second < nodeCount) {
+				_edgeOffsets[edge.first + 1]++;
+			}
+		}
+		for (uint32_t ix = 0; ix < nodeCount; ix++) {
+			_edgeOffsets[ix + 1] += _edgeOffsets[ix];
+		}
+
+		// Scatter the edges into their slots, and precompute their costs
+		_edgeTargets.resize(_edgeOffsets[nodeCount]);
+		_edgeCosts.resize(_edgeOffsets[nodeCount]);
+		std::vector<uint32_t> cursor(_edgeOffsets.begin(), _edgeOffsets.end() - 1);
+		for (const auto& edge : edges) {
+			if (edge.first < nodeCount && edge.second < nodeCount) {
+				uint32_t slot = cursor[edge.first]++;
+				_edgeTargets[slot] = edge.second;
+				_edgeCosts[slot] = glm::distance(positions[edge.first], positions[edge.second]);
+			}
+		}
+
+		// Bucket the nodes into the lookup grid, using the same count and scatter approach
+		_cellSize = glm::max(cellSize, 0.001f);
+		_cellOffsets.clear();
+		_cellNodes.clear();
+		_gridSize = glm::ivec2(0);
+		if (nodeCount == 0) {
+			return;
+		}
+
+		glm::vec2 min = glm::vec2(positions[0]);
+		glm::vec2 max = min;
+		for (const glm::vec3& pos : positions) {
+			min = glm::min(min, glm::vec2(pos));
+			max = glm::max(max, glm::vec2(pos));
+		}
+		_gridOrigin = min;
+		_gridSize = glm::ivec2((max - min) / _cellSize) + glm::ivec2(1);
+
+		_cellOffsets.assign(static_cast<size_t>(_gridSize.x) * _gridSize.y + 1, 0);
+		for (const glm::vec3& pos : positions) {
+			glm::ivec2 cell = _GetCell(pos);
+			_cellOffsets[cell.y * _gridSize.x + cell.x + 1]++;
+		}
+		for (size_t ix = 1; ix < _cellOffsets.size(); ix++) {
+			_cellOffsets[ix] += _cellOffsets[ix - 1];
+		}
+		_cellNodes.resize(nodeCount);
+		cursor.assign(_cellOffsets.begin(), _cellOffsets.end() - 1);
+		for (uint32_t ix = 0; ix < nodeCount; ix++) {
+			glm::ivec2 cell = _GetCell(positions[ix]);
+			_cellNodes[cursor[cell.y * _gridSize.x + cell.x]++] = ix;
+		}
+	}
+
+	glm::ivec2 NavGraph::_GetCell(const glm::vec3& position) const {
+		glm::ivec2 cell = glm::ivec2(glm::floor((glm::vec2(position) - _gridOrigin) / _cellSize));
+		return glm::clamp(cell, glm::ivec2(0), _gridSize - glm::ivec2(1));
+	}
+
+	uint32_t NavGraph::FindNearestNode(const glm::vec3& position) const {
+		if (_positions.empty()) {
+			return NO_NODE;
+		}
+
+		// Search outwards in square rings of cells around the position. Any node in ring r+1 is at least
+		// r cells away, so once we've found something closer than that we can stop
+		const glm::ivec2 center = _GetCell(position);
+		const int maxRing = glm::max(_gridSize.x, _gridSize.y);
+		uint32_t result = NO_NODE;
+		float bestDistSq = std::numeric_limits<float>::max();
+
+		for (int ring = 0; ring <= maxRing; ring++) {
+			glm::ivec2 min = glm::max(center - glm::ivec2(ring), glm::ivec2(0));
+			glm::ivec2 max = glm::min(center + glm::ivec2(ring), _gridSize - glm::ivec2(1));
+			for (int y = min.y; y <= max.y; y++) {
+				for (int x = min.x; x <= max.x; x++) {
+					// Only visit the cells on the border of the ring, the inside has already been searched
+					if (glm::abs(x - center.x) != ring && glm::abs(y - center.y) != ring) {
+						continue;
+					}
+					const uint32_t cell = y * _gridSize.x + x;
+					for (uint32_t ix = _cellOffsets[cell]; ix < _cellOffsets[cell + 1]; ix++) {
+						glm::vec3 delta = _positions[_cellNodes[ix]] - position;
+						float distSq = glm::dot(delta, delta);
+						if (distSq < bestDistSq) {
+							bestDistSq = distSq;
+							result = _cellNodes[ix];
+						}
+					}
+				}
+			}
+
+			float ringDist = ring * _cellSize;
+			if (result != NO_NODE && bestDistSq <= ringDist * ringDist) {
+				break;
+			}
+		}
+		return result;
+	}
+
+	PathStatus NavGraph::FindPath(uint32_t start, uint32_t goal, std::vector<uint32_t>& outPath) {
+		return FindPath(start, goal, outPath, _context);
+	}
+
+	PathStatus NavGraph::FindPath(uint32_t start, uint32_t goal, std::vector<uint32_t>& outPath, SearchContext& context) const {
+		outPath.clear();
+		if (_positions.empty()) {
+			return PathStatus::EmptyGraph;
+		}
+		if (start >= _positions.size() || goal >= _positions.size()) {
+			return PathStatus::InvalidNode;
+		}
+
+		context._Prepare(_positions.size());
+		const uint32_t generation = context._generation;
+		const glm::vec3& goalPos = _positions[goal];
+
+		context._gCost[start] = 0.0f;
+		context._fCost[start] = glm::distance(_positions[start], goalPos);
+		context._parent[start] = NO_NODE;
+		context._openStamp[start] = generation;
+		context._Push(start);
+
+		while (!context._heap.empty()) {
+			uint32_t current = context._Pop();
+			if (current == goal) {
+				// Walk the parents back to the start, then flip so the path is start to goal
+				for (uint32_t node = goal; node != NO_NODE; node = context._parent[node]) {
+					outPath.push_back(node);
+				}
+				std::reverse(outPath.begin(), outPath.end());
+				return PathStatus::Success;
+			}
+			context._closedStamp[current] = generation;
+
+			for (uint32_t edge = _edgeOffsets[current]; edge < _edgeOffsets[current + 1]; edge++) {
+				uint32_t neighbor = _edgeTargets[edge];
+				if (context._closedStamp[neighbor] == generation) {
+					continue;
+				}
+
+				float gCost = context._gCost[current] + _edgeCosts[edge];
+				bool isOpen = context._openStamp[neighbor] == generation;
+				if (isOpen && gCost >= context._gCost[neighbor]) {
+					continue;
+				}
+
+				// Our heuristic is the straight line distance, which never overestimates so the path is optimal
+				context._gCost[neighbor] = gCost;
+				context._fCost[neighbor] = gCost + glm::distance(_positions[neighbor], goalPos);
+				context._parent[neighbor] = current;
+				if (isOpen) {
+					context._SiftUp(context._heapIndex[neighbor]);
+				} else {
+					context._openStamp[neighbor] = generation;
+					context._Push(neighbor);
+				}
+			}
+		}
+
+		return PathStatus::NoPath;
+	}
+}
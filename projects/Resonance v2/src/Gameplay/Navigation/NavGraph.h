@@ -0,0 +1,147 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <GLM/glm.hpp>
+#include <EnumToString.h>
+
+#include "Utils/Macros.h"
+
+namespace Gameplay::Navigation {
+	/// <summary>
+	/// The result of a path query
+	/// </summary>
+	ENUM(PathStatus, int,
+		 Success     = 0,
+		 // The graph has no nodes to path over
+		 EmptyGraph  = 1,
+		 // The start or end node is not part of the graph
+		 InvalidNode = 2,
+		 // The start and end nodes are not connected
+		 NoPath      = 3
+	);
+
+	/// <summary>
+	/// A navigation graph compiled into flat arrays, so that searches never have to touch GameObjects
+	///
+	/// Nodes are stored as a positions array, with their outgoing edges in compressed sparse row form
+	/// (all edges for node i are in [_edgeOffsets[i], _edgeOffsets[i + 1])) along with precomputed costs.
+	/// Nodes are also bucketed into a uniform grid on the XY plane for nearest node lookups
+	/// </summary>
+	class NavGraph {
+	public:
+		MAKE_PTRS(NavGraph);
+
+		// Used to indicate that there is no node (ex: the parent of the start node, or a failed lookup)
+		static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+		/// <summary>
+		/// Stores the per-search state for A*. Each thread that searches the graph needs it's own context,
+		/// and reusing a context between searches means that we never have to clear or reallocate
+		/// </summary>
+		class SearchContext {
+		public:
+			SearchContext();
+
+		protected:
+			friend class NavGraph;
+
+			// The cost from the start node, and the estimated total cost through each node
+			std::vector<float>    _gCost;
+			std::vector<float>    _fCost;
+			std::vector<uint32_t> _parent;
+			// A node is open or closed for the current search only if it's stamp matches _generation,
+			// which lets us "clear" every node by incrementing a single counter
+			std::vector<uint32_t> _openStamp;
+			std::vector<uint32_t> _closedStamp;
+			uint32_t              _generation;
+
+			// Indexed binary min-heap of open nodes ordered by fCost, _heapIndex maps a node to it's slot
+			std::vector<uint32_t> _heap;
+			std::vector<uint32_t> _heapIndex;
+
+			void _Prepare(size_t nodeCount);
+			void _Push(uint32_t node);
+			uint32_t _Pop();
+			void _SiftUp(uint32_t slot);
+			void _SiftDown(uint32_t slot);
+		};
+
+		NavGraph();
+		~NavGraph() = default;
+
+		/// <summary>
+		/// Compiles the graph from a set of node positions and directed edges. Edge costs are the
+		/// distance between their nodes
+		/// </summary>
+		/// <param name="positions">The world positions of all the nodes</param>
+		/// <param name="edges">Directed edges, as pairs of (from, to) indices into positions</param>
+		/// <param name="cellSize">The size of the cells in the nearest node lookup grid, ideally around the typical edge length</param>
+		void Build(const std::vector<glm::vec3>& positions, const std::vector<std::pair<uint32_t, uint32_t>>& edges, float cellSize);
+
+		/// <summary>
+		/// Finds the node closest to the given position
+		/// </summary>
+		/// <param name="position">The position to search from</param>
+		/// <returns>The index of the nearest node, or NO_NODE if the graph is empty</returns>
+		uint32_t FindNearestNode(const glm::vec3& position) const;
+
+		/// <summary>
+		/// Runs an A* search between two nodes, using the given search context for scratch data
+		/// </summary>
+		/// <param name="start">The index of the node to start from</param>
+		/// <param name="goal">The index of the node to find a path to</param>
+		/// <param name="outPath">Will store the nodes along the path, in order from start to goal</param>
+		/// <param name="context">The scratch data for the search, must not be shared between threads</param>
+		/// <returns>Success if a path was found, or the reason that there is no path</returns>
+		PathStatus FindPath(uint32_t start, uint32_t goal, std::vector<uint32_t>& outPath, SearchContext& context) const;
+		/// <summary>
+		/// Runs an A* search between two nodes using the graph's own search context, should only be used
+		/// from the main thread
+		/// </summary>
+		PathStatus FindPath(uint32_t start, uint32_t goal, std::vector<uint32_t>& outPath);
+
+		/// <summary>
+		/// Gets the number of nodes in the graph
+		/// </summary>
+		size_t GetNodeCount() const { return _positions.size(); }
+		/// <summary>
+		/// Gets the number of directed edges in the graph
+		/// </summary>
+		size_t GetEdgeCount() const { return _edgeTargets.size(); }
+		/// <summary>
+		/// Gets the world position of a node
+		/// </summary>
+		const glm::vec3& GetNodePosition(uint32_t node) const { return _positions[node]; }
+		/// <summary>
+		/// Gets the range of edges leaving a node, as [GetEdgesBegin(node), GetEdgesEnd(node))
+		/// </summary>
+		uint32_t GetEdgesBegin(uint32_t node) const { return _edgeOffsets[node]; }
+		uint32_t GetEdgesEnd(uint32_t node) const { return _edgeOffsets[node + 1]; }
+		/// <summary>
+		/// Gets the node that an edge leads to
+		/// </summary>
+		uint32_t GetEdgeTarget(uint32_t edge) const { return _edgeTargets[edge]; }
+		/// <summary>
+		/// Gets the cost of travelling along an edge
+		/// </summary>
+		float GetEdgeCost(uint32_t edge) const { return _edgeCosts[edge]; }
+
+	protected:
+		std::vector<glm::vec3> _positions;
+		std::vector<uint32_t>  _edgeOffsets;
+		std::vector<uint32_t>  _edgeTargets;
+		std::vector<float>     _edgeCosts;
+
+		// The nearest node lookup grid, stored in the same compressed form as the edges
+		float                  _cellSize;
+		glm::vec2              _gridOrigin;
+		glm::ivec2             _gridSize;
+		std::vector<uint32_t>  _cellOffsets;
+		std::vector<uint32_t>  _cellNodes;
+
+		SearchContext          _context;
+
+		glm::ivec2 _GetCell(const glm::vec3& position) const;
+	};
+}
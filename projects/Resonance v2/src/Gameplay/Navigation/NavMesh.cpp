@@ -0,0 +1,356 @@
+#include "Gameplay/Navigation/NavMesh.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "Utils/FileHelpers.h"
+#include "Logging.h"
+
+namespace Gameplay::Navigation {
+	// How many cells away from a position we will look for a polygon when the position is off the mesh
+	static constexpr int MAX_POLYGON_SEARCH_CELLS = 8;
+
+	// Twice the signed area of the triangle abc on the XY plane, positive if c is to the left of a->b
+	inline float TriArea2(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c) {
+		return (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+	}
+
+	inline bool ApproxEqual(const glm::vec3& a, const glm::vec3& b) {
+		glm::vec2 delta = glm::vec2(a - b);
+		return glm::dot(delta, delta) < 1e-6f;
+	}
+
+	NavMesh::NavMesh() :
+		_polygons(),
+		_portals(),
+		_origin(glm::vec3(0.0f)),
+		_cellSize(1.0f),
+		_gridSize(glm::ivec2(0)),
+		_cellOffsets(),
+		_cellFloors(),
+		_sourceHash(0),
+		_graph(),
+		_context()
+	{ }
+
+	void NavMesh::_BuildGraph() {
+		std::vector<glm::vec3> centers;
+		std::vector<std::pair<uint32_t, uint32_t>> edges;
+		centers.reserve(_polygons.size());
+		edges.reserve(_portals.size());
+		for (uint32_t ix = 0; ix < _polygons.size(); ix++) {
+			const Polygon& poly = _polygons[ix];
+			centers.push_back(poly.Center);
+			for (uint32_t portal = poly.FirstPortal; portal < poly.FirstPortal + poly.PortalCount; portal++) {
+				edges.push_back({ ix, _portals[portal].Polygon });
+			}
+		}
+		// We never use the graph's nearest node lookup, the cell grid is much more precise
+		_graph.Build(centers, edges, _cellSize * 16.0f);
+	}
+
+	uint32_t NavMesh::_FindInCell(int x, int y, float height, float& outDistance) const {
+		uint32_t result = NavGraph::NO_NODE;
+		outDistance = std::numeric_limits<float>::max();
+		if (x < 0 || y < 0 || x >= _gridSize.x || y >= _gridSize.y) {
+			return result;
+		}
+
+		const uint32_t cell = y * _gridSize.x + x;
+		for (uint32_t ix = _cellOffsets[cell]; ix < _cellOffsets[cell + 1]; ix++) {
+			float distance = glm::abs(_cellFloors[ix].Height - height);
+			if (distance < outDistance) {
+				outDistance = distance;
+				result = _cellFloors[ix].Polygon;
+			}
+		}
+		return result;
+	}
+
+	uint32_t NavMesh::FindPolygon(const glm::vec3& position) const {
+		if (_polygons.empty()) {
+			return NavGraph::NO_NODE;
+		}
+
+		const glm::ivec2 center = glm::ivec2(glm::floor((glm::vec2(position) - glm::vec2(_origin)) / _cellSize));
+
+		// Search outwards in rings, scoring candidates by their horizontal distance in cells plus their height difference
+		uint32_t result = NavGraph::NO_NODE;
+		float bestScore = std::numeric_limits<float>::max();
+		for (int ring = 0; ring <= MAX_POLYGON_SEARCH_CELLS; ring++) {
+			if (result != NavGraph::NO_NODE && bestScore <= ring * _cellSize) {
+				break;
+			}
+			for (int y = center.y - ring; y <= center.y + ring; y++) {
+				for (int x = center.x - ring; x <= center.x + ring; x++) {
+					if (glm::abs(x - center.x) != ring && glm::abs(y - center.y) != ring) {
+						continue;
+					}
+					float heightDiff;
+					uint32_t poly = _FindInCell(x, y, position.z, heightDiff);
+					float score = ring * _cellSize + heightDiff;
+					if (poly != NavGraph::NO_NODE && score < bestScore) {
+						bestScore = score;
+						result = poly;
+					}
+				}
+			}
+		}
+		return result;
+	}
+
+	PathStatus NavMesh::FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& outPath) {
+		return FindPath(start, goal, outPath, _context);
+	}
+
+	PathStatus NavMesh::FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& outPath, NavGraph::SearchContext& context) const {
+		outPath.clear();
+		if (_polygons.empty()) {
+			return PathStatus::EmptyGraph;
+		}
+
+		uint32_t startPoly = FindPolygon(start);
+		uint32_t goalPoly = FindPolygon(goal);
+		if (startPoly == NavGraph::NO_NODE || goalPoly == NavGraph::NO_NODE) {
+			return PathStatus::InvalidNode;
+		}
+
+		// The corridor is small and short lived, but we don't want to allocate it on every search
+		thread_local std::vector<uint32_t> corridor;
+		PathStatus status = _graph.FindPath(startPoly, goalPoly, corridor, context);
+		if (status != PathStatus::Success) {
+			return status;
+		}
+
+		StringPull(start, goal, corridor, outPath);
+		return PathStatus::Success;
+	}
+
+	void NavMesh::StringPull(const glm::vec3& start, const glm::vec3& goal, const std::vector<uint32_t>& corridor, std::vector<glm::vec3>& outPath) const {
+		// Collect the portals between each pair of polygons in the corridor, ordered into left and right
+		// sides as seen when walking through the corridor. The start and goal are degenerate portals at either end
+		thread_local std::vector<std::pair<glm::vec3, glm::vec3>> portals;
+		portals.clear();
+		portals.push_back({ start, start });
+		for (size_t ix = 0; ix + 1 < corridor.size(); ix++) {
+			const Polygon& from = _polygons[corridor[ix]];
+			for (uint32_t portal = from.FirstPortal; portal < from.FirstPortal + from.PortalCount; portal++) {
+				const Portal& link = _portals[portal];
+				if (link.Polygon == corridor[ix + 1]) {
+					glm::vec3 mid = (link.A + link.B) * 0.5f;
+					if (TriArea2(from.Center, mid, link.A) >= 0.0f) {
+						portals.push_back({ link.A, link.B });
+					} else {
+						portals.push_back({ link.B, link.A });
+					}
+					break;
+				}
+			}
+		}
+		portals.push_back({ goal, goal });
+
+		// Simple stupid funnel algorithm, tightens the left and right sides of a funnel from the apex through
+		// each portal. When one side crosses over the other, the crossed corner becomes a point on the path and
+		// the new apex, and we restart from the portal where that corner was found
+		glm::vec3 apex = portals[0].first;
+		glm::vec3 left = portals[0].first;
+		glm::vec3 right = portals[0].second;
+		size_t apexIndex = 0, leftIndex = 0, rightIndex = 0;
+		outPath.push_back(apex);
+
+		for (size_t ix = 1; ix < portals.size(); ix++) {
+			const glm::vec3& newLeft = portals[ix].first;
+			const glm::vec3& newRight = portals[ix].second;
+
+			// Try to narrow the right side of the funnel
+			if (TriArea2(apex, right, newRight) >= 0.0f) {
+				if (ApproxEqual(apex, right) || TriArea2(apex, left, newRight) < 0.0f) {
+					right = newRight;
+					rightIndex = ix;
+				} else {
+					// The right side crossed the left, so the left corner is on the path
+					apex = left;
+					apexIndex = leftIndex;
+					if (!ApproxEqual(outPath.back(), apex)) {
+						outPath.push_back(apex);
+					}
+					left = right = apex;
+					leftIndex = rightIndex = apexIndex;
+					ix = apexIndex;
+					continue;
+				}
+			}
+
+			// Try to narrow the left side of the funnel
+			if (TriArea2(apex, left, newLeft) <= 0.0f) {
+				if (ApproxEqual(apex, left) || TriArea2(apex, right, newLeft) > 0.0f) {
+					left = newLeft;
+					leftIndex = ix;
+				} else {
+					// The left side crossed the right, so the right corner is on the path
+					apex = right;
+					apexIndex = rightIndex;
+					if (!ApproxEqual(outPath.back(), apex)) {
+						outPath.push_back(apex);
+					}
+					left = right = apex;
+					leftIndex = rightIndex = apexIndex;
+					ix = apexIndex;
+					continue;
+				}
+			}
+		}
+
+		if (!ApproxEqual(outPath.back(), goal) || outPath.size() == 1) {
+			outPath.push_back(goal);
+		}
+	}
+
+	void NavMesh::GetBoundaryEdges(std::vector<glm::vec3>& outEdges) const {
+		// Portals are within a small fraction of a cell of their edge, anything further off belongs to a different side
+		const float tolerance = _cellSize * 0.01f;
+		std::vector<glm::vec2> covered;
+		for (const Polygon& poly : _polygons) {
+			for (int side = 0; side < 4; side++) {
+				const glm::vec3& start = poly.Vertices[side];
+				const glm::vec3& end = poly.Vertices[(side + 1) % 4];
+				const glm::vec2 edge = glm::vec2(end) - glm::vec2(start);
+				const float length = glm::length(edge);
+				if (length <= tolerance) {
+					continue;
+				}
+				const glm::vec2 dir = edge / length;
+				const glm::vec2 normal = glm::vec2(-dir.y, dir.x);
+
+				// Find how far along the edge each portal on it starts and ends
+				covered.clear();
+				for (uint32_t ix = poly.FirstPortal; ix < poly.FirstPortal + poly.PortalCount; ix++) {
+					const glm::vec2 a = glm::vec2(_portals[ix].A) - glm::vec2(start);
+					const glm::vec2 b = glm::vec2(_portals[ix].B) - glm::vec2(start);
+					if (glm::abs(glm::dot(a, normal)) > tolerance || glm::abs(glm::dot(b, normal)) > tolerance) {
+						continue;
+					}
+					float ta = glm::dot(a, dir), tb = glm::dot(b, dir);
+					covered.push_back(glm::vec2(glm::min(ta, tb), glm::max(ta, tb)));
+				}
+				std::sort(covered.begin(), covered.end(), [](const glm::vec2& l, const glm::vec2& r) { return l.x < r.x; });
+
+				// Whatever is left between the portals is wall
+				float t = 0.0f;
+				auto addWall = [&](float from, float to) {
+					if (to - from > tolerance) {
+						outEdges.push_back(glm::mix(start, end, from / length));
+						outEdges.push_back(glm::mix(start, end, to / length));
+					}
+				};
+				for (const glm::vec2& span : covered) {
+					addWall(t, glm::min(span.x, length));
+					t = glm::max(t, span.y);
+				}
+				addWall(t, length);
+			}
+		}
+	}
+
+	NavMesh::Sptr NavMesh::Load(const std::string& path) {
+		FileHelpers::FileBuffer file;
+		if (!FileHelpers::ReadFileBuffer(path, file) || file.Size < sizeof(NavMeshHeader)) {
+			return nullptr;
+		}
+
+		NavMeshHeader header;
+		memcpy(&header, file.Data, sizeof(NavMeshHeader));
+		if (memcmp(header.HeaderBytes, NavMeshHeader().HeaderBytes, 4) != 0 || header.Version != 0x01) {
+			LOG_WARN("Navmesh \"{}\" is invalid or an unsupported version", path);
+			return nullptr;
+		}
+
+		const size_t numCells = static_cast<size_t>(header.GridSize.x) * header.GridSize.y;
+		const size_t expectedSize = sizeof(NavMeshHeader) +
+			header.NumPolygons * sizeof(Polygon) +
+			header.NumPortals * sizeof(Portal) +
+			(numCells + 1) * sizeof(uint32_t) +
+			header.NumCellFloors * sizeof(CellFloor);
+		if (header.GridSize.x < 0 || header.GridSize.y < 0 || file.Size < expectedSize) {
+			LOG_WARN("Navmesh \"{}\" is truncated", path);
+			return nullptr;
+		}
+
+		NavMesh::Sptr result = std::make_shared<NavMesh>();
+		result->_sourceHash = header.SourceHash;
+		result->_origin     = header.Origin;
+		result->_cellSize   = header.CellSize;
+		result->_gridSize   = header.GridSize;
+
+		// The arrays are stored back to back after the header, in the order that they are declared
+		const uint8_t* data = file.Data + sizeof(NavMeshHeader);
+		result->_polygons.resize(header.NumPolygons);
+		memcpy(result->_polygons.data(), data, header.NumPolygons * sizeof(Polygon));
+		data += header.NumPolygons * sizeof(Polygon);
+
+		result->_portals.resize(header.NumPortals);
+		memcpy(result->_portals.data(), data, header.NumPortals * sizeof(Portal));
+		data += header.NumPortals * sizeof(Portal);
+
+		result->_cellOffsets.resize(numCells + 1);
+		memcpy(result->_cellOffsets.data(), data, (numCells + 1) * sizeof(uint32_t));
+		data += (numCells + 1) * sizeof(uint32_t);
+
+		result->_cellFloors.resize(header.NumCellFloors);
+		memcpy(result->_cellFloors.data(), data, header.NumCellFloors * sizeof(CellFloor));
+
+		// Make sure that nothing in the file points outside of our arrays before we trust it
+		for (const Polygon& poly : result->_polygons) {
+			if (poly.FirstPortal + poly.PortalCount > header.NumPortals) {
+				LOG_WARN("Navmesh \"{}\" is corrupt", path);
+				return nullptr;
+			}
+		}
+		for (const Portal& portal : result->_portals) {
+			if (portal.Polygon >= header.NumPolygons) {
+				LOG_WARN("Navmesh \"{}\" is corrupt", path);
+				return nullptr;
+			}
+		}
+		for (const CellFloor& floor : result->_cellFloors) {
+			if (floor.Polygon >= header.NumPolygons) {
+				LOG_WARN("Navmesh \"{}\" is corrupt", path);
+				return nullptr;
+			}
+		}
+		if (result->_cellOffsets.back() != header.NumCellFloors) {
+			LOG_WARN("Navmesh \"{}\" is corrupt", path);
+			return nullptr;
+		}
+
+		result->_BuildGraph();
+		return result;
+	}
+
+	bool NavMesh::Save(const std::string& path) const {
+		std::ofstream file(path, std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to open \"{}\" for writing navmesh", path);
+			return false;
+		}
+
+		NavMeshHeader header = NavMeshHeader();
+		header.Version       = 0x01;
+		header.SourceHash    = _sourceHash;
+		header.Origin        = _origin;
+		header.CellSize      = _cellSize;
+		header.GridSize      = _gridSize;
+		header.NumPolygons   = static_cast<uint32_t>(_polygons.size());
+		header.NumPortals    = static_cast<uint32_t>(_portals.size());
+		header.NumCellFloors = static_cast<uint32_t>(_cellFloors.size());
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(NavMeshHeader));
+		file.write(reinterpret_cast<const char*>(_polygons.data()), _polygons.size() * sizeof(Polygon));
+		file.write(reinterpret_cast<const char*>(_portals.data()), _portals.size() * sizeof(Portal));
+		file.write(reinterpret_cast<const char*>(_cellOffsets.data()), _cellOffsets.size() * sizeof(uint32_t));
+		file.write(reinterpret_cast<const char*>(_cellFloors.data()), _cellFloors.size() * sizeof(CellFloor));
+		return file.good();
+	}
+}
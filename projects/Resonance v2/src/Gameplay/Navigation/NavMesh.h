@@ -0,0 +1,163 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Navigation/NavGraph.h"
+#include "Utils/Macros.h"
+
+namespace Gameplay::Navigation {
+	/// <summary>
+	/// A navigation mesh made of convex polygons covering the walkable surfaces of a level, as baked by
+	/// the NavMeshBuilder
+	///
+	/// Searches run A* over the polygons (using a NavGraph of polygon centers), and the resulting corridor
+	/// of polygons is turned into a path with the funnel algorithm, so agents walk straight lines across
+	/// open areas and hug corners instead of zig-zagging between nodes
+	/// </summary>
+	class NavMesh {
+	public:
+		MAKE_PTRS(NavMesh);
+
+		// A shared edge between two polygons that agents can pass through
+		struct Portal {
+			// The polygon on the other side of the portal
+			uint32_t  Polygon;
+			// The end points of the portal, in no particular order
+			glm::vec3 A;
+			glm::vec3 B;
+		};
+
+		// A convex walkable polygon, the vertices are in counter-clockwise order when viewed from above
+		struct Polygon {
+			glm::vec3 Vertices[4];
+			glm::vec3 Center;
+			// The portals leaving this polygon are in [FirstPortal, FirstPortal + PortalCount)
+			uint32_t  FirstPortal;
+			uint32_t  PortalCount;
+		};
+
+		NavMesh();
+		~NavMesh() = default;
+
+		/// <summary>
+		/// Finds the polygon under a position. If the position is off the mesh (ex: pressed against a wall, inside
+		/// the area eroded by the agent radius) the closest polygon within a few cells is used instead
+		/// </summary>
+		/// <param name="position">The world position to look up</param>
+		/// <returns>The index of the polygon, or NavGraph::NO_NODE if there is no polygon nearby</returns>
+		uint32_t FindPolygon(const glm::vec3& position) const;
+
+		/// <summary>
+		/// Finds a path across the mesh, using the given search context for scratch data
+		/// </summary>
+		/// <param name="start">The world position to path from</param>
+		/// <param name="goal">The world position to path to</param>
+		/// <param name="outPath">Will store the corners along the path, in order from start to goal (including both)</param>
+		/// <param name="context">The scratch data for the search, must not be shared between threads</param>
+		/// <returns>Success if a path was found, or the reason that there is no path</returns>
+		PathStatus FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& outPath, NavGraph::SearchContext& context) const;
+		/// <summary>
+		/// Finds a path across the mesh using the mesh's own search context, should only be used from the main thread
+		/// </summary>
+		PathStatus FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& outPath);
+
+		/// <summary>
+		/// Runs the funnel algorithm along a corridor of polygons to find the shortest path through it
+		/// </summary>
+		/// <param name="start">The world position the path starts at, should be in the first polygon</param>
+		/// <param name="goal">The world position the path ends at, should be in the last polygon</param>
+		/// <param name="corridor">The connected polygons to path through, as found by searching GetGraph</param>
+		/// <param name="outPath">Will have the corners along the path appended to it, from start to goal (including both)</param>
+		void StringPull(const glm::vec3& start, const glm::vec3& goal, const std::vector<uint32_t>& corridor, std::vector<glm::vec3>& outPath) const;
+
+		/// <summary>
+		/// Finds the walls of the mesh, that is every part of a polygon's edges that isn't a portal to another polygon
+		/// </summary>
+		/// <param name="outEdges">Will have the end points of each wall appended to it, two points per wall</param>
+		void GetBoundaryEdges(std::vector<glm::vec3>& outEdges) const;
+
+		/// <summary>
+		/// Gets the polygon adjacency graph, where each node is the polygon with the same index
+		/// </summary>
+		const NavGraph& GetGraph() const { return _graph; }
+
+		/// <summary>
+		/// Gets the number of polygons in the mesh
+		/// </summary>
+		size_t GetPolygonCount() const { return _polygons.size(); }
+		/// <summary>
+		/// Gets a polygon in the mesh
+		/// </summary>
+		const Polygon& GetPolygon(uint32_t index) const { return _polygons[index]; }
+		/// <summary>
+		/// Gets the hash of the geometry and settings that the mesh was baked from
+		/// </summary>
+		uint64_t GetSourceHash() const { return _sourceHash; }
+
+		/// <summary>
+		/// Loads a mesh that was previously saved with Save
+		/// </summary>
+		/// <param name="path">The path to the navmesh file</param>
+		/// <returns>The loaded mesh, or nullptr if the file is missing or invalid</returns>
+		static NavMesh::Sptr Load(const std::string& path);
+		/// <summary>
+		/// Saves this mesh to a binary file
+		/// </summary>
+		/// <param name="path">The path of the file to create</param>
+		/// <returns>True if the mesh was saved, false if otherwise</returns>
+		bool Save(const std::string& path) const;
+
+	protected:
+		friend class NavMeshBuilder;
+
+		// A layer of walkable floor in a lookup cell
+		struct CellFloor {
+			float    Height;
+			uint32_t Polygon;
+		};
+
+		// Will be put at the start of the navmesh file, contains info about the contents of the file
+		struct NavMeshHeader {
+			// A check value so we can ensure that we're loading in the right file type
+			char       HeaderBytes[4] ={ 'N', 'A', 'V', 'M' };
+			// The version code, we can use this to create different loaders if our format changes
+			uint16_t   Version = 0;
+			// The hash of the geometry and settings the mesh was baked from
+			uint64_t   SourceHash = 0;
+			glm::vec3  Origin = glm::vec3(0.0f);
+			float      CellSize = 0.0f;
+			glm::ivec2 GridSize = glm::ivec2(0);
+			uint32_t   NumPolygons = 0;
+			uint32_t   NumPortals = 0;
+			uint32_t   NumCellFloors = 0;
+		};
+
+		std::vector<Polygon>   _polygons;
+		std::vector<Portal>    _portals;
+
+		// The polygon lookup grid, with the same cells as the voxels the mesh was baked from. The floors
+		// in cell i are in [_cellOffsets[i], _cellOffsets[i + 1])
+		glm::vec3              _origin;
+		float                  _cellSize;
+		glm::ivec2             _gridSize;
+		std::vector<uint32_t>  _cellOffsets;
+		std::vector<CellFloor> _cellFloors;
+
+		uint64_t               _sourceHash;
+
+		// The polygon adjacency graph that A* runs over
+		NavGraph               _graph;
+		NavGraph::SearchContext _context;
+
+		/// <summary>
+		/// Rebuilds _graph from the polygons and portals
+		/// </summary>
+		void _BuildGraph();
+		/// <summary>
+		/// Finds the polygon on the floor in a cell closest in height to the given height
+		/// </summary>
+		uint32_t _FindInCell(int x, int y, float height, float& outDistance) const;
+	};
+}
@@ -0,0 +1,540 @@
+#include "Gameplay/Navigation/NavMeshBuilder.h"
+
+#include <limits>
+#include <deque>
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+#include <BulletCollision/CollisionShapes/btTriangleCallback.h>
+#include <LinearMath/btAabbUtil2.h>
+
+#include "Logging.h"
+
+namespace Gameplay::Navigation {
+	namespace {
+		// The most cells we will allow in a bake, to catch runaway bounds before we try to allocate them
+		constexpr size_t MAX_BAKE_CELLS = 4096 * 4096;
+		// Geometry with bounds larger than this is treated as infinite (ex: static planes)
+		constexpr float  INFINITE_EXTENT = 1.0e5f;
+		constexpr int    NO_SPAN = -1;
+		constexpr int    NO_REGION = -1;
+
+		// The offsets to the neighboring cells, in the order -X, +Y, +X, -Y
+		constexpr int DIR_X[4] = { -1, 0, 1, 0 };
+		constexpr int DIR_Y[4] = { 0, 1, 0, -1 };
+		constexpr int DIR_NEG_X = 0, DIR_POS_Y = 1, DIR_POS_X = 2, DIR_NEG_Y = 3;
+
+		// A solid span in a column of the heightfield, heights are in cells above the origin
+		struct SolidSpan {
+			int  Min;
+			int  Max;
+			bool Walkable;
+		};
+
+		// The walkable open space on top of a solid span
+		struct OpenSpan {
+			int  Floor;
+			int  Ceiling;
+			int  Connections[4];
+			int  Distance;
+			int  Region;
+			bool Eroded;
+		};
+
+		// The cells that make up a rectangular region, each row is a run of spans along +X
+		struct Region {
+			int x0, y0;
+			std::vector<std::vector<int>> Rows;
+		};
+
+		// Collects triangles from concave shapes, transforming them into world space as we go
+		class TriangleCollector : public btTriangleCallback {
+		public:
+			TriangleCollector(const btTransform& transform, std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) :
+				_transform(transform), _vertices(vertices), _indices(indices) { }
+
+			virtual void processTriangle(btVector3* triangle, int /*partId*/, int /*triangleIndex*/) override {
+				for (int ix = 0; ix < 3; ix++) {
+					btVector3 pos = _transform(triangle[ix]);
+					_indices.push_back(static_cast<uint32_t>(_vertices.size()));
+					_vertices.push_back(glm::vec3(pos.x(), pos.y(), pos.z()));
+				}
+			}
+
+		private:
+			const btTransform&      _transform;
+			std::vector<glm::vec3>& _vertices;
+			std::vector<uint32_t>&  _indices;
+		};
+
+		bool IsNavigationBlocker(const btCollisionObject* object) {
+			return object->getInternalType() == btCollisionObject::CO_RIGID_BODY &&
+				object->isStaticObject() && !object->isKinematicObject() && object->hasContactResponse();
+		}
+
+		void GatherShape(const btCollisionShape* shape, const btTransform& transform, const btVector3& boundsMin, const btVector3& boundsMax, std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices) {
+			if (shape->isCompound()) {
+				const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+				for (int ix = 0; ix < compound->getNumChildShapes(); ix++) {
+					GatherShape(compound->getChildShape(ix), transform * compound->getChildTransform(ix), boundsMin, boundsMax, vertices, indices);
+				}
+			}
+			else if (shape->isConcave()) {
+				// Only ask for the triangles inside of our bounds, this is what keeps static planes finite
+				btVector3 localMin, localMax;
+				btTransformAabb(boundsMin, boundsMax, 0.0f, transform.inverse(), localMin, localMax);
+				TriangleCollector collector(transform, vertices, indices);
+				static_cast<const btConcaveShape*>(shape)->processAllTriangles(&collector, localMin, localMax);
+			}
+			else if (shape->isConvex()) {
+				// Primitives don't have triangles of their own, so we wrap them in a hull. This is exact for boxes
+				// and convex meshes, and a close approximation for round shapes
+				btShapeHull hull(static_cast<const btConvexShape*>(shape));
+				if (!hull.buildHull(shape->getMargin())) {
+					return;
+				}
+				const uint32_t baseVertex = static_cast<uint32_t>(vertices.size());
+				for (int ix = 0; ix < hull.numVertices(); ix++) {
+					btVector3 pos = transform(hull.getVertexPointer()[ix]);
+					vertices.push_back(glm::vec3(pos.x(), pos.y(), pos.z()));
+				}
+				for (int ix = 0; ix < hull.numIndices(); ix++) {
+					indices.push_back(baseVertex + hull.getIndexPointer()[ix]);
+				}
+			}
+		}
+
+		// Clips a polygon against an axis aligned plane, keeping the part on one side of it
+		void ClipPolygon(const std::vector<glm::vec3>& in, std::vector<glm::vec3>& out, int axis, float value, bool keepAbove) {
+			out.clear();
+			for (size_t ix = 0; ix < in.size(); ix++) {
+				const glm::vec3& a = in[ix];
+				const glm::vec3& b = in[(ix + 1) % in.size()];
+				float da = keepAbove ? a[axis] - value : value - a[axis];
+				float db = keepAbove ? b[axis] - value : value - b[axis];
+				if (da >= 0.0f) {
+					out.push_back(a);
+				}
+				// If the edge crosses the plane, add the point where it crosses
+				if ((da >= 0.0f) != (db >= 0.0f)) {
+					out.push_back(a + (b - a) * (da / (da - db)));
+				}
+			}
+		}
+
+		// Adds a solid span to a column, merging it with any spans that it overlaps
+		void AddSpan(std::vector<SolidSpan>& column, SolidSpan span, int mergeThreshold) {
+			size_t ix = 0;
+			while (ix < column.size()) {
+				SolidSpan& current = column[ix];
+				if (current.Max < span.Min) {
+					ix++;
+					continue;
+				}
+				if (current.Min > span.Max) {
+					break;
+				}
+
+				// The walkable flag comes from whichever top surface ends up on top
+				if (current.Min < span.Min) {
+					span.Min = current.Min;
+				}
+				if (current.Max > span.Max) {
+					span.Max = current.Max;
+				}
+				if (glm::abs(span.Max - current.Max) <= mergeThreshold) {
+					span.Walkable |= current.Walkable;
+				}
+				column.erase(column.begin() + ix);
+			}
+			column.insert(column.begin() + ix, span);
+		}
+	}
+
+	void NavMeshBuilder::GatherCollisionGeometry(const btCollisionWorld* world, std::vector<glm::vec3>& outVertices, std::vector<uint32_t>& outIndices) {
+		const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+
+		// Find the bounds of everything that isn't infinite, so that we can cut infinite shapes down to size
+		btVector3 boundsMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+		btVector3 boundsMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+		bool hasBounds = false;
+		for (int ix = 0; ix < objects.size(); ix++) {
+			if (!IsNavigationBlocker(objects[ix])) {
+				continue;
+			}
+			btVector3 min, max;
+			objects[ix]->getCollisionShape()->getAabb(objects[ix]->getWorldTransform(), min, max);
+			btVector3 extents = max - min;
+			if (extents[extents.maxAxis()] < INFINITE_EXTENT) {
+				boundsMin.setMin(min);
+				boundsMax.setMax(max);
+				hasBounds = true;
+			}
+		}
+		if (!hasBounds) {
+			LOG_WARN("No finite static collision geometry to bake navigation from");
+			return;
+		}
+
+		for (int ix = 0; ix < objects.size(); ix++) {
+			if (IsNavigationBlocker(objects[ix])) {
+				GatherShape(objects[ix]->getCollisionShape(), objects[ix]->getWorldTransform(), boundsMin, boundsMax, outVertices, outIndices);
+			}
+		}
+	}
+
+	uint64_t NavMeshBuilder::ComputeCollisionBodiesHash(const btCollisionWorld* world) {
+		// 64 bit FNV-1a over each body's address and position, bodies that come and go (ex: pickups) aren't static
+		// and never make it in
+		uint64_t hash = 0xcbf29ce484222325ull;
+		auto hashBytes = [&](const void* data, size_t size) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+			for (size_t ix = 0; ix < size; ix++) {
+				hash = (hash ^ bytes[ix]) * 0x100000001b3ull;
+			}
+		};
+		const btCollisionObjectArray& objects = world->getCollisionObjectArray();
+		for (int ix = 0; ix < objects.size(); ix++) {
+			if (IsNavigationBlocker(objects[ix])) {
+				const btCollisionObject* object = objects[ix];
+				const btVector3& origin = object->getWorldTransform().getOrigin();
+				hashBytes(&object, sizeof(object));
+				hashBytes(&origin, sizeof(btVector3));
+			}
+		}
+		return hash;
+	}
+
+	uint64_t NavMeshBuilder::ComputeSourceHash(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const NavMeshBakeSettings& settings) {
+		// 64 bit FNV-1a over the raw bytes of everything that affects the bake
+		uint64_t hash = 0xcbf29ce484222325ull;
+		auto hashBytes = [&](const void* data, size_t size) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+			for (size_t ix = 0; ix < size; ix++) {
+				hash = (hash ^ bytes[ix]) * 0x100000001b3ull;
+			}
+		};
+		hashBytes(vertices.data(), vertices.size() * sizeof(glm::vec3));
+		hashBytes(indices.data(), indices.size() * sizeof(uint32_t));
+		hashBytes(&settings, sizeof(NavMeshBakeSettings));
+		return hash;
+	}
+
+	NavMesh::Sptr NavMeshBuilder::Bake(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const NavMeshBakeSettings& settings) {
+		if (vertices.empty() || indices.size() < 3) {
+			LOG_WARN("Cannot bake a navmesh without any geometry");
+			return nullptr;
+		}
+
+		const float cellSize   = glm::max(settings.CellSize, 0.01f);
+		const float cellHeight = glm::max(settings.CellHeight, 0.01f);
+		const int   climbCells  = static_cast<int>(glm::floor(settings.AgentMaxClimb / cellHeight));
+		const int   heightCells = static_cast<int>(glm::ceil(settings.AgentHeight / cellHeight));
+		const int   radiusCells = static_cast<int>(glm::ceil(settings.AgentRadius / cellSize));
+		const float walkableZ   = glm::cos(glm::radians(settings.AgentMaxSlope));
+
+		glm::vec3 boundsMin = vertices[0];
+		glm::vec3 boundsMax = vertices[0];
+		for (const glm::vec3& vert : vertices) {
+			boundsMin = glm::min(boundsMin, vert);
+			boundsMax = glm::max(boundsMax, vert);
+		}
+		const glm::ivec2 gridSize = glm::ivec2(glm::ceil(glm::vec2(boundsMax - boundsMin) / cellSize)) + glm::ivec2(1);
+		const size_t numCells = static_cast<size_t>(gridSize.x) * gridSize.y;
+		if (numCells > MAX_BAKE_CELLS) {
+			LOG_WARN("Navmesh bounds are too large to bake ({}x{} cells), try a larger cell size", gridSize.x, gridSize.y);
+			return nullptr;
+		}
+
+		// Voxelize the triangles into solid spans. Each triangle is clipped into a strip for each row of cells,
+		// and then each strip into a piece for each cell, and the height range of that piece becomes a span
+		std::vector<std::vector<SolidSpan>> columns(numCells);
+		std::vector<glm::vec3> triangle(3), row, rowRemainder, cell, cellRemainder, scratch;
+		for (size_t tri = 0; tri + 2 < indices.size(); tri += 3) {
+			if (indices[tri] >= vertices.size() || indices[tri + 1] >= vertices.size() || indices[tri + 2] >= vertices.size()) {
+				continue;
+			}
+			triangle[0] = vertices[indices[tri]];
+			triangle[1] = vertices[indices[tri + 1]];
+			triangle[2] = vertices[indices[tri + 2]];
+
+			// Collision geometry doesn't have a reliable winding, so slopes facing up or down are both walkable,
+			// the top surface will win when spans merge
+			glm::vec3 normal = glm::cross(triangle[1] - triangle[0], triangle[2] - triangle[0]);
+			float normalLength = glm::length(normal);
+			bool walkable = normalLength > 0.0f && glm::abs(normal.z / normalLength) >= walkableZ;
+
+			glm::vec3 triMin = glm::min(triangle[0], glm::min(triangle[1], triangle[2]));
+			glm::vec3 triMax = glm::max(triangle[0], glm::max(triangle[1], triangle[2]));
+			int y0 = glm::clamp(static_cast<int>((triMin.y - boundsMin.y) / cellSize), 0, gridSize.y - 1);
+			int y1 = glm::clamp(static_cast<int>((triMax.y - boundsMin.y) / cellSize), 0, gridSize.y - 1);
+
+			rowRemainder = triangle;
+			for (int y = y0; y <= y1; y++) {
+				float rowEdge = boundsMin.y + (y + 1) * cellSize;
+				ClipPolygon(rowRemainder, row, 1, rowEdge, false);
+				ClipPolygon(rowRemainder, scratch, 1, rowEdge, true);
+				std::swap(rowRemainder, scratch);
+				if (row.size() < 3) {
+					continue;
+				}
+
+				float rowMinX = row[0].x, rowMaxX = row[0].x;
+				for (const glm::vec3& pos : row) {
+					rowMinX = glm::min(rowMinX, pos.x);
+					rowMaxX = glm::max(rowMaxX, pos.x);
+				}
+				int x0 = glm::clamp(static_cast<int>((rowMinX - boundsMin.x) / cellSize), 0, gridSize.x - 1);
+				int x1 = glm::clamp(static_cast<int>((rowMaxX - boundsMin.x) / cellSize), 0, gridSize.x - 1);
+
+				cellRemainder = row;
+				for (int x = x0; x <= x1; x++) {
+					float cellEdge = boundsMin.x + (x + 1) * cellSize;
+					ClipPolygon(cellRemainder, cell, 0, cellEdge, false);
+					ClipPolygon(cellRemainder, scratch, 0, cellEdge, true);
+					std::swap(cellRemainder, scratch);
+					if (cell.size() < 3) {
+						continue;
+					}
+
+					float minZ = cell[0].z, maxZ = cell[0].z;
+					for (const glm::vec3& pos : cell) {
+						minZ = glm::min(minZ, pos.z);
+						maxZ = glm::max(maxZ, pos.z);
+					}
+					SolidSpan span;
+					span.Min = static_cast<int>(glm::floor((minZ - boundsMin.z) / cellHeight));
+					// Nudge the top down slightly so that floating point error doesn't lift flat floors up a whole cell
+					span.Max = glm::max(static_cast<int>(glm::ceil((maxZ - boundsMin.z) / cellHeight - 0.001f)), span.Min + 1);
+					span.Walkable = walkable;
+					AddSpan(columns[y * gridSize.x + x], span, 1);
+				}
+			}
+		}
+
+		// Let agents step up onto small obstacles like curbs and stairs, even though their sides aren't walkable
+		for (std::vector<SolidSpan>& column : columns) {
+			bool previousWalkable = false;
+			int previousMax = 0;
+			for (size_t ix = 0; ix < column.size(); ix++) {
+				bool walkable = column[ix].Walkable;
+				if (!walkable && previousWalkable && column[ix].Max - previousMax <= climbCells) {
+					column[ix].Walkable = true;
+				}
+				previousWalkable = walkable;
+				previousMax = column[ix].Max;
+			}
+		}
+
+		// Find the open space above each walkable span that an agent can stand in, stored in compressed rows
+		std::vector<uint32_t> columnOffsets(numCells + 1, 0);
+		std::vector<OpenSpan> spans;
+		for (size_t ix = 0; ix < numCells; ix++) {
+			const std::vector<SolidSpan>& column = columns[ix];
+			for (size_t span = 0; span < column.size(); span++) {
+				int ceiling = span + 1 < column.size() ? column[span + 1].Min : std::numeric_limits<int>::max() / 2;
+				if (column[span].Walkable && ceiling - column[span].Max >= heightCells) {
+					spans.push_back({ column[span].Max, ceiling, { NO_SPAN, NO_SPAN, NO_SPAN, NO_SPAN }, 0, NO_REGION, false });
+				}
+			}
+			columnOffsets[ix + 1] = static_cast<uint32_t>(spans.size());
+		}
+		columns.clear();
+		columns.shrink_to_fit();
+
+		// Connect spans to their neighbors if an agent can step between them without hitting their head
+		for (int y = 0; y < gridSize.y; y++) {
+			for (int x = 0; x < gridSize.x; x++) {
+				const uint32_t column = y * gridSize.x + x;
+				for (uint32_t ix = columnOffsets[column]; ix < columnOffsets[column + 1]; ix++) {
+					OpenSpan& span = spans[ix];
+					for (int dir = 0; dir < 4; dir++) {
+						int nx = x + DIR_X[dir], ny = y + DIR_Y[dir];
+						if (nx < 0 || ny < 0 || nx >= gridSize.x || ny >= gridSize.y) {
+							continue;
+						}
+						const uint32_t neighborColumn = ny * gridSize.x + nx;
+						for (uint32_t other = columnOffsets[neighborColumn]; other < columnOffsets[neighborColumn + 1]; other++) {
+							const OpenSpan& neighbor = spans[other];
+							int gap = glm::min(span.Ceiling, neighbor.Ceiling) - glm::max(span.Floor, neighbor.Floor);
+							if (glm::abs(neighbor.Floor - span.Floor) <= climbCells && gap >= heightCells) {
+								span.Connections[dir] = static_cast<int>(other);
+								break;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		// Erode the walkable area by the agent's radius, using a breadth first search out from the border spans
+		std::deque<int> frontier;
+		for (size_t ix = 0; ix < spans.size(); ix++) {
+			OpenSpan& span = spans[ix];
+			bool isBorder = false;
+			for (int dir = 0; dir < 4; dir++) {
+				isBorder |= span.Connections[dir] == NO_SPAN;
+			}
+			span.Distance = isBorder ? 0 : std::numeric_limits<int>::max();
+			if (isBorder) {
+				frontier.push_back(static_cast<int>(ix));
+			}
+		}
+		while (!frontier.empty()) {
+			const OpenSpan& span = spans[frontier.front()];
+			frontier.pop_front();
+			for (int dir = 0; dir < 4; dir++) {
+				int neighbor = span.Connections[dir];
+				if (neighbor != NO_SPAN && spans[neighbor].Distance > span.Distance + 1) {
+					spans[neighbor].Distance = span.Distance + 1;
+					frontier.push_back(neighbor);
+				}
+			}
+		}
+		for (OpenSpan& span : spans) {
+			span.Eroded = span.Distance < radiusCells;
+		}
+		auto isFree = [&](int span) {
+			return span != NO_SPAN && !spans[span].Eroded && spans[span].Region == NO_REGION;
+		};
+
+		// Split the walkable spans into rectangles. Starting from a free span we grow a run along +X, then keep
+		// adding rows along +Y for as long as every span in the run has a free neighbor in the next row
+		std::vector<Region> regions;
+		for (int y = 0; y < gridSize.y; y++) {
+			for (int x = 0; x < gridSize.x; x++) {
+				const uint32_t column = y * gridSize.x + x;
+				for (uint32_t ix = columnOffsets[column]; ix < columnOffsets[column + 1]; ix++) {
+					if (!isFree(static_cast<int>(ix))) {
+						continue;
+					}
+
+					Region region;
+					region.x0 = x;
+					region.y0 = y;
+					region.Rows.emplace_back();
+					for (int span = static_cast<int>(ix); isFree(span); span = spans[span].Connections[DIR_POS_X]) {
+						region.Rows[0].push_back(span);
+						spans[span].Region = static_cast<int>(regions.size());
+					}
+
+					std::vector<int> nextRow;
+					while (true) {
+						nextRow.clear();
+						for (int span : region.Rows.back()) {
+							int next = spans[span].Connections[DIR_POS_Y];
+							if (!isFree(next) || (!nextRow.empty() && spans[nextRow.back()].Connections[DIR_POS_X] != next)) {
+								break;
+							}
+							nextRow.push_back(next);
+						}
+						if (nextRow.size() != region.Rows.back().size()) {
+							break;
+						}
+						for (int span : nextRow) {
+							spans[span].Region = static_cast<int>(regions.size());
+						}
+						region.Rows.push_back(nextRow);
+					}
+					regions.push_back(std::move(region));
+				}
+			}
+		}
+
+		if (regions.empty()) {
+			LOG_WARN("Navmesh bake found no walkable area");
+			return nullptr;
+		}
+
+		NavMesh::Sptr result = std::make_shared<NavMesh>();
+		result->_origin = boundsMin;
+		result->_cellSize = cellSize;
+		result->_gridSize = gridSize;
+		result->_sourceHash = 0;
+
+		auto toWorld = [&](float x, float y, int floor) {
+			return glm::vec3(boundsMin.x + x * cellSize, boundsMin.y + y * cellSize, boundsMin.z + floor * cellHeight);
+		};
+
+		// Turn each region into a polygon, and find the portals to neighboring regions along each of it's sides
+		for (const Region& region : regions) {
+			const std::vector<int>& bottom = region.Rows.front();
+			const std::vector<int>& top = region.Rows.back();
+			const float x1 = static_cast<float>(region.x0 + bottom.size());
+			const float y1 = static_cast<float>(region.y0 + region.Rows.size());
+
+			NavMesh::Polygon poly;
+			poly.Vertices[0] = toWorld(static_cast<float>(region.x0), static_cast<float>(region.y0), spans[bottom.front()].Floor);
+			poly.Vertices[1] = toWorld(x1, static_cast<float>(region.y0), spans[bottom.back()].Floor);
+			poly.Vertices[2] = toWorld(x1, y1, spans[top.back()].Floor);
+			poly.Vertices[3] = toWorld(static_cast<float>(region.x0), y1, spans[top.front()].Floor);
+
+			float floorSum = 0.0f;
+			for (const std::vector<int>& row : region.Rows) {
+				for (int span : row) {
+					floorSum += static_cast<float>(spans[span].Floor);
+				}
+			}
+			float averageFloor = floorSum / (region.Rows.size() * bottom.size());
+			poly.Center = toWorld((region.x0 + x1) * 0.5f, (region.y0 + y1) * 0.5f, 0);
+			poly.Center.z += averageFloor * cellHeight;
+			poly.FirstPortal = static_cast<uint32_t>(result->_portals.size());
+
+			// Walks along one side of the rectangle, adding a portal for each run of cells that connect to the same region
+			auto addSide = [&](const std::vector<int>& side, int dir, bool alongX, float edge, float start) {
+				size_t runStart = 0;
+				for (size_t ix = 0; ix <= side.size(); ix++) {
+					int runRegion = NO_REGION;
+					if (ix < side.size()) {
+						int neighbor = spans[side[ix]].Connections[dir];
+						runRegion = neighbor != NO_SPAN && !spans[neighbor].Eroded ? spans[neighbor].Region : NO_REGION;
+					}
+					int startNeighbor = spans[side[runStart]].Connections[dir];
+					int startRegion = startNeighbor != NO_SPAN && !spans[startNeighbor].Eroded ? spans[startNeighbor].Region : NO_REGION;
+					if (ix < side.size() && runRegion == startRegion) {
+						continue;
+					}
+
+					if (startRegion != NO_REGION) {
+						float from = start + runStart, to = start + ix;
+						NavMesh::Portal portal;
+						portal.Polygon = static_cast<uint32_t>(startRegion);
+						portal.A = alongX ? toWorld(from, edge, spans[side[runStart]].Floor) : toWorld(edge, from, spans[side[runStart]].Floor);
+						portal.B = alongX ? toWorld(to, edge, spans[side[ix - 1]].Floor) : toWorld(edge, to, spans[side[ix - 1]].Floor);
+						result->_portals.push_back(portal);
+					}
+					runStart = ix;
+				}
+			};
+
+			std::vector<int> leftSide, rightSide;
+			for (const std::vector<int>& row : region.Rows) {
+				leftSide.push_back(row.front());
+				rightSide.push_back(row.back());
+			}
+			addSide(bottom, DIR_NEG_Y, true, static_cast<float>(region.y0), static_cast<float>(region.x0));
+			addSide(top, DIR_POS_Y, true, y1, static_cast<float>(region.x0));
+			addSide(leftSide, DIR_NEG_X, false, static_cast<float>(region.x0), static_cast<float>(region.y0));
+			addSide(rightSide, DIR_POS_X, false, x1, static_cast<float>(region.y0));
+
+			poly.PortalCount = static_cast<uint32_t>(result->_portals.size()) - poly.FirstPortal;
+			result->_polygons.push_back(poly);
+		}
+
+		// Build the lookup grid from the spans that ended up in a region
+		result->_cellOffsets.assign(numCells + 1, 0);
+		for (size_t column = 0; column < numCells; column++) {
+			for (uint32_t ix = columnOffsets[column]; ix < columnOffsets[column + 1]; ix++) {
+				if (spans[ix].Region != NO_REGION) {
+					result->_cellFloors.push_back({ boundsMin.z + spans[ix].Floor * cellHeight, static_cast<uint32_t>(spans[ix].Region) });
+				}
+			}
+			result->_cellOffsets[column + 1] = static_cast<uint32_t>(result->_cellFloors.size());
+		}
+
+		result->_sourceHash = ComputeSourceHash(vertices, indices, settings);
+		result->_BuildGraph();
+
+		LOG_INFO("Baked navmesh with {} polygons and {} portals from {} triangles", result->_polygons.size(), result->_portals.size(), indices.size() / 3);
+		return result;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Navigation/NavMesh.h"
+
+class btCollisionWorld;
+
+namespace Gameplay::Navigation {
+	/// <summary>
+	/// The parameters for baking a navmesh, distances are in world units and angles are in degrees
+	/// </summary>
+	struct NavMeshBakeSettings {
+		// The size of the voxels on the XY plane, smaller values follow walls more closely but take longer to bake
+		float CellSize     = 0.3f;
+		// The size of the voxels along the Z axis
+		float CellHeight   = 0.2f;
+		// How tall an agent is, floors with less room than this above them are not walkable
+		float AgentHeight  = 2.0f;
+		// How wide an agent is, the mesh is shrunk away from walls and ledges by this much
+		float AgentRadius  = 0.6f;
+		// The highest step that an agent can walk up
+		float AgentMaxClimb = 0.5f;
+		// The steepest slope that an agent can walk on
+		float AgentMaxSlope = 45.0f;
+	};
+
+	/// <summary>
+	/// Bakes navmeshes from level geometry. This does not touch any rendering state, so it can be run
+	/// headless from tools or at load time
+	///
+	/// The geometry is voxelized into columns of solid spans, and the open space on top of walkable spans
+	/// with enough clearance becomes the walkable area. After shrinking that area by the agent radius, it
+	/// is split into rectangular regions of connected cells. Since the regions are rectangles, their contours
+	/// are already convex polygons, and the cells along their borders give us the portals between them
+	/// </summary>
+	class NavMeshBuilder {
+	public:
+		NavMeshBuilder() = delete;
+
+		/// <summary>
+		/// Collects the triangles of all the static collision objects in a physics world, in world space.
+		/// Kinematic bodies and triggers are skipped, since they can move or be walked through
+		/// </summary>
+		/// <param name="world">The physics world to collect from</param>
+		/// <param name="outVertices">Will have the triangle vertices appended to it</param>
+		/// <param name="outIndices">Will have the triangle indices appended to it</param>
+		static void GatherCollisionGeometry(const btCollisionWorld* world, std::vector<glm::vec3>& outVertices, std::vector<uint32_t>& outIndices);
+		/// <summary>
+		/// Calculates a hash of which bodies GatherCollisionGeometry would collect from, and where they are. Much
+		/// cheaper than gathering, so it can be used to tell when the static geometry needs gathering again
+		/// </summary>
+		/// <param name="world">The physics world to check</param>
+		static uint64_t ComputeCollisionBodiesHash(const btCollisionWorld* world);
+
+		/// <summary>
+		/// Calculates a hash of some geometry and bake settings, used to tell if a cached mesh is stale
+		/// </summary>
+		static uint64_t ComputeSourceHash(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const NavMeshBakeSettings& settings);
+
+		/// <summary>
+		/// Bakes a navmesh from a triangle soup, with Z being up
+		/// </summary>
+		/// <param name="vertices">The world space vertices of the geometry</param>
+		/// <param name="indices">The indices of the triangles, 3 per triangle</param>
+		/// <param name="settings">The settings to bake with</param>
+		/// <returns>The baked mesh, or nullptr if there is nothing walkable</returns>
+		static NavMesh::Sptr Bake(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const NavMeshBakeSettings& settings = NavMeshBakeSettings());
+	};
+}
@@ -0,0 +1,257 @@
+#include "Gameplay/Navigation/PathService.h"
+
+#include <chrono>
+
+#include "Utils/ThreadPool.h"
+
+namespace Gameplay::Navigation {
+	PathService::PathService() :
+		_source(nullptr),
+		_nextTicket(1),
+		_mainThreadBudgetUs(500.0f),
+		_cacheCapacity(256),
+		_tickets(),
+		_inFlight(),
+		_cache(),
+		_cacheOrder(),
+		_mainContext(),
+		_maxWorkers(0),
+		_mutex(),
+		_tasksDone(),
+		_isStopping(false),
+		_runningTasks(0),
+		_jobs(),
+		_completed()
+	{ }
+
+	PathService::~PathService() {
+		// Our tasks may still be on the pool, anything they haven't picked up yet is dropped
+		std::unique_lock<std::mutex> lock(_mutex);
+		_isStopping = true;
+		_tasksDone.wait(lock, [this]() { return _runningTasks == 0; });
+	}
+
+	void PathService::SetWorkerCount(int count) {
+		_maxWorkers = count;
+		_StartTasks();
+	}
+
+	void PathService::_StartTasks() {
+		int toStart = 0;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			while (_runningTasks < _maxWorkers && static_cast<size_t>(_runningTasks) < _jobs.size()) {
+				_runningTasks++;
+				toStart++;
+			}
+		}
+		for (int ix = 0; ix < toStart; ix++) {
+			ThreadPool::Get().Enqueue([this]() { _RunTask(); });
+		}
+	}
+
+	void PathService::SetSource(const NavGraph::Sptr& graph, const NavMesh::Sptr& mesh) {
+		std::shared_ptr<Source> source = std::make_shared<Source>();
+		source->Graph = graph;
+		source->Mesh = mesh;
+		_source = source;
+
+		// Node indices may mean something different now, so nothing new can join the old searches
+		_cache.clear();
+		_cacheOrder.clear();
+		_inFlight.clear();
+	}
+
+	uint64_t PathService::_MakeKey(uint32_t start, uint32_t goal) {
+		return (static_cast<uint64_t>(start) << 32) | goal;
+	}
+
+	PathTicket PathService::Request(const glm::vec3& start, const glm::vec3& goal) {
+		PathTicket ticket = _nextTicket++;
+		if (_nextTicket == INVALID_TICKET) {
+			_nextTicket++;
+		}
+
+		Ticket& request = _tickets[ticket];
+		request.Start   = start;
+		request.Goal    = goal;
+		request.IsReady = false;
+		request.Status  = PathStatus::NoPath;
+		request.Source  = _source;
+
+		// Resolve the positions to nodes now, so that any requests that start and end in the same places can share a search
+		const NavGraph* graph = _source == nullptr ? nullptr : (_source->Mesh != nullptr ? &_source->Mesh->GetGraph() : _source->Graph.get());
+		if (graph == nullptr || graph->GetNodeCount() == 0) {
+			_Finish(ticket, PathStatus::EmptyGraph, nullptr, _source);
+			return ticket;
+		}
+		uint32_t startNode = _source->Mesh != nullptr ? _source->Mesh->FindPolygon(start) : graph->FindNearestNode(start);
+		uint32_t goalNode = _source->Mesh != nullptr ? _source->Mesh->FindPolygon(goal) : graph->FindNearestNode(goal);
+		if (startNode == NavGraph::NO_NODE || goalNode == NavGraph::NO_NODE) {
+			_Finish(ticket, PathStatus::InvalidNode, nullptr, _source);
+			return ticket;
+		}
+
+		const uint64_t key = _MakeKey(startNode, goalNode);
+		auto cached = _cache.find(key);
+		if (cached != _cache.end()) {
+			_Finish(ticket, cached->second.Status, cached->second.Result, _source);
+			return ticket;
+		}
+
+		auto inFlight = _inFlight.find(key);
+		if (inFlight != _inFlight.end()) {
+			inFlight->second->Tickets.push_back(ticket);
+			return ticket;
+		}
+
+		Job job;
+		job.Start   = startNode;
+		job.Goal    = goalNode;
+		job.Source  = _source;
+		job.Waiting = std::make_shared<WaitList>();
+		job.Waiting->Tickets.push_back(ticket);
+		job.Status  = PathStatus::NoPath;
+		_inFlight[key] = job.Waiting;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_jobs.push_back(std::move(job));
+		}
+		_StartTasks();
+		return ticket;
+	}
+
+	bool PathService::Poll(PathTicket ticket, PathStatus& outStatus, std::vector<glm::vec3>& outPath) {
+		auto it = _tickets.find(ticket);
+		if (it == _tickets.end() || !it->second.IsReady) {
+			return false;
+		}
+
+		const Ticket& request = it->second;
+		outStatus = request.Status;
+		outPath.clear();
+		if (request.Status == PathStatus::Success) {
+			// Paths are stored from the goal back to the start, since agents walk them from the back
+			if (request.Source->Mesh != nullptr) {
+				thread_local std::vector<glm::vec3> corners;
+				corners.clear();
+				request.Source->Mesh->StringPull(request.Start, request.Goal, *request.Result, corners);
+				for (size_t ix = corners.size() - 1; ix > 0; ix--) {
+					outPath.push_back(corners[ix]);
+				}
+			} else {
+				const std::vector<uint32_t>& nodes = *request.Result;
+				for (size_t ix = nodes.size() - 1; ix > 0; ix--) {
+					outPath.push_back(request.Source->Graph->GetNodePosition(nodes[ix]));
+				}
+				// Both ends are at the same node, just head straight for it
+				if (nodes.size() == 1) {
+					outPath.push_back(request.Source->Graph->GetNodePosition(nodes[0]));
+				}
+			}
+		}
+
+		_tickets.erase(it);
+		return true;
+	}
+
+	void PathService::Cancel(PathTicket ticket) {
+		// Any search the ticket is waiting on will skip it when it finishes
+		_tickets.erase(ticket);
+	}
+
+	void PathService::_Solve(Job& job, NavGraph::SearchContext& context) {
+		const NavGraph& graph = job.Source->Mesh != nullptr ? job.Source->Mesh->GetGraph() : *job.Source->Graph;
+		std::vector<uint32_t> path;
+		job.Status = graph.FindPath(job.Start, job.Goal, path, context);
+		job.Result = std::make_shared<const std::vector<uint32_t>>(std::move(path));
+	}
+
+	void PathService::_RunTask() {
+		// Each thread has it's own scratch space, so they can search the same graph at once
+		thread_local NavGraph::SearchContext context;
+		while (true) {
+			Job job;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				if (_isStopping || _jobs.empty()) {
+					_runningTasks--;
+					_tasksDone.notify_all();
+					return;
+				}
+				job = std::move(_jobs.front());
+				_jobs.pop_front();
+			}
+
+			_Solve(job, context);
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_completed.push_back(std::move(job));
+		}
+	}
+
+	void PathService::Update() {
+		// Without any workers, we solve what we can fit into our budget on the main thread. We always
+		// do at least one search, so that requests can't be starved by a tiny budget
+		if (_maxWorkers <= 0) {
+			auto start = std::chrono::high_resolution_clock::now();
+			std::unique_lock<std::mutex> lock(_mutex);
+			while (!_jobs.empty()) {
+				Job job = std::move(_jobs.front());
+				_jobs.pop_front();
+				_Solve(job, _mainContext);
+				_completed.push_back(std::move(job));
+
+				std::chrono::duration<float, std::micro> elapsed = std::chrono::high_resolution_clock::now() - start;
+				if (elapsed.count() >= _mainThreadBudgetUs) {
+					break;
+				}
+			}
+		}
+
+		std::deque<Job> completed;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			completed.swap(_completed);
+		}
+
+		for (const Job& job : completed) {
+			const uint64_t key = _MakeKey(job.Start, job.Goal);
+			// Results from an old source still go to the tickets that asked for them, but shouldn't be reused
+			if (job.Source == _source) {
+				_AddToCache(key, job.Status, job.Result);
+				auto inFlight = _inFlight.find(key);
+				if (inFlight != _inFlight.end() && inFlight->second == job.Waiting) {
+					_inFlight.erase(inFlight);
+				}
+			}
+			for (PathTicket ticket : job.Waiting->Tickets) {
+				_Finish(ticket, job.Status, job.Result, job.Source);
+			}
+		}
+	}
+
+	void PathService::_Finish(PathTicket ticket, PathStatus status, const Corridor& result, const SourcePtr& source) {
+		auto it = _tickets.find(ticket);
+		if (it == _tickets.end()) {
+			return;
+		}
+		it->second.IsReady = true;
+		it->second.Status  = status;
+		it->second.Result  = result;
+		it->second.Source  = source;
+	}
+
+	void PathService::_AddToCache(uint64_t key, PathStatus status, const Corridor& result) {
+		if (_cache.find(key) != _cache.end()) {
+			return;
+		}
+		// Evict the oldest results once we're full
+		while (_cache.size() >= _cacheCapacity && !_cacheOrder.empty()) {
+			_cache.erase(_cacheOrder.front());
+			_cacheOrder.pop_front();
+		}
+		_cache[key] = { status, result };
+		_cacheOrder.push_back(key);
+	}
+}
@@ -0,0 +1,161 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <unordered_map>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/Navigation/NavGraph.h"
+#include "Gameplay/Navigation/NavMesh.h"
+#include "Utils/Macros.h"
+
+namespace Gameplay::Navigation {
+	// Identifies a path request made to a PathService
+	typedef uint32_t PathTicket;
+
+	/// <summary>
+	/// Queues up path requests so that they don't all have to be solved on the frame they are made
+	///
+	/// Requests are resolved to a pair of start and goal nodes (or polygons if there is a navmesh) when they are
+	/// made, and requests for the same pair share a single search. Searches run on the shared ThreadPool, or on the
+	/// main thread in Update under a time budget if no workers are allowed. Recent results are cached until the source
+	/// graph changes
+	/// </summary>
+	class PathService {
+	public:
+		MAKE_PTRS(PathService);
+
+		// A ticket that never refers to a request
+		static constexpr PathTicket INVALID_TICKET = 0;
+
+		PathService();
+		~PathService();
+
+		PathService(const PathService& other) = delete;
+		PathService& operator=(const PathService& other) = delete;
+
+		/// <summary>
+		/// Sets how many pool workers can be solving requests at once. With 0 workers, requests are solved on the main thread in Update
+		/// </summary>
+		void SetWorkerCount(int count);
+		/// <summary>
+		/// Gets the most pool workers that can be solving requests at once
+		/// </summary>
+		int GetWorkerCount() const { return _maxWorkers; }
+
+		/// <summary>
+		/// Sets how long Update can spend solving requests on the main thread, in microseconds. Only used when there are no workers
+		/// </summary>
+		void SetMainThreadBudget(float microseconds) { _mainThreadBudgetUs = microseconds; }
+
+		/// <summary>
+		/// Sets the graph and navmesh that paths are found on, and clears the cache. If there is a mesh, paths are
+		/// found on it and the graph is ignored. Searches that are already running will finish on the old source
+		/// </summary>
+		void SetSource(const NavGraph::Sptr& graph, const NavMesh::Sptr& mesh);
+
+		/// <summary>
+		/// Requests a path between two positions
+		/// </summary>
+		/// <returns>A ticket to poll for the path with</returns>
+		PathTicket Request(const glm::vec3& start, const glm::vec3& goal);
+		/// <summary>
+		/// Checks if a request has been solved. Once this returns true the ticket is no longer valid
+		/// </summary>
+		/// <param name="ticket">The ticket returned by Request</param>
+		/// <param name="outStatus">Will store if the search succeeded, or why it failed</param>
+		/// <param name="outPath">Will store the points along the path, ordered from the goal back towards
+		/// the start (the start itself is excluded)</param>
+		/// <returns>True if the request is finished, false if it's still pending (or the ticket is invalid)</returns>
+		bool Poll(PathTicket ticket, PathStatus& outStatus, std::vector<glm::vec3>& outPath);
+		/// <summary>
+		/// Cancels a request, the ticket will no longer be valid
+		/// </summary>
+		void Cancel(PathTicket ticket);
+
+		/// <summary>
+		/// Collects the results from the workers, or solves requests within the main thread budget. Should be called once a frame
+		/// </summary>
+		void Update();
+
+		/// <summary>
+		/// Gets the number of searches waiting to be solved or collected
+		/// </summary>
+		size_t GetPendingCount() const { return _inFlight.size(); }
+		/// <summary>
+		/// Gets the number of results in the cache
+		/// </summary>
+		size_t GetCacheSize() const { return _cache.size(); }
+
+	protected:
+		// The graph and mesh that a search was run on, kept alive by any search still using it
+		struct Source {
+			NavGraph::Sptr Graph;
+			NavMesh::Sptr  Mesh;
+		};
+		typedef std::shared_ptr<const Source> SourcePtr;
+		typedef std::shared_ptr<const std::vector<uint32_t>> Corridor;
+
+		// The tickets waiting on a search, only ever touched on the main thread
+		struct WaitList {
+			std::vector<PathTicket> Tickets;
+		};
+
+		struct Job {
+			uint32_t                  Start;
+			uint32_t                  Goal;
+			SourcePtr                 Source;
+			std::shared_ptr<WaitList> Waiting;
+			PathStatus                Status;
+			Corridor                  Result;
+		};
+
+		struct Ticket {
+			glm::vec3  Start;
+			glm::vec3  Goal;
+			bool       IsReady;
+			PathStatus Status;
+			Corridor   Result;
+			SourcePtr  Source;
+		};
+
+		struct CacheEntry {
+			PathStatus Status;
+			Corridor   Result;
+		};
+
+		SourcePtr  _source;
+		PathTicket _nextTicket;
+		float      _mainThreadBudgetUs;
+		size_t     _cacheCapacity;
+
+		std::unordered_map<PathTicket, Ticket> _tickets;
+		// The searches for the current source that have not finished yet, by key, so duplicate requests can join them
+		std::unordered_map<uint64_t, std::shared_ptr<WaitList>> _inFlight;
+		std::unordered_map<uint64_t, CacheEntry> _cache;
+		std::deque<uint64_t> _cacheOrder;
+
+		NavGraph::SearchContext  _mainContext;
+		int                      _maxWorkers;
+		std::mutex               _mutex;
+		std::condition_variable  _tasksDone;
+		// Guarded by _mutex
+		bool                     _isStopping;
+		int                      _runningTasks;
+		std::deque<Job>          _jobs;
+		std::deque<Job>          _completed;
+
+		static uint64_t _MakeKey(uint32_t start, uint32_t goal);
+		static void _Solve(Job& job, NavGraph::SearchContext& context);
+		/// <summary>
+		/// Hands the queued jobs out to the pool, if we're allowed any more workers
+		/// </summary>
+		void _StartTasks();
+		void _RunTask();
+		void _Finish(PathTicket ticket, PathStatus status, const Corridor& result, const SourcePtr& source);
+		void _AddToCache(uint64_t key, PathStatus status, const Corridor& result);
+	};
+}
@@ -5,6 +5,7 @@
 namespace Gameplay::Physics {
 	/// <summary>
 	/// A complex collider type that allows us to construct collision hulls from arbitrary convex meshes
+	/// The hull is cooked from the mesh's CPU-side data and cached next to the mesh file, see CollisionCooker
 	/// </summary>
 	class ConvexMeshCollider final : public ICollider {
 	public:
@@ -19,7 +20,8 @@ namespace Gameplay::Physics {
 		virtual void FromJson(const nlohmann::json& data) override;
 
 	protected:
-		btTriangleMesh* _triMesh;
+		// The vertices of the cooked hull, copied from the mesh so that the shape can be rebuilt
+		std::vector<glm::vec3> _hull;
 		ConvexMeshCollider();
 
 		virtual btCollisionShape* CreateShape() const override;
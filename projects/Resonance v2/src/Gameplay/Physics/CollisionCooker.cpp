@@ -0,0 +1,107 @@
+#include "Gameplay/Physics/CollisionCooker.h"
+
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <btBulletCollisionCommon.h>
+#include <BulletCollision/CollisionShapes/btShapeHull.h>
+
+#include "Utils/FileHelpers.h"
+#include "Logging.h"
+
+namespace Gameplay::Physics {
+	bool CollisionCooker::CookConvexHull(const std::vector<glm::vec3>& positions, std::vector<glm::vec3>& outHull, bool highDetail) {
+		outHull.clear();
+		if (positions.size() < 4) {
+			LOG_WARN("Cannot cook a convex hull from {} points", positions.size());
+			return false;
+		}
+
+		// Wrap the source points in a temporary shape so that btShapeHull can query their support
+		btConvexHullShape source;
+		for (const glm::vec3& pos : positions) {
+			source.addPoint(btVector3(pos.x, pos.y, pos.z), false);
+		}
+		source.recalcLocalAabb();
+
+		// The hull shape will calculate the reduced convex hull that contains our points
+		btShapeHull hull(&source);
+		if (!hull.buildHull(source.getMargin(), highDetail ? 1 : 0)) {
+			LOG_WARN("Failed to build hull for convex mesh");
+			return false;
+		}
+
+		outHull.reserve(hull.numVertices());
+		const btVector3* vertices = hull.getVertexPointer();
+		for (int ix = 0; ix < hull.numVertices(); ix++) {
+			outHull.push_back(glm::vec3(vertices[ix].x(), vertices[ix].y(), vertices[ix].z()));
+		}
+		return true;
+	}
+
+	bool CollisionCooker::LoadHull(const std::string& path, const std::string& sourcePath, std::vector<glm::vec3>& outHull) {
+		FileHelpers::FileBuffer file;
+		if (!FileHelpers::ReadFileBuffer(path, file) || file.Size < sizeof(HullHeader)) {
+			return false;
+		}
+
+		HullHeader header;
+		memcpy(&header, file.Data, sizeof(HullHeader));
+		if (memcmp(header.HeaderBytes, HullHeader().HeaderBytes, 4) != 0 || header.Version != 0x02) {
+			LOG_WARN("Collision hull \"{}\" is invalid or an unsupported version", path);
+			return false;
+		}
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		_GetSourceStamp(sourcePath, sourceSize, sourceTime);
+		if (header.SourceSize != sourceSize || header.SourceTime != sourceTime) {
+			LOG_INFO("\"{}\" has changed, re-cooking collision hull", sourcePath);
+			return false;
+		}
+		if (file.Size < sizeof(HullHeader) + header.NumPoints * sizeof(glm::vec3)) {
+			LOG_WARN("Collision hull \"{}\" is truncated", path);
+			return false;
+		}
+
+		outHull.resize(header.NumPoints);
+		memcpy(outHull.data(), file.Data + sizeof(HullHeader), header.NumPoints * sizeof(glm::vec3));
+		return true;
+	}
+
+	bool CollisionCooker::SaveHull(const std::string& path, const std::string& sourcePath, const std::vector<glm::vec3>& hull) {
+		std::ofstream file(path, std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to open \"{}\" for writing collision hull", path);
+			return false;
+		}
+
+		HullHeader header = HullHeader();
+		header.Version    = 0x02;
+		header.NumPoints  = static_cast<uint32_t>(hull.size());
+		_GetSourceStamp(sourcePath, header.SourceSize, header.SourceTime);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(HullHeader));
+		file.write(reinterpret_cast<const char*>(hull.data()), hull.size() * sizeof(glm::vec3));
+		return file.good();
+	}
+
+	std::string CollisionCooker::GetHullPath(const std::string& meshPath) {
+		return meshPath + ".hull";
+	}
+
+	void CollisionCooker::_GetSourceStamp(const std::string& sourcePath, uint64_t& outSize, int64_t& outTime) {
+		outSize = 0;
+		outTime = 0;
+		std::error_code error;
+		const uintmax_t size = std::filesystem::file_size(sourcePath, error);
+		if (error) {
+			return;
+		}
+		const std::filesystem::file_time_type time = std::filesystem::last_write_time(sourcePath, error);
+		if (error) {
+			return;
+		}
+		outSize = static_cast<uint64_t>(size);
+		outTime = static_cast<int64_t>(time.time_since_epoch().count());
+	}
+}
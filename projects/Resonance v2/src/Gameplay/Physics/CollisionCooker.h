@@ -0,0 +1,76 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// Cooks render geometry into simplified collision data ahead of time, so that colliders can be
+	/// created without reading anything back from the GPU, and so that narrow-phase tests run against
+	/// a small hull rather than every triangle in the render mesh
+	///
+	/// Cooked hulls are stored next to the mesh they were generated from, in the same way that the
+	/// OptimizedObjLoader caches binary meshes
+	/// </summary>
+	class CollisionCooker {
+	public:
+		CollisionCooker() = delete;
+
+		/// <summary>
+		/// Computes a simplified convex hull around a cloud of points. The hull is built by sampling the
+		/// support of the points along a fixed set of directions, so it's size is bounded regardless of
+		/// how many points are in the source (at most 62 vertices, or a few hundred with highDetail)
+		/// </summary>
+		/// <param name="positions">The points to wrap, typically the vertex positions of a mesh</param>
+		/// <param name="outHull">Will store the vertices of the simplified hull</param>
+		/// <param name="highDetail">True to sample more directions, for large or highly curved props</param>
+		/// <returns>True if the hull was built, false if otherwise</returns>
+		static bool CookConvexHull(const std::vector<glm::vec3>& positions, std::vector<glm::vec3>& outHull, bool highDetail = false);
+
+		/// <summary>
+		/// Loads a hull that was previously cooked with SaveHull. The hull remembers the size and write time of
+		/// the mesh it was cooked from, and is only loaded if the mesh still matches
+		/// </summary>
+		/// <param name="path">The path to the hull file</param>
+		/// <param name="sourcePath">The path to the mesh file the hull was cooked from</param>
+		/// <param name="outHull">Will store the vertices of the hull</param>
+		/// <returns>True if the hull was loaded, false if the file is missing, invalid or out of date</returns>
+		static bool LoadHull(const std::string& path, const std::string& sourcePath, std::vector<glm::vec3>& outHull);
+		/// <summary>
+		/// Saves a cooked hull to a file
+		/// </summary>
+		/// <param name="path">The path to the hull file to create</param>
+		/// <param name="sourcePath">The path to the mesh file the hull was cooked from</param>
+		/// <param name="hull">The vertices of the hull</param>
+		/// <returns>True if the hull was saved, false if otherwise</returns>
+		static bool SaveHull(const std::string& path, const std::string& sourcePath, const std::vector<glm::vec3>& hull);
+
+		/// <summary>
+		/// Gets the path that the cooked hull for a mesh file should be stored at
+		/// </summary>
+		/// <param name="meshPath">The path to the mesh file the hull was cooked from</param>
+		static std::string GetHullPath(const std::string& meshPath);
+
+	protected:
+		// Will be put at the start of the hull file, contains info about the contents of the file
+		struct HullHeader {
+			// A check value so we can ensure that we're loading in the right file type
+			char     HeaderBytes[4] ={ 'C', 'H', 'U', 'L' };
+			// The version code, we can use this to create different loaders if our format changes
+			uint16_t Version = 0;
+			// The number of hull vertices that follow the header
+			uint32_t NumPoints = 0;
+			uint32_t Reserved = 0;
+			// The size and write time of the mesh file the hull was cooked from, so edited meshes get re-cooked
+			uint64_t SourceSize = 0;
+			int64_t  SourceTime = 0;
+		};
+
+		/// <summary>
+		/// Gets the size and write time of a mesh file, both are left at 0 if the file can't be found on disk (ex: it's
+		/// in an asset pack, and can't have been edited)
+		/// </summary>
+		static void _GetSourceStamp(const std::string& sourcePath, uint64_t& outSize, int64_t& outTime);
+	};
+}
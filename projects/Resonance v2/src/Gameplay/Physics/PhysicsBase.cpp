@@ -137,6 +137,16 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		return _collisionMask;
 	}
 
+	bool PhysicsBase::GetWorldAabb(glm::vec3& outMin, glm::vec3& outMax) {
+		btBroadphaseProxy* proxy = _GetBroadphaseHandle();
+		if (proxy == nullptr) {
+			return false;
+		}
+		outMin = glm::vec3(proxy->m_aabbMin.x(), proxy->m_aabbMin.y(), proxy->m_aabbMin.z());
+		outMax = glm::vec3(proxy->m_aabbMax.x(), proxy->m_aabbMax.y(), proxy->m_aabbMax.z());
+		return true;
+	}
+
 	ICollider::Sptr PhysicsBase::AddCollider(const ICollider::Sptr& collider) {
 		if (_scene != nullptr) {
 			collider->Awake(GetGameObject());
@@ -203,6 +213,15 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		return wasDirty;
 	}
 
+	bool PhysicsBase::_HasDirtyColliders() const {
+		for (const auto& collider : _colliders) {
+			if (collider->_isDirty) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	bool PhysicsBase::_HandleGroupDirty() {
 		// If the group or mask have changed, notify bullet
 		if (_isGroupMaskDirty) {
@@ -69,6 +69,13 @@ namespace Gameplay {
 			/// <param name="collider">The collider to remove</param>
 			void RemoveCollider(const ICollider::Sptr& collider);
 
+			/// <summary>
+			/// Gets the world space bounds of this object, as last seen by the physics broadphase
+			/// </summary>
+			/// <param name="outMin">Will store the minimum corner of the bounds</param>
+			/// <param name="outMax">Will store the maximum corner of the bounds</param>
+			/// <returns>True if the object is in the physics world, false if otherwise</returns>
+			bool GetWorldAabb(glm::vec3& outMin, glm::vec3& outMax);
 
 			/// <summary>
 			/// Invoked for each RigidBody before the physics world is stepped forward a frame,
@@ -115,6 +122,8 @@ namespace Gameplay {
 
 			// Handles resolving any dirty state stuff for our object
 			bool _HandleShapeDirty();
+			// Checks if any of our colliders have changed, without rebuilding their shapes
+			bool _HasDirtyColliders() const;
 
 			bool _HandleGroupDirty();
 
@@ -0,0 +1,173 @@
+#include "Gameplay/Physics/RayBatch.h"
+
+#include "Utils/GlmBulletConversions.h"
+#include "Utils/ThreadPool.h"
+
+namespace Gameplay::Physics {
+	// How many rays a thread takes at a time
+	static constexpr uint32_t RAYS_PER_CHUNK = 64;
+
+	// Feeds the broadphase leaves a ray passes through to the narrowphase, same as btCollisionWorld::rayTest does
+	struct RayLeafCollector : btDbvt::ICollide {
+		btTransform                         From;
+		btTransform                         To;
+		btCollisionWorld::RayResultCallback& Callback;
+
+		RayLeafCollector(const btVector3& from, const btVector3& to, btCollisionWorld::RayResultCallback& callback) :
+			From(btQuaternion::getIdentity(), from),
+			To(btQuaternion::getIdentity(), to),
+			Callback(callback)
+		{ }
+
+		void Process(const btDbvtNode* leaf) {
+			// We've already hit something right at the start, nothing can be closer
+			if (Callback.m_closestHitFraction == btScalar(0.0f)) {
+				return;
+			}
+			btBroadphaseProxy* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+			btCollisionObject* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+			if (Callback.needsCollision(object->getBroadphaseHandle())) {
+				btCollisionWorld::rayTestSingle(From, To, object, object->getCollisionShape(), object->getWorldTransform(), Callback);
+			}
+		}
+	};
+
+	// Keeps track of which part of a shape the closest hit was on, so hits on merged meshes can be traced back to their bodies
+	struct ClosestPartRayCallback : btCollisionWorld::ClosestRayResultCallback {
+		int m_shapePart;
+
+		ClosestPartRayCallback(const btVector3& from, const btVector3& to) :
+			btCollisionWorld::ClosestRayResultCallback(from, to),
+			m_shapePart(-1)
+		{ }
+
+		virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override {
+			m_shapePart = rayResult.m_localShapeInfo != nullptr ? rayResult.m_localShapeInfo->m_shapePart : -1;
+			return btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+		}
+	};
+
+	RayBatch::RayBatch() :
+		_from(),
+		_to(),
+		_group(),
+		_mask(),
+		_pendingBatch(1),
+		_batchFrom(),
+		_batchTo(),
+		_batchGroup(),
+		_batchMask(),
+		_resultBatch(0),
+		_results(),
+		_world(nullptr),
+		_broadphase(nullptr),
+		_maxWorkers(-1)
+	{ }
+
+	RayBatch::~RayBatch() = default;
+
+	RayHandle RayBatch::Submit(const glm::vec3& from, const glm::vec3& to, int group, int mask) {
+		RayHandle handle = (static_cast<RayHandle>(_pendingBatch) << 32) | static_cast<uint32_t>(_from.size());
+		_from.push_back(from);
+		_to.push_back(to);
+		_group.push_back(group);
+		_mask.push_back(mask);
+		return handle;
+	}
+
+	uint32_t RayBatch::GetResultIndex(RayHandle handle) const {
+		if (handle == INVALID_RAY || static_cast<uint32_t>(handle >> 32) != _resultBatch) {
+			return NO_RESULT;
+		}
+		return static_cast<uint32_t>(handle);
+	}
+
+	void RayBatch::ForgetObject(const btCollisionObject* object) {
+		// Removing bodies is rare enough that a scan over the results is fine
+		for (const btCollisionObject*& hit : _results.Object) {
+			if (hit == object) {
+				hit = nullptr;
+			}
+		}
+	}
+
+	void RayBatch::Execute(btCollisionWorld* world) {
+		// The pending rays become the current batch, and the old batch's storage is re-used for the next one
+		_batchFrom.swap(_from);
+		_batchTo.swap(_to);
+		_batchGroup.swap(_group);
+		_batchMask.swap(_mask);
+		_from.clear();
+		_to.clear();
+		_group.clear();
+		_mask.clear();
+		_resultBatch = _pendingBatch++;
+		// Batch 0 is never used, so a zeroed handle can't look valid
+		if (_pendingBatch == 0) {
+			_pendingBatch++;
+		}
+
+		const uint32_t count = static_cast<uint32_t>(_batchFrom.size());
+		_results.HasHit.resize(count);
+		_results.Fraction.resize(count);
+		_results.Point.resize(count);
+		_results.Normal.resize(count);
+		_results.IsStatic.resize(count);
+		_results.Object.resize(count);
+		_results.Part.resize(count);
+
+		_world = world;
+		_broadphase = dynamic_cast<btDbvtBroadphase*>(world->getBroadphase());
+
+		// Without a dbvt broadphase we can't walk it ourselves, so the rays can only be cast one at a time
+		ThreadPool::Get().ParallelFor(count, RAYS_PER_CHUNK, [this](uint32_t begin, uint32_t end) {
+			// Each thread has it's own traversal stack, so they can walk the broadphase at once
+			thread_local TraversalStack stack;
+			for (uint32_t ix = begin; ix < end; ix++) {
+				_CastRay(ix, stack);
+			}
+		}, _broadphase == nullptr ? 0 : _maxWorkers);
+	}
+
+	void RayBatch::_CastRay(uint32_t index, TraversalStack& stack) {
+		// btVector3 is padded to 16 bytes, so we can't just reinterpret the packed arrays with ToBt
+		const btVector3 from(_batchFrom[index].x, _batchFrom[index].y, _batchFrom[index].z);
+		const btVector3 to(_batchTo[index].x, _batchTo[index].y, _batchTo[index].z);
+
+		ClosestPartRayCallback callback(from, to);
+		callback.m_collisionFilterGroup = _batchGroup[index];
+		callback.m_collisionFilterMask = _batchMask[index];
+
+		if (_broadphase == nullptr) {
+			_world->rayTest(from, to, callback);
+		} else {
+			btVector3 direction = to - from;
+			btScalar length = direction.length();
+			if (length > SIMD_EPSILON) {
+				direction /= length;
+				btVector3 inverse(
+					direction[0] == btScalar(0.0f) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0f) / direction[0],
+					direction[1] == btScalar(0.0f) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0f) / direction[1],
+					direction[2] == btScalar(0.0f) ? btScalar(BT_LARGE_FLOAT) : btScalar(1.0f) / direction[2]
+				);
+				unsigned int signs[3] = { inverse[0] < 0.0f, inverse[1] < 0.0f, inverse[2] < 0.0f };
+
+				// The broadphase keeps dynamic and static proxies in separate trees
+				RayLeafCollector collector(from, to, callback);
+				for (int set = 0; set < 2; set++) {
+					const btDbvt& tree = _broadphase->m_sets[set];
+					tree.rayTestInternal(tree.m_root, from, to, inverse, signs, length, btVector3(0, 0, 0), btVector3(0, 0, 0), stack, collector);
+				}
+			}
+		}
+
+		const bool hasHit = callback.hasHit();
+		_results.HasHit[index] = hasHit;
+		_results.Fraction[index] = callback.m_closestHitFraction;
+		_results.Point[index] = hasHit ? ToGlm(callback.m_hitPointWorld) : glm::vec3(0.0f);
+		_results.Normal[index] = hasHit ? ToGlm(callback.m_hitNormalWorld) : glm::vec3(0.0f);
+		_results.IsStatic[index] = hasHit && callback.m_collisionObject->isStaticObject();
+		_results.Object[index] = callback.m_collisionObject;
+		_results.Part[index] = hasHit ? callback.m_shapePart : -1;
+	}
+}
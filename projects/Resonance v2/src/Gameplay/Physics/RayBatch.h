@@ -0,0 +1,124 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <GLM/glm.hpp>
+#include <btBulletCollisionCommon.h>
+
+#include "Utils/Macros.h"
+
+namespace Gameplay::Physics {
+	// Identifies a ray submitted to a RayBatch, only valid until the batch after it is executed
+	typedef uint64_t RayHandle;
+
+	/// <summary>
+	/// Collects raycasts from gameplay code over a frame, and runs them all at once across the shared ThreadPool
+	/// after the physics step. Rays submitted in one frame have their results ready to read in the next
+	///
+	/// Each thread walks the broadphase trees with its own stack instead of going through btCollisionWorld::rayTest,
+	/// since the broadphase shares a single ray stack between callers unless Bullet is built with BT_THREADSAFE
+	/// </summary>
+	class RayBatch {
+	public:
+		MAKE_PTRS(RayBatch);
+
+		// A handle that never refers to a ray
+		static constexpr RayHandle INVALID_RAY = ~0ull;
+		// Returned by GetResultIndex if a handle's results are not available
+		static constexpr uint32_t NO_RESULT = ~0u;
+
+		// The results of the last executed batch, each ray's results are at the index returned by GetResultIndex
+		struct Results {
+			std::vector<uint8_t>                  HasHit;
+			// How far along the ray the hit was, from 0 to 1
+			std::vector<float>                    Fraction;
+			std::vector<glm::vec3>                Point;
+			std::vector<glm::vec3>                Normal;
+			// Whether the object that was hit is static, so callers that only care about that don't need the object
+			std::vector<uint8_t>                  IsStatic;
+			// The object that was hit, or nullptr if it has been removed from the world since the batch was executed
+			std::vector<const btCollisionObject*> Object;
+			// The shape part that was hit on meshes with several parts (ex: merged world geometry), or -1
+			std::vector<int>                      Part;
+		};
+
+		RayBatch();
+		~RayBatch();
+
+		RayBatch(const RayBatch& other) = delete;
+		RayBatch& operator=(const RayBatch& other) = delete;
+
+		/// <summary>
+		/// Sets the most pool workers that can help run the batch, the thread calling Execute always helps as well.
+		/// A negative count lets every worker in the pool help
+		/// </summary>
+		void SetWorkerCount(int count) { _maxWorkers = count; }
+		/// <summary>
+		/// Gets the most pool workers that can help run the batch
+		/// </summary>
+		int GetWorkerCount() const { return _maxWorkers; }
+
+		/// <summary>
+		/// Queues up a ray to be cast in the next call to Execute
+		/// </summary>
+		/// <param name="from">The start of the ray in world space</param>
+		/// <param name="to">The end of the ray in world space</param>
+		/// <param name="group">The collision filter group of the ray</param>
+		/// <param name="mask">The collision filter mask of the ray, only objects in these groups will be hit</param>
+		/// <returns>A handle to look up the results with once the batch has run</returns>
+		RayHandle Submit(const glm::vec3& from, const glm::vec3& to, int group = btBroadphaseProxy::DefaultFilter, int mask = btBroadphaseProxy::AllFilter);
+
+		/// <summary>
+		/// Casts all of the rays that have been submitted since the last call, replacing the previous results.
+		/// Must not be called while the world is being stepped or modified
+		/// </summary>
+		/// <param name="world">The world to cast the rays against</param>
+		void Execute(btCollisionWorld* world);
+
+		/// <summary>
+		/// Finds where a ray's results are stored in GetResults
+		/// </summary>
+		/// <param name="handle">The handle returned by Submit</param>
+		/// <returns>The index of the ray in the results, or NO_RESULT if the ray was not part of the last executed batch</returns>
+		uint32_t GetResultIndex(RayHandle handle) const;
+		/// <summary>
+		/// Gets the results of the last executed batch
+		/// </summary>
+		const Results& GetResults() const { return _results; }
+
+		/// <summary>
+		/// Clears an object out of the last executed batch's results, must be called before any object that was
+		/// in the world is deleted. The hits themselves are kept, only their Object is set to nullptr
+		/// </summary>
+		/// <param name="object">The object that is being removed from the world</param>
+		void ForgetObject(const btCollisionObject* object);
+
+		/// <summary>
+		/// Gets the number of rays waiting for the next call to Execute
+		/// </summary>
+		size_t GetPendingCount() const { return _from.size(); }
+
+	protected:
+		typedef btAlignedObjectArray<const btDbvtNode*> TraversalStack;
+
+		// The rays waiting for the next batch
+		std::vector<glm::vec3> _from;
+		std::vector<glm::vec3> _to;
+		std::vector<int>       _group;
+		std::vector<int>       _mask;
+		uint32_t               _pendingBatch;
+
+		// The rays in the last executed batch
+		std::vector<glm::vec3> _batchFrom;
+		std::vector<glm::vec3> _batchTo;
+		std::vector<int>       _batchGroup;
+		std::vector<int>       _batchMask;
+		uint32_t               _resultBatch;
+		Results                _results;
+
+		btCollisionWorld*      _world;
+		btDbvtBroadphase*      _broadphase;
+		int                    _maxWorkers;
+
+		void _CastRay(uint32_t index, TraversalStack& stack);
+	};
+}
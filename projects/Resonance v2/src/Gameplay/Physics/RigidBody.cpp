@@ -15,10 +15,13 @@ namespace Gameplay::Physics {
 	RigidBody::RigidBody(RigidBodyType type) :
 		PhysicsBase(),
 		_type(type),
+		_isWorldGeometry(false),
+		_isMerged(false),
 		_mass(1.0f),
 		_isMassDirty(true),
 		_body(nullptr),
 		_motionState(nullptr),
+		_syncedTransformVersion(0),
 		_linearDamping(0.0f),
 		_angularDamping(0.005f),
 		_inertia(btVector3()),
@@ -32,8 +35,15 @@ namespace Gameplay::Physics {
 
 	RigidBody::~RigidBody() {
 		if (_body != nullptr) {
-			// Remove from the physics world
-			_scene->GetPhysicsWorld()->removeRigidBody(_body);
+			// Make sure no raycast results are left pointing at us
+			_scene->GetRayBatch().ForgetObject(_body);
+
+			// Remove from the physics world, or from the merged mesh we're a part of
+			if (_isMerged) {
+				_scene->GetStaticWorld().MarkDirty(this);
+			} else {
+				_scene->GetPhysicsWorld()->removeRigidBody(_body);
+			}
 
 			// Clean up all our memory
 			delete _motionState;
@@ -78,7 +88,8 @@ namespace Gameplay::Physics {
 	}
 
 	const glm::vec3& RigidBody::GetLinearVelocity() const {
-		return ToGlm(_linearVelocity);
+		// Read dynamic bodies straight from Bullet, since we don't copy anything out of sleeping bodies
+		return _type == RigidBodyType::Dynamic && _body != nullptr && !_linearVelocityDirty ? ToGlm(_body->getLinearVelocity()) : ToGlm(_linearVelocity);
 	}
 
 	void RigidBody::SetAngularVelocity(const glm::vec3& value) {
@@ -88,7 +99,7 @@ namespace Gameplay::Physics {
 
 	glm::vec3 RigidBody::GetAngularVelocity() const
 	{
-		return glm::degrees(ToGlm(_angularVelocity));
+		return glm::degrees(_type == RigidBodyType::Dynamic && _body != nullptr && !_angularVelocityDirty ? ToGlm(_body->getAngularVelocity()) : ToGlm(_angularVelocity));
 	}
 
 	void RigidBody::SetAngularFactor(const glm::vec3& value) {
@@ -101,30 +112,39 @@ namespace Gameplay::Physics {
 	}
 
 	void RigidBody::ApplyForce(const glm::vec3& worldForce) {
+		_body->activate();
 		_body->applyCentralForce(ToBt(worldForce));
 	}
 
 	void RigidBody::ApplyForce(const glm::vec3& worldForce, const glm::vec3& localOffset) {
+		_body->activate();
 		_body->applyForce(ToBt(worldForce), ToBt(localOffset));
 	}
 
 	void RigidBody::ApplyImpulse(const glm::vec3& worldForce) {
+		_body->activate();
 		_body->applyCentralImpulse(ToBt(worldForce));
 	}
 
 	void RigidBody::ApplyImpulse(const glm::vec3& worldForce, const glm::vec3& localOffset) {
+		_body->activate();
 		_body->applyImpulse(ToBt(worldForce), ToBt(localOffset));
 	}
 
 	void RigidBody::ApplyTorque(const glm::vec3& worldTorque) {
+		_body->activate();
 		_body->applyTorque(ToBt(worldTorque));
 	}
 
 	void RigidBody::ApplyTorqueImpulse(const glm::vec3& worldTorque) {
+		_body->activate();
 		_body->applyTorqueImpulse(ToBt(worldTorque));
 	}
 
 	void RigidBody::SetType(RigidBodyType type) {
+		if (_isMerged && type != _type) {
+			_scene->GetStaticWorld().MarkDirty(this);
+		}
 		_type = type;
 		if (_body != nullptr) {
 			// Remove any static or kinematic flags for the object
@@ -143,6 +163,7 @@ namespace Gameplay::Physics {
 				// If dynamic, we need to restore gravity from the scene
 				_body->setCollisionFlags(flags);
 				_body->setGravity(_scene->GetPhysicsWorld()->getGravity());
+				_body->activate(true);
 			}
 		}
 	}
@@ -151,34 +172,91 @@ namespace Gameplay::Physics {
 		return _type;
 	}
 
+	void RigidBody::SetWorldGeometry(bool value) {
+		if (value != _isWorldGeometry && _scene != nullptr) {
+			_scene->GetStaticWorld().MarkDirty(this);
+		}
+		_isWorldGeometry = value;
+	}
+
+	bool RigidBody::IsWorldGeometry() const {
+		return _isWorldGeometry;
+	}
+
 	void RigidBody::PhysicsPreStep(float dt) {
+		// We're not in the world while we're merged, so any change means the merge has to be redone
+		if (_isMerged) {
+			if (GetGameObject()->GetTransformVersion() != _syncedTransformVersion || _isGroupMaskDirty || _isMassDirty || _HasDirtyColliders()) {
+				_scene->GetStaticWorld().MarkDirty(this);
+			}
+			return;
+		}
+
 		// Update any dirty state that may have changed
 		_HandleStateDirty();
 
-		if (_type != RigidBodyType::Static) {		
-			btTransform transform;
-			_CopyGameobjectTransformTo(transform);
-
-			// Copy to body and to it's motion state
-			if (_type == RigidBodyType::Dynamic) {
-				_body->setWorldTransform(transform);
-			} else {
-				// Kinematics prefer to be driven my motion state for some reason :|
-				_body->getMotionState()->setWorldTransform(transform);
-			}
+		// Only send our transform to Bullet if gameplay has moved us since we last synced
+		if (GetGameObject()->GetTransformVersion() != _syncedTransformVersion) {
+			_HandleTransformDirty();
+		}
+		// Static and kinematic bodies that weren't moved can go back to sleep, so that Bullet stops polling them
+		else if (_type != RigidBodyType::Dynamic && _body->isActive()) {
+			_body->setLinearVelocity(btVector3(0.0f, 0.0f, 0.0f));
+			_body->setAngularVelocity(btVector3(0.0f, 0.0f, 0.0f));
+			// Bullet doesn't update the bounds of sleeping bodies, make sure they're where we left them
+			_scene->GetPhysicsWorld()->updateSingleAabb(_body);
+			_body->forceActivationState(ISLAND_SLEEPING);
 		}
 	}
 
 	void RigidBody::PhysicsPostStep(float dt) {
-		// Kinematics are driven externally and statics don't move, so only need to get data out for dynamics!
-		if (_type == RigidBodyType::Dynamic) {
-			btTransform transform = _body->getWorldTransform();
-			_CopyGameobjectTransformFrom(transform);
+		// Bullet sends the transforms of bodies that moved to our motion state while stepping
+	}
+
+	void RigidBody::_HandleTransformDirty() {
+		btTransform transform;
+		_CopyGameobjectTransformTo(transform);
+
+		// Gameplay often writes back the transform we just gave it (ex: enemies clamping their height), there's
+		// no need to wake the body or reset it's interpolation for that
+		const btTransform& current = _body->getWorldTransform();
+		if (current.getOrigin().distance2(transform.getOrigin()) <= SIMD_EPSILON * SIMD_EPSILON &&
+			btFabs(current.getRotation().dot(transform.getRotation())) >= btScalar(1.0f) - SIMD_EPSILON) {
+			_syncedTransformVersion = GetGameObject()->GetTransformVersion();
+			return;
+		}
 
-			// Store a copy of our velocities
-			_linearVelocity = _body->getLinearVelocity();
-			_angularVelocity = _body->getAngularVelocity();
+		// Kinematics are driven by their motion state, which Bullet reads every step while they're awake
+		_motionState->SetTransform(transform);
+		_body->setWorldTransform(transform);
+		if (_type == RigidBodyType::Dynamic) {
+			// Don't let Bullet interpolate from where we were before being moved
+			_body->setInterpolationWorldTransform(transform);
 		}
+		_body->activate(true);
+
+		_syncedTransformVersion = GetGameObject()->GetTransformVersion();
+	}
+
+	RigidBody::MotionState::MotionState(RigidBody* owner) :
+		btMotionState(),
+		_owner(owner),
+		_transform(btTransform::getIdentity())
+	{ }
+
+	void RigidBody::MotionState::getWorldTransform(btTransform& worldTrans) const {
+		worldTrans = _transform;
+	}
+
+	void RigidBody::MotionState::setWorldTransform(const btTransform& /*worldTrans*/) {
+		// Bullet hands us the interpolated transform, which trails the body by up to a step. Gameplay that writes
+		// the transform back (ex: LookAt) would push that stale transform into the body and drag it backwards,
+		// so we follow the body's actual transform instead
+		_transform = _owner->_body->getWorldTransform();
+
+		// Copy our transform out to OpenGL, this doesn't count as gameplay moving us
+		_owner->_CopyGameobjectTransformFrom(_transform);
+		_owner->_syncedTransformVersion = _owner->GetGameObject()->GetTransformVersion();
 	}
 
 	void RigidBody::Awake() {
@@ -204,15 +282,16 @@ namespace Gameplay::Physics {
 		_shape->calculateLocalInertia(_mass, _inertia);
 		_isMassDirty = false;
 
-		// Create a default motion state instance for tracking the bodies motion
-		_motionState = new btDefaultMotionState();
+		// Create a motion state for Bullet to hand the body's transform back to us through
+		_motionState = new MotionState(this);
 
 		// Get the object's starting transform, create a bullet representation for it
 		btTransform transform; 
 		transform.setIdentity();
 		transform.setOrigin(ToBt(context->GetPosition()));
 		transform.setRotation(ToBt(context->GetRotation()));
-		_motionState->setWorldTransform(transform);
+		_motionState->SetTransform(transform);
+		_syncedTransformVersion = context->GetTransformVersion();
 
 		// Create the bullet rigidbody and add it to the physics scene
 		_body = new btRigidBody(_mass, _motionState, _shape, _inertia);
@@ -230,8 +309,11 @@ namespace Gameplay::Physics {
 			_body->setGravity(btVector3(0.0f, 0.0f, 0.0f));
 			_body->setCollisionFlags(_body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
 		}
-	
-		_body->setActivationState(DISABLE_DEACTIVATION);
+
+		// Dynamic bodies are allowed to fall asleep once they settle, static and kinematic bodies sleep until they're moved
+		if (_type != RigidBodyType::Dynamic) {
+			_body->forceActivationState(ISLAND_SLEEPING);
+		}
 
 		// Copy over group and mask info
 		_body->getBroadphaseProxy()->m_collisionFilterGroup = _collisionGroup;
@@ -241,6 +323,10 @@ namespace Gameplay::Physics {
 	void RigidBody::RenderImGui()
 	{
 		_isMassDirty |= LABEL_LEFT(ImGui::DragFloat, "Mass", &_mass, 0.1f, 0.0f);
+		bool isWorldGeometry = _isWorldGeometry;
+		if (LABEL_LEFT(ImGui::Checkbox, "World Geometry", &isWorldGeometry)) {
+			SetWorldGeometry(isWorldGeometry);
+		}
 		_RenderImGuiBase();
 	}
 
@@ -251,6 +337,7 @@ namespace Gameplay::Physics {
 		result["mass"] = _mass;
 		result["linear_damping"] = _linearDamping;
 		result["angular_damping"] = _angularDamping;
+		result["world_geometry"] = _isWorldGeometry;
 		// Write out base physics data
 		ToJsonBase(result);
 		return result;
@@ -263,6 +350,7 @@ namespace Gameplay::Physics {
 		result->_mass = data["mass"];
 		result->_linearDamping  = data["linear_damping"];
 		result->_angularDamping = data["angular_damping"];
+		result->_isWorldGeometry = JsonGet(data, "world_geometry", false);
 		// Read out base physics data
 		result->FromJsonBase(data);
 		return result;
@@ -273,12 +361,14 @@ namespace Gameplay::Physics {
 		if (_type == RigidBodyType::Dynamic) {
 			// If outside code has changed our velocity, send that to Bullet
 			if (_linearVelocityDirty) {
+				_body->activate();
 				_body->setLinearVelocity(_linearVelocity);
 				_linearVelocityDirty = false;
 			}
 
 			// If outside code has changed our angular velocity, send that to Bullet
 			if (_angularVelocityDirty) {
+				_body->activate();
 				_body->setAngularVelocity(_angularVelocity);
 				_angularVelocityDirty = false;
 			}
@@ -309,6 +399,7 @@ namespace Gameplay::Physics {
 				// Recalulcate our inertia properties and send to bullet
 				_shape->calculateLocalInertia(_mass, _inertia);
 				_body->setMassProps(_mass, _inertia);
+				_body->activate();
 			}
 			_isMassDirty = false;
 		}
@@ -152,15 +152,27 @@ namespace Gameplay::Physics {
 		/// </summary>
 		RigidBodyType GetType() const;
 
+		/// <summary>
+		/// Marks this body as part of the level (ex: walls and floors). Static world geometry is merged with
+		/// the rest of the level into a few triangle meshes when the scene starts, see StaticWorld
+		/// </summary>
+		/// <param name="value">True if the body is world geometry, false if otherwise</param>
+		void SetWorldGeometry(bool value);
+		/// <summary>
+		/// Returns true if this body has been marked as world geometry
+		/// </summary>
+		bool IsWorldGeometry() const;
+
 		/// <summary>
 		/// Invoked for each RigidBody before the physics world is stepped forward a frame,
-		/// handles body initialization, shape changes, mass changes, etc...
+		/// handles body initialization, shape changes, mass changes, etc... The gameobject's
+		/// transform is only sent to Bullet if something has moved it since the last sync
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
 		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// does nothing, Bullet copies the transforms of moving bodies out through our motion state
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
@@ -174,8 +186,14 @@ namespace Gameplay::Physics {
 
 
 	protected:
+		friend class StaticWorld;
+
 		// The physics update mode for the body (static, dynamic, kinematic)
 		RigidBodyType _type;
+		// True if this body can be merged into the scene's static world
+		bool          _isWorldGeometry;
+		// True while our body has been swapped out of the world for a merged mesh
+		bool          _isMerged;
 
 		// The mass of the object, in KG
 		float         _mass;
@@ -187,9 +205,34 @@ namespace Gameplay::Physics {
 		float _linearDamping;
 		mutable bool _isDampingDirty;
 
+		/// <summary>
+		/// Bullet only writes to the motion states of bodies that are awake, so sleeping and
+		/// static bodies cost nothing after the step
+		/// </summary>
+		class MotionState : public btMotionState {
+		public:
+			MotionState(RigidBody* owner);
+			virtual ~MotionState() = default;
+
+			// Inherited from btMotionState
+			virtual void getWorldTransform(btTransform& worldTrans) const override;
+			virtual void setWorldTransform(const btTransform& worldTrans) override;
+
+			/// <summary>
+			/// Sets the transform handed to Bullet, without copying it back to the gameobject
+			/// </summary>
+			void SetTransform(const btTransform& transform) { _transform = transform; }
+
+		protected:
+			RigidBody*  _owner;
+			btTransform _transform;
+		};
+
 		// Our bullet state stuff
 		btRigidBody*     _body;
-		btMotionState*   _motionState;
+		MotionState*     _motionState;
+		// The gameobject's transform version when we last synced with it
+		uint32_t         _syncedTransformVersion;
 		btVector3        _inertia;
 		btVector3        _linearVelocity;
 		bool             _linearVelocityDirty;
@@ -200,6 +243,8 @@ namespace Gameplay::Physics {
 
 		// Handles resolving any dirty state stuff for our object
 		void _HandleStateDirty();
+		// Sends the gameobject's transform to Bullet, waking the body up
+		void _HandleTransformDirty();
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
 	};
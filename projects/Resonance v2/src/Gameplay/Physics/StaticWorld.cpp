@@ -0,0 +1,370 @@
+#include "Gameplay/Physics/StaticWorld.h"
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <LinearMath/btConvexHullComputer.h>
+
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/RayBatch.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/GlmBulletConversions.h"
+#include "Logging.h"
+
+namespace Gameplay::Physics {
+	namespace {
+		// A cached BVH that was read from the cache file
+		struct CachedBvh {
+			uint64_t       SourceHash;
+			const uint8_t* Data;
+			uint32_t       Size;
+		};
+	}
+
+	StaticWorld::StaticWorld() :
+		_world(nullptr),
+		_rayBatch(nullptr),
+		_chunks(),
+		_isBuilt(false),
+		_isDirty(false),
+		_buildCount(0)
+	{ }
+
+	StaticWorld::~StaticWorld() {
+		Clear();
+	}
+
+	void StaticWorld::Build(btDynamicsWorld* world, RayBatch* rayBatch, const std::vector<std::shared_ptr<RigidBody>>& bodies, const std::string& cachePath) {
+		// Only the first build reads and writes the cache, later ones only re-merge the few bodies that changed
+		const bool isFullBuild = _chunks.empty();
+		const size_t firstNewChunk = _chunks.size();
+		_world = world;
+		_rayBatch = rayBatch;
+		_isBuilt = true;
+		_isDirty = false;
+		_buildCount++;
+
+		// Find the bodies we can merge, sorted by their filters and then along X, so that each chunk shares a
+		// filter and covers one slab of the level
+		struct Candidate {
+			RigidBody::Sptr Body;
+			float           Center;
+		};
+		std::vector<Candidate> candidates;
+		for (const RigidBody::Sptr& body : bodies) {
+			if (body->_body == nullptr || body->_isMerged || body->GetType() != RigidBodyType::Static || !_CanMerge(body->_body->getCollisionShape())) {
+				continue;
+			}
+			btVector3 aabbMin, aabbMax;
+			body->_body->getAabb(aabbMin, aabbMax);
+			candidates.push_back({ body, (aabbMin.x() + aabbMax.x()) * 0.5f });
+		}
+		if (candidates.empty()) {
+			return;
+		}
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+			if (a.Body->_collisionGroup != b.Body->_collisionGroup) {
+				return a.Body->_collisionGroup < b.Body->_collisionGroup;
+			}
+			if (a.Body->_collisionMask != b.Body->_collisionMask) {
+				return a.Body->_collisionMask < b.Body->_collisionMask;
+			}
+			return a.Center < b.Center;
+		});
+
+		// Read in the BVHs from last time, any chunk whose triangles haven't changed can re-use its BVH
+		FileHelpers::FileBuffer cache;
+		std::vector<CachedBvh> cached;
+		if (isFullBuild && !cachePath.empty() && FileHelpers::Exists(cachePath) && FileHelpers::ReadFileBuffer(cachePath, cache) && cache.Size >= sizeof(CacheHeader)) {
+			CacheHeader header;
+			memcpy(&header, cache.Data, sizeof(CacheHeader));
+			if (memcmp(header.HeaderBytes, CacheHeader().HeaderBytes, 4) == 0 && header.Version == 0x01) {
+				size_t offset = sizeof(CacheHeader);
+				for (uint32_t ix = 0; ix < header.NumChunks && offset + sizeof(CacheChunkHeader) <= cache.Size; ix++) {
+					CacheChunkHeader chunkHeader;
+					memcpy(&chunkHeader, cache.Data + offset, sizeof(CacheChunkHeader));
+					offset += sizeof(CacheChunkHeader);
+					if (offset + chunkHeader.BvhSize > cache.Size) {
+						LOG_WARN("Static world cache \"{}\" is truncated", cachePath);
+						break;
+					}
+					cached.push_back({ chunkHeader.SourceHash, cache.Data + offset, chunkHeader.BvhSize });
+					offset += chunkHeader.BvhSize;
+				}
+			} else {
+				LOG_WARN("Static world cache \"{}\" is invalid or an unsupported version", cachePath);
+			}
+		}
+
+		// A BVH can only tell apart so many parts, so large levels are split into several meshes
+		const size_t maxParts = static_cast<size_t>(1) << MAX_NUM_PARTS_IN_BITS;
+		bool isCacheStale = false;
+		size_t first = 0;
+		while (first < candidates.size()) {
+			const int group = candidates[first].Body->_collisionGroup;
+			const int mask  = candidates[first].Body->_collisionMask;
+			size_t last = first;
+			while (last < candidates.size() && last - first < maxParts &&
+				candidates[last].Body->_collisionGroup == group && candidates[last].Body->_collisionMask == mask) {
+				last++;
+			}
+
+			std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+			for (size_t ix = first; ix < last; ix++) {
+				const btRigidBody* body = candidates[ix].Body->_body;
+				chunk->VertexOffsets.push_back(static_cast<uint32_t>(chunk->Vertices.size()));
+				chunk->IndexOffsets.push_back(static_cast<uint32_t>(chunk->Indices.size()));
+				_AppendShape(body->getCollisionShape(), body->getWorldTransform(), chunk->Vertices, chunk->Indices, chunk->VertexOffsets.back());
+				chunk->Parts.push_back(candidates[ix].Body);
+			}
+			chunk->VertexOffsets.push_back(static_cast<uint32_t>(chunk->Vertices.size()));
+			chunk->IndexOffsets.push_back(static_cast<uint32_t>(chunk->Indices.size()));
+			first = last;
+
+			if (chunk->Indices.empty()) {
+				continue;
+			}
+
+			chunk->SourceHash = _ComputeHash(*chunk);
+			auto it = std::find_if(cached.begin(), cached.end(), [&](const CachedBvh& item) { return item.SourceHash == chunk->SourceHash; });
+			if (it != cached.end()) {
+				_BuildChunk(*chunk, it->Data, it->Size);
+			} else {
+				_BuildChunk(*chunk, nullptr, 0);
+				isCacheStale = true;
+			}
+
+			// Swap the merged bodies out for the mesh
+			chunk->Body = new btRigidBody(0.0f, nullptr, chunk->Shape);
+			_world->addRigidBody(chunk->Body, group, mask);
+			for (const std::weak_ptr<RigidBody>& part : chunk->Parts) {
+				RigidBody::Sptr body = part.lock();
+				_world->removeRigidBody(body->_body);
+				body->_isMerged = true;
+			}
+			_chunks.push_back(std::move(chunk));
+		}
+
+		if (isFullBuild && isCacheStale && !cachePath.empty()) {
+			SaveCache(cachePath);
+		}
+		size_t mergedCount = 0;
+		for (size_t ix = firstNewChunk; ix < _chunks.size(); ix++) {
+			mergedCount += _chunks[ix]->Parts.size();
+		}
+		LOG_INFO("Merged {} static bodies into {} meshes", mergedCount, _chunks.size() - firstNewChunk);
+	}
+
+	void StaticWorld::Clear() {
+		for (const std::unique_ptr<Chunk>& chunk : _chunks) {
+			_RemoveChunk(*chunk);
+		}
+		_chunks.clear();
+		_isBuilt = false;
+		_isDirty = false;
+	}
+
+	void StaticWorld::ClearDirty() {
+		for (size_t ix = 0; ix < _chunks.size();) {
+			if (_chunks[ix]->IsDirty) {
+				_RemoveChunk(*_chunks[ix]);
+				_chunks.erase(_chunks.begin() + ix);
+			} else {
+				ix++;
+			}
+		}
+		// Build will pick up the bodies that were put back, and any that have become world geometry
+		_isBuilt = false;
+		_isDirty = false;
+	}
+
+	void StaticWorld::MarkDirty(const RigidBody* body) {
+		_isDirty = true;
+		for (const std::unique_ptr<Chunk>& chunk : _chunks) {
+			for (const std::weak_ptr<RigidBody>& part : chunk->Parts) {
+				// A body that is being destroyed has already let go of it's last reference
+				if (part.expired() || part.lock().get() == body) {
+					chunk->IsDirty = true;
+					break;
+				}
+			}
+		}
+	}
+
+	std::shared_ptr<RigidBody> StaticWorld::GetPartBody(const btCollisionObject* object, int part) const {
+		for (const std::unique_ptr<Chunk>& chunk : _chunks) {
+			if (chunk->Body == object) {
+				return part >= 0 && part < static_cast<int>(chunk->Parts.size()) ? chunk->Parts[part].lock() : nullptr;
+			}
+		}
+		return nullptr;
+	}
+
+	size_t StaticWorld::GetMergedBodyCount() const {
+		size_t result = 0;
+		for (const std::unique_ptr<Chunk>& chunk : _chunks) {
+			result += chunk->Parts.size();
+		}
+		return result;
+	}
+
+	bool StaticWorld::_CanMerge(const btCollisionShape* shape) {
+		if (shape->isCompound()) {
+			const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+			if (compound->getNumChildShapes() == 0) {
+				return false;
+			}
+			for (int ix = 0; ix < compound->getNumChildShapes(); ix++) {
+				if (!_CanMerge(compound->getChildShape(ix))) {
+					return false;
+				}
+			}
+			return true;
+		}
+		// Round shapes could only be approximated, and planes go on forever
+		return shape->isPolyhedral();
+	}
+
+	void StaticWorld::_AppendShape(const btCollisionShape* shape, const btTransform& transform, std::vector<glm::vec3>& vertices, std::vector<int>& indices, uint32_t baseVertex) {
+		if (shape->isCompound()) {
+			const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+			for (int ix = 0; ix < compound->getNumChildShapes(); ix++) {
+				_AppendShape(compound->getChildShape(ix), transform * compound->getChildTransform(ix), vertices, indices, baseVertex);
+			}
+			return;
+		}
+
+		// Boxes and convex meshes both give us their (scaled) corners, the hull of those is the exact shape
+		const btPolyhedralConvexShape* polyhedral = static_cast<const btPolyhedralConvexShape*>(shape);
+		btAlignedObjectArray<btVector3> points;
+		for (int ix = 0; ix < polyhedral->getNumVertices(); ix++) {
+			btVector3 vertex;
+			polyhedral->getVertex(ix, vertex);
+			points.push_back(vertex);
+		}
+		if (points.size() < 4) {
+			return;
+		}
+		btConvexHullComputer hull;
+		hull.compute(&points[0].x(), sizeof(btVector3), points.size(), 0.0f, 0.0f);
+
+		// Indices are relative to the start of the part
+		const int firstVertex = static_cast<int>(vertices.size() - baseVertex);
+		for (int ix = 0; ix < hull.vertices.size(); ix++) {
+			vertices.push_back(ToGlm(transform(hull.vertices[ix])));
+		}
+
+		// Each face is a convex polygon, so it can be split into a fan of triangles
+		for (int ix = 0; ix < hull.faces.size(); ix++) {
+			const btConvexHullComputer::Edge* start = &hull.edges[hull.faces[ix]];
+			const btConvexHullComputer::Edge* edge = start->getNextEdgeOfFace();
+			int b = edge->getSourceVertex();
+			for (edge = edge->getNextEdgeOfFace(); edge != start; edge = edge->getNextEdgeOfFace()) {
+				int c = edge->getSourceVertex();
+				indices.push_back(firstVertex + start->getSourceVertex());
+				indices.push_back(firstVertex + b);
+				indices.push_back(firstVertex + c);
+				b = c;
+			}
+		}
+	}
+
+	uint64_t StaticWorld::_ComputeHash(const Chunk& chunk) {
+		// 64 bit FNV-1a over the raw bytes of the triangles and how they're split into parts
+		uint64_t hash = 0xcbf29ce484222325ull;
+		auto hashBytes = [&](const void* data, size_t size) {
+			const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+			for (size_t ix = 0; ix < size; ix++) {
+				hash = (hash ^ bytes[ix]) * 0x100000001b3ull;
+			}
+		};
+		hashBytes(chunk.Vertices.data(), chunk.Vertices.size() * sizeof(glm::vec3));
+		hashBytes(chunk.Indices.data(), chunk.Indices.size() * sizeof(int));
+		hashBytes(chunk.VertexOffsets.data(), chunk.VertexOffsets.size() * sizeof(uint32_t));
+		hashBytes(chunk.IndexOffsets.data(), chunk.IndexOffsets.size() * sizeof(uint32_t));
+		return hash;
+	}
+
+	void StaticWorld::_BuildChunk(Chunk& chunk, const uint8_t* cachedBvh, uint32_t cachedSize) {
+		// Each part gets its own indexed mesh, so that hits report which part they were on
+		chunk.Mesh = new btTriangleIndexVertexArray();
+		for (size_t ix = 0; ix < chunk.Parts.size(); ix++) {
+			btIndexedMesh mesh;
+			mesh.m_numTriangles        = static_cast<int>(chunk.IndexOffsets[ix + 1] - chunk.IndexOffsets[ix]) / 3;
+			mesh.m_triangleIndexBase   = reinterpret_cast<const unsigned char*>(chunk.Indices.data() + chunk.IndexOffsets[ix]);
+			mesh.m_triangleIndexStride = 3 * sizeof(int);
+			mesh.m_numVertices         = static_cast<int>(chunk.VertexOffsets[ix + 1] - chunk.VertexOffsets[ix]);
+			mesh.m_vertexBase          = reinterpret_cast<const unsigned char*>(chunk.Vertices.data() + chunk.VertexOffsets[ix]);
+			mesh.m_vertexStride        = sizeof(glm::vec3);
+			mesh.m_vertexType          = PHY_FLOAT;
+			chunk.Mesh->addIndexedMesh(mesh, PHY_INTEGER);
+		}
+
+		if (cachedBvh != nullptr) {
+			// The BVH is used in place, so it needs its own aligned copy of the data
+			chunk.BvhBuffer = btAlignedAlloc(cachedSize, 16);
+			memcpy(chunk.BvhBuffer, cachedBvh, cachedSize);
+			btOptimizedBvh* bvh = static_cast<btOptimizedBvh*>(btOptimizedBvh::deSerializeInPlace(chunk.BvhBuffer, cachedSize, false));
+			if (bvh != nullptr) {
+				chunk.Shape = new btBvhTriangleMeshShape(chunk.Mesh, true, false);
+				chunk.Shape->setOptimizedBvh(bvh);
+				return;
+			}
+			LOG_WARN("Failed to load cached BVH for static world, rebuilding");
+			btAlignedFree(chunk.BvhBuffer);
+			chunk.BvhBuffer = nullptr;
+		}
+		chunk.Shape = new btBvhTriangleMeshShape(chunk.Mesh, true);
+	}
+
+	void StaticWorld::_RemoveChunk(Chunk& chunk) {
+		// Raycasts from this frame may still be pointing at the mesh
+		if (_rayBatch != nullptr) {
+			_rayBatch->ForgetObject(chunk.Body);
+		}
+		_world->removeRigidBody(chunk.Body);
+		delete chunk.Body;
+		delete chunk.Shape;
+		delete chunk.Mesh;
+		if (chunk.BvhBuffer != nullptr) {
+			btAlignedFree(chunk.BvhBuffer);
+		}
+
+		// Put back any bodies that still exist
+		for (const std::weak_ptr<RigidBody>& part : chunk.Parts) {
+			RigidBody::Sptr body = part.lock();
+			if (body != nullptr && body->_isMerged) {
+				_world->addRigidBody(body->_body, body->_collisionGroup, body->_collisionMask);
+				body->_isMerged = false;
+			}
+		}
+	}
+
+	void StaticWorld::SaveCache(const std::string& path) const {
+		std::ofstream file(path, std::ios::binary);
+		if (!file) {
+			LOG_WARN("Failed to open \"{}\" for writing static world cache", path);
+			return;
+		}
+
+		CacheHeader header{};
+		header.Version   = 0x01;
+		header.NumChunks = static_cast<uint32_t>(_chunks.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+
+		for (const std::unique_ptr<Chunk>& chunk : _chunks) {
+			const btOptimizedBvh* bvh = chunk->Shape->getOptimizedBvh();
+			CacheChunkHeader chunkHeader{};
+			chunkHeader.SourceHash = chunk->SourceHash;
+			chunkHeader.BvhSize    = bvh->calculateSerializeBufferSize();
+
+			void* buffer = btAlignedAlloc(chunkHeader.BvhSize, 16);
+			bvh->serializeInPlace(buffer, chunkHeader.BvhSize, false);
+			file.write(reinterpret_cast<const char*>(&chunkHeader), sizeof(CacheChunkHeader));
+			file.write(reinterpret_cast<const char*>(buffer), chunkHeader.BvhSize);
+			btAlignedFree(buffer);
+		}
+	}
+}
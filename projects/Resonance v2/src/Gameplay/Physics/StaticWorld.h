@@ -0,0 +1,152 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+class btDynamicsWorld;
+class btCollisionShape;
+class btCollisionObject;
+class btRigidBody;
+class btBvhTriangleMeshShape;
+class btTriangleIndexVertexArray;
+class btTransform;
+
+namespace Gameplay::Physics {
+	class RigidBody;
+	class RayBatch;
+
+	/// <summary>
+	/// Merges the static bodies that make up a level into a few triangle mesh bodies, so that the broadphase only
+	/// has a handful of large objects for the level instead of one per wall, and so that raycasts against the level
+	/// walk a single quantized BVH. The BVHs are cached next to the scene file, keyed by a hash of their triangles.
+	/// When a merged body changes, only the mesh it's in gets taken apart and merged again
+	///
+	/// Only static bodies marked as world geometry and made entirely of flat sided shapes (boxes and convex meshes)
+	/// are merged, since those can be turned into triangles exactly. Each merged body becomes one part of a mesh, so
+	/// the part index of a hit (ex: from a raycast) can be used to get back to the body it came from. The original
+	/// bodies are taken out of the physics world while they're merged, and put back if the merge is cleared
+	/// </summary>
+	class StaticWorld {
+	public:
+		StaticWorld();
+		~StaticWorld();
+
+		StaticWorld(const StaticWorld& other) = delete;
+		StaticWorld& operator=(const StaticWorld& other) = delete;
+
+		/// <summary>
+		/// Merges the bodies that can be merged and aren't already, and takes them out of the world. When nothing is
+		/// merged yet (ex: the first build after loading a scene), the BVHs are loaded from the cache, and the cache
+		/// is written back if any of them were out of date
+		/// </summary>
+		/// <param name="world">The physics world that the bodies are in</param>
+		/// <param name="rayBatch">The scene's ray batch, which has to forget about meshes when they're taken apart</param>
+		/// <param name="bodies">The bodies to try and merge, bodies that can't be merged are left as they are</param>
+		/// <param name="cachePath">The file to load the BVHs from, or an empty string to always build them</param>
+		void Build(btDynamicsWorld* world, RayBatch* rayBatch, const std::vector<std::shared_ptr<RigidBody>>& bodies, const std::string& cachePath);
+		/// <summary>
+		/// Removes the merged meshes from the world, and puts the original bodies back
+		/// </summary>
+		void Clear();
+		/// <summary>
+		/// Removes only the meshes that are out of date, and puts their bodies back so they can sync before the
+		/// next Build merges them again
+		/// </summary>
+		void ClearDirty();
+
+		/// <summary>
+		/// Flags the mesh that a body is merged into as out of date, ex: when the body is moved or removed. Also
+		/// flags that a new body may need to be merged, ex: when a body is marked as world geometry
+		/// </summary>
+		/// <param name="body">The body that has changed</param>
+		void MarkDirty(const RigidBody* body);
+		bool IsDirty() const { return _isDirty; }
+		/// <summary>
+		/// Checks if Build has been called since the merge was last cleared
+		/// </summary>
+		bool IsBuilt() const { return _isBuilt; }
+
+		/// <summary>
+		/// Writes the BVHs of every merged mesh to a file, so they can be loaded instead of built next time
+		/// </summary>
+		/// <param name="path">The file to write, usually next to the scene file</param>
+		void SaveCache(const std::string& path) const;
+		/// <summary>
+		/// Gets how many times the merge has been built, so systems that copy the level geometry can tell when
+		/// their copy is out of date
+		/// </summary>
+		uint32_t GetBuildCount() const { return _buildCount; }
+
+		/// <summary>
+		/// Finds the body that a part of a merged mesh came from
+		/// </summary>
+		/// <param name="object">The collision object that was hit</param>
+		/// <param name="part">The shape part that was hit</param>
+		/// <returns>The body the part came from, or nullptr if the object is not a merged mesh</returns>
+		std::shared_ptr<RigidBody> GetPartBody(const btCollisionObject* object, int part) const;
+
+		/// <summary>
+		/// Gets the number of bodies that have been merged
+		/// </summary>
+		size_t GetMergedBodyCount() const;
+		/// <summary>
+		/// Gets the number of merged meshes that have been added to the world
+		/// </summary>
+		size_t GetMeshCount() const { return _chunks.size(); }
+
+	protected:
+		// A single merged mesh, each merged body is one part of it
+		struct Chunk {
+			// The world space triangles of each part, one after another
+			std::vector<glm::vec3>                Vertices;
+			std::vector<int>                      Indices;
+			std::vector<std::weak_ptr<RigidBody>> Parts;
+			// Where each part starts in Vertices and Indices, with one extra at the end
+			std::vector<uint32_t>                 VertexOffsets;
+			std::vector<uint32_t>                 IndexOffsets;
+			uint64_t                              SourceHash = 0;
+			// Set when one of the parts has changed, and the mesh needs to be merged again
+			bool                                  IsDirty = false;
+
+			btTriangleIndexVertexArray* Mesh = nullptr;
+			btBvhTriangleMeshShape*     Shape = nullptr;
+			btRigidBody*                Body = nullptr;
+			// Holds the BVH when it's loaded from the cache, since the BVH lives in place in the buffer
+			void*                       BvhBuffer = nullptr;
+		};
+
+		// Will be put at the start of the cache file, contains info about the contents of the file
+		struct CacheHeader {
+			// A check value so we can ensure that we're loading in the right file type
+			char     HeaderBytes[4] ={ 'S', 'W', 'B', 'V' };
+			// The version code, we can use this to create different loaders if our format changes
+			uint16_t Version = 0;
+			// Spells out the padding, so that the whole header gets written as zeroes
+			uint16_t Reserved = 0;
+			// The number of chunks that follow the header
+			uint32_t NumChunks = 0;
+		};
+		// Comes before the serialized BVH of each chunk in the cache file
+		struct CacheChunkHeader {
+			uint64_t SourceHash = 0;
+			uint32_t BvhSize = 0;
+			uint32_t Reserved = 0;
+		};
+
+		btDynamicsWorld*                    _world;
+		RayBatch*                           _rayBatch;
+		std::vector<std::unique_ptr<Chunk>> _chunks;
+		bool                                _isBuilt;
+		bool                                _isDirty;
+		uint32_t                            _buildCount;
+
+		static bool _CanMerge(const btCollisionShape* shape);
+		static void _AppendShape(const btCollisionShape* shape, const btTransform& transform, std::vector<glm::vec3>& vertices, std::vector<int>& indices, uint32_t baseVertex);
+		static uint64_t _ComputeHash(const Chunk& chunk);
+
+		void _BuildChunk(Chunk& chunk, const uint8_t* cachedBvh, uint32_t cachedSize);
+		void _RemoveChunk(Chunk& chunk);
+	};
+}
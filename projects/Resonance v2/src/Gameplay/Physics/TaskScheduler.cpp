@@ -0,0 +1,46 @@
+#include "Gameplay/Physics/TaskScheduler.h"
+
+#include <mutex>
+#include <algorithm>
+
+#include "Utils/ThreadPool.h"
+
+namespace Gameplay::Physics {
+	TaskScheduler::TaskScheduler(int numThreads) :
+		btITaskScheduler("Resonance"),
+		_maxHelpers(0)
+	{
+		setNumThreads(numThreads);
+	}
+
+	int TaskScheduler::getMaxNumThreads() const {
+		return std::min(ThreadPool::Get().GetWorkerCount() + 1, static_cast<int>(BT_MAX_THREAD_COUNT));
+	}
+
+	void TaskScheduler::setNumThreads(int numThreads) {
+		_maxHelpers = std::clamp(numThreads, 1, getMaxNumThreads()) - 1;
+	}
+
+	void TaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) {
+		if (iEnd <= iBegin) {
+			return;
+		}
+		ThreadPool::Get().ParallelFor(static_cast<uint32_t>(iEnd - iBegin), static_cast<uint32_t>(std::max(grainSize, 1)), [&](uint32_t begin, uint32_t end) {
+			body.forLoop(iBegin + static_cast<int>(begin), iBegin + static_cast<int>(end));
+		}, _maxHelpers);
+	}
+
+	btScalar TaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) {
+		if (iEnd <= iBegin) {
+			return btScalar(0.0f);
+		}
+		std::mutex mutex;
+		btScalar sum = btScalar(0.0f);
+		ThreadPool::Get().ParallelFor(static_cast<uint32_t>(iEnd - iBegin), static_cast<uint32_t>(std::max(grainSize, 1)), [&](uint32_t begin, uint32_t end) {
+			btScalar partial = body.sumLoop(iBegin + static_cast<int>(begin), iBegin + static_cast<int>(end));
+			std::lock_guard<std::mutex> lock(mutex);
+			sum += partial;
+		}, _maxHelpers);
+		return sum;
+	}
+}
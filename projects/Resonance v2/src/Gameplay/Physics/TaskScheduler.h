@@ -0,0 +1,45 @@
+#pragma once
+#include <LinearMath/btThreads.h>
+
+#include "Utils/Macros.h"
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// Runs Bullet's parallel loops on the engine's shared ThreadPool, so that btDiscreteDynamicsWorldMt can
+	/// solve islands and find contacts across cores without starting threads of it's own. The thread calling
+	/// parallelFor always helps with the loop
+	///
+	/// Note that Bullet only calls into the scheduler if it was built with BT_THREADSAFE, so scenes only use it
+	/// when BT_THREADSAFE is defined (see the bullet-threadsafe option in Premake5.lua)
+	/// </summary>
+	class TaskScheduler : public btITaskScheduler {
+	public:
+		MAKE_PTRS(TaskScheduler);
+
+		// True if the Bullet we're built against will actually run loops through the scheduler
+	#if BT_THREADSAFE
+		static constexpr bool IS_SUPPORTED = true;
+	#else
+		static constexpr bool IS_SUPPORTED = false;
+	#endif
+
+		/// <param name="numThreads">The most threads a loop can run on, including the calling thread</param>
+		TaskScheduler(int numThreads);
+		virtual ~TaskScheduler() = default;
+
+		TaskScheduler(const TaskScheduler& other) = delete;
+		TaskScheduler& operator=(const TaskScheduler& other) = delete;
+
+		// Inherited from btITaskScheduler
+		virtual int getMaxNumThreads() const override;
+		// Bullet sizes it's per-thread storage with this, so it covers every thread in the pool even if we use fewer of them
+		virtual int getNumThreads() const override { return getMaxNumThreads(); }
+		virtual void setNumThreads(int numThreads) override;
+		virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+		virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+	protected:
+		// The most workers that can help with a loop, on top of the calling thread
+		int _maxHelpers;
+	};
+}
@@ -0,0 +1,99 @@
+#include "Gameplay/Physics/TriggerDispatcher.h"
+
+#include <algorithm>
+#include <btBulletCollisionCommon.h>
+
+#include "Gameplay/Physics/TriggerVolume.h"
+
+namespace Gameplay::Physics {
+	TriggerDispatcher::TriggerDispatcher() :
+		_triggers(),
+		_freeSlots(),
+		_pairs(),
+		_objects(),
+		_active(),
+		_nextActive()
+	{ }
+
+	int TriggerDispatcher::Register(TriggerVolume* trigger) {
+		if (!_freeSlots.empty()) {
+			int index = _freeSlots.back();
+			_freeSlots.pop_back();
+			_triggers[index] = trigger;
+			return index;
+		}
+		_triggers.push_back(trigger);
+		return static_cast<int>(_triggers.size() - 1);
+	}
+
+	void TriggerDispatcher::Unregister(int index) {
+		if (index >= 0 && index < static_cast<int>(_triggers.size()) && _triggers[index] != nullptr) {
+			_triggers[index] = nullptr;
+			_freeSlots.push_back(index);
+		}
+	}
+
+	void TriggerDispatcher::_AddPair(const btCollisionObject* trigger, const btCollisionObject* object) {
+		// Triggers are the only ghost objects with a user index
+		if (trigger->getInternalType() != btCollisionObject::CO_GHOST_OBJECT) {
+			return;
+		}
+		const int index = trigger->getUserIndex();
+		if (index < 0 || index >= static_cast<int>(_triggers.size()) || _triggers[index] == nullptr) {
+			return;
+		}
+		if (_triggers[index]->_AcceptsObject(object)) {
+			_pairs.push_back({ index, object });
+		}
+	}
+
+	void TriggerDispatcher::Update(btDispatcher* dispatcher) {
+		// Trigger contacts are never solved, but the world still keeps manifolds for them while stepping
+		_pairs.clear();
+		const int numManifolds = dispatcher->getNumManifolds();
+		for (int ix = 0; ix < numManifolds; ix++) {
+			const btPersistentManifold* manifold = dispatcher->getManifoldByIndexInternal(ix);
+			if (manifold->getNumContacts() == 0) {
+				continue;
+			}
+			_AddPair(manifold->getBody0(), manifold->getBody1());
+			_AddPair(manifold->getBody1(), manifold->getBody0());
+		}
+
+		// Group the contacts by trigger, and by object within each trigger, an object can have more than one manifold with a trigger
+		std::sort(_pairs.begin(), _pairs.end(), [](const Pair& a, const Pair& b) {
+			return a.Trigger != b.Trigger ? a.Trigger < b.Trigger : std::less<const btCollisionObject*>()(a.Object, b.Object);
+		});
+		_pairs.erase(std::unique(_pairs.begin(), _pairs.end(), [](const Pair& a, const Pair& b) {
+			return a.Trigger == b.Trigger && a.Object == b.Object;
+		}), _pairs.end());
+
+		// Walk the triggers with contacts this frame alongside the ones that had something in them last frame
+		_nextActive.clear();
+		size_t pair = 0;
+		size_t active = 0;
+		while (pair < _pairs.size() || active < _active.size()) {
+			int index;
+			if (active == _active.size() || (pair < _pairs.size() && _pairs[pair].Trigger < _active[active])) {
+				index = _pairs[pair].Trigger;
+			} else {
+				index = _active[active];
+			}
+			if (active < _active.size() && _active[active] == index) {
+				active++;
+			}
+
+			_objects.clear();
+			for (; pair < _pairs.size() && _pairs[pair].Trigger == index; pair++) {
+				_objects.push_back(_pairs[pair].Object);
+			}
+
+			// The trigger may have been removed since last frame
+			TriggerVolume* trigger = _triggers[index];
+			if (trigger != nullptr && trigger->_UpdateOverlaps(_objects)) {
+				_nextActive.push_back(index);
+			}
+		}
+		_active.swap(_nextActive);
+	}
+}
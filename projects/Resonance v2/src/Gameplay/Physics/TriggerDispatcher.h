@@ -0,0 +1,61 @@
+#pragma once
+#include <vector>
+
+class btCollisionObject;
+class btDispatcher;
+
+namespace Gameplay::Physics {
+	class TriggerVolume;
+
+	/// <summary>
+	/// Works out what is inside every trigger volume in a scene with one pass over the contact manifolds
+	/// the physics world already found while stepping, instead of each trigger dispatching its own pairs
+	///
+	/// The contacts are sorted by trigger and then by object, so each trigger can compare against what
+	/// was in it last frame in one pass. Triggers that are empty and were empty last frame aren't touched
+	/// at all, so the cost follows the number of overlaps rather than the number of triggers
+	/// </summary>
+	class TriggerDispatcher {
+	public:
+		TriggerDispatcher();
+		~TriggerDispatcher() = default;
+
+		TriggerDispatcher(const TriggerDispatcher& other) = delete;
+		TriggerDispatcher& operator=(const TriggerDispatcher& other) = delete;
+
+		/// <summary>
+		/// Adds a trigger to be updated, the index should be stored in the trigger's collision object's
+		/// user index so that its contacts can be found
+		/// </summary>
+		/// <returns>The index of the trigger</returns>
+		int Register(TriggerVolume* trigger);
+		/// <summary>
+		/// Removes a trigger, no leave events are sent for anything that was inside it
+		/// </summary>
+		void Unregister(int index);
+
+		/// <summary>
+		/// Sends enter and leave events for all triggers, should be called after the world has been stepped
+		/// </summary>
+		/// <param name="dispatcher">The dispatcher that holds the world's contact manifolds</param>
+		void Update(btDispatcher* dispatcher);
+
+	protected:
+		struct Pair {
+			int                      Trigger;
+			const btCollisionObject* Object;
+		};
+
+		std::vector<TriggerVolume*> _triggers;
+		std::vector<int>            _freeSlots;
+
+		// The trigger contacts found this frame, re-used between frames
+		std::vector<Pair>                     _pairs;
+		std::vector<const btCollisionObject*> _objects;
+		// The triggers that had something inside them after the last update, sorted by index
+		std::vector<int> _active;
+		std::vector<int> _nextActive;
+
+		void _AddPair(const btCollisionObject* trigger, const btCollisionObject* object);
+	};
+}
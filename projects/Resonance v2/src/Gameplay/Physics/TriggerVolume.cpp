@@ -12,12 +12,17 @@ namespace Gameplay::Physics {
 	TriggerVolume::TriggerVolume() :
 		PhysicsBase(),
 		_ghost(nullptr),
-		_typeFlags(TriggerTypeFlags::Dynamics)
+		_typeFlags(TriggerTypeFlags::Dynamics),
+		_triggerIndex(-1),
+		_overlaps(),
+		_nextOverlaps()
 	{
 	}
 
 	TriggerVolume::~TriggerVolume() {
 		if (_ghost != nullptr) {
+			_scene->GetTriggerDispatcher().Unregister(_triggerIndex);
+			_scene->GetRayBatch().ForgetObject(_ghost);
 			_scene->GetPhysicsWorld()->removeCollisionObject(_ghost);
 			delete _ghost;
 		}
@@ -37,102 +42,95 @@ namespace Gameplay::Physics {
 	}
 
 	void TriggerVolume::PhysicsPostStep(float dt) {
-		// This will store all the objects inside the trigger this frame
-		std::vector<std::weak_ptr<RigidBody>> thisFrameCollision;
-
-		// Get all our collisions from from the world
-		_scene->GetPhysicsWorld()->getDispatcher()->dispatchAllCollisionPairs(_ghost->getOverlappingPairCache(), _scene->GetPhysicsWorld()->getDispatchInfo(), _scene->GetPhysicsWorld()->getDispatcher());
-		btBroadphasePairArray& collisionPairs = _ghost->getOverlappingPairCache()->getOverlappingPairArray();
-
-		// Determine how many objects are intersecting the volume
-		const int numObjects=collisionPairs.size();
-		thisFrameCollision.reserve(numObjects);
+		// Our contacts are handled for every trigger at once by the scene's TriggerDispatcher
+	}
 
-		// Will store our contact manifolds, can be static to be shared between frames and instances
-		static btManifoldArray	m_manifoldArray;
+	bool TriggerVolume::_AcceptsObject(const btCollisionObject* obj) const {
+		// Make sure the object's group matches our mask (since this isn't filtered for us)
+		if ((obj->getBroadphaseHandle()->m_collisionFilterGroup & _collisionMask) == 0) {
+			return false;
+		}
 
-		// Iterate over all the objects that we're colliding with
-		for (int i = 0; i < numObjects; ++i) {
-			// resize the number of manifolds to zero for everything we collide with
-			m_manifoldArray.resize(0);
+		// Make sure the internal type is a bullet rigid body (no trigger-trigger interactions)
+		if (obj->getInternalType() != btCollisionObject::CO_RIGID_BODY) {
+			return false;
+		}
 
-			// Get the btCollisionObject that we're colliding with
-			btCollisionObject *obj = _ghost->getOverlappingObject(i);
+		// Make sure that the object is not a kinematic or static object (note: you may want
+		// to modify this behaviour depending on your game)
+		return ((obj->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT & btCollisionObject::CF_KINEMATIC_OBJECT) == 0) ||
+			((obj->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Statics)) ||
+			((obj->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Kinematics));
+	}
 
-			// Get the contact pair and resolve contact manifolds
-			btBroadphasePair* pair = &collisionPairs[i];
-			if (pair != nullptr && pair->m_algorithm != nullptr) {
-				pair->m_algorithm->getAllContactManifolds(m_manifoldArray);
-			} else {
-				continue;
+	bool TriggerVolume::_UpdateOverlaps(const std::vector<const btCollisionObject*>& objects) {
+		// Nothing changed, which is most frames for most triggers
+		if (objects.size() == _overlaps.size()) {
+			bool isSame = true;
+			for (size_t ix = 0; ix < objects.size() && isSame; ix++) {
+				isSame = objects[ix] == _overlaps[ix].Object && (_overlaps[ix].IsIgnored || !_overlaps[ix].Body.expired());
+			}
+			if (isSame) {
+				return !_overlaps.empty();
 			}
+		}
 
-			// Iterate over all the contact manifolds and check if any of them have contacts
-			bool hasCollision = false;
-			for (int j=0; j < m_manifoldArray.size(); j++) {
-				btPersistentManifold* manifold = m_manifoldArray[j];
-				if (manifold != nullptr && manifold->getNumContacts() > 0) {
-					hasCollision = true;
-					break;
+		// Both lists are sorted by address, so we can walk them side by side
+		std::less<const btCollisionObject*> less;
+		_nextOverlaps.clear();
+		size_t prev = 0;
+		size_t next = 0;
+		while (prev < _overlaps.size() || next < objects.size()) {
+			if (next == objects.size() || (prev < _overlaps.size() && less(_overlaps[prev].Object, objects[next]))) {
+				_Leave(_overlaps[prev++]);
+			} else if (prev == _overlaps.size() || less(objects[next], _overlaps[prev].Object)) {
+				_nextOverlaps.push_back(_Enter(objects[next++]));
+			} else {
+				// If the body was destroyed while inside us, this is a new body that was made in the same spot in memory
+				if (!_overlaps[prev].IsIgnored && _overlaps[prev].Body.expired()) {
+					_nextOverlaps.push_back(_Enter(objects[next]));
+				} else {
+					_nextOverlaps.push_back(_overlaps[prev]);
 				}
+				prev++;
+				next++;
 			}
+		}
 
-			// If we have contacts and the object's group matches our mask (since this isn't filtered for us)
-			if (hasCollision && (obj->getBroadphaseHandle()->m_collisionFilterGroup & _collisionMask)) {
-				// Make sure the internal type is a bullet rigid body (no trigger-trigger interactions)
-				if (obj->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
-					// Get the collision object as a btRigidBody
-					const btRigidBody *body = (const btRigidBody *)obj;
-
-					// Make sure that the object is not a kinematic or static object (note: you may want
-					// to modify this behaviour depending on your game)
-					if (((body->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT & btCollisionObject::CF_KINEMATIC_OBJECT) == 0) ||
-						((body->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Statics)) ||
-						((body->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Kinematics))) {
-
-						// Extract the weak pointer that we stored in all our rigidbody user pointers
-						std::weak_ptr<IComponent> rawPtr = *reinterpret_cast<std::weak_ptr<IComponent>*>(body->getUserPointer());
-						// Cast lock the raw pointer and cast up to a RigidBody
-						std::shared_ptr<RigidBody> physicsPtr = std::dynamic_pointer_cast<RigidBody>(rawPtr.lock());
-
-						// As long as we got a pointer out, we can proceed to try and invoke
-						if (physicsPtr != nullptr && physicsPtr->GetGameObject() != GetGameObject()) {
-							// Add the object to the known collisions for this frame
-							thisFrameCollision.push_back(physicsPtr);
-
-							// Check to see if the object has been added to our object cache
-							auto& it = std::find_if(_currentCollisions.begin(), _currentCollisions.end(), [&](const std::weak_ptr<RigidBody>& item) {
-								return item.lock() == physicsPtr;
-							});
-
-							// If the object is NOT in the cache, we invoke all the callbacks
-							if (it == _currentCollisions.end()) {
-								physicsPtr->GetGameObject()->OnEnteredTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
-								GetGameObject()->OnTriggerVolumeEntered(physicsPtr);
-							}
-						}
-					}
-				}
+		_overlaps.swap(_nextOverlaps);
+		return !_overlaps.empty();
+	}
 
-			}
+	TriggerVolume::Overlap TriggerVolume::_Enter(const btCollisionObject* object) {
+		Overlap result;
+		result.Object = object;
+		result.IsIgnored = true;
+
+		// Extract the weak pointer that we stored in all our rigidbody user pointers, and cast it up to a RigidBody
+		const std::weak_ptr<IComponent>* rawPtr = reinterpret_cast<const std::weak_ptr<IComponent>*>(object->getUserPointer());
+		std::shared_ptr<RigidBody> physicsPtr = rawPtr != nullptr ? std::dynamic_pointer_cast<RigidBody>(rawPtr->lock()) : nullptr;
+		result.Body = physicsPtr;
+
+		// As long as we got a pointer out, we can proceed to try and invoke
+		if (physicsPtr != nullptr && physicsPtr->GetGameObject() != GetGameObject()) {
+			result.IsIgnored = false;
+			physicsPtr->GetGameObject()->OnEnteredTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
+			GetGameObject()->OnTriggerVolumeEntered(physicsPtr);
 		}
-	
-		// Compare our current frame list to the previous frame to see if anything has left
-		for (auto& weakPtr : _currentCollisions) {
-			// Search the the current list to see if the item still exists
-			auto& it = std::find_if(thisFrameCollision.begin(), thisFrameCollision.end(), [&](const std::weak_ptr<RigidBody>& item) {
-				return item.lock() == weakPtr.lock();
-			});
-
-			// If the item no longer exists in the list, we need to invoke exit callbacks
-			if (it == thisFrameCollision.end()) {
-				weakPtr.lock()->GetGameObject()->OnLeavingTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
-				GetGameObject()->OnTriggerVolumeLeaving(weakPtr.lock());
-			}
+		return result;
+	}
+
+	void TriggerVolume::_Leave(const Overlap& overlap) {
+		if (overlap.IsIgnored) {
+			return;
 		}
 
-		// Load the contents of the current collision items into the cache
-		_currentCollisions.swap(thisFrameCollision);
+		// Bodies that were destroyed while inside of us have nobody left to tell
+		std::shared_ptr<RigidBody> physicsPtr = overlap.Body.lock();
+		if (physicsPtr != nullptr) {
+			physicsPtr->GetGameObject()->OnLeavingTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
+			GetGameObject()->OnTriggerVolumeLeaving(physicsPtr);
+		}
 	}
 
 	void TriggerVolume::Awake() {
@@ -153,10 +151,12 @@ namespace Gameplay::Physics {
 			_AddColliderToShape(collider.get());
 		}
 
-		// Create the ghost object
-		_ghost = new btPairCachingGhostObject();
+		// Create the ghost object, the world keeps the contact manifolds for it so it doesn't need its own pair cache
+		_ghost = new btGhostObject();
 		_ghost->setCollisionShape(_shape);
 		_ghost->setUserPointer(&SelfRef());
+		_triggerIndex = _scene->GetTriggerDispatcher().Register(this);
+		_ghost->setUserIndex(_triggerIndex);
 		_ghost->setCollisionFlags(_ghost->getCollisionFlags() | btCollisionObject::CF_NO_CONTACT_RESPONSE);
 
 		// Get the transform and send it to the ghost
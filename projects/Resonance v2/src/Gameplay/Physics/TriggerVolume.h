@@ -4,9 +4,10 @@
 #include "Gameplay/Physics/RigidBody.h"
 #include "EnumToString.h"
 
-class btPairCachingGhostObject;
+class btGhostObject;
 
 namespace Gameplay::Physics {
+	class TriggerDispatcher;
 
 	ENUM_FLAGS(TriggerTypeFlags, int,
 		Dynamics   = 0,
@@ -34,7 +35,7 @@ namespace Gameplay::Physics {
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
 		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// does nothing, the scene's TriggerDispatcher sends our events for us
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
@@ -51,12 +52,40 @@ namespace Gameplay::Physics {
 		MAKE_TYPENAME(TriggerVolume);
 
 	protected:
-		btPairCachingGhostObject*   _ghost;
+		friend class TriggerDispatcher;
+
+		// An object that was inside the trigger last frame
+		struct Overlap {
+			const btCollisionObject*  Object;
+			std::weak_ptr<RigidBody>  Body;
+			// Set for objects that don't get events (ex: our own gameobject's body)
+			bool                      IsIgnored;
+		};
+
+		btGhostObject*              _ghost;
 		TriggerTypeFlags            _typeFlags;
+		// Our index in the scene's TriggerDispatcher
+		int                         _triggerIndex;
 
-		std::vector<std::weak_ptr<RigidBody>> _currentCollisions;
+		// Sorted by object, so they can be compared against the next frame's objects in one pass
+		std::vector<Overlap>        _overlaps;
+		std::vector<Overlap>        _nextOverlaps;
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
 
+		/// <summary>
+		/// Checks if an object touching the trigger should count as being inside of it
+		/// </summary>
+		bool _AcceptsObject(const btCollisionObject* object) const;
+		/// <summary>
+		/// Compares the objects inside the trigger this frame with last frame, and invokes the
+		/// enter and leave events for anything that changed
+		/// </summary>
+		/// <param name="objects">The objects inside the trigger this frame, sorted by address</param>
+		/// <returns>True if anything is inside the trigger, false if otherwise</returns>
+		bool _UpdateOverlaps(const std::vector<const btCollisionObject*>& objects);
+		Overlap _Enter(const btCollisionObject* object);
+		void _Leave(const Overlap& overlap);
+
 	};
 }
\ No newline at end of file
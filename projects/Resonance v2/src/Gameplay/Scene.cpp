@@ -3,6 +3,9 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
 
 #include "Utils/FileHelpers.h"
 #include "Utils/GlmBulletConversions.h"
@@ -17,6 +20,9 @@
 #include "Application/Application.h"
 
 namespace Gameplay {
+	Scene::PhysicsSettings Scene::_physicsSettings;
+	Physics::TaskScheduler::Sptr Scene::_taskScheduler = nullptr;
+
 	Scene::Scene() :
 		_objects(std::vector<GameObject::Sptr>()),
 		_deletionQueue(std::vector<std::weak_ptr<GameObject>>()),
@@ -30,7 +36,8 @@ namespace Gameplay {
 		_skyboxMesh(nullptr),
 		_skyboxTexture(nullptr),
 		_skyboxRotation(glm::mat3(1.0f)),
-		_gravity(glm::vec3(0.0f, 0.0f, 0.0f))
+		_gravity(glm::vec3(0.0f, 0.0f, 0.0f)),
+		_solverPool(nullptr)
 	{
 		_lightingUbo = std::make_shared<UniformBuffer<LightingUboStruct>>();
 		_lightingUbo->GetData().AmbientCol = glm::vec3(0.1f);
@@ -50,6 +57,8 @@ namespace Gameplay {
 		_skyboxShader = nullptr;
 		_skyboxMesh = nullptr;
 		_skyboxTexture = nullptr;
+		// Put the merged bodies back first, so they can be cleaned up like any other body
+		_staticWorld.Clear();
 		_objects.clear();
 		Lights.clear();
 		_CleanupPhysics();
@@ -153,6 +162,11 @@ namespace Gameplay {
 	}
 
 	void Scene::DoPhysics(float dt) {
+		// If any merged world geometry has changed (ex: moved in the editor), put the meshes it's in back in the world so they can sync
+		if (_staticWorld.IsDirty()) {
+			_staticWorld.ClearDirty();
+		}
+
 		_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
 			body->PhysicsPreStep(dt);
 			});
@@ -160,16 +174,30 @@ namespace Gameplay {
 			body->PhysicsPreStep(dt);
 			});
 
+		// Merge the world geometry once every body has been created and synced, the BVHs are cached next to the scene file.
+		// After that, this only merges the bodies that were put back above
+		if (_isAwake && !_staticWorld.IsBuilt()) {
+			std::vector<Gameplay::Physics::RigidBody::Sptr> worldGeometry;
+			_components.Each<Gameplay::Physics::RigidBody>([&](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
+				if (body->IsWorldGeometry()) {
+					worldGeometry.push_back(body);
+				}
+				});
+			_staticWorld.Build(_physicsWorld, &_rayBatch, worldGeometry, _filePath.empty() ? "" : _filePath + ".bvh");
+		}
+
 		if (IsPlaying) {
 
 			_physicsWorld->stepSimulation(dt, 15);
 
-			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-				body->PhysicsPostStep(dt);
-				});
-			_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-				body->PhysicsPostStep(dt);
-				});
+			// Rigid bodies that moved have already been copied out through their motion states, so
+			// there's nothing to do for them here
+
+			// Every trigger's enter and leave events come from the contacts the world found while stepping
+			_triggerDispatcher.Update(_collisionDispatcher);
+
+			// The world won't change again until next frame, so this is when we can answer all of the frame's raycasts at once
+			_rayBatch.Execute(_physicsWorld);
 		}
 	}
 
@@ -183,6 +211,8 @@ namespace Gameplay {
 	void Scene::Update(float dt) {
 		_FlushDeleteQueue();
 		if (IsPlaying) {
+			soundPerception.Rebuild(soundEmmiters);
+			aiScheduler.Schedule(dt, MainCamera != nullptr ? MainCamera->GetGameObject()->GetPosition() : glm::vec3(0.0f), _rayBatch);
 			for (auto& obj : _objects) {
 				obj->Update(dt);
 			}
@@ -204,36 +234,45 @@ namespace Gameplay {
 		}
 	}
 
-	void Scene::SetShaderLight(int index, bool update /*= true*/) {
-		if (index >= 0 && index < Lights.size() && index < MAX_LIGHTS) {
-			// Get a reference to the light UBO data so we can update it
-			LightingUboStruct& data = _lightingUbo->GetData();
-			Light& light = Lights[index];
-
-			// Copy to the ubo data
-			data.Lights[index].Position = light.Position;
-			data.Lights[index].Color = light.Color;
-			data.Lights[index].Attenuation = 1.0f / (1.0f + light.Range);
-
-			// If requested, send the new data to the UBO
-			if (update)	_lightingUbo->Update();
-		}
-	}
-
 	void Scene::SetupShaderAndLights() {
+		const glm::mat4* viewProjection = MainCamera != nullptr ? &MainCamera->GetViewProjection() : nullptr;
+		const std::vector<Light>& lights = _lightManager.Collect(Lights, MAX_LIGHTS, viewProjection);
+
 		// Get a reference to the light UBO data so we can update it
 		LightingUboStruct& data = _lightingUbo->GetData();
-		// Send in how many active lights we have and the global lighting settings
-		data.AmbientCol = glm::vec3(0.1f);
-		data.NumLights = static_cast<float>(Lights.size());
 
-		// Iterate over all lights that are enabled and configure them
-		for (int ix = 0; ix < Lights.size(); ix++) {
-			SetShaderLight(ix, false);
+		// Keep track of which bytes have changed, so we only send that part of the buffer
+		const uint8_t* base = reinterpret_cast<const uint8_t*>(&data);
+		size_t dirtyStart = sizeof(LightingUboStruct);
+		size_t dirtyEnd = 0;
+		auto markDirty = [&](const void* field, size_t size) {
+			const size_t offset = reinterpret_cast<const uint8_t*>(field) - base;
+			dirtyStart = glm::min(dirtyStart, offset);
+			dirtyEnd = glm::max(dirtyEnd, offset + size);
+		};
+
+		// Send in how many active lights we have, the shaders only loop over those
+		const float numLights = static_cast<float>(lights.size());
+		if (data.NumLights != numLights) {
+			data.NumLights = numLights;
+			markDirty(&data.NumLights, sizeof(float));
 		}
 
-		// Send updated data to OpenGL
-		_lightingUbo->Update();
+		for (size_t ix = 0; ix < lights.size(); ix++) {
+			const Light& light = lights[ix];
+			LightingUboStruct::Light& target = data.Lights[ix];
+			const float attenuation = 1.0f / (1.0f + light.Range);
+			if (target.Position != light.Position || target.Color != light.Color || target.Attenuation != attenuation) {
+				target.Position = light.Position;
+				target.Color = light.Color;
+				target.Attenuation = attenuation;
+				markDirty(&target, sizeof(LightingUboStruct::Light));
+			}
+		}
+
+		if (dirtyEnd > dirtyStart) {
+			_lightingUbo->Update(static_cast<uint32_t>(dirtyStart), static_cast<uint32_t>(dirtyEnd - dirtyStart));
+		}
 	}
 
 	btDynamicsWorld* Scene::GetPhysicsWorld() const {
@@ -320,15 +359,9 @@ namespace Gameplay {
 		// Save lights
 		std::vector<nlohmann::json> lights;
 		lights.resize(Lights.size());
-		int LCount = 0;
 		for (int ix = 0; ix < Lights.size(); ix++) {
-			if (Lights[ix].isGenerated)
-				continue;
-
-			lights[LCount] = Lights[ix].ToJson();
-			LCount++;
+			lights[ix] = Lights[ix].ToJson();
 		}
-		lights.resize(LCount);
 		blob["lights"] = lights;
 
 		// Save camera info
@@ -341,6 +374,10 @@ namespace Gameplay {
 		_filePath = path;
 		// Save data to file
 		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
+		// The merged meshes may have been rebuilt since the scene was loaded, so this is when the cache catches up
+		if (_staticWorld.IsBuilt()) {
+			_staticWorld.SaveCache(path + ".bvh");
+		}
 		LOG_INFO("Saved scene to \"{}\"", path);
 	}
 
@@ -362,20 +399,55 @@ namespace Gameplay {
 		return _objects[index];
 	}
 
+	void Scene::SetPhysicsSettings(const PhysicsSettings& settings) {
+		_physicsSettings = settings;
+	}
+
 	void Scene::_InitPhysics() {
 		_collisionConfig = new btDefaultCollisionConfiguration();
-		_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
 		_broadphaseInterface = new btDbvtBroadphase();
 		_ghostCallback = new btGhostPairCallback();
 		_broadphaseInterface->getOverlappingPairCache()->setInternalGhostPairCallback(_ghostCallback);
-		_constraintSolver = new btSequentialImpulseConstraintSolver();
-		_physicsWorld = new btDiscreteDynamicsWorld(
-			_collisionDispatcher,
-			_broadphaseInterface,
-			_constraintSolver,
-			_collisionConfig
-		);
+
+		// With the prebuilt (non threadsafe) Bullet libraries, the Mt world would just run serially and assert in debug
+		if (_physicsSettings.Multithreaded && !Physics::TaskScheduler::IS_SUPPORTED) {
+			LOG_WARN("Multithreaded physics requires Bullet to be built with BT_THREADSAFE, using a single threaded world");
+		}
+
+		if (_physicsSettings.Multithreaded && Physics::TaskScheduler::IS_SUPPORTED) {
+			// The task scheduler has to be set before any of the multithreaded parts are created, it runs on the shared thread pool
+			if (_taskScheduler == nullptr) {
+				_taskScheduler = std::make_shared<Physics::TaskScheduler>(_physicsSettings.Threads);
+				btSetTaskScheduler(_taskScheduler.get());
+			}
+			int threads = _physicsSettings.Threads > 0 ? _physicsSettings.Threads : _taskScheduler->getMaxNumThreads();
+			_taskScheduler->setNumThreads(threads);
+
+			// Small islands are solved in parallel by the pool, large ones (ex: a stack of crates) by the multithreaded solver
+			_collisionDispatcher = new btCollisionDispatcherMt(_collisionConfig);
+			_solverPool = new btConstraintSolverPoolMt(_taskScheduler->getNumThreads());
+			_constraintSolver = new btSequentialImpulseConstraintSolverMt();
+			_physicsWorld = new btDiscreteDynamicsWorldMt(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				_solverPool,
+				_constraintSolver,
+				_collisionConfig
+			);
+			LOG_INFO("Created multithreaded physics world with {} threads", threads);
+		} else {
+			_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+			_constraintSolver = new btSequentialImpulseConstraintSolver();
+			_physicsWorld = new btDiscreteDynamicsWorld(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				_constraintSolver,
+				_collisionConfig
+			);
+		}
 		_physicsWorld->setGravity(ToBt(_gravity));
+		// Only bodies that are awake move, rigid bodies update their own bounds when they're put to sleep after being moved
+		_physicsWorld->setForceUpdateAllAabbs(false);
 		// TODO bullet debug drawing
 		_bulletDebugDraw = new BulletDebugDraw();
 		_physicsWorld->setDebugDrawer(_bulletDebugDraw);
@@ -384,6 +456,7 @@ namespace Gameplay {
 
 	void Scene::_CleanupPhysics() {
 		delete _physicsWorld;
+		delete _solverPool;
 		delete _constraintSolver;
 		delete _broadphaseInterface;
 		delete _ghostCallback;
@@ -5,8 +5,15 @@
 #include "Gameplay/Components/Camera.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Light.h"
+#include "Gameplay/LightManager.h"
+#include "Gameplay/SoundPerception.h"
+#include "Gameplay/AIScheduler.h"
 
 #include "Physics/BulletDebugDraw.h"
+#include "Physics/RayBatch.h"
+#include "Physics/TaskScheduler.h"
+#include "Physics/TriggerDispatcher.h"
+#include "Physics/StaticWorld.h"
 
 #include "Graphics/Buffers/UniformBuffer.h"
 
@@ -16,6 +23,7 @@ class TextureCube;
 class ShaderProgram;
 
 class InspectorWindow;
+class btConstraintSolverPoolMt;
 class HierarchyWindow;
 
 const int LIGHT_UBO_BINDING_SLOT = 0;
@@ -40,7 +48,15 @@ namespace Gameplay {
 		static const int MAX_LIGHTS = 30;
 		static const int LIGHT_UBO_BINDING = 2;
 
-		// Stores all the lights in our scene
+		// How the physics world is set up for new scenes, loaded from the app settings
+		struct PhysicsSettings {
+			// If true, scenes use btDiscreteDynamicsWorldMt, which finds contacts and solves islands across threads
+			bool Multithreaded = false;
+			// How many of the shared thread pool's threads the physics world can use, 0 uses all of them
+			int  Threads = 0;
+		};
+
+		// Stores all the lights that are saved with our scene, lights made by gameplay come from the light manager
 		std::vector<Light>         Lights;
 		// The camera for our scene
 		Camera::Sptr               MainCamera;
@@ -54,6 +70,10 @@ namespace Gameplay {
 		std::vector<GameObject*> navNodes;
 
 		std::vector<GameObject*> soundEmmiters;
+		// Lets enemies find the sound emmiters they can hear, rebuilt at the start of each update
+		SoundPerception soundPerception;
+		// Decides which enemies run their full update each frame, based on how close they are to the player
+		AIScheduler aiScheduler;
 		GameObject* pathManager;
 		GameObject* audioManager;
 
@@ -167,15 +187,8 @@ namespace Gameplay {
 		void RenderGUI();
 
 		/// <summary>
-		/// Handles setting the shader uniforms for our light structure in our array of lights
-		/// </summary>
-		/// <param name="shader">The pointer to the shader</param>
-		/// <param name="uniformName">The name of the uniform (ex: u_Lights)</param>
-		/// <param name="index">The index of the light to set</param>
-		/// <param name="light">The light data to copy over</param>
-		void SetShaderLight(int index, bool update = true);
-		/// <summary>
-		/// Creates the shader and sets up all the lights
+		/// Picks the lights that are worth drawing this frame from the scene's lights and the light manager's,
+		/// and sends the parts of the light buffer that have changed
 		/// </summary>
 		void SetupShaderAndLights();
 
@@ -190,6 +203,34 @@ namespace Gameplay {
 		/// Gets the scene's Bullet physics world
 		/// </summary>
 		btDynamicsWorld* GetPhysicsWorld() const;
+		/// <summary>
+		/// Gets whether this scene's physics world was created multithreaded
+		/// </summary>
+		bool IsPhysicsMultithreaded() const { return _solverPool != nullptr; }
+
+		/// <summary>
+		/// Sets how the physics world is set up, only scenes created after this is called are affected
+		/// </summary>
+		static void SetPhysicsSettings(const PhysicsSettings& settings);
+		static const PhysicsSettings& GetPhysicsSettings() { return _physicsSettings; }
+		/// <summary>
+		/// Gets the scene's ray batch. Rays submitted to it during Update are cast after the
+		/// physics step, and their results can be read in the next frame's Update
+		/// </summary>
+		Physics::RayBatch& GetRayBatch() { return _rayBatch; }
+		/// <summary>
+		/// Gets the scene's trigger dispatcher, which sends the enter and leave events for all
+		/// trigger volumes after the physics step
+		/// </summary>
+		Physics::TriggerDispatcher& GetTriggerDispatcher() { return _triggerDispatcher; }
+		/// <summary>
+		/// Gets the scene's static world, which holds the level geometry merged into triangle meshes
+		/// </summary>
+		Physics::StaticWorld& GetStaticWorld() { return _staticWorld; }
+		/// <summary>
+		/// Gets the scene's light manager, which lights made by gameplay (ex: sound rings) should be allocated from
+		/// </summary>
+		LightManager& GetLightManager() { return _lightManager; }
 
 		/// <summary>
 		/// Loads a scene from a JSON blob
@@ -238,8 +279,22 @@ namespace Gameplay {
 		btConstraintSolver* _constraintSolver;
 		// this is what allows us to get our pairs from the trigger volumes
 		btGhostPairCallback* _ghostCallback;
+		// The solvers that islands are handed out to, only used by multithreaded worlds
+		btConstraintSolverPoolMt* _solverPool;
+
+		static PhysicsSettings _physicsSettings;
+		// Bullet only has one task scheduler, so it's shared by every scene
+		static Physics::TaskScheduler::Sptr _taskScheduler;
 
 		BulletDebugDraw* _bulletDebugDraw;
+		// The raycasts submitted by gameplay this frame
+		Physics::RayBatch _rayBatch;
+		// Sends the events for all of our trigger volumes
+		Physics::TriggerDispatcher _triggerDispatcher;
+		// The world geometry that has been merged into triangle meshes
+		Physics::StaticWorld _staticWorld;
+		// Pools the lights made by gameplay, and culls and merges lights before they're sent to the shaders
+		LightManager _lightManager;
 
 		// The path that we've saved or loaded this scene from
 		std::string             _filePath;
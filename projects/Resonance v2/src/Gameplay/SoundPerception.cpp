@@ -0,0 +1,147 @@
+#include "Gameplay/SoundPerception.h"
+
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Components/SoundEmmiter.h"
+#include "Utils/GlmBulletConversions.h"
+
+namespace Gameplay {
+	SoundPerception::SoundPerception() :
+		_cellSize(8.0f),
+		_cacheFrames(5),
+		_frame(0),
+		_queryStamp(0),
+		_raycastCount(0),
+		_lastRaycastCount(0),
+		_emitters(),
+		_emitterLookup(),
+		_cells()
+	{ }
+
+	uint64_t SoundPerception::_CellKey(int x, int y) {
+		return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+	}
+
+	glm::ivec2 SoundPerception::_GetCell(const glm::vec3& position) const {
+		return glm::ivec2(glm::floor(glm::vec2(position) / _cellSize));
+	}
+
+	void SoundPerception::SetCellSize(float value) {
+		_cellSize = glm::max(value, 0.1f);
+		// Cached results are keyed by cell, so they mean something else now
+		for (Emitter& emitter : _emitters) {
+			emitter.Cache.clear();
+		}
+	}
+
+	void SoundPerception::Rebuild(const std::vector<GameObject*>& emitters) {
+		_frame++;
+		_lastRaycastCount = _raycastCount;
+		_raycastCount = 0;
+
+		for (auto& [key, bucket] : _cells) {
+			bucket.clear();
+		}
+
+		// Emitters are only ever added to the scene, so they keep their index (and their cache) between frames
+		bool isResized = _emitters.size() != emitters.size();
+		if (isResized) {
+			_emitters.resize(emitters.size());
+			_emitterLookup.clear();
+		}
+
+		for (uint32_t ix = 0; ix < emitters.size(); ix++) {
+			Emitter& emitter = _emitters[ix];
+			if (emitter.Object != emitters[ix]) {
+				_emitterLookup.erase(emitter.Object);
+				emitter.Object = emitters[ix];
+				emitter.Cache.clear();
+				_emitterLookup[emitter.Object] = ix;
+			} else if (isResized) {
+				_emitterLookup[emitter.Object] = ix;
+			}
+
+			emitter.Position = emitter.Object->GetPosition();
+			emitter.Volume = emitter.Object->Get<SoundEmmiter>()->volume;
+
+			// Anything cached for where the emitter used to be is no longer valid
+			glm::ivec2 cell = _GetCell(emitter.Position);
+			if (cell != emitter.Cell) {
+				emitter.Cell = cell;
+				emitter.Cache.clear();
+			} else if (emitter.Cache.size() > 64) {
+				for (auto it = emitter.Cache.begin(); it != emitter.Cache.end();) {
+					it = _frame - it->second.Frame >= _cacheFrames ? emitter.Cache.erase(it) : std::next(it);
+				}
+			}
+
+			// Muted emitters can have a negative volume, they can still be heard up close so they still go in the grid
+			float radius = glm::max(emitter.Volume, 0.0f);
+			glm::ivec2 min = _GetCell(emitter.Position - glm::vec3(radius));
+			glm::ivec2 max = _GetCell(emitter.Position + glm::vec3(radius));
+			for (int y = min.y; y <= max.y; y++) {
+				for (int x = min.x; x <= max.x; x++) {
+					_cells[_CellKey(x, y)].push_back(ix);
+				}
+			}
+		}
+	}
+
+	void SoundPerception::Query(const glm::vec3& position, float listeningRadius, std::vector<GameObject*>& outEmitters) {
+		outEmitters.clear();
+		_queryStamp++;
+
+		// If the listening and audible radii overlap at all, they share a cell, so we only need to check the
+		// cells our own radius touches
+		glm::ivec2 min = _GetCell(position - glm::vec3(listeningRadius));
+		glm::ivec2 max = _GetCell(position + glm::vec3(listeningRadius));
+		for (int y = min.y; y <= max.y; y++) {
+			for (int x = min.x; x <= max.x; x++) {
+				auto it = _cells.find(_CellKey(x, y));
+				if (it == _cells.end()) {
+					continue;
+				}
+
+				for (uint32_t ix : it->second) {
+					Emitter& emitter = _emitters[ix];
+					if (emitter.QueryStamp == _queryStamp) {
+						continue;
+					}
+					emitter.QueryStamp = _queryStamp;
+
+					if (glm::length(emitter.Position - position) < emitter.Volume + listeningRadius) {
+						outEmitters.push_back(emitter.Object);
+					}
+				}
+			}
+		}
+	}
+
+	bool SoundPerception::IsOccluded(btCollisionWorld* world, const glm::vec3& listener, GameObject* emitter, const glm::vec3& target) {
+		auto lookup = _emitterLookup.find(emitter);
+		Occlusion* cached = nullptr;
+		if (lookup != _emitterLookup.end()) {
+			// Callers don't all cast towards the emitter itself (ex: chasing enemies cast towards the player), so the
+			// target is part of the key too
+			const glm::ivec2 cell = _GetCell(listener);
+			const glm::ivec2 targetCell = _GetCell(target);
+			const uint64_t key = _CellKey(cell.x, cell.y) ^ (_CellKey(targetCell.x, targetCell.y) * 0x9E3779B97F4A7C15ull);
+			cached = &_emitters[lookup->second].Cache[key];
+			if (cached->Frame != 0 && _frame - cached->Frame < _cacheFrames && cached->ListenerCell == cell && cached->TargetCell == targetCell) {
+				return cached->IsOccluded;
+			}
+			cached->ListenerCell = cell;
+			cached->TargetCell = targetCell;
+		}
+
+		btCollisionWorld::ClosestRayResultCallback hit(ToBt(listener), ToBt(target));
+		world->rayTest(ToBt(listener), ToBt(target), hit);
+		_raycastCount++;
+
+		bool isOccluded = hit.hasHit() && hit.m_collisionObject->isStaticObject();
+		if (cached != nullptr) {
+			cached->IsOccluded = isOccluded;
+			cached->Frame = _frame;
+		}
+		return isOccluded;
+	}
+}
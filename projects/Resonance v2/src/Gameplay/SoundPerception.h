@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <GLM/glm.hpp>
+
+class btCollisionWorld;
+
+namespace Gameplay {
+	class GameObject;
+
+	/// <summary>
+	/// Lets listeners (ex: enemies) find the sound emitters they can hear without checking every emitter
+	/// in the scene, and without casting a ray to each of them every frame
+	///
+	/// Emitters are put into a uniform grid over the XY plane, covering every cell their audible radius
+	/// touches, so a listener only has to look at the cells its own listening radius touches. Occlusion
+	/// raycasts are cached for each pair of listener cell and emitter for a few frames, and thrown away
+	/// early if the emitter moves to a different cell
+	/// </summary>
+	class SoundPerception {
+	public:
+		SoundPerception();
+		~SoundPerception() = default;
+
+		/// <summary>
+		/// Re-inserts the emitters into the grid with their current positions and volumes, and starts a
+		/// new frame for the occlusion cache. Should be called once a frame, before any listeners query
+		/// </summary>
+		/// <param name="emitters">The game objects with SoundEmmiter components, in the order they were registered</param>
+		void Rebuild(const std::vector<GameObject*>& emitters);
+
+		/// <summary>
+		/// Finds the emitters that are loud enough to reach a listener, ignoring occlusion
+		/// </summary>
+		/// <param name="position">The position of the listener</param>
+		/// <param name="listeningRadius">How far the listener can hear, on top of the emitter's volume</param>
+		/// <param name="outEmitters">Will store the emitters that can be heard</param>
+		void Query(const glm::vec3& position, float listeningRadius, std::vector<GameObject*>& outEmitters);
+
+		/// <summary>
+		/// Checks if there is static geometry between a listener and an emitter, re-using the result of
+		/// a recent raycast from the same cell, towards a target in the same cell, if there is one
+		/// </summary>
+		/// <param name="world">The physics world to raycast against</param>
+		/// <param name="listener">The position of the listener</param>
+		/// <param name="emitter">The emitter being listened to, as returned by Query</param>
+		/// <param name="target">The point to raycast towards, usually the emitter's position</param>
+		/// <returns>True if the sound is blocked, false if otherwise</returns>
+		bool IsOccluded(btCollisionWorld* world, const glm::vec3& listener, GameObject* emitter, const glm::vec3& target);
+
+		/// <summary>
+		/// Sets the size of the grid cells in world units, this also sets how far a listener can move
+		/// before it stops re-using cached occlusion results
+		/// </summary>
+		void SetCellSize(float value);
+		float GetCellSize() const { return _cellSize; }
+
+		/// <summary>
+		/// Sets how many frames an occlusion result can be re-used for
+		/// </summary>
+		void SetCacheFrames(uint32_t value) { _cacheFrames = value; }
+		uint32_t GetCacheFrames() const { return _cacheFrames; }
+
+		/// <summary>
+		/// Gets the number of occlusion raycasts done in the last full frame
+		/// </summary>
+		uint32_t GetRaycastCount() const { return _lastRaycastCount; }
+
+	protected:
+		struct Occlusion {
+			bool       IsOccluded;
+			uint32_t   Frame;
+			// The cells the ray went between, so results from different rays that share a key are never mixed up
+			glm::ivec2 ListenerCell;
+			glm::ivec2 TargetCell;
+		};
+
+		struct Emitter {
+			GameObject* Object = nullptr;
+			glm::vec3   Position = glm::vec3(0.0f);
+			float       Volume = 0.0f;
+			glm::ivec2  Cell = glm::ivec2(0);
+			// The last query that found this emitter, so each query only reports it once
+			uint32_t    QueryStamp = 0;
+			// Occlusion results, by the cells the listener and the ray's target were in
+			std::unordered_map<uint64_t, Occlusion> Cache;
+		};
+
+		float    _cellSize;
+		uint32_t _cacheFrames;
+		uint32_t _frame;
+		uint32_t _queryStamp;
+		uint32_t _raycastCount;
+		uint32_t _lastRaycastCount;
+
+		std::vector<Emitter> _emitters;
+		std::unordered_map<GameObject*, uint32_t> _emitterLookup;
+		// The emitters overlapping each cell. Buckets are cleared rather than erased so they keep their memory between frames
+		std::unordered_map<uint64_t, std::vector<uint32_t>> _cells;
+
+		static uint64_t _CellKey(int x, int y);
+		glm::ivec2 _GetCell(const glm::vec3& position) const;
+	};
+}
@@ -0,0 +1,295 @@
+#include "Gameplay/VoiceManager.h"
+
+#include <cstring>
+
+namespace Gameplay {
+	static float DistanceSq(const glm::vec3& a, const glm::vec3& b) {
+		const glm::vec3 delta = a - b;
+		return glm::dot(delta, delta);
+	}
+
+	VoiceManager::VoiceManager() :
+		_settings(),
+		_listener(0.0f),
+		_positionUpdates(0),
+		_nextOrder(0),
+		_voices(),
+		_voiceLookup()
+	{ }
+
+	void VoiceManager::Configure(FMOD::System* system, const Settings& settings) {
+		_settings = settings;
+
+		// Anything over the software channel count will be virtual, and voices below the threshold get made
+		// virtual first, so the mixer never has more than RealVoices to deal with
+		system->setSoftwareChannels(settings.RealVoices);
+
+		FMOD_ADVANCEDSETTINGS advanced;
+		memset(&advanced, 0, sizeof(FMOD_ADVANCEDSETTINGS));
+		advanced.cbSize = sizeof(FMOD_ADVANCEDSETTINGS);
+		system->getAdvancedSettings(&advanced);
+		advanced.vol0virtualvol = settings.AudibilityThreshold;
+		system->setAdvancedSettings(&advanced);
+	}
+
+	int VoiceManager::GetCategoryPriority(SoundCategory category) {
+		switch (category) {
+			case SoundCategory::Music:     return 0;
+			case SoundCategory::Interface: return 16;
+			case SoundCategory::Ambience:  return 32;
+			case SoundCategory::Player:    return 64;
+			case SoundCategory::Enemy:     return 96;
+			case SoundCategory::Effect:
+			default:                       return 128;
+		}
+	}
+
+	FMOD::Channel* VoiceManager::Play(FMOD::System* system, FMOD::Sound* sound, int maxInstances, const glm::vec3& position, float volume, float pitch) {
+		FMOD_MODE mode = FMOD_DEFAULT;
+		sound->getMode(&mode);
+		const bool is3D = (mode & FMOD_3D) != 0;
+		const float distance = is3D ? DistanceSq(position, _listener) : 0.0f;
+
+		const bool isLooping = (mode & (FMOD_LOOP_NORMAL | FMOD_LOOP_BIDI)) != 0;
+		bool isCapped = false;
+
+		if (maxInstances > 0) {
+			// Find the audible instance that is furthest away, going with the oldest one if they're all as far
+			int count = 0;
+			int furthest = -1;
+			float furthestDistance = 0.0f;
+			for (size_t ix = 0; ix < _voices.size(); ix++) {
+				const Voice& voice = _voices[ix];
+				if (voice.Sound != sound || voice.IsCapped) {
+					continue;
+				}
+				count++;
+				const float voiceDistance = _GetDistance(voice);
+				if (furthest == -1 || voiceDistance > furthestDistance ||
+					(voiceDistance == furthestDistance && voice.Order < _voices[furthest].Order)) {
+					furthest = static_cast<int>(ix);
+					furthestDistance = voiceDistance;
+				}
+			}
+
+			if (count >= maxInstances) {
+				// Every instance is closer than the new one, so it would be the one we'd want to drop anyways
+				if (distance > furthestDistance) {
+					if (!isLooping) {
+						return nullptr;
+					}
+					isCapped = true;
+				} else if (isLooping) {
+					_SetCapped(_voices[furthest], true);
+				} else {
+					_voices[furthest].Channel->stop();
+					_RemoveVoice(furthest);
+				}
+			}
+		}
+
+		// Start paused so that the voice has the right volume and position before it gets mixed
+		FMOD::Channel* channel = nullptr;
+		if (system->playSound(sound, nullptr, true, &channel) != FMOD_OK || channel == nullptr) {
+			return nullptr;
+		}
+		channel->setVolume(isCapped ? 0.0f : volume);
+		if (pitch != 1.0f) {
+			channel->setPitch(pitch);
+		}
+		if (is3D) {
+			FMOD_VECTOR fmodPosition = _ToFmod(position);
+			channel->set3DAttributes(&fmodPosition, nullptr);
+		}
+		channel->setPaused(false);
+
+		Voice voice;
+		voice.Channel = channel;
+		voice.Sound = sound;
+		voice.Is3D = is3D;
+		voice.Position = position;
+		voice.SentPosition = position;
+		voice.Order = _nextOrder++;
+		voice.Volume = volume;
+		voice.MaxInstances = maxInstances;
+		voice.IsLooping = isLooping;
+		voice.IsCapped = isCapped;
+
+		// FMOD can hand out a channel handle that we still have around if that voice was stolen
+		auto it = _voiceLookup.find(channel);
+		if (it != _voiceLookup.end()) {
+			_voices[it->second] = voice;
+		} else {
+			_voiceLookup[channel] = _voices.size();
+			_voices.push_back(voice);
+		}
+		return channel;
+	}
+
+	bool VoiceManager::SetPosition(FMOD::Channel* channel, const glm::vec3& position, const glm::vec3& velocity) {
+		auto it = _voiceLookup.find(channel);
+		if (it == _voiceLookup.end()) {
+			return false;
+		}
+		Voice& voice = _voices[it->second];
+		voice.Position = position;
+		voice.Velocity = velocity;
+		return true;
+	}
+
+	void VoiceManager::GetOcclusionSources(std::vector<AudioOcclusion::Source>& sources) const {
+		sources.clear();
+		for (const Voice& voice : _voices) {
+			if (voice.Is3D) {
+				AudioOcclusion::Source source;
+				source.Key = voice.Channel;
+				source.Order = voice.Order;
+				source.Position = voice.Position;
+				sources.push_back(source);
+			}
+		}
+	}
+
+	void VoiceManager::SetOcclusion(const std::vector<AudioOcclusion::Result>& results) {
+		for (const AudioOcclusion::Result& result : results) {
+			auto it = _voiceLookup.find(static_cast<FMOD::Channel*>(result.Key));
+			// FMOD re-uses channel handles, so the order tells us if it's still the same voice
+			if (it != _voiceLookup.end() && _voices[it->second].Order == result.Order) {
+				_voices[it->second].TargetOcclusion = result.Occlusion;
+			}
+		}
+	}
+
+	void VoiceManager::ClearOcclusion() {
+		for (Voice& voice : _voices) {
+			voice.TargetOcclusion = 0.0f;
+		}
+	}
+
+	void VoiceManager::Update(float deltaTime) {
+		_positionUpdates = 0;
+		const float realEpsilon = _settings.PositionEpsilon * _settings.PositionEpsilon;
+		const float virtualEpsilon = _settings.VirtualPositionEpsilon * _settings.VirtualPositionEpsilon;
+		const float occlusionBlend = glm::clamp(deltaTime * _settings.OcclusionSpeed, 0.0f, 1.0f);
+
+		bool anyCapped = false;
+		for (size_t ix = 0; ix < _voices.size();) {
+			Voice& voice = _voices[ix];
+
+			// Stopped or stolen channels will either report that they aren't playing, or give us an error
+			bool isPlaying = false;
+			if (voice.Channel->isPlaying(&isPlaying) != FMOD_OK || !isPlaying) {
+				_RemoveVoice(ix);
+				continue;
+			}
+
+			if (voice.Is3D) {
+				const float moved = glm::max(DistanceSq(voice.Position, voice.SentPosition), DistanceSq(voice.Velocity, voice.SentVelocity));
+				// Most voices don't move, so we only ask FMOD if a voice is virtual when it has
+				if (moved > realEpsilon) {
+					bool isVirtual = false;
+					voice.Channel->isVirtual(&isVirtual);
+					if (!isVirtual || moved > virtualEpsilon) {
+						FMOD_VECTOR position = _ToFmod(voice.Position);
+						FMOD_VECTOR velocity = _ToFmod(voice.Velocity);
+						voice.Channel->set3DAttributes(&position, &velocity);
+						voice.SentPosition = voice.Position;
+						voice.SentVelocity = voice.Velocity;
+						_positionUpdates++;
+					}
+				}
+
+				// FMOD turns occlusion into both a volume drop and a low pass, on top of the voice's own volume
+				voice.Occlusion += (voice.TargetOcclusion - voice.Occlusion) * occlusionBlend;
+				// Easing never quite gets there, so snap once we're close enough that nobody could hear it
+				if (glm::abs(voice.TargetOcclusion - voice.Occlusion) < 0.001f) {
+					voice.Occlusion = voice.TargetOcclusion;
+				}
+				if (glm::abs(voice.Occlusion - voice.SentOcclusion) > _settings.OcclusionEpsilon ||
+					(voice.Occlusion != voice.SentOcclusion && voice.Occlusion == voice.TargetOcclusion)) {
+					voice.Channel->set3DOcclusion(voice.Occlusion, voice.Occlusion);
+					voice.SentOcclusion = voice.Occlusion;
+				}
+			}
+			anyCapped |= voice.IsCapped;
+			ix++;
+		}
+
+		if (anyCapped) {
+			_UpdateCapped();
+		}
+	}
+
+	void VoiceManager::_SetCapped(Voice& voice, bool isCapped) {
+		// At zero volume FMOD makes the voice virtual, so it keeps it's place in the loop without being mixed
+		voice.Channel->setVolume(isCapped ? 0.0f : voice.Volume);
+		voice.IsCapped = isCapped;
+	}
+
+	void VoiceManager::_UpdateCapped() {
+		// Only swap when the capped voice is quite a bit closer, so two voices at about the same distance don't trade back and forth
+		static constexpr float SWAP_RATIO = 0.64f;
+
+		for (size_t ix = 0; ix < _voices.size(); ix++) {
+			if (!_voices[ix].IsCapped) {
+				continue;
+			}
+			FMOD::Sound* sound = _voices[ix].Sound;
+
+			// Find the closest capped voice and the furthest audible voice for this sound
+			int closest = -1;
+			int furthest = -1;
+			int count = 0;
+			for (size_t other = 0; other < _voices.size(); other++) {
+				const Voice& voice = _voices[other];
+				if (voice.Sound != sound) {
+					continue;
+				}
+				const float voiceDistance = _GetDistance(voice);
+				if (voice.IsCapped) {
+					if (closest == -1 || voiceDistance < _GetDistance(_voices[closest])) {
+						closest = static_cast<int>(other);
+					}
+				} else {
+					count++;
+					if (furthest == -1 || voiceDistance > _GetDistance(_voices[furthest])) {
+						furthest = static_cast<int>(other);
+					}
+				}
+			}
+
+			// Each sound gets handled once, by it's closest capped voice
+			if (closest != static_cast<int>(ix)) {
+				continue;
+			}
+			Voice& voice = _voices[ix];
+			if (count < voice.MaxInstances) {
+				_SetCapped(voice, false);
+			} else if (furthest != -1 && _GetDistance(voice) < _GetDistance(_voices[furthest]) * SWAP_RATIO) {
+				_SetCapped(_voices[furthest], true);
+				_SetCapped(voice, false);
+			}
+		}
+	}
+
+	float VoiceManager::_GetDistance(const Voice& voice) const {
+		return voice.Is3D ? DistanceSq(voice.Position, _listener) : 0.0f;
+	}
+
+	void VoiceManager::_RemoveVoice(size_t index) {
+		_voiceLookup.erase(_voices[index].Channel);
+		if (index != _voices.size() - 1) {
+			_voices[index] = _voices.back();
+			_voiceLookup[_voices[index].Channel] = index;
+		}
+		_voices.pop_back();
+	}
+
+	FMOD_VECTOR VoiceManager::_ToFmod(const glm::vec3& value) {
+		FMOD_VECTOR result;
+		result.x = value.x;
+		result.y = value.y;
+		result.z = value.z;
+		return result;
+	}
+}
@@ -0,0 +1,168 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <GLM/glm.hpp>
+#include <EnumToString.h>
+#include "fmod.hpp"
+#include "Gameplay/AudioOcclusion.h"
+
+/// <summary>
+/// Groups sounds by what they're used for, each category has a default priority for it's voices
+/// </summary>
+ENUM(SoundCategory, int,
+	Music     = 0,
+	Interface = 1,
+	Ambience  = 2,
+	Player    = 3,
+	Enemy     = 4,
+	Effect    = 5
+);
+
+namespace Gameplay {
+	/// <summary>
+	/// Keeps track of every voice (playing channel) so that crowded scenes stay cheap to mix and update
+	///
+	/// FMOD is set up so only a fixed number of voices are actually mixed, and voices that are too quiet to
+	/// hear are made virtual, so they cost nothing until they become audible again. Each sound can also cap
+	/// how many instances of it play at once. Positions are only sent to FMOD when a voice has moved far
+	/// enough to matter, with a much larger distance for virtual voices, so the number of API calls a frame
+	/// doesn't grow with how many objects are making noise. The same goes for occlusion, which is eased towards
+	/// the latest results from an AudioOcclusion and only sent when it has changed
+	/// </summary>
+	class VoiceManager {
+	public:
+		struct Settings {
+			// How many voices FMOD will actually mix, the rest are virtual
+			int   RealVoices = 32;
+			// How many voices can be playing at once, including virtual voices
+			int   MaxVoices = 256;
+			// Voices that are quieter than this are made virtual
+			float AudibilityThreshold = 0.001f;
+			// How far a real voice has to move before it's new position is sent to FMOD
+			float PositionEpsilon = 0.05f;
+			// How far a virtual voice has to move before it's new position is sent to FMOD
+			float VirtualPositionEpsilon = 1.0f;
+			// How quickly a voice's occlusion eases towards it's latest result, per second
+			float OcclusionSpeed = 8.0f;
+			// How much a voice's occlusion has to change before it's sent to FMOD
+			float OcclusionEpsilon = 0.02f;
+		};
+
+		VoiceManager();
+		~VoiceManager() = default;
+
+		/// <summary>
+		/// Sets up the voice limits on an FMOD system, must be called before the system is initialized
+		/// </summary>
+		/// <param name="system">The system to configure</param>
+		/// <param name="settings">The limits to use</param>
+		void Configure(FMOD::System* system, const Settings& settings);
+		const Settings& GetSettings() const { return _settings; }
+
+		/// <summary>
+		/// Gets the default FMOD priority of a category, 0 is the most important and 256 is the least
+		/// </summary>
+		static int GetCategoryPriority(SoundCategory category);
+
+		/// <summary>
+		/// Starts playing a sound, if it doesn't go over the sound's instance limit. When a sound is at it's
+		/// limit, the instance furthest from the listener is stopped to make room, unless the new one would be
+		/// even further away. Looping sounds are never stopped for going over the limit, since nothing would
+		/// start them again, instead the furthest instances are kept silent (and virtual) until they're close
+		/// enough to take a slot back
+		/// </summary>
+		/// <param name="system">The system to play the sound on</param>
+		/// <param name="sound">The sound to play</param>
+		/// <param name="maxInstances">The most instances of the sound that can play at once, or 0 for no limit</param>
+		/// <param name="position">The world position of the sound, ignored for 2D sounds</param>
+		/// <param name="volume">The volume to play the sound at</param>
+		/// <param name="pitch">The pitch to play the sound at</param>
+		/// <returns>The new channel, or nullptr if the sound was not played</returns>
+		FMOD::Channel* Play(FMOD::System* system, FMOD::Sound* sound, int maxInstances, const glm::vec3& position, float volume, float pitch = 1.0f);
+
+		/// <summary>
+		/// Moves a playing voice, the new position is sent to FMOD during Update if it has moved far enough
+		/// </summary>
+		/// <param name="channel">The channel returned by Play</param>
+		/// <param name="position">The new world position of the voice</param>
+		/// <param name="velocity">The velocity of the voice, used for doppler</param>
+		/// <returns>True if the voice is still playing, false if otherwise</returns>
+		bool SetPosition(FMOD::Channel* channel, const glm::vec3& position, const glm::vec3& velocity = glm::vec3(0.0f));
+
+		/// <summary>
+		/// Sets where the listener is, used to pick which instance to stop when a sound is at it's limit
+		/// </summary>
+		void SetListener(const glm::vec3& position) { _listener = position; }
+
+		/// <summary>
+		/// Gets the 3D voices that occlusion should be worked out for
+		/// </summary>
+		/// <param name="sources">Replaced with one source per 3D voice</param>
+		void GetOcclusionSources(std::vector<AudioOcclusion::Source>& sources) const;
+		/// <summary>
+		/// Sets the occlusion that each voice will ease towards, results for voices that have since stopped are ignored
+		/// </summary>
+		/// <param name="results">The results from an AudioOcclusion, for sources from GetOcclusionSources</param>
+		void SetOcclusion(const std::vector<AudioOcclusion::Result>& results);
+		/// <summary>
+		/// Eases every voice back to being unoccluded, ex: when occlusion is turned off
+		/// </summary>
+		void ClearOcclusion();
+
+		/// <summary>
+		/// Forgets about voices that have finished, and sends positions and occlusion that have changed to FMOD.
+		/// Should be called once a frame, before the FMOD system is updated
+		/// </summary>
+		/// <param name="deltaTime">The time in seconds since the last update</param>
+		void Update(float deltaTime);
+
+		/// <summary>
+		/// Gets the number of voices that are playing, including virtual voices
+		/// </summary>
+		size_t GetVoiceCount() const { return _voices.size(); }
+		/// <summary>
+		/// Gets the number of positions that were sent to FMOD in the last update
+		/// </summary>
+		uint32_t GetPositionUpdateCount() const { return _positionUpdates; }
+
+	protected:
+		struct Voice {
+			FMOD::Channel* Channel = nullptr;
+			FMOD::Sound*   Sound = nullptr;
+			bool           Is3D = false;
+			glm::vec3      Position = glm::vec3(0.0f);
+			glm::vec3      Velocity = glm::vec3(0.0f);
+			// The last position and velocity that FMOD was given
+			glm::vec3      SentPosition = glm::vec3(0.0f);
+			glm::vec3      SentVelocity = glm::vec3(0.0f);
+			// When the voice was started, so we can find the oldest instance of a sound
+			uint64_t       Order = 0;
+			// The occlusion we're easing towards, the current occlusion, and the last occlusion FMOD was given
+			float          TargetOcclusion = 0.0f;
+			float          Occlusion = 0.0f;
+			float          SentOcclusion = 0.0f;
+			// The volume the voice was played at, and it's sound's instance limit
+			float          Volume = 1.0f;
+			int            MaxInstances = 0;
+			// Looping voices over their sound's limit are kept at zero volume instead of being stopped
+			bool           IsLooping = false;
+			bool           IsCapped = false;
+		};
+
+		Settings  _settings;
+		glm::vec3 _listener;
+		uint32_t  _positionUpdates;
+		uint64_t  _nextOrder;
+
+		std::vector<Voice> _voices;
+		std::unordered_map<FMOD::Channel*, size_t> _voiceLookup;
+
+		void _RemoveVoice(size_t index);
+		void _SetCapped(Voice& voice, bool isCapped);
+		// Gives slots that have freed up, or are held by voices much further away, to the closest capped voices
+		void _UpdateCapped();
+		float _GetDistance(const Voice& voice) const;
+		static FMOD_VECTOR _ToFmod(const glm::vec3& value);
+	};
+}
@@ -59,6 +59,14 @@ void IBuffer::UpdateData(const void* data, uint32_t elementSize, uint32_t elemen
 	}
 }
 
+void IBuffer::AllocateStorage(uint32_t elementSize, uint32_t elementCount, BufferMapMode flags, const void* data) {
+	glNamedBufferStorage(_rendererId, (GLsizeiptr)elementSize * elementCount, data, *flags);
+
+	_elementCount = elementCount;
+	_elementSize = elementSize;
+	_size = elementCount * elementSize;
+}
+
 void* IBuffer::Map(BufferMapMode mode) {
 	return glMapNamedBufferRange(_rendererId, 0, _size, *mode);
 }
@@ -84,6 +84,16 @@ public:
 	/// </summary>
 	BufferUsage GetUsage() const { return _usage; }
 
+	/// <summary>
+	/// Allocates immutable storage for the buffer, which is needed for it to be mapped persistently. The
+	/// buffer can't be resized by LoadData or UpdateData after this
+	/// </summary>
+	/// <param name="elementSize">The size of a single element in bytes</param>
+	/// <param name="elementCount">The number of elements to make room for</param>
+	/// <param name="flags">How the buffer will be mapped, must include every flag that Map will be called with</param>
+	/// <param name="data">The data to fill the buffer with, or nullptr to leave it uninitialized</param>
+	void AllocateStorage(uint32_t elementSize, uint32_t elementCount, BufferMapMode flags, const void* data = nullptr);
+
 	/// <summary>
 	/// Maps the buffer's data to a pointer that the CPU can access. Note that unmap should be called
 	/// to allow the GPU to take over control of the memory again
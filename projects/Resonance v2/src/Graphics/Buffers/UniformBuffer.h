@@ -109,4 +109,13 @@ public:
 	void Update() {
 		glNamedBufferSubData(_rendererId, 0, sizeof(Structure), _rawData);
 	}
+	/// <summary>
+	/// Resyncs only part of the data with the GL side buffer, for when only
+	/// a few fields have changed
+	/// </summary>
+	/// <param name="offset">The offset in bytes of the first byte to send</param>
+	/// <param name="size">The number of bytes to send</param>
+	void Update(uint32_t offset, uint32_t size) {
+		glNamedBufferSubData(_rendererId, offset, size, _rawData + offset);
+	}
 };
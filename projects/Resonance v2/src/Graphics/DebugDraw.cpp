@@ -1,4 +1,5 @@
 #include "Graphics/DebugDraw.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 
 DebugDrawer::DebugDrawer() :
 	_colorStack(std::stack<glm::vec3>()),
@@ -164,10 +165,10 @@ DebugDrawer& DebugDrawer::Get() {
 				}
 			)LIT";
 
-		__Shader = ShaderProgram::Create();
-		__Shader->LoadShaderPart(vs_source, ShaderPartType::Vertex);
-		__Shader->LoadShaderPart(fs_source, ShaderPartType::Fragment);
-		__Shader->Link();
+		__Shader = ResourceManager::GetShaderFromSource({
+			{ ShaderPartType::Vertex, vs_source },
+			{ ShaderPartType::Fragment, fs_source }
+		});
 	}
 	return *__Instance;
 }
@@ -4,9 +4,15 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 #include <locale>
 #include <codecvt>
+#include <cstddef>
 
 
-std::unordered_map<Texture2D*, GuiBatcher::MeshData> GuiBatcher::_meshBuilders;
+const std::vector<BufferAttribute> GuiBatcher::GuiVertex::V_DECL = {
+	BufferAttribute(0, 2, AttributeType::Float, sizeof(GuiVertex), offsetof(GuiVertex, Position), AttribUsage::Position),
+	BufferAttribute(1, 4, AttributeType::Float, sizeof(GuiVertex), offsetof(GuiVertex, Color), AttribUsage::Color),
+	BufferAttribute(3, 2, AttributeType::Float, sizeof(GuiVertex), offsetof(GuiVertex, UV), AttribUsage::Texture),
+	BufferAttribute(4, 1, AttributeType::Float, sizeof(GuiVertex), offsetof(GuiVertex, Texture), AttribUsage::User0),
+};
 
 VertexArrayObject::Sptr GuiBatcher::__vao = nullptr;
 IndexBuffer::Sptr GuiBatcher::__ibo = nullptr;
@@ -16,46 +22,64 @@ int GuiBatcher::__defaultEdgeRadius = 0;
 
 VertexBuffer::Sptr GuiBatcher::__vbo = nullptr;
 ShaderProgram::Sptr GuiBatcher::__shader = nullptr;
-ShaderProgram::Sptr GuiBatcher::__fontShader = nullptr;
 glm::ivec2 GuiBatcher::__windowSize = {0, 0};
 glm::mat4 GuiBatcher::__projection = glm::mat4(1.0f);
 glm::mat3 GuiBatcher::__model = glm::mat3(1.0f);
 std::vector<glm::mat3> GuiBatcher::__modelTransformStack = std::vector<glm::mat3>();
 std::vector<GuiBatcher::IRect> GuiBatcher::__scissorRects = std::vector<GuiBatcher::IRect>();
 
-void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2 uvMin, const glm::vec2 uvMax) {
-	// Create vertices and transform positions
-	VertexPosColTex verts[4];
-	verts[0].Position = __model * glm::vec3(min.x, min.y, 1.0f);
-	verts[1].Position = __model * glm::vec3(min.x, max.y, 1.0f);
-	verts[2].Position = __model * glm::vec3(max.x, max.y, 1.0f);
-	verts[3].Position = __model * glm::vec3(max.x, min.y, 1.0f);
-		
-	// Grab mesh info for the texture batch
-	MeshData& mesh = _meshBuilders[tex.get()];
-	// We can use the vertex count for depth, so that things drawn later have a bit of spacing
-	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
+GuiBatcher::GuiVertex* GuiBatcher::__stream = nullptr;
+uint32_t GuiBatcher::__streamCursor = 0;
+uint32_t GuiBatcher::__batchStart = 0;
+uint32_t GuiBatcher::__segment = 0;
+GLsync GuiBatcher::__segmentFences[GuiBatcher::STREAM_SEGMENTS] = { };
 
-	// Copy in all color and set depth 
-	for (int ix = 0; ix < 4; ix++) {
-		verts[ix].Color = color;
-		verts[ix].Position.z = depth;
-	}
+Texture2D* GuiBatcher::__slotTextures[GuiBatcher::MAX_TEXTURE_SLOTS] = { };
+int GuiBatcher::__slotCount = 0;
+int GuiBatcher::__fontSlotMask = 0;
 
-	// Copy over UV coords
-	verts[0].UV = glm::vec2(uvMin.x, uvMax.y);
-	verts[1].UV = glm::vec2(uvMin.x, uvMin.y);
-	verts[2].UV = glm::vec2(uvMax.x, uvMin.y);
-	verts[3].UV = glm::vec2(uvMax.x, uvMax.y);
+std::unordered_map<Texture2D*, GuiBatcher::AtlasEntry> GuiBatcher::__atlasEntries;
+std::vector<GuiBatcher::AtlasPage> GuiBatcher::__atlasPages;
 
-	// Add vertices and indices to range
-	uint32_t ix = mesh.Builder.AddVertexRange(verts, 4);
-	mesh.Builder.AddIndexTri(ix + 0, ix + 2, ix + 1);
-	mesh.Builder.AddIndexTri(ix + 0, ix + 3, ix + 2);
+/// <summary>
+/// Rounds a size up to the next multiple of the given alignment
+/// </summary>
+inline int AlignUp(int value, int alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, const glm::vec2 uvMin, const glm::vec2 uvMax) {
+	if (tex == nullptr) {
+		return;
+	}
+	__StaticInit();
+	__ReserveQuads(1);
+
+	// Packed textures have their UVs moved into their region of the atlas page
+	const AtlasEntry& entry = __GetAtlasEntry(tex);
+	Texture2D* source = entry.Page >= 0 ? __atlasPages[entry.Page].Texture.get() : tex.get();
+	int slot = __GetTextureSlot(source, false);
+
+	glm::vec2 positions[4] = {
+		__model * glm::vec3(min.x, min.y, 1.0f),
+		__model * glm::vec3(min.x, max.y, 1.0f),
+		__model * glm::vec3(max.x, max.y, 1.0f),
+		__model * glm::vec3(max.x, min.y, 1.0f)
+	};
+	glm::vec2 uvs[4] = {
+		entry.UvOffset + glm::vec2(uvMin.x, uvMax.y) * entry.UvScale,
+		entry.UvOffset + glm::vec2(uvMin.x, uvMin.y) * entry.UvScale,
+		entry.UvOffset + glm::vec2(uvMax.x, uvMin.y) * entry.UvScale,
+		entry.UvOffset + glm::vec2(uvMax.x, uvMax.y) * entry.UvScale
+	};
+	__PushQuad(positions, uvs, color, slot);
 }
 
 void GuiBatcher::PushRect(const glm::vec2& min, const glm::vec2& max, const glm::vec4& color, const Texture2D::Sptr& tex, int edgeRadius)
 {
+	if (tex == nullptr) {
+		return;
+	}
 	if (edgeRadius <= 0) {
 		PushRect(min, max, color, tex, { 0,0 }, { 1,1 });
 	} 
@@ -107,21 +131,16 @@ void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, co
 	// Transform the origin based off the model transform
 	glm::vec2 origin = position;
 
-	// Gets the texture used to render the font
+	// Gets the texture used to render the font, fonts keep their own atlas since they only have one channel
 	Texture2D::Sptr atlas = font->GetAtlas();
-
-	// Grab the mesh builder and make sure it's a texture batch
-	MeshData& mesh = _meshBuilders[atlas.get()];
-	mesh.IsFont = true;
+	if (atlas == nullptr) {
+		return;
+	}
+	__StaticInit();
 
 	// Allocate some space for the vertices
-	VertexPosColTex verts[4];
-	verts[0].Color = color;
-	verts[1].Color = color;
-	verts[2].Color = color;
-	verts[3].Color = color;
-
-	float depth = mesh.Builder.GetVertexCount() / 1000.0f;
+	glm::vec2 positions[4];
+	glm::vec2 uvs[4];
 
 	// Iterate over all characters in string
 	for (int i = 0; i < length; i++) {
@@ -145,20 +164,15 @@ void GuiBatcher::RenderText(const std::wstring& text, const Font::Sptr& font, co
 		}
 		// All other characters get rendered
 		else {
-			verts[0].Position = __model * glm::vec3(origin + (offset + glyph.Positions[0]) * scale, 1.0f);
-			verts[1].Position = __model * glm::vec3(origin + (offset + glyph.Positions[1]) * scale, 1.0f);
-			verts[2].Position = __model * glm::vec3(origin + (offset + glyph.Positions[2]) * scale, 1.0f);
-			verts[3].Position = __model * glm::vec3(origin + (offset + glyph.Positions[3]) * scale, 1.0f);
-			verts[0].UV = glyph.UVs[0];
-			verts[1].UV = glyph.UVs[1];
-			verts[2].UV = glyph.UVs[2];
-			verts[3].UV = glyph.UVs[3];
-
-			verts[0].Position.z = verts[1].Position.z = verts[2].Position.z = verts[3].Position.z = depth;
+			for (int ix = 0; ix < 4; ix++) {
+				positions[ix] = __model * glm::vec3(origin + (offset + glyph.Positions[ix]) * scale, 1.0f);
+				uvs[ix] = glyph.UVs[ix];
+			}
 
-			uint32_t ix = mesh.Builder.AddVertexRange(verts, 4);
-			mesh.Builder.AddIndexTri(ix + 0, ix + 1, ix + 2);
-			mesh.Builder.AddIndexTri(ix + 0, ix + 2, ix + 3);
+			// The slot has to be found after reserving, since either one can start a new batch
+			__ReserveQuads(1);
+			int slot = __GetTextureSlot(atlas.get(), true);
+			__PushQuad(positions, uvs, color, slot);
 
 			// Advance the offset based on the size of the glyph
 			offset.x = glyph.OffsetX;
@@ -185,30 +199,242 @@ void GuiBatcher::RenderText(const std::string& text, const Font::Sptr& font, con
 void GuiBatcher::Flush()
 {
 	__StaticInit();
+	__DrawBatch();
+}
+
+const GuiBatcher::AtlasEntry& GuiBatcher::__GetAtlasEntry(const Texture2D::Sptr& tex) {
+	// A texture that's been freed could have had it's address re-used, so make sure it's still the same one
+	auto it = __atlasEntries.find(tex.get());
+	if (it != __atlasEntries.end() && it->second.Source.lock() == tex) {
+		// New data has been loaded into the texture since we packed it, the size can't change so it goes back in the same spot
+		if (it->second.Page >= 0 && it->second.DataVersion != tex->GetDataVersion()) {
+			__CopyToPage(tex.get(), it->second);
+		}
+		return it->second;
+	}
+
+	// New textures are rare once the GUI is up, so this is when we clean up after the ones that are gone
+	__ForgetDeadTextures();
+
+	AtlasEntry& entry = __atlasEntries[tex.get()];
+	entry.Source = tex;
+	entry.Page = -1;
+	entry.Origin = glm::ivec2(0);
+	entry.DataVersion = 0;
+	entry.UvOffset = glm::vec2(0.0f);
+	entry.UvScale = glm::vec2(1.0f);
+	__PackTexture(tex.get(), entry);
+	return entry;
+}
+
+bool GuiBatcher::__PackTexture(Texture2D* tex, AtlasEntry& entry) {
+	// We copy texels straight across on the GPU, so the formats need to match the pages. Textures that weren't loaded
+	// from a file are render targets or generated, and could be written to at any time, so those are drawn on their own
+	const Texture2DDescription& desc = tex->GetDescription();
+	const int width = static_cast<int>(desc.Width);
+	const int height = static_cast<int>(desc.Height);
+	if (desc.Filename.empty() || desc.Format != InternalFormat::RGBA8 || desc.MultisampleCount != 1 || width <= 0 || height <= 0 ||
+		width > MAX_ATLAS_ITEM_SIZE || height > MAX_ATLAS_ITEM_SIZE) {
+		return false;
+	}
 
-	// Iterate over each texture and it's mesh
-	for (auto&[key, value] : _meshBuilders) {
-		Texture2D* tex = key;
-		// If the texture exists and the mesh has data
-		if (tex != nullptr && value.Builder.GetIndexCount() > 0) {
-			// Update the VAO and it's buffers
-			__vao->Bind();
-			__vbo->UpdateData(value.Builder.GetVertexDataPtr(), sizeof(VertexPosColTex), value.Builder.GetVertexCount(), true);
-			__ibo->UpdateData(value.Builder.GetIndexDataPtr(), sizeof(uint32_t), value.Builder.GetIndexCount(), true);
-
-			// Bind texture, send uniforms to shader
-			tex->Bind(0);
-			ShaderProgram::Sptr shader = value.IsFont ? __fontShader : __shader;
-			shader->Bind();
-			shader->SetUniformMatrix(0, &__projection, 1, false);
-
-			// Draw geometry
-			__vao->Draw();
-
-			// Clear mesh
-			value.Builder.Reset();
+	// Each texture gets a border of it's own edges, so filtering doesn't pull in it's neighbours. Mip filtered textures
+	// need enough of a border (lined up to it) that the smallest level we generate still has a texel of it
+	const bool hasMips = desc.MinificationFilter != MinFilter::Nearest && desc.MinificationFilter != MinFilter::Linear;
+	const int padding = hasMips ? 1 << (ATLAS_MIP_LEVELS - 1) : 1;
+	stbrp_rect rect = stbrp_rect();
+	rect.w = static_cast<stbrp_coord>(AlignUp(width, padding) + padding * 2);
+	rect.h = static_cast<stbrp_coord>(AlignUp(height, padding) + padding * 2);
+
+	// Pages only hold textures with the same filtering, so pixel art stays crisp and everything else stays smooth
+	int page = -1;
+	for (int ix = 0; ix < static_cast<int>(__atlasPages.size()) && page == -1; ix++) {
+		AtlasPage& atlasPage = __atlasPages[ix];
+		if (atlasPage.Minification == desc.MinificationFilter && atlasPage.Magnification == desc.MagnificationFilter &&
+			stbrp_pack_rects(&atlasPage.Packer, &rect, 1)) {
+			page = ix;
 		}
 	}
+	if (page == -1) {
+		if (__atlasPages.size() >= MAX_ATLAS_PAGES) {
+			return false;
+		}
+
+		Texture2DDescription pageDesc = Texture2DDescription();
+		pageDesc.Width = ATLAS_PAGE_SIZE;
+		pageDesc.Height = ATLAS_PAGE_SIZE;
+		pageDesc.Format = InternalFormat::RGBA8;
+		pageDesc.HorizontalWrap = WrapMode::ClampToEdge;
+		pageDesc.VerticalWrap = WrapMode::ClampToEdge;
+		pageDesc.MinificationFilter = desc.MinificationFilter;
+		pageDesc.MagnificationFilter = desc.MagnificationFilter;
+		pageDesc.MaxAnisotropic = 1.0f;
+		pageDesc.GenerateMipMaps = hasMips;
+
+		// The packer is kept with the page, so we can keep adding to it as new textures show up
+		__atlasPages.emplace_back();
+		AtlasPage& newPage = __atlasPages.back();
+		newPage.Texture = std::make_shared<Texture2D>(pageDesc);
+		newPage.Minification = desc.MinificationFilter;
+		newPage.Magnification = desc.MagnificationFilter;
+		newPage.Padding = padding;
+		newPage.EntryCount = 0;
+		newPage.Nodes.resize(ATLAS_PAGE_SIZE);
+		stbrp_init_target(&newPage.Packer, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, newPage.Nodes.data(), static_cast<int>(newPage.Nodes.size()));
+		glClearTexImage(newPage.Texture->GetHandle(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		if (hasMips) {
+			glTextureParameteri(newPage.Texture->GetHandle(), GL_TEXTURE_MAX_LEVEL, ATLAS_MIP_LEVELS - 1);
+		}
+
+		page = static_cast<int>(__atlasPages.size()) - 1;
+		if (!stbrp_pack_rects(&newPage.Packer, &rect, 1)) {
+			return false;
+		}
+	}
+
+	__atlasPages[page].EntryCount++;
+	entry.Page = page;
+	entry.Origin = glm::ivec2(rect.x + padding, rect.y + padding);
+	entry.UvOffset = glm::vec2(entry.Origin) / static_cast<float>(ATLAS_PAGE_SIZE);
+	entry.UvScale = glm::vec2(width, height) / static_cast<float>(ATLAS_PAGE_SIZE);
+	__CopyToPage(tex, entry);
+	return true;
+}
+
+void GuiBatcher::__CopyToPage(Texture2D* tex, AtlasEntry& entry) {
+	const AtlasPage& page = __atlasPages[entry.Page];
+	const int width = static_cast<int>(tex->GetWidth());
+	const int height = static_cast<int>(tex->GetHeight());
+	const int x = entry.Origin.x;
+	const int y = entry.Origin.y;
+	const int padRight = AlignUp(width, page.Padding) - width + page.Padding;
+	const int padTop = AlignUp(height, page.Padding) - height + page.Padding;
+	const uint32_t dst = page.Texture->GetHandle();
+
+	// Copy the texture in, then stretch it's outer columns and rows out into the border
+	glCopyImageSubData(tex->GetHandle(), GL_TEXTURE_2D, 0, 0, 0, 0, dst, GL_TEXTURE_2D, 0, x, y, 0, width, height, 1);
+	for (int ix = 1; ix <= page.Padding; ix++) {
+		glCopyImageSubData(dst, GL_TEXTURE_2D, 0, x, y, 0, dst, GL_TEXTURE_2D, 0, x - ix, y, 0, 1, height, 1);
+	}
+	for (int ix = 1; ix <= padRight; ix++) {
+		glCopyImageSubData(dst, GL_TEXTURE_2D, 0, x + width - 1, y, 0, dst, GL_TEXTURE_2D, 0, x + width - 1 + ix, y, 0, 1, height, 1);
+	}
+	const int rowX = x - page.Padding;
+	const int rowWidth = page.Padding + width + padRight;
+	for (int iy = 1; iy <= page.Padding; iy++) {
+		glCopyImageSubData(dst, GL_TEXTURE_2D, 0, rowX, y, 0, dst, GL_TEXTURE_2D, 0, rowX, y - iy, 0, rowWidth, 1, 1);
+	}
+	for (int iy = 1; iy <= padTop; iy++) {
+		glCopyImageSubData(dst, GL_TEXTURE_2D, 0, rowX, y + height - 1, 0, dst, GL_TEXTURE_2D, 0, rowX, y + height - 1 + iy, 0, rowWidth, 1, 1);
+	}
+
+	if (page.Texture->GetDescription().GenerateMipMaps) {
+		glGenerateTextureMipmap(dst);
+	}
+	entry.DataVersion = tex->GetDataVersion();
+}
+
+void GuiBatcher::__ForgetDeadTextures() {
+	bool isPageEmptied = false;
+	for (auto it = __atlasEntries.begin(); it != __atlasEntries.end();) {
+		if (!it->second.Source.expired()) {
+			it++;
+			continue;
+		}
+
+		// stb_rect_pack can't give back a single region, but once a page has nothing left in it we can start it over
+		if (it->second.Page >= 0) {
+			AtlasPage& page = __atlasPages[it->second.Page];
+			page.EntryCount--;
+			if (page.EntryCount == 0) {
+				stbrp_init_target(&page.Packer, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, page.Nodes.data(), static_cast<int>(page.Nodes.size()));
+				isPageEmptied = true;
+			}
+		}
+		it = __atlasEntries.erase(it);
+	}
+
+	// Quads pushed before a texture went away may still be waiting to draw from it's region, so get them out
+	// before anything else gets copied over it
+	if (isPageEmptied) {
+		__DrawBatch();
+	}
+}
+
+int GuiBatcher::__GetTextureSlot(Texture2D* tex, bool isFont) {
+	for (int ix = 0; ix < __slotCount; ix++) {
+		if (__slotTextures[ix] == tex) {
+			return ix;
+		}
+	}
+
+	// Out of slots, so everything so far gets drawn and we start a fresh batch
+	if (__slotCount == MAX_TEXTURE_SLOTS) {
+		__DrawBatch();
+	}
+	__slotTextures[__slotCount] = tex;
+	if (isFont) {
+		__fontSlotMask |= 1 << __slotCount;
+	}
+	return __slotCount++;
+}
+
+void GuiBatcher::__ReserveQuads(uint32_t count) {
+	const uint32_t segmentVerts = SEGMENT_QUADS * 4;
+	const uint32_t segmentEnd = (__segment + 1) * segmentVerts;
+	if (__streamCursor + count * 4 <= segmentEnd) {
+		return;
+	}
+
+	// Draw what's in this segment, and fence it so we know when the GPU is done reading it
+	__DrawBatch();
+	if (__segmentFences[__segment] != nullptr) {
+		glDeleteSync(__segmentFences[__segment]);
+	}
+	__segmentFences[__segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+	// Wait for the GPU to finish with the next segment before we write over it, by the time we've gone all
+	// the way around it should long be done
+	__segment = (__segment + 1) % STREAM_SEGMENTS;
+	if (__segmentFences[__segment] != nullptr) {
+		while (glClientWaitSync(__segmentFences[__segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) { }
+		glDeleteSync(__segmentFences[__segment]);
+		__segmentFences[__segment] = nullptr;
+	}
+	__streamCursor = __segment * segmentVerts;
+	__batchStart = __streamCursor;
+}
+
+void GuiBatcher::__PushQuad(const glm::vec2 positions[4], const glm::vec2 uvs[4], const glm::vec4& color, int slot) {
+	GuiVertex* verts = __stream + __streamCursor;
+	for (int ix = 0; ix < 4; ix++) {
+		verts[ix].Position = positions[ix];
+		verts[ix].Color = color;
+		verts[ix].UV = uvs[ix];
+		verts[ix].Texture = static_cast<float>(slot);
+	}
+	__streamCursor += 4;
+}
+
+void GuiBatcher::__DrawBatch() {
+	if (__streamCursor > __batchStart) {
+		for (int ix = 0; ix < __slotCount; ix++) {
+			__slotTextures[ix]->Bind(ix);
+		}
+		__shader->Bind();
+		__shader->SetUniformMatrix(0, &__projection, 1, false);
+		__shader->SetUniform(1, &__fontSlotMask);
+
+		// The index buffer holds the pattern for a segment's worth of quads, so each batch just offsets into the stream
+		const uint32_t quadCount = (__streamCursor - __batchStart) / 4;
+		__vao->Bind();
+		glDrawElementsBaseVertex(GL_TRIANGLES, quadCount * 6, GL_UNSIGNED_INT, nullptr, __batchStart);
+		VertexArrayObject::Unbind();
+	}
+
+	__batchStart = __streamCursor;
+	__slotCount = 0;
+	__fontSlotMask = 0;
 }
 
 void GuiBatcher::PushModelTransform(const glm::mat3& transform) {
@@ -231,78 +457,84 @@ void GuiBatcher::__StaticInit()
 {
 	static bool needsInit = true;
 	if (needsInit) {
-		__shader = ShaderProgram::Create();
-		__shader->LoadShaderPart(R"LIT(#version 460
-					layout(location = 0) in vec3 inPos;
+		// Everything is drawn with the one shader, each vertex says which of the bound textures it uses and
+		// the font mask says which of those only have their red channel as alpha
+		std::unordered_map<ShaderPartType, std::string> sources = {
+			{ ShaderPartType::Vertex, R"LIT(#version 460
+					layout(location = 0) in vec2 inPos;
 					layout(location = 1) in vec4 inColor;
 					layout(location = 3) in vec2 inUV;
+					layout(location = 4) in float inTexture;
 
 					layout(location = 0) out vec4 outColor;
 					layout(location = 1) out vec2 outUV;
+					layout(location = 2) flat out int outTexture;
 
 					layout(location = 0) uniform mat4 u_Projection;
 
 					void main() {
 						outColor = inColor;
 						outUV = inUV;
-						gl_Position = u_Projection * vec4(inPos, 1);
+						outTexture = int(inTexture);
+						gl_Position = u_Projection * vec4(inPos, 0, 1);
 					}
-				)LIT", ShaderPartType::Vertex);
-
-		__shader->LoadShaderPart(R"LIT(#version 460
+				)LIT" },
+			{ ShaderPartType::Fragment, R"LIT(#version 460
 					layout(location = 0) in vec4 inColor;
 					layout(location = 1) in vec2 inUV;
+					layout(location = 2) flat in int outTexture;
 
 					layout(location = 0) out vec4 outColor;
 
-					uniform layout(binding=0) sampler2D s_Texture;
+					uniform layout(binding=0) sampler2D s_Textures[8];
+					layout(location = 1) uniform int u_FontMask;
 
 					void main() {
-						outColor = texture(s_Texture, inUV) * inColor;
+						// Samplers can't be indexed with a value that changes across the draw, so we pick with constants
+						vec4 tex;
+						switch (outTexture) {
+							case 0: tex = texture(s_Textures[0], inUV); break;
+							case 1: tex = texture(s_Textures[1], inUV); break;
+							case 2: tex = texture(s_Textures[2], inUV); break;
+							case 3: tex = texture(s_Textures[3], inUV); break;
+							case 4: tex = texture(s_Textures[4], inUV); break;
+							case 5: tex = texture(s_Textures[5], inUV); break;
+							case 6: tex = texture(s_Textures[6], inUV); break;
+							default: tex = texture(s_Textures[7], inUV); break;
+						}
+
+						if ((u_FontMask & (1 << outTexture)) != 0) {
+							outColor = vec4(inColor.rgb, tex.r);
+						} else {
+							outColor = tex * inColor;
+						}
 					}
-				)LIT", ShaderPartType::Fragment);
+				)LIT" }
+		};
 
-		__shader->Link();
-
-		__fontShader = ShaderProgram::Create();
-		__fontShader->LoadShaderPart(R"LIT(#version 460
-					layout(location = 0) in vec3 inPos;
-					layout(location = 1) in vec4 inColor;
-					layout(location = 3) in vec2 inUV;
-
-					layout(location = 0) out vec4 outColor;
-					layout(location = 1) out vec2 outUV;
-
-					layout(location = 0) uniform mat4 u_Projection;
-
-					void main() {
-						outColor = inColor;
-						outUV = inUV;
-						gl_Position = u_Projection * vec4(inPos, 1);
-					}
-				)LIT", ShaderPartType::Vertex);
-
-		__fontShader->LoadShaderPart(R"LIT(#version 460
-					layout(location = 0) in vec4 inColor;
-					layout(location = 1) in vec2 inUV;
-
-					layout(location = 0) out vec4 outColor;
-
-					uniform layout(binding=0) sampler2D s_Texture;
-
-					void main() {
-						float fontPow = texture(s_Texture, inUV).r;
-						outColor = vec4(inColor.rgb, fontPow);
-					}
-				)LIT" , ShaderPartType::Fragment);
-
-		__fontShader->Link();
+		__shader = ResourceManager::GetShaderFromSource(sources);
 
+		// The vertex stream stays mapped for the life of the game, we write straight into it
+		const BufferMapMode streamFlags = BufferMapMode::Write | BufferMapMode::Persistent | BufferMapMode::Coherent;
 		__vbo = VertexBuffer::Create(BufferUsage::DynamicDraw);
-		__ibo = IndexBuffer::Create(BufferUsage::DynamicDraw, IndexType::UInt);
+		__vbo->AllocateStorage(sizeof(GuiVertex), STREAM_SEGMENTS * SEGMENT_QUADS * 4, streamFlags);
+		__stream = reinterpret_cast<GuiVertex*>(__vbo->Map(streamFlags));
+
+		// Every quad uses the same indices, each batch offsets them to where it's vertices start
+		std::vector<uint32_t> indices(SEGMENT_QUADS * 6);
+		for (uint32_t ix = 0; ix < SEGMENT_QUADS; ix++) {
+			indices[ix * 6 + 0] = ix * 4 + 0;
+			indices[ix * 6 + 1] = ix * 4 + 2;
+			indices[ix * 6 + 2] = ix * 4 + 1;
+			indices[ix * 6 + 3] = ix * 4 + 0;
+			indices[ix * 6 + 4] = ix * 4 + 3;
+			indices[ix * 6 + 5] = ix * 4 + 2;
+		}
+		__ibo = IndexBuffer::Create(BufferUsage::StaticDraw, IndexType::UInt);
+		__ibo->LoadData(indices.data(), static_cast<uint32_t>(indices.size()));
 
 		__vao = VertexArrayObject::Create();
-		__vao->AddVertexBuffer(__vbo, VertexPosColTex::V_DECL);
+		__vao->AddVertexBuffer(__vbo, GuiVertex::V_DECL);
 		__vao->SetIndexBuffer(__ibo);
 
 		// Generate a simple white texture with a black border
@@ -389,3 +621,10 @@ void GuiBatcher::SetDefaultBorderRadius(int value) {
 int GuiBatcher::GetDefaultBorderRadius() {
 	return __defaultEdgeRadius;
 }
+
+void GuiBatcher::ResetAtlas() {
+	// Anything already pushed could still be drawing from the pages
+	__DrawBatch();
+	__atlasEntries.clear();
+	__atlasPages.clear();
+}
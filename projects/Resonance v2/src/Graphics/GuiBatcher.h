@@ -7,12 +7,19 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Graphics/VertexTypes.h"
 #include "Graphics/Font.h"
-#include "Utils/MeshBuilder.h"
 #include <unordered_map>
+#include <stb_rect_pack.h>
 
 	/// <summary>
 	/// The GUI Batcher class provides utilities for drawing rectangles and
 	/// fonts to the screen in a 2D fashion
+	/// 
+	/// Small RGBA textures loaded from files are packed into a few atlas pages the first time they're
+	/// drawn, and everything is written in the order it was pushed into a single
+	/// persistently mapped vertex stream. Each batch can sample from a handful of
+	/// textures at once (atlas pages, font atlases and anything too big to pack), so
+	/// the whole GUI usually goes out in one draw, and later elements are always
+	/// drawn over earlier ones
 	/// </summary>
 	class GuiBatcher {
 	public:
@@ -112,31 +119,125 @@
 		/// </summary>
 		static int GetDefaultBorderRadius();
 
+		/// <summary>
+		/// Forgets every texture that's been packed and frees the atlas pages, ex: when a new scene is loaded
+		/// and the old scene's GUI textures are going away
+		/// </summary>
+		static void ResetAtlas();
+
 	private:
 		struct IRect {
 			glm::ivec2 Min;
 			glm::ivec2 Max;
 		};
 
-		struct MeshData {
-			MeshBuilder<VertexPosColTex> Builder;
-			bool IsFont;
+		// The vertex layout of the GUI stream, Texture is the batch texture slot to sample from
+		struct GuiVertex {
+			glm::vec2 Position;
+			glm::vec4 Color;
+			glm::vec2 UV;
+			float     Texture;
+
+			static const std::vector<BufferAttribute> V_DECL;
+		};
+
+		// Where a texture is drawn from, either a region of an atlas page or the texture itself
+		struct AtlasEntry {
+			std::weak_ptr<Texture2D> Source;
+			// The page the texture was packed into, or -1 if it's drawn from the texture itself
+			int        Page;
+			// The texel the texture starts at in the page, and the version of it's data that was copied there
+			glm::ivec2 Origin;
+			uint32_t   DataVersion;
+			glm::vec2  UvOffset;
+			glm::vec2  UvScale;
+		};
+
+		struct AtlasPage {
+			Texture2D::Sptr         Texture;
+			MinFilter               Minification;
+			MagFilter               Magnification;
+			// How far each texture's edges are stretched out around it, pages with mips also line textures up to this
+			int                     Padding;
+			// The number of live textures in the page, once it hits zero the page can be packed from scratch
+			int                     EntryCount;
+			stbrp_context           Packer;
+			std::vector<stbrp_node> Nodes;
 		};
 
+		// The most textures a single batch can sample from, must match the GUI shader
+		static const int      MAX_TEXTURE_SLOTS = 8;
+		static const int      ATLAS_PAGE_SIZE = 2048;
+		static const int      MAX_ATLAS_PAGES = 4;
+		// Textures bigger than this on either side are not packed
+		static const int      MAX_ATLAS_ITEM_SIZE = 512;
+		// Pages for mip filtered textures only get this many levels, so the padding between textures stays small
+		static const int      ATLAS_MIP_LEVELS = 4;
+		// The vertex stream is split into segments, so we only wait on the GPU when we wrap back around to one
+		static const uint32_t STREAM_SEGMENTS = 3;
+		static const uint32_t SEGMENT_QUADS = 4096;
+
 		static glm::ivec2 __windowSize;
 		static glm::mat4 __projection;
 		static glm::mat3 __model;
 		static std::vector<glm::mat3> __modelTransformStack;
 		static std::vector<IRect> __scissorRects;
 		static ShaderProgram::Sptr __shader;
-		static ShaderProgram::Sptr __fontShader;
-		static std::unordered_map<Texture2D*, MeshData> _meshBuilders;
 		static VertexArrayObject::Sptr __vao;
 		static VertexBuffer::Sptr __vbo;
 		static IndexBuffer::Sptr __ibo;
 
+		// The persistently mapped vertex stream, and where we are in it
+		static GuiVertex* __stream;
+		static uint32_t __streamCursor;
+		static uint32_t __batchStart;
+		static uint32_t __segment;
+		static GLsync __segmentFences[STREAM_SEGMENTS];
+
+		// The textures bound for the current batch, and which of them are fonts
+		static Texture2D* __slotTextures[MAX_TEXTURE_SLOTS];
+		static int __slotCount;
+		static int __fontSlotMask;
+
+		static std::unordered_map<Texture2D*, AtlasEntry> __atlasEntries;
+		static std::vector<AtlasPage> __atlasPages;
+
 		static Texture2D::Sptr __defaultUITexture;
 		static int __defaultEdgeRadius;
 
 		static void __StaticInit();
+
+		/// <summary>
+		/// Gets where a texture should be drawn from, packing it into an atlas page if it hasn't been seen before
+		/// </summary>
+		static const AtlasEntry& __GetAtlasEntry(const Texture2D::Sptr& tex);
+		/// <summary>
+		/// Tries to copy a texture into an atlas page
+		/// </summary>
+		/// <returns>True if the texture was packed, false if it should be drawn on it's own</returns>
+		static bool __PackTexture(Texture2D* tex, AtlasEntry& entry);
+		/// <summary>
+		/// Copies a packed texture's data into it's region of the atlas page, stretching it's edges out into the padding
+		/// </summary>
+		static void __CopyToPage(Texture2D* tex, AtlasEntry& entry);
+		/// <summary>
+		/// Drops the entries of textures that have been destroyed, and starts over on any pages left empty
+		/// </summary>
+		static void __ForgetDeadTextures();
+		/// <summary>
+		/// Gets the batch texture slot for a texture, drawing the current batch first if all the slots are taken
+		/// </summary>
+		static int __GetTextureSlot(Texture2D* tex, bool isFont);
+		/// <summary>
+		/// Makes sure the stream has room for some more quads, moving on to the next segment if it doesn't
+		/// </summary>
+		static void __ReserveQuads(uint32_t count);
+		/// <summary>
+		/// Adds a quad to the stream, the corners go around the edge of the quad
+		/// </summary>
+		static void __PushQuad(const glm::vec2 positions[4], const glm::vec2 uvs[4], const glm::vec4& color, int slot);
+		/// <summary>
+		/// Draws everything that has been pushed since the last batch
+		/// </summary>
+		static void __DrawBatch();
 	};
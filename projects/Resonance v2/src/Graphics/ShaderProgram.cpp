@@ -3,19 +3,27 @@
 #include <fstream>
 #include <sstream>
 #include <filesystem>
+#include <cstring>
+#include <algorithm>
 
 #include "Utils/FileHelpers.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+
+const char* ShaderProgram::__BinaryCacheFolder = "shader_cache";
+bool ShaderProgram::__BinaryCacheEnabled = true;
 
 ShaderProgram::ShaderProgram() : 
 	IGraphicsResource(),
-	IResource()
+	IResource(),
+	_varyingsInterleaved(true)
 {
 	_rendererId = glCreateProgram();
 }
 
 ShaderProgram::ShaderProgram(const std::unordered_map<ShaderPartType, std::string>& filePaths) :
 	IGraphicsResource(),
-	IResource()
+	IResource(),
+	_varyingsInterleaved(true)
 {
 	_rendererId = glCreateProgram();
 	for (auto& [type, path] : filePaths) {
@@ -32,11 +40,53 @@ ShaderProgram::~ShaderProgram() {
 }
 
 bool ShaderProgram::LoadShaderPart(const char* source, ShaderPartType type) {
+	if (source == nullptr || source[0] == '\0') {
+		LOG_WARN("Ignoring empty source for shader part {}", ~type);
+		return false;
+	}
+
+	// If we're overwriting, warn before we store
+	if (_resolvedSources.find(type) != _resolvedSources.end()) {
+		LOG_WARN("Another shader has been attached to this slot, overwriting");
+	}
+	// We hang onto the source until we link, since if we find the program in the
+	// binary cache we never need to compile it at all
+	_resolvedSources[type] = source;
+
+	// Store info about where we got this data from
+	_fileSourceMap[type].IsFilePath = false;
+	_fileSourceMap[type].Source = source;
+
+	return true;
+}
+
+bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
+	// Make sure that the file exists before we try reading
+	if (FileHelpers::Exists(path)) {
+		// Load the source from the file, using our helper that will
+		// resolve #include directives
+		std::string source = FileHelpers::ReadResolveIncludes(path);
+		// Pass off to LoadShaderPart
+		bool result =  LoadShaderPart(source.c_str(), type);
+		_fileSourceMap[type].IsFilePath = true;
+		_fileSourceMap[type].Source = path;
+		if (result == false) {
+			LOG_ERROR("Source File: {}", path);
+		}
+		return result; 
+	} else {
+		LOG_WARN("Could not open file at \"{}\"", path);
+		return false;
+	}
+}
+
+bool ShaderProgram::_CompileShaderPart(const std::string& source, ShaderPartType type) {
 	// Creates a new shader part (VS, FS, GS, etc...)
 	GLuint handle = glCreateShader((GLenum)type);
 
 	// Load the GLSL source and compile it
-	glShaderSource(handle, 1, &source, nullptr);
+	const char* sourcePtr = source.c_str();
+	glShaderSource(handle, 1, &sourcePtr, nullptr);
 	glCompileShader(handle);
 
 	// Get the compilation status for the shader part
@@ -56,6 +106,9 @@ bool ShaderProgram::LoadShaderPart(const char* source, ShaderPartType type) {
 
 		// Dump error log
 		LOG_ERROR("Failed to compile shader part:\n{}", log);
+		if (_fileSourceMap[type].IsFilePath) {
+			LOG_ERROR("Source File: {}", _fileSourceMap[type].Source);
+		}
 
 		// Clean up our log memory
 		delete[] log;
@@ -67,52 +120,52 @@ bool ShaderProgram::LoadShaderPart(const char* source, ShaderPartType type) {
 		return false;
 	}
 
-	// If we're overwriting, warn and clean up the old program before we store
-	if (_handles[type] != 0) {
-		LOG_WARN("Another shader has been attached to this slot, overwriting");
-		glDeleteShader(_handles[type]);
-	}
 	_handles[type] = handle;
+	return true;
+}
 
-	// Store info about where we got this data from
-	_fileSourceMap[type].IsFilePath = false;
-	_fileSourceMap[type].Source = source;
+bool ShaderProgram::Link() {
 
-	return status != GL_FALSE;
-}
+	LOG_TRACE("Starting shader link:");
+	for (auto& [type, source] : _resolvedSources) {
+		LOG_TRACE("\t{} - {}", ~type, _fileSourceMap[type].IsFilePath ? _fileSourceMap[type].Source : "<from source>");
+	}
 
-bool ShaderProgram::LoadShaderPartFromFile(const char* path, ShaderPartType type) {
-	// Make sure that the file exists before we try reading
-	if (std::filesystem::exists(path)) {
-		// Load the source from the file, using our helper that will
-		// resolve #include directives
-		std::string source = FileHelpers::ReadResolveIncludes(path);
-		// Pass off to LoadShaderPart
-		bool result =  LoadShaderPart(source.c_str(), type);
-		_fileSourceMap[type].IsFilePath = true;
-		_fileSourceMap[type].Source = path;
-		if (result == false) {
-			LOG_ERROR("Source File: {}", path);
+	// Apply our defines before anything else, so that each permutation gets it's own cache entry
+	if (!_defines.empty()) {
+		for (auto& [type, source] : _resolvedSources) {
+			_InjectDefines(source);
 		}
-		return result; 
-	} else {
-		LOG_WARN("Could not open file at \"{}\"", path);
-		return false;
 	}
-}
 
-bool ShaderProgram::Link() {
+	// If we have a binary for this exact source and driver, we can skip compilation entirely
+	const uint64_t cacheKey = __BinaryCacheEnabled ? _CalculateCacheKey() : 0;
+	if (__BinaryCacheEnabled && _TryLoadBinary(cacheKey)) {
+		_resolvedSources.clear();
+		LOG_TRACE("Loaded program from binary cache, starting introspection");
+		_Introspect();
+		return true;
+	}
+
+	// Compile all our shader parts
+	for (auto& [type, source] : _resolvedSources) {
+		_CompileShaderPart(source, type);
+	}
+	// We no longer need the sources, the file source map has all we need for serialization
+	_resolvedSources.clear();
 
-	LOG_TRACE("Starting shader link:");
-	
 	// Attach all our shaders
 	for (auto& [type, id] : _handles) {
 		if (id != 0) {
 			glAttachShader(_rendererId, id);
-			LOG_TRACE("\t{} - {}", ~type, _fileSourceMap[type].IsFilePath ? _fileSourceMap[type].Source : "<from source>");
 		}
 	}
 
+	// Let the driver know we will want to retrieve the binary after linking
+	if (__BinaryCacheEnabled) {
+		glProgramParameteri(_rendererId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
 	// Perform linking
 	glLinkProgram(_rendererId);
 
@@ -147,6 +200,11 @@ bool ShaderProgram::Link() {
 		}
 	} else {
 		LOG_TRACE("Linking complete, starting introspection");
+
+		// Store the linked program so next run can skip compilation
+		if (__BinaryCacheEnabled) {
+			_SaveBinary(cacheKey);
+		}
 	}
 
 	// Perform our uniform introspection to see what uniforms are in the shader
@@ -155,6 +213,182 @@ bool ShaderProgram::Link() {
 	return status != GL_FALSE;
 }
 
+void ShaderProgram::SetBinaryCacheEnabled(bool value) {
+	__BinaryCacheEnabled = value;
+}
+
+bool ShaderProgram::IsBinaryCacheEnabled() {
+	return __BinaryCacheEnabled;
+}
+
+void ShaderProgram::AddDefine(const std::string& name) {
+	if (std::find(_defines.begin(), _defines.end(), name) == _defines.end()) {
+		_defines.push_back(name);
+	}
+}
+
+const std::vector<std::string>& ShaderProgram::GetDefines() const {
+	return _defines;
+}
+
+void ShaderProgram::_InjectDefines(std::string& source) const {
+	std::string block;
+	for (const auto& define : _defines) {
+		block += "#define " + define + "\n";
+	}
+
+	// GLSL requires #version to be the first directive, so our defines need to go after it
+	size_t versionPos = source.find("#version");
+	if (versionPos != std::string::npos) {
+		size_t eol = source.find('\n', versionPos);
+		if (eol == std::string::npos) {
+			source += "\n" + block;
+		} else {
+			source.insert(eol + 1, block);
+		}
+	} else {
+		source.insert(0, block);
+	}
+}
+
+uint64_t ShaderProgram::_CalculateCacheKey() const {
+	// 64 bit FNV-1a, we don't need anything cryptographic, just something
+	// that changes whenever the source or driver does
+	uint64_t hash = 14695981039346656037ull;
+	auto hashBytes = [&](const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t ix = 0; ix < size; ix++) {
+			hash ^= bytes[ix];
+			hash *= 1099511628211ull;
+		}
+	};
+	auto hashString = [&](const char* str) {
+		// Include the null terminator so that "ab" + "c" != "a" + "bc"
+		if (str != nullptr) {
+			hashBytes(str, strlen(str) + 1);
+		}
+	};
+
+	// Binaries are only valid for the exact driver that created them
+	hashString(reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+	hashString(reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+	hashString(reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+	// Unordered map iteration order is not stable, so we walk the stages in a fixed order
+	static const ShaderPartType stageOrder[] ={
+		ShaderPartType::Vertex,
+		ShaderPartType::TessControl,
+		ShaderPartType::TessEval,
+		ShaderPartType::Geometry,
+		ShaderPartType::Fragment
+	};
+	for (ShaderPartType type : stageOrder) {
+		auto it = _resolvedSources.find(type);
+		if (it != _resolvedSources.end()) {
+			GLint typeId = (GLint)type;
+			hashBytes(&typeId, sizeof(GLint));
+			hashString(it->second.c_str());
+		}
+	}
+
+	// Transform feedback varyings are baked into the linked program
+	for (const auto& name : _varyings) {
+		hashString(name.c_str());
+	}
+	hashBytes(&_varyingsInterleaved, sizeof(bool));
+
+	return hash;
+}
+
+// Header for our program binary files
+struct ProgramBinaryHeader {
+	char     HeaderBytes[4] ={ 'S', 'P', 'B', 'C' };
+	uint32_t Version = 1;
+	uint32_t Format  = 0;
+	uint32_t Length  = 0;
+};
+
+bool ShaderProgram::_TryLoadBinary(uint64_t key) {
+	// Some drivers don't support any binary formats, in which case there's nothing to do
+	static GLint numFormats = -1;
+	if (numFormats == -1) {
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+		if (numFormats == 0) {
+			LOG_WARN("Driver does not support program binaries, shader cache is disabled");
+		}
+	}
+	if (numFormats <= 0) {
+		__BinaryCacheEnabled = false;
+		return false;
+	}
+
+	const std::string path = fmt::format("{}/{:016x}.bin", __BinaryCacheFolder, key);
+	if (!std::filesystem::exists(path)) {
+		return false;
+	}
+
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file) {
+		return false;
+	}
+
+	// Make sure the header is valid and the length is sane before we try the binary
+	ProgramBinaryHeader header;
+	char expected[4] ={ 'S', 'P', 'B', 'C' };
+	file.read(reinterpret_cast<char*>(&header), sizeof(ProgramBinaryHeader));
+	if (!file || memcmp(header.HeaderBytes, expected, 4) != 0 || header.Version != 1 || header.Length == 0) {
+		LOG_WARN("Ignoring invalid shader cache file \"{}\"", path);
+		return false;
+	}
+
+	std::vector<char> data(header.Length);
+	file.read(data.data(), header.Length);
+	if (!file) {
+		LOG_WARN("Shader cache file \"{}\" is truncated", path);
+		return false;
+	}
+
+	// The driver is free to reject binaries (ex: after a driver update that didn't change the version string),
+	// in which case link status is false, and we fall back to compiling from source
+	glProgramBinary(_rendererId, header.Format, data.data(), header.Length);
+
+	GLint status = 0;
+	glGetProgramiv(_rendererId, GL_LINK_STATUS, &status);
+	if (status == GL_FALSE) {
+		LOG_INFO("Driver rejected cached program binary \"{}\", recompiling", path);
+		return false;
+	}
+
+	return true;
+}
+
+void ShaderProgram::_SaveBinary(uint64_t key) {
+	GLint length = 0;
+	glGetProgramiv(_rendererId, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	ProgramBinaryHeader header;
+	std::vector<char> data(length);
+	GLenum format = 0;
+	glGetProgramBinary(_rendererId, length, &length, &format, data.data());
+	header.Format = format;
+	header.Length = length;
+
+	std::error_code err;
+	std::filesystem::create_directories(__BinaryCacheFolder, err);
+
+	const std::string path = fmt::format("{}/{:016x}.bin", __BinaryCacheFolder, key);
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file) {
+		LOG_WARN("Could not write shader cache file \"{}\"", path);
+		return;
+	}
+	file.write(reinterpret_cast<const char*>(&header), sizeof(ProgramBinaryHeader));
+	file.write(data.data(), length);
+}
+
 void ShaderProgram::Bind() {
 	// Simply calls glUseProgram with our shader handle
 	glUseProgram(_rendererId);
@@ -313,12 +547,42 @@ nlohmann::json ShaderProgram::ToJson() const {
 	for (auto& [key, value] : _fileSourceMap) {
 		result[~key][value.IsFilePath ? "path" : "source"] = value.Source;
 	}
+	if (!_defines.empty()) {
+		result["defines"] = _defines;
+	}
 	return result;
 
 }
 
 ShaderProgram::Sptr ShaderProgram::FromJson(const nlohmann::json& data) {
+	// Collect the defines first, since they need to be set before we link
+	std::vector<std::string> defines;
+	if (data.contains("defines") && data["defines"].is_array()) {
+		defines = data["defines"].get<std::vector<std::string>>();
+	}
+
+	// If every stage comes from a file, we can share the program with anyone else who
+	// has requested the same files and defines (even if it's under another GUID)
+	std::unordered_map<ShaderPartType, std::string> filePaths;
+	bool allFiles = true;
+	for (auto& [key, blob] : data.items()) {
+		ShaderPartType type = ParseShaderPartType(key, ShaderPartType::Unknown);
+		if (type != ShaderPartType::Unknown) {
+			if (blob.contains("path")) {
+				filePaths[type] = blob["path"].get<std::string>();
+			} else {
+				allFiles = false;
+			}
+		}
+	}
+	if (allFiles && !filePaths.empty()) {
+		return ResourceManager::GetShader(filePaths, defines);
+	}
+
 	ShaderProgram::Sptr result = std::make_shared<ShaderProgram>();
+	for (const auto& define : defines) {
+		result->AddDefine(define);
+	}
 	for (auto& [key, blob] : data.items()) {
 		// Get the shader part type from the key
 		ShaderPartType type = ParseShaderPartType(key, ShaderPartType::Unknown);
@@ -508,4 +772,8 @@ GlResourceType ShaderProgram::GetResourceClass() const {
 void ShaderProgram::RegisterVaryings(const char* const* names, int numVaryings, bool interleaved /*= true*/)
 {
 	glTransformFeedbackVaryings(_rendererId, numVaryings, names, interleaved ? GL_INTERLEAVED_ATTRIBS : GL_SEPARATE_ATTRIBS);
+
+	// Store the varyings so they can contribute to our binary cache key
+	_varyings.assign(names, names + numVaryings);
+	_varyingsInterleaved = interleaved;
 }
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>               // for std::string
 #include <unordered_map>        // for std::unordered_map
+#include <vector>               // for std::vector
 #include <GLM/glm.hpp>          // for our GLM types
 #include <GLM/gtc/type_ptr.hpp> // for glm::value_ptr
 #include <Logging.h>            // for the logging functions
@@ -69,6 +70,7 @@ public:
 
 	/// <summary>
 	/// Loads a single shader stage into this shader object (ex: Vertex Shader or Fragment Shader)
+	/// Compilation is deferred until Link, so that a cached program binary can skip it entirely
 	/// </summary>
 	/// <param name="source">The source code of the shader to load</param>
 	/// <param name="type">The stage to load (GL_VERTEX_SHADER or GL_FRAGMENT_SHADER)</param>
@@ -90,12 +92,34 @@ public:
 	/// <param name="interleaved">True if the attributes should be interleaved into a single buffer</param>
 	void RegisterVaryings(const char* const* names, int numVaryings, bool interleaved = true);
 
+	/// <summary>
+	/// Adds a preprocessor define that will be injected after the #version line of every
+	/// stage when the program is linked, must be called before Link
+	/// </summary>
+	/// <param name="name">The name of the define (ex: "INSTANCED" or "SKINNED")</param>
+	void AddDefine(const std::string& name);
+	/// <summary>
+	/// Gets the preprocessor defines that this program was built with
+	/// </summary>
+	const std::vector<std::string>& GetDefines() const;
+
 	/// <summary>
 	/// Links the vertex and fragment shader, and allows this shader program to be used
+	/// Will first attempt to load a program binary from the shader cache, and will only
+	/// compile the shader parts if no valid binary exists for the current driver
 	/// </summary>
 	/// <returns>True if the linking was successful, false if otherwise</returns>
 	bool Link();
 
+	/// <summary>
+	/// Enables or disables the on-disk program binary cache for all shaders linked after this call
+	/// </summary>
+	static void SetBinaryCacheEnabled(bool value);
+	/// <summary>
+	/// Gets whether the on-disk program binary cache is enabled
+	/// </summary>
+	static bool IsBinaryCacheEnabled();
+
 	/// <summary>
 	/// Binds this shader for use
 	/// </summary>
@@ -190,6 +214,50 @@ protected:
 	};
 	std::unordered_map<ShaderPartType, ShaderSource> _fileSourceMap;
 
+	// Stores the fully resolved source for each shader part until Link,
+	// this is what we compile, and what the binary cache is keyed on
+	std::unordered_map<ShaderPartType, std::string> _resolvedSources;
+
+	// The preprocessor defines that are injected into every stage on link
+	std::vector<std::string> _defines;
+
+	// The transform feedback varyings registered with RegisterVaryings,
+	// these are part of the linked program so they need to be in the cache key
+	std::vector<std::string> _varyings;
+	bool                     _varyingsInterleaved;
+
+	// The folder that program binaries are stored in, relative to the working directory
+	static const char* __BinaryCacheFolder;
+	static bool        __BinaryCacheEnabled;
+
+	/// <summary>
+	/// Compiles a single shader part from source, and stores it's handle in _handles
+	/// </summary>
+	/// <param name="source">The resolved source code of the shader part</param>
+	/// <param name="type">The stage to compile</param>
+	/// <returns>True if the shader compiled, false if there was an issue</returns>
+	bool _CompileShaderPart(const std::string& source, ShaderPartType type);
+	/// <summary>
+	/// Injects our defines into the given source, directly after the #version directive
+	/// </summary>
+	void _InjectDefines(std::string& source) const;
+	/// <summary>
+	/// Calculates the cache key for this program, based on the resolved sources of all
+	/// stages, the registered varyings, and the vendor, renderer and version of the GL driver
+	/// </summary>
+	uint64_t _CalculateCacheKey() const;
+	/// <summary>
+	/// Attempts to load the program from a cached binary
+	/// </summary>
+	/// <param name="key">The cache key, as calculated by _CalculateCacheKey</param>
+	/// <returns>True if the cached binary was loaded and linked, false if we need to compile</returns>
+	bool _TryLoadBinary(uint64_t key);
+	/// <summary>
+	/// Stores the binary for this program into the cache, should only be called after a successful link
+	/// </summary>
+	/// <param name="key">The cache key, as calculated by _CalculateCacheKey</param>
+	void _SaveBinary(uint64_t key);
+
 	/// <summary>
 	/// Performs program introspection, where we examine the uniforms that
 	/// the program contains
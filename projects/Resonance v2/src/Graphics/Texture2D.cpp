@@ -1,6 +1,7 @@
 #include "Texture2D.h"
 #include <stb_image.h>
 #include <Logging.h>
+#include "Utils/FileHelpers.h"
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
 
@@ -39,7 +40,10 @@ Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
 	return std::make_shared<Texture2D>(descr);
 }
 
-Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(TextureType::_2D) {
+Texture2D::Texture2D(const Texture2DDescription& description) : 
+	ITexture(TextureType::_2D),
+	_dataVersion(0)
+{
 	_description = description;
 	_SetTextureParams();
 	if (!description.Filename.empty()) {
@@ -48,7 +52,8 @@ Texture2D::Texture2D(const Texture2DDescription& description) : ITexture(Texture
 }
 
 Texture2D::Texture2D(const std::string& filePath) : 
-	ITexture(TextureType::_2D) 
+	ITexture(TextureType::_2D),
+	_dataVersion(0)
 {
 	_description.Filename = filePath;
 	_SetTextureParams();
@@ -97,6 +102,7 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 
 	// Upload our data to our image
 	glTextureSubImage2D(_rendererId, 0, offsetX, offsetY, width, height, (GLenum)format, (GLenum)type, data);
+	_dataVersion++;
 
 	// If requested, generate mip-maps for our texture
 	if (_description.GenerateMipMaps) {
@@ -112,9 +118,13 @@ void Texture2D::_LoadDataFromFile() {
 		int width, height, numChannels;
 		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
 
-		// Use STBI to load the image
+		// Use STBI to load the image, going through FileHelpers so we can be served from an asset pack
 		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
+		uint8_t* data = nullptr;
+		FileHelpers::FileBuffer file;
+		if (FileHelpers::ReadFileBuffer(_description.Filename, file)) {
+			data = stbi_load_from_memory(file.Data, (int)file.Size, &width, &height, &numChannels, targetChannels);
+		}
 
 		// If we could not load any data, warn and return null
 		if (data == nullptr) {
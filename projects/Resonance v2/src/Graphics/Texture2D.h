@@ -134,6 +134,11 @@ public:
 	/// <param name="offsetX">The x edge of the destination rectangle in the texture, left->right</param>
 	/// <param name="offsetY">The y edge of the destination rectangle in the texture, bottom->top</param>
 	void LoadData(uint32_t width, uint32_t height, PixelFormat format, PixelType type, void* data, uint32_t offsetX = 0, uint32_t offsetY = 0);
+	/// <summary>
+	/// Gets a counter that goes up every time data is loaded into this texture, so that anything
+	/// holding a copy of the texels can tell when it's out of date
+	/// </summary>
+	uint32_t GetDataVersion() const { return _dataVersion; }
 
 	/// <summary>
 	/// Gets this texture's description, which contains basic information about the
@@ -146,6 +151,7 @@ public:
 
 protected:
 	Texture2DDescription _description;
+	uint32_t             _dataVersion;
 
 	/// <summary>
 	/// Loads this texture from the file specified in the description
@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "stb_image.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/FileHelpers.h"
 
 TextureCube::TextureCube(const std::string& baseFilename) :
 	ITexture(TextureType::Cubemap),
@@ -66,7 +67,8 @@ void TextureCube::_LoadFromDescription()
 	// If we weren't passed face filenames but WERE passed a base filename, try and get the 6 face files
 	if (_description.FaceFileNames.empty() && !_description.Filename.empty()) {
 		// Get the file path and it's directory to extract the root file name w/o extension
-		std::filesystem::path baseName = std::filesystem::absolute(std::filesystem::path(_description.Filename));
+		// Note that we keep the path relative, so that it matches paths stored in asset packs
+		std::filesystem::path baseName = std::filesystem::path(_description.Filename);
 		std::filesystem::path directory = baseName.parent_path();
 		std::filesystem::path rootFileName = directory / baseName.stem();
 
@@ -82,7 +84,7 @@ void TextureCube::_LoadFromDescription()
 			targetPath += baseName.extension();
 
 			// If the file exists, store it in the description
-			if (std::filesystem::exists(targetPath)) {
+			if (FileHelpers::Exists(targetPath.string())) {
 				_description.FaceFileNames[face] = targetPath.string();
 			}
 		}
@@ -115,9 +117,13 @@ void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>
 		const std::string& filename = _description.FaceFileNames[face];
 		int fileWidth, fileHeight, fileNumChannels;
 
-		// Use STBI to load the image
+		// Use STBI to load the image, going through FileHelpers so we can be served from an asset pack
 		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(filename.c_str(), &fileWidth, &fileHeight, &fileNumChannels, 0);
+		uint8_t* data = nullptr;
+		FileHelpers::FileBuffer file;
+		if (FileHelpers::ReadFileBuffer(filename, file)) {
+			data = stbi_load_from_memory(file.Data, (int)file.Size, &fileWidth, &fileHeight, &fileNumChannels, 0);
+		}
 
 		// If we could not load any data, warn and return null
 		if (data == nullptr) {
@@ -0,0 +1,507 @@
+#include "Utils/AssetPack.h"
+
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <Logging.h>
+
+#include "Utils/StringUtils.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+	const uint32_t PACK_VERSION   = 1;
+	const uint32_t PACK_ALIGNMENT = 64;
+
+	// 64 bit FNV-1a, used for our path index
+	uint64_t HashPath(const std::string& path) {
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : path) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	inline uint32_t Read32(const uint8_t* ptr) {
+		uint32_t result;
+		memcpy(&result, ptr, sizeof(uint32_t));
+		return result;
+	}
+
+	// Writes an LZ4 style length extension (a run of 255s followed by the remainder)
+	inline void WriteLength(std::vector<uint8_t>& out, size_t length) {
+		while (length >= 255) {
+			out.push_back(255);
+			length -= 255;
+		}
+		out.push_back(static_cast<uint8_t>(length));
+	}
+
+	// Writes a single LZ4 sequence, matchLength of 0 indicates the final literal-only sequence
+	void WriteSequence(std::vector<uint8_t>& out, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength) {
+		size_t matchToken = matchLength >= 4 ? matchLength - 4 : 0;
+		uint8_t token = static_cast<uint8_t>((std::min<size_t>(numLiterals, 15) << 4) | std::min<size_t>(matchToken, 15));
+		out.push_back(token);
+		if (numLiterals >= 15) {
+			WriteLength(out, numLiterals - 15);
+		}
+		out.insert(out.end(), literals, literals + numLiterals);
+		if (matchLength > 0) {
+			out.push_back(static_cast<uint8_t>(offset & 0xFF));
+			out.push_back(static_cast<uint8_t>((offset >> 8) & 0xFF));
+			if (matchToken >= 15) {
+				WriteLength(out, matchToken - 15);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Compresses data into a single block using the LZ4 block format, with a simple greedy matcher.
+	/// Output is compatible with LZ4_decompress_safe, so the reference library can be dropped in later
+	/// </summary>
+	void Lz4Compress(const uint8_t* src, size_t srcSize, std::vector<uint8_t>& out) {
+		// LZ4 requires that the last 5 bytes are literals, and that the last match starts 12 bytes before the end
+		const size_t MIN_MATCH     = 4;
+		const size_t LAST_LITERALS = 5;
+		const size_t MF_LIMIT      = 12;
+		const int    HASH_BITS     = 14;
+
+		out.clear();
+		out.reserve(srcSize + srcSize / 255 + 16);
+
+		size_t anchor = 0;
+		if (srcSize > MF_LIMIT) {
+			std::vector<int64_t> table(1ull << HASH_BITS, -1);
+			const size_t matchLimit = srcSize - LAST_LITERALS;
+			const size_t inputLimit = srcSize - MF_LIMIT;
+
+			size_t ip = 0;
+			while (ip < inputLimit) {
+				uint32_t sequence = Read32(src + ip);
+				uint32_t hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+				int64_t  ref = table[hash];
+				table[hash] = static_cast<int64_t>(ip);
+
+				if (ref >= 0 && ip - ref <= 0xFFFF && Read32(src + ref) == sequence) {
+					// Extend the match as far as we're allowed
+					size_t length = MIN_MATCH;
+					while (ip + length < matchLimit && src[ref + length] == src[ip + length]) {
+						length++;
+					}
+					WriteSequence(out, src + anchor, ip - anchor, ip - ref, length);
+					ip += length;
+					anchor = ip;
+				} else {
+					ip++;
+				}
+			}
+		}
+
+		// Whatever is left is stored as literals
+		WriteSequence(out, src + anchor, srcSize - anchor, 0, 0);
+	}
+
+	/// <summary>
+	/// Decompresses a single LZ4 block, validating all reads and writes
+	/// </summary>
+	/// <returns>True if the block decompressed to exactly dstSize bytes</returns>
+	bool Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+		size_t ip = 0;
+		size_t op = 0;
+		while (ip < srcSize) {
+			uint8_t token = src[ip++];
+
+			// Copy out the literals
+			size_t numLiterals = token >> 4;
+			if (numLiterals == 15) {
+				uint8_t b;
+				do {
+					if (ip >= srcSize) return false;
+					b = src[ip++];
+					numLiterals += b;
+				} while (b == 255);
+			}
+			if (ip + numLiterals > srcSize || op + numLiterals > dstSize) return false;
+			memcpy(dst + op, src + ip, numLiterals);
+			ip += numLiterals;
+			op += numLiterals;
+
+			// The last sequence has no match
+			if (ip >= srcSize) break;
+
+			// Read the match
+			if (ip + 2 > srcSize) return false;
+			size_t offset = src[ip] | (src[ip + 1] << 8);
+			ip += 2;
+			if (offset == 0 || offset > op) return false;
+
+			size_t matchLength = token & 0x0F;
+			if (matchLength == 15) {
+				uint8_t b;
+				do {
+					if (ip >= srcSize) return false;
+					b = src[ip++];
+					matchLength += b;
+				} while (b == 255);
+			}
+			matchLength += 4;
+			if (op + matchLength > dstSize) return false;
+
+			// Matches can overlap the output, so we need to copy byte by byte
+			const uint8_t* match = dst + op - offset;
+			for (size_t ix = 0; ix < matchLength; ix++) {
+				dst[op + ix] = match[ix];
+			}
+			op += matchLength;
+		}
+		return op == dstSize;
+	}
+
+	// These are already compressed (or are handed to a library that wants them as-is), so we store them raw
+	bool ShouldCompress(const fs::path& path) {
+		static const char* rawExtensions[] ={
+			".png", ".jpg", ".jpeg", ".wav", ".mp3", ".ogg", ".bank", ".fsb", ".pak"
+		};
+		std::string extension = path.extension().string();
+		StringTools::ToLower(extension);
+		for (const char* ext : rawExtensions) {
+			if (extension == ext) return false;
+		}
+		return true;
+	}
+}
+
+AssetPack::AssetPack() :
+	_path(""),
+	_fileHandle(nullptr),
+	_mappingHandle(nullptr),
+	_fileDescriptor(-1),
+	_data(nullptr),
+	_size(0),
+	_header(nullptr),
+	_entries(nullptr),
+	_strings(nullptr)
+{ }
+
+AssetPack::~AssetPack() {
+	_Unmap();
+}
+
+std::string AssetPack::NormalizePath(const std::string& path) {
+	std::string result = path;
+	std::replace(result.begin(), result.end(), '\\', '/');
+	result = fs::path(result).lexically_normal().generic_string();
+	while (result.rfind("./", 0) == 0) {
+		result.erase(0, 2);
+	}
+	StringTools::ToLower(result);
+	return result;
+}
+
+AssetPack::Sptr AssetPack::Open(const std::string& path) {
+	AssetPack::Sptr result = std::make_shared<AssetPack>();
+	if (!result->_Map(path)) {
+		return nullptr;
+	}
+
+	// Validate the header and make sure the index and string table are within the file
+	if (result->_size < sizeof(PackHeader)) {
+		LOG_ERROR("Asset pack \"{}\" is too small to be valid", path);
+		return nullptr;
+	}
+	const PackHeader* header = reinterpret_cast<const PackHeader*>(result->_data);
+	if (memcmp(header->HeaderBytes, PackHeader().HeaderBytes, 4) != 0 || header->Version != PACK_VERSION) {
+		LOG_ERROR("Asset pack \"{}\" has an invalid header or unsupported version", path);
+		return nullptr;
+	}
+	if (header->IndexOffset + header->NumEntries * sizeof(PackEntry) > result->_size ||
+		header->StringsOffset + header->StringsSize > result->_size) {
+		LOG_ERROR("Asset pack \"{}\" is truncated", path);
+		return nullptr;
+	}
+
+	result->_header  = header;
+	result->_entries = reinterpret_cast<const PackEntry*>(result->_data + header->IndexOffset);
+	result->_strings = reinterpret_cast<const char*>(result->_data + header->StringsOffset);
+	result->_path    = path;
+
+	LOG_INFO("Mounted asset pack \"{}\" ({} entries, {} bytes)", path, header->NumEntries, result->_size);
+	return result;
+}
+
+const AssetPack::PackEntry* AssetPack::Find(const std::string& path) const {
+	if (_header == nullptr) return nullptr;
+
+	const std::string normalized = NormalizePath(path);
+	const uint64_t hash = HashPath(normalized);
+
+	// The index is sorted by hash, so we can binary search it
+	const PackEntry* begin = _entries;
+	const PackEntry* end = _entries + _header->NumEntries;
+	const PackEntry* it = std::lower_bound(begin, end, hash, [](const PackEntry& entry, uint64_t value) {
+		return entry.PathHash < value;
+	});
+
+	// Walk any entries with the same hash, and compare the paths to resolve collisions
+	for (; it != end && it->PathHash == hash; it++) {
+		if (it->PathOffset + (uint64_t)it->PathLength <= _header->StringsSize &&
+			normalized.size() == it->PathLength &&
+			memcmp(_strings + it->PathOffset, normalized.data(), it->PathLength) == 0) {
+			return it;
+		}
+	}
+	return nullptr;
+}
+
+bool AssetPack::GetView(const std::string& path, const uint8_t** data, size_t* size) const {
+	const PackEntry* entry = Find(path);
+	if (entry == nullptr || (entry->Flags & EntryFlag_Compressed) || entry->Offset + entry->Size > _size) {
+		return false;
+	}
+	*data = _data + entry->Offset;
+	*size = static_cast<size_t>(entry->Size);
+	return true;
+}
+
+bool AssetPack::Read(const std::string& path, std::string& out) const {
+	const PackEntry* entry = Find(path);
+	if (entry == nullptr || entry->Offset + entry->StoredSize > _size) {
+		return false;
+	}
+
+	out.resize(static_cast<size_t>(entry->Size));
+	if (entry->Flags & EntryFlag_Compressed) {
+		if (!Lz4Decompress(_data + entry->Offset, static_cast<size_t>(entry->StoredSize), reinterpret_cast<uint8_t*>(&out[0]), out.size())) {
+			LOG_ERROR("Failed to decompress \"{}\" from asset pack \"{}\"", path, _path);
+			out.clear();
+			return false;
+		}
+	} else if (entry->Size > 0) {
+		memcpy(&out[0], _data + entry->Offset, static_cast<size_t>(entry->Size));
+	}
+	return true;
+}
+
+void AssetPack::Prefetch() const {
+	if (_data == nullptr) return;
+
+#ifndef _WIN32
+	madvise(const_cast<uint8_t*>(_data), _size, MADV_SEQUENTIAL);
+	madvise(const_cast<uint8_t*>(_data), _size, MADV_WILLNEED);
+#endif
+	// Touch one byte per page in order, the volatile stops the compiler from removing the loop
+	const size_t pageSize = 4096;
+	volatile uint8_t sink = 0;
+	for (size_t ix = 0; ix < _size; ix += pageSize) {
+		sink ^= _data[ix];
+	}
+	(void)sink;
+}
+
+bool AssetPack::Build(const std::string& rootFolder, const std::string& outputPath, bool compress) {
+	if (!fs::is_directory(rootFolder)) {
+		LOG_ERROR("Cannot build asset pack, \"{}\" is not a folder", rootFolder);
+		return false;
+	}
+
+	// Collect all the files, skipping the output and any caches that are machine specific
+	struct PendingEntry {
+		fs::path    FullPath;
+		std::string Key;
+	};
+	std::vector<PendingEntry> files;
+	const fs::path outputAbsolute = fs::absolute(outputPath).lexically_normal();
+	for (auto& item : fs::recursive_directory_iterator(rootFolder)) {
+		if (!item.is_regular_file()) continue;
+		if (fs::absolute(item.path()).lexically_normal() == outputAbsolute) continue;
+
+		std::string key = NormalizePath(fs::relative(item.path(), rootFolder).generic_string());
+		if (key.rfind("shader_cache/", 0) == 0) continue;
+
+		files.push_back({ item.path(), key });
+	}
+
+	std::ofstream file(outputPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file) {
+		LOG_ERROR("Could not open \"{}\" for writing", outputPath);
+		return false;
+	}
+
+	// We'll write the header again once we know where everything is
+	PackHeader header;
+	header.Version = PACK_VERSION;
+	header.Alignment = PACK_ALIGNMENT;
+	header.NumEntries = static_cast<uint32_t>(files.size());
+	file.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+
+	std::vector<PackEntry> entries;
+	std::string strings;
+	std::vector<uint8_t> compressed;
+	uint64_t offset = sizeof(PackHeader);
+	uint64_t rawTotal = 0;
+	const char padding[PACK_ALIGNMENT] ={ 0 };
+
+	entries.reserve(files.size());
+	for (const auto& pending : files) {
+		std::ifstream input(pending.FullPath, std::ios::in | std::ios::binary);
+		std::string contents((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+		// Align the start of the entry
+		uint64_t aligned = (offset + PACK_ALIGNMENT - 1) & ~(uint64_t)(PACK_ALIGNMENT - 1);
+		file.write(padding, aligned - offset);
+		offset = aligned;
+
+		PackEntry entry;
+		entry.PathHash = HashPath(pending.Key);
+		entry.Offset = offset;
+		entry.Size = contents.size();
+		entry.PathOffset = static_cast<uint32_t>(strings.size());
+		entry.PathLength = static_cast<uint32_t>(pending.Key.size());
+		strings += pending.Key;
+
+		// Only keep the compressed version if it's worth the decompression cost
+		bool stored = false;
+		if (compress && !contents.empty() && ShouldCompress(pending.FullPath)) {
+			Lz4Compress(reinterpret_cast<const uint8_t*>(contents.data()), contents.size(), compressed);
+			if (compressed.size() < contents.size() - contents.size() / 10) {
+				entry.Flags |= EntryFlag_Compressed;
+				entry.StoredSize = compressed.size();
+				file.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+				stored = true;
+			}
+		}
+		if (!stored) {
+			entry.StoredSize = contents.size();
+			file.write(contents.data(), contents.size());
+		}
+
+		offset += entry.StoredSize;
+		rawTotal += entry.Size;
+		entries.push_back(entry);
+	}
+
+	// Sort the index by hash so we can binary search it at runtime
+	std::sort(entries.begin(), entries.end(), [](const PackEntry& a, const PackEntry& b) {
+		return a.PathHash < b.PathHash;
+	});
+
+	uint64_t aligned = (offset + PACK_ALIGNMENT - 1) & ~(uint64_t)(PACK_ALIGNMENT - 1);
+	file.write(padding, aligned - offset);
+	offset = aligned;
+
+	header.IndexOffset = offset;
+	file.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(PackEntry));
+	offset += entries.size() * sizeof(PackEntry);
+
+	header.StringsOffset = offset;
+	header.StringsSize = strings.size();
+	file.write(strings.data(), strings.size());
+	offset += strings.size();
+
+	// Go back and write the complete header
+	file.seekp(0, std::ios::beg);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(PackHeader));
+
+	if (!file) {
+		LOG_ERROR("Failed while writing asset pack \"{}\"", outputPath);
+		return false;
+	}
+
+	LOG_INFO("Built asset pack \"{}\" with {} entries ({} bytes packed from {} bytes)", outputPath, entries.size(), offset, rawTotal);
+	return true;
+}
+
+bool AssetPack::_Map(const std::string& path) {
+#ifdef _WIN32
+	HANDLE fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("Could not open asset pack \"{}\"", path);
+		return false;
+	}
+	_fileHandle = fileHandle;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0) {
+		LOG_ERROR("Could not get the size of asset pack \"{}\"", path);
+		_Unmap();
+		return false;
+	}
+	_size = static_cast<size_t>(size.QuadPart);
+
+	HANDLE mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		LOG_ERROR("Could not create a file mapping for asset pack \"{}\"", path);
+		_Unmap();
+		return false;
+	}
+	_mappingHandle = mapping;
+
+	_data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+	_fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (_fileDescriptor < 0) {
+		LOG_ERROR("Could not open asset pack \"{}\"", path);
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(_fileDescriptor, &info) != 0 || info.st_size == 0) {
+		LOG_ERROR("Could not get the size of asset pack \"{}\"", path);
+		_Unmap();
+		return false;
+	}
+	_size = static_cast<size_t>(info.st_size);
+
+	void* mapped = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fileDescriptor, 0);
+	_data = mapped == MAP_FAILED ? nullptr : static_cast<const uint8_t*>(mapped);
+#endif
+
+	if (_data == nullptr) {
+		LOG_ERROR("Could not map asset pack \"{}\"", path);
+		_Unmap();
+		return false;
+	}
+	return true;
+}
+
+void AssetPack::_Unmap() {
+#ifdef _WIN32
+	if (_data != nullptr) {
+		UnmapViewOfFile(_data);
+	}
+	if (_mappingHandle != nullptr) {
+		CloseHandle(static_cast<HANDLE>(_mappingHandle));
+	}
+	if (_fileHandle != nullptr) {
+		CloseHandle(static_cast<HANDLE>(_fileHandle));
+	}
+#else
+	if (_data != nullptr) {
+		munmap(const_cast<uint8_t*>(_data), _size);
+	}
+	if (_fileDescriptor >= 0) {
+		close(_fileDescriptor);
+	}
+#endif
+	_data = nullptr;
+	_size = 0;
+	_header = nullptr;
+	_entries = nullptr;
+	_strings = nullptr;
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+	_fileDescriptor = -1;
+}
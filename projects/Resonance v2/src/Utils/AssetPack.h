@@ -0,0 +1,148 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Utils/Macros.h"
+
+/// <summary>
+/// A read-only archive of assets that is memory mapped as a single file. Entries are
+/// looked up through an index sorted by a hash of their normalized path, and their data
+/// is aligned so that uncompressed entries can be handed directly to loaders (ex: stbi, FMOD)
+/// without copying
+///
+/// Layout:
+///    PackHeader
+///    Entry data (each aligned to PackHeader::Alignment)
+///    PackEntry[NumEntries] (sorted by PathHash)
+///    String table (the normalized paths of all entries)
+/// </summary>
+class AssetPack final {
+public:
+	MAKE_PTRS(AssetPack);
+	NO_COPY(AssetPack);
+	NO_MOVE(AssetPack);
+
+	// Will be put at the start of the pack file, contains info about where to find the index
+	struct PackHeader {
+		// A check value so we can ensure that we're loading in the right file type
+		char     HeaderBytes[4] ={ 'R', 'P', 'A', 'K' };
+		// The version code, we can use this to create different loaders if our format changes
+		uint32_t Version = 0;
+		// The number of entries in the index
+		uint32_t NumEntries = 0;
+		// The alignment of each entry's data, in bytes
+		uint32_t Alignment = 0;
+		// The offset of the index from the start of the file
+		uint64_t IndexOffset = 0;
+		// The offset and size of the string table that stores all the paths
+		uint64_t StringsOffset = 0;
+		uint64_t StringsSize = 0;
+	};
+
+	// Flags that can be set on an individual entry
+	enum EntryFlags : uint32_t {
+		EntryFlag_None       = 0,
+		// The entry is stored as a single LZ4 block
+		EntryFlag_Compressed = 1 << 0
+	};
+
+	// A single entry in the pack index
+	struct PackEntry {
+		// The hash of the normalized path, the index is sorted by this
+		uint64_t PathHash = 0;
+		// The offset of the data from the start of the file
+		uint64_t Offset = 0;
+		// The number of bytes the data takes up in the pack
+		uint64_t StoredSize = 0;
+		// The number of bytes of the data once uncompressed
+		uint64_t Size = 0;
+		// The location of the path in the string table, so we can resolve hash collisions
+		uint32_t PathOffset = 0;
+		uint32_t PathLength = 0;
+		// See EntryFlags
+		uint32_t Flags = EntryFlag_None;
+		uint32_t Reserved = 0;
+	};
+
+	~AssetPack();
+
+	/// <summary>
+	/// Opens and memory maps the pack file at the given path
+	/// </summary>
+	/// <param name="path">The path to the pack file to open</param>
+	/// <returns>The opened pack, or nullptr if the file could not be opened or is invalid</returns>
+	static AssetPack::Sptr Open(const std::string& path);
+
+	/// <summary>
+	/// Builds a pack file from all the files within a folder. Paths in the pack will be relative to the
+	/// folder, so packing the working directory lets the pack serve the same paths the game already uses
+	/// </summary>
+	/// <param name="rootFolder">The folder to pack, recursively</param>
+	/// <param name="outputPath">The path of the pack file to create</param>
+	/// <param name="compress">True to LZ4 compress entries that benefit from it</param>
+	/// <returns>True if the pack was written, false if otherwise</returns>
+	static bool Build(const std::string& rootFolder, const std::string& outputPath, bool compress = true);
+
+	/// <summary>
+	/// Normalizes a path so that it can be used as a key in a pack (forward slashes, lower case, no ./ or ../)
+	/// </summary>
+	static std::string NormalizePath(const std::string& path);
+
+	/// <summary>
+	/// Gets the entry for the given path, or nullptr if the pack does not contain it
+	/// </summary>
+	const PackEntry* Find(const std::string& path) const;
+
+	/// <summary>
+	/// Gets a pointer directly into the mapped pack for the given path. This only works for
+	/// entries that are stored uncompressed
+	/// </summary>
+	/// <param name="path">The path of the file to get</param>
+	/// <param name="data">Will store the pointer to the data</param>
+	/// <param name="size">Will store the size of the data in bytes</param>
+	/// <returns>True if the entry exists and is uncompressed, false if otherwise</returns>
+	bool GetView(const std::string& path, const uint8_t** data, size_t* size) const;
+
+	/// <summary>
+	/// Reads the given entry into a string, decompressing if required
+	/// </summary>
+	/// <param name="path">The path of the file to read</param>
+	/// <param name="out">The string to store the contents in</param>
+	/// <returns>True if the entry exists and was read, false if otherwise</returns>
+	bool Read(const std::string& path, std::string& out) const;
+
+	/// <summary>
+	/// Touches every page of the mapping in order, so that the OS performs one sequential read of the
+	/// pack rather than faulting in pages at random as assets are loaded
+	/// </summary>
+	void Prefetch() const;
+
+	/// <summary>
+	/// Gets the path that this pack was opened from
+	/// </summary>
+	const std::string& GetPath() const { return _path; }
+	/// <summary>
+	/// Gets the number of entries in this pack
+	/// </summary>
+	size_t GetEntryCount() const { return _header != nullptr ? _header->NumEntries : 0; }
+
+	AssetPack();
+
+protected:
+	std::string _path;
+
+	// Platform handles for the mapping
+	void*    _fileHandle;
+	void*    _mappingHandle;
+	int      _fileDescriptor;
+
+	const uint8_t*    _data;
+	size_t            _size;
+	const PackHeader* _header;
+	const PackEntry*  _entries;
+	const char*       _strings;
+
+	bool _Map(const std::string& path);
+	void _Unmap();
+};
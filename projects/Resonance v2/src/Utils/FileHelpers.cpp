@@ -4,9 +4,78 @@
 #include <Logging.h>
 
 #include "Utils/StringUtils.h"
+#include "Utils/AssetPack.h"
+
+std::vector<std::shared_ptr<AssetPack>> FileHelpers::__packs;
+
+bool FileHelpers::MountPack(const std::string& path, bool prefetch /*= true*/) {
+	AssetPack::Sptr pack = AssetPack::Open(path);
+	if (pack == nullptr) {
+		return false;
+	}
+	if (prefetch) {
+		pack->Prefetch();
+	}
+	// Most recently mounted packs are searched first
+	__packs.insert(__packs.begin(), pack);
+	return true;
+}
+
+void FileHelpers::UnmountPacks() {
+	__packs.clear();
+}
+
+bool FileHelpers::Exists(const std::string& filename) {
+	return IsPacked(filename) || std::filesystem::exists(filename);
+}
+
+bool FileHelpers::IsPacked(const std::string& filename) {
+	for (const auto& pack : __packs) {
+		if (pack->Find(filename) != nullptr) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FileHelpers::ReadFileBuffer(const std::string& filename, FileBuffer& out) {
+	out.Storage.clear();
+	out.IsMapped = false;
+
+	for (const auto& pack : __packs) {
+		// Uncompressed entries can be used in place
+		if (pack->GetView(filename, &out.Data, &out.Size)) {
+			out.IsMapped = true;
+			return true;
+		}
+		if (pack->Read(filename, out.Storage)) {
+			out.Data = reinterpret_cast<const uint8_t*>(out.Storage.data());
+			out.Size = out.Storage.size();
+			return true;
+		}
+	}
+
+	if (!std::filesystem::exists(filename)) {
+		out.Data = nullptr;
+		out.Size = 0;
+		return false;
+	}
+	out.Storage = ReadFile(filename);
+	out.Data = reinterpret_cast<const uint8_t*>(out.Storage.data());
+	out.Size = out.Storage.size();
+	return true;
+}
 
 std::string FileHelpers::ReadFile(const std::string& filename) {
 	std::string result;
+
+	// Mounted packs take priority over loose files
+	for (const auto& pack : __packs) {
+		if (pack->Read(filename, result)) {
+			return result;
+		}
+	}
+
 	std::ifstream in(filename, std::ios::in | std::ios::binary); // ifstream closes itself due to RAII
 
 	if (in) {
@@ -76,7 +145,7 @@ std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::v
 		if (std::find(resolvedPaths.begin(), resolvedPaths.end(), target.string()) == resolvedPaths.end()) {
 
 			// Make sure file exists, then load and resolve it's includes
-			LOG_ASSERT(std::filesystem::exists(target), "File does not exist");
+			LOG_ASSERT(FileHelpers::Exists(target.string()), "File does not exist");
 			std::string replacement = FileHelpers::ReadResolveIncludes(target.string(), resolvedPaths);
 
 			// Inject result into our string
@@ -97,6 +166,6 @@ std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::v
 }
 
 void FileHelpers::WriteContentsToFile(const std::string& filename, const std::string& contents, bool append /*= false*/) {
-	std::ofstream output(filename, std::ios::out | (append ? std::ios::app : 0));
+	std::ofstream output(filename, std::ios::out | (append ? std::ios::app : std::ios::openmode(0)));
 	output << contents;
 }
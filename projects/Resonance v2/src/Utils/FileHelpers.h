@@ -2,10 +2,60 @@
 
 #include <string>
 #include <vector>
+#include <memory>
+#include <cstdint>
+
+class AssetPack;
 
 class FileHelpers {
 public:
+	/// <summary>
+	/// A read-only view of a file's contents. If the file is stored uncompressed in a mounted
+	/// asset pack, Data points directly into the pack, otherwise the contents are copied into Storage
+	/// </summary>
+	struct FileBuffer {
+		const uint8_t* Data = nullptr;
+		size_t         Size = 0;
+		std::string    Storage;
+		// True if Data points into a mounted pack, and will stay valid until the pack is unmounted
+		bool           IsMapped = false;
+	};
+
 	FileHelpers() = delete;
+
+	/// <summary>
+	/// Mounts an asset pack, after which all reads through FileHelpers will check the pack before the disk.
+	/// Packs mounted later take priority over earlier packs
+	/// </summary>
+	/// <param name="path">The path to the pack file</param>
+	/// <param name="prefetch">True to read the entire pack into the OS cache in one sequential pass</param>
+	/// <returns>True if the pack was mounted, false if otherwise</returns>
+	static bool MountPack(const std::string& path, bool prefetch = true);
+	/// <summary>
+	/// Unmounts all asset packs, any mapped FileBuffers will no longer be valid
+	/// </summary>
+	static void UnmountPacks();
+
+	/// <summary>
+	/// Checks whether a file exists in any mounted asset pack, or on disk
+	/// </summary>
+	/// <param name="filename">The path of the file to check</param>
+	static bool Exists(const std::string& filename);
+	/// <summary>
+	/// Checks whether a file is stored in any mounted asset pack
+	/// </summary>
+	/// <param name="filename">The path of the file to check</param>
+	static bool IsPacked(const std::string& filename);
+
+	/// <summary>
+	/// Reads the entire contents of a file into a buffer, avoiding a copy where the file
+	/// can be served directly from a mounted asset pack
+	/// </summary>
+	/// <param name="filename">The path of the file to load</param>
+	/// <param name="out">The buffer to store the result in</param>
+	/// <returns>True if the file was read, false if otherwise</returns>
+	static bool ReadFileBuffer(const std::string& filename, FileBuffer& out);
+
 	/// <summary>
 	/// Reads the entire contents of a file into a string
 	/// </summary>
@@ -29,4 +79,7 @@ public:
 	/// <param name="contents">The contents of the file to write</param>
 	/// <param name="append">True if contents should be appended to end of existing files</param>
 	static void WriteContentsToFile(const std::string& filename, const std::string& contents, bool append = false);
+
+protected:
+	static std::vector<std::shared_ptr<AssetPack>> __packs;
 };
\ No newline at end of file
@@ -0,0 +1,490 @@
+#include "Utils/GltfLoader.h"
+
+#include <filesystem>
+#include <cstring>
+#include <cstddef>
+#include <GLM/gtc/quaternion.hpp>
+#include <GLM/gtc/type_ptr.hpp>
+#include <GLM/gtc/matrix_transform.hpp>
+
+#include "tiny_gltf.h"
+
+#include "Utils/OptimizedObjLoader.h"
+#include "Utils/MeshFactory.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/StringUtils.h"
+#include "Utils/ThreadPool.h"
+#include "GLFW/glfw3.h"
+#include "Logging.h"
+
+namespace fs = std::filesystem;
+
+// The tangent's handedness is decoded into the float directly after it, so the bitangent must immediately follow the tangent
+static_assert(offsetof(VertexPosNormTexColTangents, BiTangent) == offsetof(VertexPosNormTexColTangents, Tangent) + sizeof(glm::vec3),
+			  "Tangent and BiTangent must be contiguous for glTF tangent decoding");
+
+namespace {
+	// A triangle primitive, along with it's world transform and the range it occupies in the final mesh
+	struct PrimitiveInstance {
+		const tinygltf::Primitive* Primitive;
+		glm::mat4 Transform;
+		size_t    VertexOffset;
+		size_t    VertexCount;
+		size_t    IndexOffset;
+		size_t    IndexCount;
+	};
+
+	// The result of decoding a single primitive
+	struct DecodeResult {
+		bool Success     = false;
+		bool HasTangents = false;
+	};
+
+	// We only care about the geometry, so skip decoding any images in the file
+	bool SkipImageData(tinygltf::Image*, const int, std::string*, std::string*, int, int, const unsigned char*, int, void*) {
+		return true;
+	}
+
+	// Route external buffer reads through FileHelpers, so that .gltf files can be served from asset packs
+	bool FileExistsCallback(const std::string& path, void*) {
+		return FileHelpers::Exists(path);
+	}
+	bool ReadWholeFileCallback(std::vector<unsigned char>* out, std::string* err, const std::string& path, void*) {
+		FileHelpers::FileBuffer buffer;
+		if (!FileHelpers::ReadFileBuffer(path, buffer)) {
+			if (err != nullptr) {
+				*err += "File not found: " + path + "\n";
+			}
+			return false;
+		}
+		out->assign(buffer.Data, buffer.Data + buffer.Size);
+		return true;
+	}
+
+	float ReadComponent(const uint8_t* data, int componentType, bool normalized) {
+		// See the glTF spec for how normalized integers map to floats
+		switch (componentType) {
+			case TINYGLTF_COMPONENT_TYPE_BYTE:           { int8_t   v; memcpy(&v, data, sizeof(v)); return normalized ? glm::max(v / 127.0f, -1.0f) : v; }
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  { uint8_t  v; memcpy(&v, data, sizeof(v)); return normalized ? v / 255.0f : v; }
+			case TINYGLTF_COMPONENT_TYPE_SHORT:          { int16_t  v; memcpy(&v, data, sizeof(v)); return normalized ? glm::max(v / 32767.0f, -1.0f) : v; }
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, data, sizeof(v)); return normalized ? v / 65535.0f : v; }
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   { uint32_t v; memcpy(&v, data, sizeof(v)); return static_cast<float>(v); }
+			case TINYGLTF_COMPONENT_TYPE_FLOAT:          { float    v; memcpy(&v, data, sizeof(v)); return v; }
+			default: return 0.0f;
+		}
+	}
+
+	uint32_t ReadIndex(const uint8_t* data, int componentType) {
+		switch (componentType) {
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:  { uint8_t  v; memcpy(&v, data, sizeof(v)); return v; }
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT: { uint16_t v; memcpy(&v, data, sizeof(v)); return v; }
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:   { uint32_t v; memcpy(&v, data, sizeof(v)); return v; }
+			default: return 0;
+		}
+	}
+
+	// Resolves the start of the data for a buffer view, and validates that count elements fit within it
+	bool ResolveView(const tinygltf::Model& model, int viewIx, size_t byteOffset, size_t elementSize, size_t count, const uint8_t*& data, size_t& stride) {
+		if (viewIx < 0 || viewIx >= static_cast<int>(model.bufferViews.size())) {
+			return false;
+		}
+		const tinygltf::BufferView& view = model.bufferViews[viewIx];
+		if (view.buffer < 0 || view.buffer >= static_cast<int>(model.buffers.size())) {
+			return false;
+		}
+		const tinygltf::Buffer& buffer = model.buffers[view.buffer];
+
+		stride = view.byteStride != 0 ? view.byteStride : elementSize;
+		size_t required = count > 0 ? stride * (count - 1) + elementSize : 0;
+		if (view.byteOffset + view.byteLength > buffer.data.size() || byteOffset + required > view.byteLength) {
+			return false;
+		}
+		data = buffer.data.data() + view.byteOffset + byteOffset;
+		return true;
+	}
+
+	// Invokes fn(index, data) for every element of an accessor. Data will be nullptr for accessors without
+	// a buffer view (which are all zeros by spec), and sparse substitutions are applied after the dense data
+	template <typename Fn>
+	bool ForEachElement(const tinygltf::Model& model, const tinygltf::Accessor& accessor, size_t elementSize, Fn&& fn) {
+		const size_t count = accessor.count;
+		if (accessor.bufferView >= 0) {
+			const uint8_t* data = nullptr;
+			size_t stride = 0;
+			if (!ResolveView(model, accessor.bufferView, accessor.byteOffset, elementSize, count, data, stride)) {
+				return false;
+			}
+			for (size_t ix = 0; ix < count; ix++) {
+				fn(ix, data + ix * stride);
+			}
+		} else {
+			for (size_t ix = 0; ix < count; ix++) {
+				fn(ix, nullptr);
+			}
+		}
+
+		if (accessor.sparse.isSparse) {
+			const auto& sparse = accessor.sparse;
+			const size_t indexSize = tinygltf::GetComponentSizeInBytes(sparse.indices.componentType);
+			const uint8_t* indices = nullptr;
+			const uint8_t* values = nullptr;
+			size_t indexStride = 0, valueStride = 0;
+			if (!ResolveView(model, sparse.indices.bufferView, sparse.indices.byteOffset, indexSize, sparse.count, indices, indexStride) ||
+				!ResolveView(model, sparse.values.bufferView, sparse.values.byteOffset, elementSize, sparse.count, values, valueStride)) {
+				return false;
+			}
+			for (int ix = 0; ix < sparse.count; ix++) {
+				uint32_t target = ReadIndex(indices + ix * indexStride, sparse.indices.componentType);
+				if (target >= count) {
+					return false;
+				}
+				fn(target, values + ix * valueStride);
+			}
+		}
+		return true;
+	}
+
+	// Decodes a float attribute into the member at memberOffset of every vertex. Returns the number of components in the
+	// attribute, 0 if the primitive does not have the attribute, or -1 if the attribute is invalid
+	int DecodeAttribute(const tinygltf::Model& model, const tinygltf::Primitive& primitive, const char* name,
+						VertexPosNormTexColTangents* vertices, size_t vertexCount, size_t memberOffset, int maxComponents)
+	{
+		auto it = primitive.attributes.find(name);
+		if (it == primitive.attributes.end()) {
+			return 0;
+		}
+		if (it->second < 0 || it->second >= static_cast<int>(model.accessors.size())) {
+			return -1;
+		}
+		const tinygltf::Accessor& accessor = model.accessors[it->second];
+		const int numComponents = tinygltf::GetNumComponentsInType(accessor.type);
+		const int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+		if (accessor.count != vertexCount || numComponents <= 0 || componentSize <= 0) {
+			return -1;
+		}
+
+		const int toRead = glm::min(numComponents, maxComponents);
+		bool success = ForEachElement(model, accessor, static_cast<size_t>(numComponents) * componentSize, [&](size_t ix, const uint8_t* data) {
+			float* dest = reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(&vertices[ix]) + memberOffset);
+			for (int c = 0; c < toRead; c++) {
+				dest[c] = data != nullptr ? ReadComponent(data + c * componentSize, accessor.componentType, accessor.normalized) : 0.0f;
+			}
+		});
+		return success ? numComponents : -1;
+	}
+
+	// Decodes a single primitive into it's range of the final vertex and index arrays. Primitives never share
+	// ranges, so this can be run for all primitives in parallel
+	DecodeResult DecodePrimitive(const tinygltf::Model& model, const PrimitiveInstance& instance, VertexPosNormTexColTangents* vertices, uint32_t* indices) {
+		DecodeResult result;
+		const tinygltf::Primitive& primitive = *instance.Primitive;
+		const size_t vertexCount = instance.VertexCount;
+
+		if (DecodeAttribute(model, primitive, "POSITION", vertices, vertexCount, offsetof(VertexPosNormTexColTangents, Position), 3) <= 0) {
+			return result;
+		}
+		int numNormals  = DecodeAttribute(model, primitive, "NORMAL",     vertices, vertexCount, offsetof(VertexPosNormTexColTangents, Normal), 3);
+		int numUvs      = DecodeAttribute(model, primitive, "TEXCOORD_0", vertices, vertexCount, offsetof(VertexPosNormTexColTangents, UV), 2);
+		int numColors   = DecodeAttribute(model, primitive, "COLOR_0",    vertices, vertexCount, offsetof(VertexPosNormTexColTangents, Color), 4);
+		// Tangents are vec4 with the handedness in w, which lands in BiTangent.x until we resolve it below
+		int numTangents = DecodeAttribute(model, primitive, "TANGENT",    vertices, vertexCount, offsetof(VertexPosNormTexColTangents, Tangent), 4);
+		if (numNormals < 0 || numUvs < 0 || numColors < 0 || numTangents < 0) {
+			return result;
+		}
+
+		// Decode the indices, rebasing them into the final mesh
+		if (primitive.indices >= 0) {
+			const tinygltf::Accessor& accessor = model.accessors[primitive.indices];
+			const uint32_t base = static_cast<uint32_t>(instance.VertexOffset);
+			bool valid = true;
+			bool success = ForEachElement(model, accessor, tinygltf::GetComponentSizeInBytes(accessor.componentType), [&](size_t ix, const uint8_t* data) {
+				// Any trailing partial triangle was trimmed from our range, don't spill into the next primitive
+				if (ix >= instance.IndexCount) {
+					return;
+				}
+				uint32_t index = data != nullptr ? ReadIndex(data, accessor.componentType) : 0;
+				valid &= index < vertexCount;
+				indices[ix] = base + index;
+			});
+			if (!success || !valid) {
+				return result;
+			}
+		} else {
+			for (size_t ix = 0; ix < instance.IndexCount; ix++) {
+				indices[ix] = static_cast<uint32_t>(instance.VertexOffset + ix);
+			}
+		}
+
+		// Mirrored transforms flip the winding order, so flip it back
+		if (glm::determinant(glm::mat3(instance.Transform)) < 0.0f) {
+			for (size_t ix = 0; ix + 2 < instance.IndexCount; ix += 3) {
+				std::swap(indices[ix + 1], indices[ix + 2]);
+			}
+		}
+
+		// Move everything into object space, and convert to our conventions
+		const glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(instance.Transform)));
+		const glm::mat3 tangentMatrix = glm::mat3(instance.Transform);
+		for (size_t ix = 0; ix < vertexCount; ix++) {
+			VertexPosNormTexColTangents& vert = vertices[ix];
+			vert.Position = glm::vec3(instance.Transform * glm::vec4(vert.Position, 1.0f));
+			vert.Normal = normalMatrix * vert.Normal;
+			// glTF has the UV origin at the top left, we have it at the bottom left
+			vert.UV.y = 1.0f - vert.UV.y;
+			if (numColors == 0) {
+				vert.Color = glm::vec4(1.0f);
+			} else if (numColors == 3) {
+				vert.Color.a = 1.0f;
+			}
+		}
+
+		// Normals are optional in glTF, generate smooth normals from the faces if we don't have any
+		if (numNormals == 0) {
+			for (size_t ix = 0; ix + 2 < instance.IndexCount; ix += 3) {
+				VertexPosNormTexColTangents& a = vertices[indices[ix + 0] - instance.VertexOffset];
+				VertexPosNormTexColTangents& b = vertices[indices[ix + 1] - instance.VertexOffset];
+				VertexPosNormTexColTangents& c = vertices[indices[ix + 2] - instance.VertexOffset];
+				glm::vec3 faceNormal = glm::cross(b.Position - a.Position, c.Position - a.Position);
+				a.Normal += faceNormal;
+				b.Normal += faceNormal;
+				c.Normal += faceNormal;
+			}
+		}
+		for (size_t ix = 0; ix < vertexCount; ix++) {
+			VertexPosNormTexColTangents& vert = vertices[ix];
+			float length = glm::length(vert.Normal);
+			vert.Normal = length > 0.0f ? vert.Normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+			if (numTangents > 0) {
+				float handedness = vert.BiTangent.x < 0.0f ? -1.0f : 1.0f;
+				vert.Tangent = glm::normalize(tangentMatrix * vert.Tangent);
+				vert.BiTangent = glm::cross(vert.Normal, vert.Tangent) * handedness;
+			}
+		}
+
+		result.Success = true;
+		result.HasTangents = numTangents > 0 && numNormals > 0;
+		return result;
+	}
+
+	glm::mat4 GetLocalTransform(const tinygltf::Node& node) {
+		if (node.matrix.size() == 16) {
+			return glm::mat4(glm::make_mat4(node.matrix.data()));
+		}
+		glm::mat4 result = glm::mat4(1.0f);
+		if (node.translation.size() == 3) {
+			result = glm::translate(result, glm::vec3(glm::make_vec3(node.translation.data())));
+		}
+		if (node.rotation.size() == 4) {
+			// glTF stores quaternions as XYZW, GLM takes WXYZ
+			result *= glm::mat4_cast(glm::quat(
+				static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]),
+				static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2])));
+		}
+		if (node.scale.size() == 3) {
+			result = glm::scale(result, glm::vec3(glm::make_vec3(node.scale.data())));
+		}
+		return result;
+	}
+
+	void AddMeshPrimitives(const tinygltf::Model& model, int meshIx, const glm::mat4& transform, std::vector<PrimitiveInstance>& out) {
+		if (meshIx < 0 || meshIx >= static_cast<int>(model.meshes.size())) {
+			return;
+		}
+		for (const tinygltf::Primitive& primitive : model.meshes[meshIx].primitives) {
+			// Default mode is triangles, we don't support points, lines, strips or fans
+			if (primitive.mode != -1 && primitive.mode != TINYGLTF_MODE_TRIANGLES) {
+				LOG_WARN("Skipping glTF primitive with unsupported mode {}", primitive.mode);
+				continue;
+			}
+			auto position = primitive.attributes.find("POSITION");
+			if (position == primitive.attributes.end() || position->second < 0 || position->second >= static_cast<int>(model.accessors.size())) {
+				continue;
+			}
+			if (primitive.indices >= static_cast<int>(model.accessors.size())) {
+				continue;
+			}
+
+			PrimitiveInstance instance;
+			instance.Primitive = &primitive;
+			instance.Transform = transform;
+			instance.VertexCount = model.accessors[position->second].count;
+			instance.IndexCount = primitive.indices >= 0 ? model.accessors[primitive.indices].count : instance.VertexCount;
+			instance.IndexCount -= instance.IndexCount % 3;
+			instance.VertexOffset = 0;
+			instance.IndexOffset = 0;
+			out.push_back(instance);
+		}
+	}
+
+	void GatherNode(const tinygltf::Model& model, int nodeIx, const glm::mat4& parent, std::vector<PrimitiveInstance>& out, int depth) {
+		// glTF does not allow cycles, but don't trust the file to follow that
+		if (nodeIx < 0 || nodeIx >= static_cast<int>(model.nodes.size()) || depth > static_cast<int>(model.nodes.size())) {
+			return;
+		}
+		const tinygltf::Node& node = model.nodes[nodeIx];
+		glm::mat4 transform = parent * GetLocalTransform(node);
+		AddMeshPrimitives(model, node.mesh, transform, out);
+		for (int child : node.children) {
+			GatherNode(model, child, transform, out, depth + 1);
+		}
+	}
+
+	// Checks if the source file has been changed since the cache was written. Files we can't get a time for (ex: ones
+	// in an asset pack) are trusted, since they can't have been edited
+	bool IsCacheStale(const std::string& sourcePath, const std::string& cachePath) {
+		std::error_code error;
+		const fs::file_time_type sourceTime = fs::last_write_time(sourcePath, error);
+		if (error) {
+			return false;
+		}
+		const fs::file_time_type cacheTime = fs::last_write_time(cachePath, error);
+		return !error && sourceTime > cacheTime;
+	}
+}
+
+VertexArrayObject::Sptr GltfLoader::LoadFromFile(const std::string& filename) {
+	if (!IsGltfFile(filename)) {
+		LOG_WARN("Cannot load glTF model from \"{}\"", filename);
+		return nullptr;
+	}
+
+	// Append rather than replace the extension, since .gltf files often have a .bin buffer with the same name
+	std::string binPath = filename + ".bin";
+	if (FileHelpers::Exists(binPath)) {
+		if (IsCacheStale(filename, binPath)) {
+			LOG_INFO("\"{}\" has changed, rebuilding binary mesh \"{}\"", filename, binPath);
+		} else {
+			VertexArrayObject::Sptr result = OptimizedObjLoader::LoadFromFile(binPath);
+			if (result != nullptr) {
+				return result;
+			}
+			// The binary file is truncated or corrupt, throw it out and go back to the glTF
+			LOG_WARN("Rebuilding binary mesh \"{}\" from \"{}\"", binPath, filename);
+			std::error_code error;
+			fs::remove(binPath, error);
+		}
+	}
+
+	float startTime = static_cast<float>(glfwGetTime());
+
+	MeshBuilder<VertexPosNormTexColTangents> mesh;
+	if (!LoadMesh(filename, mesh)) {
+		return nullptr;
+	}
+
+	float endTime = static_cast<float>(glfwGetTime());
+	LOG_TRACE("Loaded glTF file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, mesh.GetVertexCount(), mesh.GetIndexCount());
+
+	// Cache the result so that we can skip parsing next time, this can fail if we're running out of a read-only location
+	try {
+		OptimizedObjLoader::SaveBinaryFile(mesh, binPath);
+	} catch (const std::runtime_error& e) {
+		LOG_WARN("Failed to write binary mesh \"{}\": {}", binPath, e.what());
+	}
+
+	return mesh.Bake();
+}
+
+bool GltfLoader::LoadMesh(const std::string& filename, MeshBuilder<VertexPosNormTexColTangents>& mesh) {
+	FileHelpers::FileBuffer file;
+	if (!FileHelpers::ReadFileBuffer(filename, file)) {
+		LOG_WARN("Failed to read glTF file \"{}\"", filename);
+		return false;
+	}
+
+	tinygltf::TinyGLTF loader;
+	loader.SetImageLoader(&SkipImageData, nullptr);
+	tinygltf::FsCallbacks callbacks;
+	callbacks.FileExists     = &FileExistsCallback;
+	callbacks.ExpandFilePath = &tinygltf::ExpandFilePath;
+	callbacks.ReadWholeFile  = &ReadWholeFileCallback;
+	callbacks.WriteWholeFile = &tinygltf::WriteWholeFile;
+	callbacks.user_data      = nullptr;
+	loader.SetFsCallbacks(callbacks);
+
+	// External buffers are relative to the file, GLB files start with the magic "glTF"
+	std::string baseDir = fs::path(filename).parent_path().string();
+	bool isBinary = file.Size >= 4 && memcmp(file.Data, "glTF", 4) == 0;
+
+	tinygltf::Model model;
+	std::string err, warn;
+	bool success = isBinary ?
+		loader.LoadBinaryFromMemory(&model, &err, &warn, file.Data, static_cast<unsigned int>(file.Size), baseDir) :
+		loader.LoadASCIIFromString(&model, &err, &warn, reinterpret_cast<const char*>(file.Data), static_cast<unsigned int>(file.Size), baseDir);
+	if (!warn.empty()) {
+		LOG_WARN("glTF file \"{}\": {}", filename, warn);
+	}
+	if (!success) {
+		LOG_ERROR("Failed to parse glTF file \"{}\": {}", filename, err);
+		return false;
+	}
+
+	// Collect all the primitives in the scene, flattening the node hierarchy
+	std::vector<PrimitiveInstance> instances;
+	if (!model.scenes.empty()) {
+		int sceneIx = model.defaultScene >= 0 && model.defaultScene < static_cast<int>(model.scenes.size()) ? model.defaultScene : 0;
+		for (int nodeIx : model.scenes[sceneIx].nodes) {
+			GatherNode(model, nodeIx, glm::mat4(1.0f), instances, 0);
+		}
+	} else {
+		// No scenes means the file is just a library of meshes, so take them all as-is
+		for (int meshIx = 0; meshIx < static_cast<int>(model.meshes.size()); meshIx++) {
+			AddMeshPrimitives(model, meshIx, glm::mat4(1.0f), instances);
+		}
+	}
+	if (instances.empty()) {
+		LOG_WARN("glTF file \"{}\" does not contain any triangle meshes", filename);
+		return false;
+	}
+
+	// Lay out every primitive in the final arrays up front, so we only allocate once
+	size_t numVertices = 0, numIndices = 0;
+	for (PrimitiveInstance& instance : instances) {
+		instance.VertexOffset = numVertices;
+		instance.IndexOffset = numIndices;
+		numVertices += instance.VertexCount;
+		numIndices += instance.IndexCount;
+	}
+	if (numVertices > UINT32_MAX) {
+		LOG_ERROR("glTF file \"{}\" has too many vertices ({})", filename, numVertices);
+		return false;
+	}
+	mesh._vertices.clear();
+	mesh._indices.clear();
+	mesh._vertices.resize(numVertices);
+	mesh._indices.resize(numIndices);
+
+	// Decode the primitives across the thread pool, each one straight into it's slice of the mesh
+	std::vector<DecodeResult> results(instances.size());
+	ThreadPool::Get().ParallelFor(static_cast<uint32_t>(instances.size()), 1, [&](uint32_t begin, uint32_t end) {
+		for (uint32_t ix = begin; ix < end; ix++) {
+			const PrimitiveInstance& instance = instances[ix];
+			results[ix] = DecodePrimitive(model, instance, mesh._vertices.data() + instance.VertexOffset, mesh._indices.data() + instance.IndexOffset);
+		}
+	});
+
+	bool allDecoded = true;
+	bool allTangents = true;
+	for (const DecodeResult& result : results) {
+		allDecoded &= result.Success;
+		allTangents &= result.HasTangents;
+	}
+	if (!allDecoded) {
+		LOG_ERROR("glTF file \"{}\" contains invalid accessor data", filename);
+		mesh.Reset();
+		return false;
+	}
+
+	// If any primitive is missing tangents we need to generate them
+	if (!allTangents) {
+		MeshFactory::CalculateTBN(mesh);
+	}
+
+	return true;
+}
+
+bool GltfLoader::IsGltfFile(const std::string& filename) {
+	std::string extension = fs::path(filename).extension().string();
+	StringTools::ToLower(extension);
+	return extension == ".gltf" || extension == ".glb";
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+
+#include "Graphics/VertexArrayObject.h"
+#include "Graphics/VertexTypes.h"
+
+#include "Utils/MeshBuilder.h"
+
+/// <summary>
+/// Loads the geometry from glTF 2.0 (.gltf or .glb) files into a single mesh. All triangle
+/// primitives in the default scene are flattened into object space using their node transforms,
+/// and each primitive's accessors are decoded on it's own thread directly into the final vertex array
+///
+/// Like the OptimizedObjLoader, the first load of a file will write a binary mesh next to it, which
+/// will be loaded instead on subsequent runs
+/// </summary>
+class GltfLoader {
+public:
+	GltfLoader() = delete;
+
+	/// <summary>
+	/// Loads a VAO from a glTF or GLB file, or from it's converted binary file if one exists
+	/// </summary>
+	/// <param name="filename">The path to the .gltf or .glb file to load</param>
+	/// <returns>A VAO loaded from disk, or nullptr if the file could not be loaded</returns>
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
+
+	/// <summary>
+	/// Loads the geometry from a glTF or GLB file into a mesh builder, ignoring any existing binary file
+	/// </summary>
+	/// <param name="filename">The path to the .gltf or .glb file to load</param>
+	/// <param name="mesh">The mesh to store the geometry in, any existing geometry will be replaced</param>
+	/// <returns>True if the file was loaded, false if otherwise</returns>
+	static bool LoadMesh(const std::string& filename, MeshBuilder<VertexPosNormTexColTangents>& mesh);
+
+	/// <summary>
+	/// Checks whether the given file has an extension that this loader can handle
+	/// </summary>
+	/// <param name="filename">The path of the file to check</param>
+	static bool IsGltfFile(const std::string& filename);
+};
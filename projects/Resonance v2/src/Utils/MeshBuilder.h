@@ -166,6 +166,7 @@ public:
 	
 protected:
 	friend class MeshFactory;
+	friend class GltfLoader;
 	
 	std::vector<VertType> _vertices;
 	std::vector<uint32_t> _indices;
@@ -7,8 +7,10 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <cstring>
 
 #include "Utils/StringUtils.h"
+#include "Utils/FileHelpers.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 
@@ -28,11 +30,27 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 		// Get the binary path
 		fs::path binPath = filePath.replace_extension(binaryExtension);
 		// If the file does not exist, convert the OBJ file to a binary file
-		if (!fs::exists(binPath)) {
+		if (!FileHelpers::Exists(binPath.string())) {
 			ConvertToBinary(filename, binPath.string());
 		}
 		// Load the corresponding binary file
-		return _LoadFromBinFile(binPath.string());
+		VertexArrayObject::Sptr result = _LoadFromBinFile(binPath.string());
+		if (result == nullptr) {
+			// The binary file is truncated or corrupt, throw it out and go back to the OBJ
+			LOG_WARN("Rebuilding binary mesh \"{}\" from \"{}\"", binPath.string(), filename);
+			std::error_code error;
+			fs::remove(binPath, error);
+
+			MeshBuilder<VertexPosNormTexColTangents>* mesh = _LoadFromObjFile(filename);
+			try {
+				SaveBinaryFile(*mesh, binPath.string());
+			} catch (const std::runtime_error& e) {
+				LOG_WARN("Failed to save binary mesh \"{}\": {}", binPath.string(), e.what());
+			}
+			result = mesh->Bake();
+			delete mesh;
+		}
+		return result;
 	} 
 	// Load our fancy binary files
 	else if (extension == ".bin") {
@@ -72,6 +90,42 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 	delete mesh;
 }
 
+void OptimizedObjLoader::SaveBinaryFile(
+	const void* vertices, uint32_t numVertices, uint16_t vertexStride, const std::vector<BufferAttribute>& vDecl,
+	const void* indices, uint32_t numIndices, IndexType indexType,
+	const std::string& outFilename)
+{
+	// Open the output file
+	std::ofstream file(outFilename, std::ios::binary);
+	if (!file) {
+		throw std::runtime_error("Failed to open output file");
+	}
+
+	// Create the fixed size header for our output file
+	BinaryHeader header  = BinaryHeader();
+	header.Version       = 0x01; // This is version 1! Update this and implement different readers if changes to format are made
+	header.NumIndices    = indices != nullptr ? numIndices : 0;
+	header.IndicesType   = indexType;
+	header.NumVertices   = numVertices;
+	header.VertexStride  = vertexStride;
+	header.NumAttributes = static_cast<uint8_t>(vDecl.size());
+
+	// Write header bytes to the stream
+	file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
+
+	// Write which attributes we have to the stream
+	for (size_t ix = 0; ix < vDecl.size(); ix++) {
+		file.write(reinterpret_cast<const char*>(&vDecl[ix]), sizeof(BufferAttribute));
+	}
+	// Write any index data to the file
+	if (header.NumIndices > 0) {
+		file.write(reinterpret_cast<const char*>(indices), header.NumIndices * (size_t)GetIndexTypeSize(indexType));
+	}
+
+	// Write vertex data to file
+	file.write(reinterpret_cast<const char*>(vertices), numVertices * (size_t)vertexStride);
+}
+
 MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename) {
 	// Open our file in binary mode
 	std::ifstream file;
@@ -235,50 +289,67 @@ MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(c
 
 VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
 
-	// Open the output file
-	std::ifstream file(filename, std::ios::binary);
+	// Read the whole file in one go (or grab it straight from an asset pack)
+	FileHelpers::FileBuffer file;
 	// If our file fails to open, we will throw an error
-	if (!file) { throw std::runtime_error("Failed to open file"); }
+	if (!FileHelpers::ReadFileBuffer(filename, file)) { throw std::runtime_error("Failed to open file"); }
 
 	float startTime = static_cast<float>(glfwGetTime());
 
 	// Get the file size so we can avoid reading past the end
-	file.seekg(0, std::ios::end);
-	size_t size = file.tellg();
-	file.seekg(0, std::ios::beg);
+	size_t size = file.Size;
+	const uint8_t* cursor = file.Data;
 
 	// Read the header from the file
 	BinaryHeader header = BinaryHeader();
 	if (size >= sizeof(BinaryHeader)) {
-		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
+		memcpy(&header, cursor, sizeof(BinaryHeader));
+		cursor += sizeof(BinaryHeader);
+		size -= sizeof(BinaryHeader);
 	} else {
-		LOG_ERROR("Not enough data in the file!");
+		LOG_WARN("Not enough data in \"{}\" for a header", filename);
 		return nullptr;
 	}
 
-	// TODO: validate header
+	if (memcmp(header.HeaderBytes, HEADER_BYTES, sizeof(HEADER_BYTES)) != 0) {
+		LOG_WARN("\"{}\" is not a binary mesh file", filename);
+		return nullptr;
+	}
 
 	// Handle our version
 	if (header.Version == 0x01) {
-		// Determine how many bytes we need in the file
-		size_t requiredBytes =
-			sizeof(BinaryHeader) +
-			(header.NumAttributes * sizeof(BufferAttribute)) +
-			(header.VertexStride * (size_t)header.NumVertices) +
-			(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-
-		// Make sure there's enough data in the file
-		if (size < requiredBytes) {
-			LOG_ERROR("Not enough data in the file!");
+		// Every count in the header is checked against what's left in the file before we copy anything,
+		// so that a truncated or corrupt file can't make us read past the end
+		const size_t attributeBytes = header.NumAttributes * sizeof(BufferAttribute);
+		if (attributeBytes > size) {
+			LOG_WARN("Not enough data in \"{}\" for {} vertex attributes", filename, header.NumAttributes);
+			return nullptr;
+		}
+		size -= attributeBytes;
+
+		const size_t indexSize = GetIndexTypeSize(header.IndicesType);
+		if (header.NumIndices > 0 && indexSize == 0) {
+			LOG_WARN("Invalid index type in \"{}\"", filename);
+			return nullptr;
+		}
+		const size_t indexBytes = header.NumIndices * indexSize;
+		if (indexBytes > size) {
+			LOG_WARN("Not enough data in \"{}\" for {} indices", filename, header.NumIndices);
+			return nullptr;
+		}
+		size -= indexBytes;
+
+		const size_t vertexBytes = header.VertexStride * (size_t)header.NumVertices;
+		if (header.VertexStride == 0 || vertexBytes > size) {
+			LOG_WARN("Not enough data in \"{}\" for {} vertices", filename, header.NumVertices);
 			return nullptr;
 		}
 
 		// Read all attributes from the file, this is basically our VDECL
 		std::vector<BufferAttribute> vertexDeclaration;
 		vertexDeclaration.resize(header.NumAttributes);
-		for (int ix = 0; ix < header.NumAttributes; ix++) {
-			file.read(reinterpret_cast<char*>(&vertexDeclaration[ix]), sizeof(BufferAttribute));
-		}
+		memcpy(vertexDeclaration.data(), cursor, attributeBytes);
+		cursor += attributeBytes;
 
 		// These will have the buffer pointers
 		IndexBuffer::Sptr indices = nullptr;
@@ -289,25 +360,14 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 			// Create index buffer
 			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
 
-			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
+			// We can upload straight from the file data, no need for an extra copy
+			indices->LoadData(cursor, indexSize, header.NumIndices, header.IndicesType);
+			cursor += indexBytes;
 		}
 
-		// Create a new VBO
+		// Create a new VBO and upload straight from the file data
 		vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
-
-		// Create memory to store vertices and load from file
-		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
-		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
-
-		// Load data into OpenGL and free the CPU copy
-		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
-		free(vertexStore);
+		vertices->LoadData(cursor, header.VertexStride, header.NumVertices);
 
 		// Create the VAO and attach our index and vertex buffers
 		VertexArrayObject::Sptr result = VertexArrayObject::Create();
@@ -324,5 +384,6 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 		return result;
 	}
 
+	LOG_WARN("Unknown binary mesh version {} in \"{}\"", header.Version, filename);
 	return nullptr;
 }
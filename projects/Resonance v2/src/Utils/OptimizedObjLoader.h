@@ -42,6 +42,22 @@ public:
 	template <typename VertexType>
 	static void SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename);
 
+	/// <summary>
+	/// Saves raw interleaved vertex data and indices to a binary file, for loaders that do not go through a MeshBuilder
+	/// </summary>
+	/// <param name="vertices">The interleaved vertex data</param>
+	/// <param name="numVertices">The number of vertices in the vertex data</param>
+	/// <param name="vertexStride">The size of a single vertex, in bytes</param>
+	/// <param name="vDecl">The attributes that make up a vertex</param>
+	/// <param name="indices">The index data, or nullptr if the mesh is not indexed</param>
+	/// <param name="numIndices">The number of indices in the index data</param>
+	/// <param name="indexType">The type of the indices</param>
+	/// <param name="outFilename">The path to the file to create</param>
+	static void SaveBinaryFile(
+		const void* vertices, uint32_t numVertices, uint16_t vertexStride, const std::vector<BufferAttribute>& vDecl,
+		const void* indices, uint32_t numIndices, IndexType indexType,
+		const std::string& outFilename);
+
 protected:
 	// Will be put at the start of the binary file, contains info about the contents of the file
 	struct BinaryHeader {
@@ -70,33 +86,8 @@ protected:
 
 template <typename VertexType>
 void OptimizedObjLoader::SaveBinaryFile(MeshBuilder<VertexType>& mesh, const std::string& outFilename) {
-	// Open the output file
-	std::ofstream file(outFilename, std::ios::binary);
-	if (!file) {
-		throw std::runtime_error("Failed to open output file");
-	}
-
-	// Create the fixed size header for our output file
-	BinaryHeader header  = BinaryHeader();
-	header.Version       = 0x01; // This is version 1! Update this and implement different readers if changes to format are made
-	header.NumIndices    = mesh.GetIndexCount();
-	header.IndicesType   = IndexType::UInt;
-	header.NumVertices   = mesh.GetVertexCount();
-	header.VertexStride  = sizeof(VertexType);
-	header.NumAttributes = VertexType::V_DECL.size();
-
-	// Write header bytes to the stream
-	file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryHeader));
-
-	// Write which attributes we have to the stream
-	for (int ix = 0; ix < VertexType::V_DECL.size(); ix++) {
-		file.write(reinterpret_cast<const char*>(&VertexType::V_DECL[ix]), sizeof(BufferAttribute));
-	}
-	// Write any index data to the file
-	if (mesh.GetIndexCount() > 0) {
-		file.write(reinterpret_cast<const char*>(mesh.GetIndexDataPtr()), mesh.GetIndexCount() * sizeof(uint32_t));
-	}
-
-	// Write vertex data to file
-	file.write(reinterpret_cast<const char*>(mesh.GetVertexDataPtr()), mesh.GetVertexCount() * sizeof(VertexType));
+	SaveBinaryFile(
+		mesh.GetVertexDataPtr(), static_cast<uint32_t>(mesh.GetVertexCount()), sizeof(VertexType), VertexType::V_DECL,
+		mesh.GetIndexDataPtr(), static_cast<uint32_t>(mesh.GetIndexCount()), IndexType::UInt,
+		outFilename);
 }
@@ -4,10 +4,13 @@
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
 
+#include <algorithm>
+
 std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
 std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
 
 nlohmann::ordered_json ResourceManager::_manifest;
+std::unordered_map<std::string, ShaderProgram::Sptr> ResourceManager::_shaderRegistry;
 
 void ResourceManager::Init() {
 	// TODO: initialize the resource manager once it's a bit more complex
@@ -21,6 +24,10 @@ const nlohmann::ordered_json& ResourceManager::GetManifest() {
 	return _manifest;
 }
 
+void ResourceManager::SetManifestSection(const std::string& name, const nlohmann::ordered_json& data) {
+	_manifest[name] = data;
+}
+
 void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets) {
 	std::string contents = FileHelpers::ReadFile(path);
 	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
@@ -45,7 +52,7 @@ void ResourceManager::SaveManifest(const std::string& path) {
 		for (auto& [guid, res] : map) {
 			if (res != nullptr) {
 				_manifest[typeName][guid.str()] = res->ToJson();
-				_manifest[typeName][guid.str()]["guid"] = res->GetGUID().str();
+				_manifest[typeName][guid.str()]["guid"] = guid.str();
 			}
 		}
 	}
@@ -56,5 +63,113 @@ void ResourceManager::Cleanup() {
 	for (auto& [type, map] : _resources) {
 		map.clear();
 	}
+	_shaderRegistry.clear();
+}
+
+ShaderProgram::Sptr ResourceManager::GetShader(
+	const std::unordered_map<ShaderPartType, std::string>& filePaths,
+	const std::vector<std::string>& defines,
+	const std::vector<std::string>& varyings)
+{
+	return _GetOrCreateShader(filePaths, true, defines, varyings);
+}
+
+ShaderProgram::Sptr ResourceManager::GetShaderFromSource(
+	const std::unordered_map<ShaderPartType, std::string>& sources,
+	const std::vector<std::string>& defines)
+{
+	return _GetOrCreateShader(sources, false, defines, {});
+}
+
+ShaderProgram::Sptr ResourceManager::GetShaderPermutation(const ShaderProgram::Sptr& base, const std::vector<std::string>& defines) {
+	if (base == nullptr) {
+		return nullptr;
+	}
+
+	// The JSON representation tells us where each stage came from
+	nlohmann::json data = base->ToJson();
+	std::unordered_map<ShaderPartType, std::string> stages;
+	bool fromFile = true;
+	for (auto& [key, blob] : data.items()) {
+		ShaderPartType type = ParseShaderPartType(key, ShaderPartType::Unknown);
+		if (type != ShaderPartType::Unknown) {
+			if (blob.contains("path")) {
+				stages[type] = blob["path"].get<std::string>();
+			} else {
+				stages[type] = blob["source"].get<std::string>();
+				fromFile = false;
+			}
+		}
+	}
+
+	// Mixing file and inline stages is not something we can key on, fall back to treating them all as source
+	if (!fromFile) {
+		for (auto& [key, blob] : data.items()) {
+			ShaderPartType type = ParseShaderPartType(key, ShaderPartType::Unknown);
+			if (type != ShaderPartType::Unknown && blob.contains("path")) {
+				stages[type] = FileHelpers::ReadResolveIncludes(blob["path"].get<std::string>());
+			}
+		}
+	}
+
+	std::vector<std::string> allDefines = base->GetDefines();
+	allDefines.insert(allDefines.end(), defines.begin(), defines.end());
+	return _GetOrCreateShader(stages, fromFile, allDefines, {});
+}
+
+ShaderProgram::Sptr ResourceManager::_GetOrCreateShader(
+	const std::unordered_map<ShaderPartType, std::string>& stages, bool fromFile,
+	const std::vector<std::string>& defines, const std::vector<std::string>& varyings)
+{
+	// Sort everything so that the key doesn't depend on the order things were requested in
+	std::map<GLint, std::string> sortedStages;
+	for (auto& [type, value] : stages) {
+		sortedStages[(GLint)type] = value;
+	}
+	std::vector<std::string> sortedDefines = defines;
+	std::sort(sortedDefines.begin(), sortedDefines.end());
+	sortedDefines.erase(std::unique(sortedDefines.begin(), sortedDefines.end()), sortedDefines.end());
+
+	// Build up the key, the order of varyings matters so we leave them as is
+	std::string key = fromFile ? "file" : "source";
+	for (auto& [type, value] : sortedStages) {
+		key += "|" + std::to_string(type) + ":" + value;
+	}
+	for (const auto& define : sortedDefines) {
+		key += "|D:" + define;
+	}
+	for (const auto& varying : varyings) {
+		key += "|V:" + varying;
+	}
+
+	auto it = _shaderRegistry.find(key);
+	if (it != _shaderRegistry.end()) {
+		return it->second;
+	}
+
+	// First time we've seen this combination, build it
+	ShaderProgram::Sptr result = ShaderProgram::Create();
+	for (const auto& define : sortedDefines) {
+		result->AddDefine(define);
+	}
+	for (auto& [type, value] : stages) {
+		if (fromFile) {
+			result->LoadShaderPartFromFile(value.c_str(), type);
+		} else {
+			result->LoadShaderPart(value.c_str(), type);
+		}
+	}
+	if (!varyings.empty()) {
+		std::vector<const char*> names;
+		names.reserve(varyings.size());
+		for (const auto& varying : varyings) {
+			names.push_back(varying.c_str());
+		}
+		result->RegisterVaryings(names.data(), (int)names.size(), true);
+	}
+	result->Link();
+
+	_shaderRegistry[key] = result;
+	return result;
 }
 
@@ -94,9 +94,17 @@ public:
 		// Create the type loader for the type
 		_typeLoaders[typeName] = [](const nlohmann::json& data) {
 			IResource::Sptr res = T::FromJson(data);
-			res->OverrideGUID(Guid(data["guid"]));
-			_resources[std::type_index(typeid(T))][res->GetGUID()] = res;
-			return res->GetGUID();
+			Guid guid = Guid(data["guid"]);
+			auto& store = _resources[std::type_index(typeid(T))];
+
+			// Some loaders (ex: shaders) may return a resource that is shared with another GUID,
+			// in that case we alias the GUID to the existing resource rather than stealing it's ID
+			auto it = store.find(res->GetGUID());
+			if (it == store.end() || it->second != res) {
+				res->OverrideGUID(guid);
+			}
+			store[guid] = res;
+			return guid;
 		};
 
 		// Make sure we haven't registered the type yet, then add an empty object
@@ -130,11 +138,49 @@ public:
 		}
 	}
 
+	/// <summary>
+	/// Gets a shader program built from the given stage files and preprocessor defines. Programs are
+	/// shared between all requesters, so a given combination of files and defines is only ever compiled once,
+	/// and permutations are only compiled when they are first requested
+	/// </summary>
+	/// <param name="filePaths">The paths to the shader stages, keyed by stage</param>
+	/// <param name="defines">The preprocessor defines to build the program with (ex: "INSTANCED")</param>
+	/// <param name="varyings">The transform feedback varyings to capture, if any</param>
+	/// <returns>The shared shader program</returns>
+	static ShaderProgram::Sptr GetShader(
+		const std::unordered_map<ShaderPartType, std::string>& filePaths,
+		const std::vector<std::string>& defines = {},
+		const std::vector<std::string>& varyings = {});
+	/// <summary>
+	/// Gets a shader program built from inline GLSL sources and preprocessor defines, shared between
+	/// all requesters with the same sources and defines
+	/// </summary>
+	/// <param name="sources">The GLSL source for the shader stages, keyed by stage</param>
+	/// <param name="defines">The preprocessor defines to build the program with</param>
+	/// <returns>The shared shader program</returns>
+	static ShaderProgram::Sptr GetShaderFromSource(
+		const std::unordered_map<ShaderPartType, std::string>& sources,
+		const std::vector<std::string>& defines = {});
+	/// <summary>
+	/// Gets a permutation of an existing shader program, with additional preprocessor defines
+	/// </summary>
+	/// <param name="base">The program to use as the base for the permutation</param>
+	/// <param name="defines">The defines to add on top of the base program's defines</param>
+	/// <returns>The shared shader program for the permutation</returns>
+	static ShaderProgram::Sptr GetShaderPermutation(const ShaderProgram::Sptr& base, const std::vector<std::string>& defines);
+
 	/// <summary>
 	/// Gets the current JSON manifest
 	/// </summary>
 	static const nlohmann::ordered_json& GetManifest();
 	/// <summary>
+	/// Replaces a section of the manifest that isn't stored by a resource type (ex: the sound bank), so that
+	/// it will be written out the next time the manifest is saved
+	/// </summary>
+	/// <param name="name">The name of the section</param>
+	/// <param name="data">The JSON contents of the section</param>
+	static void SetManifestSection(const std::string& name, const nlohmann::ordered_json& data);
+	/// <summary>
 	/// Loads a manifest file into the resource manager. Note that this will not perform load on the assets themselves 
 	/// unless preloadAssets is set to true
 	/// </summary>
@@ -169,4 +215,16 @@ protected:
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
+
+	/// <summary>
+	/// Shared shader programs, keyed by their stages, defines and varyings
+	/// </summary>
+	static std::unordered_map<std::string, ShaderProgram::Sptr> _shaderRegistry;
+
+	/// <summary>
+	/// Handles looking up or creating a shared shader program
+	/// </summary>
+	static ShaderProgram::Sptr _GetOrCreateShader(
+		const std::unordered_map<ShaderPartType, std::string>& stages, bool fromFile,
+		const std::vector<std::string>& defines, const std::vector<std::string>& varyings);
 };
\ No newline at end of file
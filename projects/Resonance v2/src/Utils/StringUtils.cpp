@@ -1,4 +1,5 @@
 #include "Utils/StringUtils.h"
+#include <cstring>
 
 std::string StringTools::SanitizeClassName(const std::string& name)
 {
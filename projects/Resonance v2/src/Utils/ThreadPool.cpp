@@ -0,0 +1,138 @@
+#include "Utils/ThreadPool.h"
+
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+// The state of a single ParallelFor, shared with the helper tasks since they may only get picked up after the loop is done
+struct ParallelLoop {
+	const std::function<void(uint32_t, uint32_t)>* Body = nullptr;
+	uint32_t                Count = 0;
+	uint32_t                GrainSize = 1;
+	uint32_t                ChunkCount = 0;
+	std::atomic<uint32_t>   NextChunk{ 0 };
+	std::mutex              Mutex;
+	std::condition_variable Done;
+	// Guarded by Mutex
+	uint32_t                FinishedChunks = 0;
+
+	void RunChunks() {
+		uint32_t finished = 0;
+		for (uint32_t chunk = NextChunk++; chunk < ChunkCount; chunk = NextChunk++) {
+			const uint32_t begin = chunk * GrainSize;
+			(*Body)(begin, std::min(Count, begin + GrainSize));
+			finished++;
+		}
+
+		if (finished > 0) {
+			bool isDone;
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+				FinishedChunks += finished;
+				isDone = FinishedChunks == ChunkCount;
+			}
+			if (isDone) {
+				Done.notify_one();
+			}
+		}
+	}
+};
+
+ThreadPool& ThreadPool::Get() {
+	static ThreadPool pool(std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 1));
+	return pool;
+}
+
+ThreadPool::ThreadPool(int workerCount) :
+	_workers(),
+	_mutex(),
+	_wake(),
+	_isStopping(false),
+	_tasks()
+{
+	for (int ix = 0; ix < workerCount; ix++) {
+		_workers.emplace_back(&ThreadPool::_WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isStopping = true;
+	}
+	_wake.notify_all();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> task) {
+	if (_workers.empty()) {
+		task();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_tasks.push_back(std::move(task));
+	}
+	_wake.notify_one();
+}
+
+void ThreadPool::ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body, int maxHelpers) {
+	if (count == 0) {
+		return;
+	}
+	grainSize = std::max(grainSize, 1u);
+	const uint32_t chunkCount = (count + grainSize - 1) / grainSize;
+	int helpers = std::min(static_cast<int>(chunkCount) - 1, GetWorkerCount());
+	if (maxHelpers >= 0) {
+		helpers = std::min(helpers, maxHelpers);
+	}
+
+	// Not worth handing out, just run it here
+	if (helpers <= 0) {
+		body(0, count);
+		return;
+	}
+
+	std::shared_ptr<ParallelLoop> loop = std::make_shared<ParallelLoop>();
+	loop->Body = &body;
+	loop->Count = count;
+	loop->GrainSize = grainSize;
+	loop->ChunkCount = chunkCount;
+
+	{
+		// Loops jump the queue, since someone is waiting on them
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (int ix = 0; ix < helpers; ix++) {
+			_tasks.push_front([loop]() { loop->RunChunks(); });
+		}
+	}
+	if (helpers == 1) {
+		_wake.notify_one();
+	} else {
+		_wake.notify_all();
+	}
+
+	loop->RunChunks();
+
+	// Helpers that got here too late find no chunks left, and never touch the body
+	std::unique_lock<std::mutex> lock(loop->Mutex);
+	loop->Done.wait(lock, [&]() { return loop->FinishedChunks == loop->ChunkCount; });
+}
+
+void ThreadPool::_WorkerMain() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_wake.wait(lock, [this]() { return _isStopping || !_tasks.empty(); });
+			if (_isStopping) {
+				return;
+			}
+			task = std::move(_tasks.front());
+			_tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+#include "Utils/Macros.h"
+
+/// <summary>
+/// The engine's shared pool of worker threads. Systems that want to spread work over cores (physics, batched
+/// raycasts, path searches, audio occlusion, asset loading) hand it to this pool instead of starting threads of
+/// their own, so that together they never ask for more threads than there are cores
+///
+/// Work can either be queued up to run in the background with Enqueue, or split up with ParallelFor, which the
+/// calling thread always helps with. Tasks should never block waiting on the main thread
+/// </summary>
+class ThreadPool final {
+public:
+	NO_COPY(ThreadPool);
+	NO_MOVE(ThreadPool);
+
+	/// <summary>
+	/// Gets the pool shared by the whole engine, it's created with one worker for each core after the first
+	/// </summary>
+	static ThreadPool& Get();
+
+	/// <summary>
+	/// Gets the number of worker threads in the pool, not including any threads that call ParallelFor
+	/// </summary>
+	int GetWorkerCount() const { return static_cast<int>(_workers.size()); }
+
+	/// <summary>
+	/// Queues up a task to run on one of the workers. With no workers, the task runs right away on the calling thread
+	/// </summary>
+	void Enqueue(std::function<void()> task);
+
+	/// <summary>
+	/// Splits the range [0, count) into chunks and runs them across the workers and the calling thread, returning
+	/// once every chunk is done. Loops started from inside a task or another loop are fine, the calling thread
+	/// just does more of the work itself
+	/// </summary>
+	/// <param name="count">The number of items in the loop</param>
+	/// <param name="grainSize">The number of items in each chunk</param>
+	/// <param name="body">Called with the [begin, end) range of each chunk</param>
+	/// <param name="maxHelpers">The most workers that can help with the loop, on top of the calling thread</param>
+	void ParallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body, int maxHelpers = -1);
+
+protected:
+	ThreadPool(int workerCount);
+	~ThreadPool();
+
+	std::vector<std::thread>          _workers;
+	std::mutex                        _mutex;
+	std::condition_variable           _wake;
+	// Guarded by _mutex
+	bool                              _isStopping;
+	std::deque<std::function<void()>> _tasks;
+
+	void _WorkerMain();
+};
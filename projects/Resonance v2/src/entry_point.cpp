@@ -1,11 +1,22 @@
 #define GLM_SWIZZLE 
 #include "Application/Application.h"
+#include "Utils/AssetPack.h"
+#include <cstring>
 
 int main(int argc, char** args) {
 	Logger::Init();
 
 	// TODO: parse arguments?
 
+	// Asset pack builder, ex: Resonance.exe --build-pack ./ assets.pak
+	// Run the game once beforehand so that the binary mesh files exist to be packed
+	if (argc >= 4 && strcmp(args[1], "--build-pack") == 0) {
+		bool compress = !(argc >= 5 && strcmp(args[4], "--no-compress") == 0);
+		bool success = AssetPack::Build(args[2], args[3], compress);
+		Logger::Uninitialize();
+		return success ? 0 : 1;
+	}
+
 	Application::Start(argc, args);
 
 	Logger::Uninitialize();